@@ -1,8 +1,10 @@
 #include "AppRuntime.h"
 
-#include <iostream>
+#include <algorithm>
+#include <array>
 #include <mutex>
 #include <chrono>
+#include <deque>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
@@ -15,7 +17,12 @@
 #include <unistd.h>
 #include <dirent.h>
 #include <filesystem>
+#include <cstdio>
 #include <cstring>
+#include <stdexcept>
+
+#include "rfid/MockReaderBackend.h"
+#include "utils/InfraLog.h"
 
 namespace {
 
@@ -23,9 +30,24 @@ namespace fs = std::filesystem;
 
 // CORE PumpRuntimeStore -> GUI thread köprüsü için basit cache
 struct PumpStoreGuiCache {
+    static constexpr std::size_t kMaxTransitions = 32;
+
     std::mutex             mtx;
-    ::core::PumpRuntimeState last_state{};
-    bool                   has_state{false};
+    // Slot başına son state (slot_index ile); GUI seçili slot'u gösterir,
+    // geçiş aksiyonları kendi slot'unun state'iyle uygulanır.
+    std::array<::core::PumpRuntimeState, ::core::PumpRuntimeStore::kMaxSlots> states{};
+    std::uint32_t          has_state_mask{0};
+
+    // GUI thread'inin henüz uygulamadığı istasyon geçişleri. kMaxTransitions
+    // aşılınca en eski satış-dışı geçiş düşer; CloseSale (fatura satırı)
+    // hiç düşmez.
+    std::deque<recum12::gui::StationLogEntry> transitions;
+    std::uint64_t          dropped{0};
+    std::uint64_t          dropped_reported{0};
+
+    // Henüz GUI'ye/infra log'a aktarılmamış akış anomalileri (nadir; taşarsa en yenisi düşer)
+    std::array<::core::FlowAnomaly, 8> anomalies{};
+    std::size_t            anomaly_count{0};
 };
 
 PumpStoreGuiCache g_pump_store_gui_cache;
@@ -36,6 +58,16 @@ struct AuthGuiCache {
     std::string  last_msg;
     bool         has_msg{false};
 };
+
+// Yerel tarih (dd.mm.yyyy): saat label'ı ve vardiya gün dönümü için
+std::string local_date(std::time_t t)
+{
+    std::tm tm {};
+    localtime_r(&t, &tm);
+    char buf[16] {};
+    std::strftime(buf, sizeof(buf), "%d.%m.%Y", &tm);
+    return buf;
+}
 // Belirli bir network arayüzü (örn: "eth0", "wlan0") için IPv4 adresini bulur.
 // Bulamazsa "0.0.0.0" döner.
 std::string get_ip_for_iface(const std::string& iface_name)
@@ -111,19 +143,39 @@ bool is_rs485_device_present(const std::string& dev_path)
 
 AuthGuiCache g_auth_gui_cache;
 
-// Worker thread'i
-//  - MIN-POLL (heart-beat) gönderiyor
+// Core (RS485) worker thread'i
 //  - RX verisini parse ediyor
+//  - RFID thread'inin kuyruğa bıraktığı kart olaylarını işliyor (auth stage)
+//  - Pompa TX kuyruğunu (bus scheduler) boşaltıyor
+//  - Zamanlayıcı çarkını ilerletiyor (MIN-POLL heart-beat, istasyon timeout'ları)
 // UI güncellemeleri ise dispatcher üzerinden main thread'e aktarılıyor.
 //
-void rs485_worker(recum12::hw::PumpInterfaceLvl3& pump,
-                  std::atomic<bool>&               running)
+void rs485_worker(recum12::hw::PumpInterfaceLvl3&    pump,
+                  recum12::core::RfidAuthController& auth,
+                  recum12::core::TimerWheel&         timers,
+                  const std::vector<std::uint8_t>&   poll_addrs,
+                  const std::function<void()>&       after_store,
+                  std::atomic<bool>&                 running)
 {
-    std::cout << "[RS485] worker started" << std::endl;
+    RECUM_LOG_INFO("RS485", "worker started");
 
     using namespace std::chrono_literals;
 
-    auto last_poll = std::chrono::steady_clock::now();
+    // ~1000 ms'de bir MIN-POLL (heart-beat) gönder:
+    //  50 20 FA  → pompadan 50 70 FA (MIN-ACK) beklenir.
+    // Artık sürekli CD1 spam etmiyoruz; sadece MIN-POLL (hattaki her pompaya).
+    auto heartbeat = timers.scheduleEvery(1000ms, [&pump, &poll_addrs]() {
+        if (!pump.isOpen()) {
+            return;
+        }
+        if (poll_addrs.empty()) {
+            pump.sendMinPoll();
+            return;
+        }
+        for (const auto addr : poll_addrs) {
+            pump.sendMinPoll(addr);
+        }
+    });
 
     while (running.load(std::memory_order_relaxed)) {
         if (pump.isOpen()) {
@@ -131,47 +183,49 @@ void rs485_worker(recum12::hw::PumpInterfaceLvl3& pump,
             const bool had_activity = pump.pollOnceRx();
 
             if (had_activity) {
-                std::cout << "[RS485] rx activity" << std::endl;
-            }
-
-            // ~1000 ms'de bir MIN-POLL (heart-beat) gönder:
-            //  50 20 FA  → pompadan 50 70 FA (MIN-ACK) beklenir.
-            const auto now = std::chrono::steady_clock::now();
-            if (now - last_poll >= 1000ms) {
-                // Artık sürekli CD1 spam etmiyoruz; sadece MIN-POLL.
-                pump.sendMinPoll();
-                last_poll = now;
+                RECUM_LOG_DEBUG("RS485", "rx activity");
             }
         }
 
-        std::this_thread::sleep_for(20ms);
-    }
-}
+        // Vadesi gelen zamanlayıcılar (heart-beat, FillWait/Unauth timeout)
+        timers.advance();
 
-// RFID worker:
-//  - Pn532Reader.pollOnce() çağırır
-//  - Kart algılama / hata callback'leri RfidAuthController üzerinden çalışır
-void rfid_worker(recum12::rfid::Pn532Reader& reader,
-                 std::atomic<bool>&           running)
-{
-    using namespace std::chrono_literals;
+        // Geçişlerin kilit dışı işleri (kapanan satış → kota): yeniden kart
+        // okutma kontrolünden önce toplama girsin
+        if (after_store) {
+            after_store();
+        }
 
-    std::cout << "[RFID] worker started" << std::endl;
+        // Auth stage: bekleyen kart olaylarını işle (AUTHORIZE TX kuyruğuna düşer)
+        auth.processPending();
 
-    while (running.load(std::memory_order_relaxed)) {
-        reader.pollOnce();
-        std::this_thread::sleep_for(100ms);
+        if (pump.isOpen()) {
+            // Kuyruktaki komutları (AUTHORIZE, GUI AUTH butonu, MIN-POLL vb.) yaz
+            pump.flushTxQueue();
+        }
+
+        // En fazla 20 ms'lik tick (yakın bir zamanlayıcı varsa daha kısa);
+        // kart olayı gelirse hemen uyan.
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            timers.timeUntilNext(20ms));
+        auth.waitForPending(wait);
     }
+
+    timers.cancel(heartbeat);
 }
 
 } // namespace
 
 namespace recum12::gui {
 
-RuntimeWorkers::RuntimeWorkers(recum12::hw::PumpInterfaceLvl3& p,
-                               recum12::rfid::Pn532Reader&     r)
+RuntimeWorkers::RuntimeWorkers(recum12::hw::PumpInterfaceLvl3&    p,
+                               recum12::rfid::ReaderPool&         r,
+                               recum12::core::RfidAuthController& a,
+                               recum12::core::TimerWheel&         t)
     : pump(p)
-    , rfid_reader(r)
+    , rfid_pool(r)
+    , rfid_auth(a)
+    , timers(t)
 {
 }
 
@@ -180,36 +234,38 @@ void RuntimeWorkers::start()
     using namespace std::chrono_literals;
     running.store(true, std::memory_order_relaxed);
 
-    if (pump.isOpen()) {
-        rs485_thread = std::thread(rs485_worker,
-                                   std::ref(pump),
-                                   std::ref(running));
-    }
-
-    // RFID worker her durumda çalışsın; Pn532Reader.pollOnce() içinde
+    // Core worker her durumda çalışsın: pompa kapalı olsa da kart olayları
+    // (ör. yetkisiz kart mesajı) işlenmeli. Pompa I/O'su içeride isOpen()'a bağlı.
+    rs485_thread = std::thread(rs485_worker,
+                               std::ref(pump),
+                               std::ref(rfid_auth),
+                               std::ref(timers),
+                               std::cref(poll_addrs),
+                               std::cref(after_store),
+                               std::ref(running));
+
+    // RFID havuzu her durumda çalışsın; Pn532Reader.pollOnce() içinde
     // open() / reconnect mantığı zaten var.
-    rfid_thread = std::thread(rfid_worker,
-                              std::ref(rfid_reader),
-                              std::ref(running));
+    rfid_pool.start();
 }
 
 void RuntimeWorkers::stop()
 {
     running.store(false, std::memory_order_relaxed);
 
+    // Havuz süren donanım taramalarını keser (yoksa tur bitene kadar bekler)
+    rfid_pool.stop();
+
     if (rs485_thread.joinable()) {
         rs485_thread.join();
     }
-    if (rfid_thread.joinable()) {
-        rfid_thread.join();
-    }
 }
 
 AppRuntime::AppRuntime(MainWindow& ui_)
     : ui(ui_)
     , status_ctrl(ui)
     , rs485_adapter(ui, status_ctrl)
-    , workers(pump, rfid_reader)
+    , workers(pump, rfid_pool, rfid_auth, timers)
 {
     using recum12::gui::StatusMessageController;
     using recum12::utils::Settings;
@@ -228,12 +284,11 @@ AppRuntime::AppRuntime(MainWindow& ui_)
     Glib::ustring wifi_ip = wifi_ip_str.empty() ? "0.0.0.0" : wifi_ip_str;
 
     // Debug için network durumunu logla
-    std::cout << "[NET] status"
-              << " eth="  << (net.ethernet_connected ? "UP" : "DOWN")
-              << " wifi=" << (net.wifi_connected     ? "UP" : "DOWN")
-              << " gsm="  << (net.gsm_connected      ? "UP" : "DOWN")
-              << " gps="  << (net.gps_connected      ? "UP" : "DOWN")
-              << std::endl;
+    RECUM_LOG_INFO("NET", "status eth={} wifi={} gsm={} gps={}",
+                   net.ethernet_connected ? "UP" : "DOWN",
+                   net.wifi_connected     ? "UP" : "DOWN",
+                   net.gsm_connected      ? "UP" : "DOWN",
+                   net.gps_connected      ? "UP" : "DOWN");
 
     // İleride: bu bilgiler MainWindow ikonları ve IP label'larına yansıtılacak
     // (NetworkManager_Integration_Guide planına göre).
@@ -256,30 +311,74 @@ AppRuntime::AppRuntime(MainWindow& ui_)
             app_root = recum12::utils::LogManager::detectAppRoot();
         }
     }
-    std::cout << "[LogManager] app_root = " << app_root << std::endl;
+    RECUM_LOG_INFO("LogManager", "app_root = {}", app_root);
 
     const bool scaffold_ok = recum12::utils::LogManager::ensureScaffold(app_root);
-    std::cout << "[LogManager] ensureScaffold -> "
-              << (scaffold_ok ? "OK" : "FAIL") << std::endl;
+    RECUM_LOG_INFO("LogManager", "ensureScaffold -> {}", scaffold_ok ? "OK" : "FAIL");
+
+    // Infra log sink'i: bundan sonraki RECUM_LOG_* kayıtları recumLogs.csv'ye
+    // (ve console açıksa toplu olarak stdout/stderr'e) gider.
+    if (scaffold_ok) {
+        using recum12::utils::InfraLevel;
+        const auto& il = settings.infraLog();
+        recum12::utils::InfraSinkConfig ic;
+        ic.min_level    = (il.min_level == "DEBUG") ? InfraLevel::Debug
+                        : (il.min_level == "WARN")  ? InfraLevel::Warn
+                        : (il.min_level == "ERROR") ? InfraLevel::Error
+                                                    : InfraLevel::Info;
+        ic.ring_records = static_cast<std::size_t>(il.ring_records);
+        ic.max_bytes    = static_cast<std::uint64_t>(il.max_kb) * 1024;
+        ic.keep_files   = il.keep_files;
+        ic.console      = il.console;
+        if (!log_manager.startInfraLog(app_root, ic)) {
+            RECUM_LOG_WARN("LogManager", "infra log sink başlatılamadı; konsola yazılıyor");
+        }
+    }
+
+    // logs.csv yazımı arka plan yazıcısına (kalıcı fd + grup commit);
+    // açılamazsa appendUsage eski senkron yola düşer.
+    if (scaffold_ok) {
+        using recum12::utils::UsageDurability;
+        const auto& ul = settings.usageLog();
+        recum12::utils::UsageWriterConfig wc;
+        wc.durability     = (ul.durability == "record")   ? UsageDurability::PerRecord
+                          : (ul.durability == "sale_end") ? UsageDurability::OnSaleEnd
+                                                          : UsageDurability::Interval;
+        wc.interval       = std::chrono::milliseconds(ul.interval_ms);
+        wc.queue_capacity = static_cast<std::size_t>(ul.queue);
+        log_manager.setUsageLoadWorkers(static_cast<unsigned>(ul.load_workers));
+        recum12::utils::LogManager::UsageCacheWindow cw;
+        cw.max_rows = static_cast<std::size_t>(ul.cache_rows);
+        cw.max_days = ul.cache_days;
+        log_manager.setUsageCacheWindow(cw);
+        const bool async_ok = log_manager.openUsageWriter(app_root, wc);
+        RECUM_LOG_INFO("LogManager", "usage writer ({}) -> {}", ul.durability,
+                       async_ok ? "OK" : "FAIL, senkron");
+
+        // Mühürlü günlük segmentler: arka planda sıkıştırma + saklama süresi
+        recum12::utils::UsageSegmentLog::MaintenancePolicy mp;
+        mp.compress       = ul.compress;
+        mp.retention_days = ul.retention_days;
+        const bool maint_ok = log_manager.startUsageMaintenance(app_root, mp);
+        RECUM_LOG_INFO("LogManager", "usage maintenance (compress={}, retention_days={}) -> {}",
+                       mp.compress ? "on" : "off", mp.retention_days, maint_ok ? "OK" : "FAIL");
+    }
 
     // İlk test log kaydı: uygulama runtime'ı başladı.
     if (scaffold_ok) {
         recum12::utils::LogManager::UsageEntry e{};
-        e.processId = 0;          // PC tarafı başlangıç kaydı
+        e.processId = 0;          // 0 → LogManager kalıcı sayaçtan atar
         e.logCode   = "APP_START";
         // timeStamp boş bırakılırsa appendUsage içinde ISO-8601 UTC doldurulur.
         e.sendOk    = "NA";
 
         const bool logged = log_manager.appendUsage(app_root, e);
-        std::cout << "[LogManager] appendUsage(APP_START) -> "
-                  << (logged ? "OK" : "FAIL") << std::endl;
+        RECUM_LOG_INFO("LogManager", "appendUsage(APP_START) -> {}", logged ? "OK" : "FAIL");
         if (!logged) {
-            std::cerr << "[LogManager] ERROR: APP_START satırı yazılamadı."
-                      << " (logs/log_user/logs.csv)" << std::endl;
+            RECUM_LOG_ERROR("LogManager", "APP_START satırı yazılamadı. (logs/log_user/usage/)");
         }
     } else {
-        std::cerr << "[LogManager] ERROR: ensureScaffold başarısız,"
-                  << " APP_START log'u atlanıyor." << std::endl;
+        RECUM_LOG_ERROR("LogManager", "ensureScaffold başarısız, APP_START log'u atlanıyor.");
     }
     // users.csv yükleme
     const std::string user_paths[] = {
@@ -290,16 +389,43 @@ AppRuntime::AppRuntime(MainWindow& ui_)
     bool users_loaded = false;
     for (const auto& upath : user_paths) {
         if (user_manager.loadUsers(upath)) {
-            std::cout << "[UserManager] loaded user db from: "
-                      << upath << std::endl;
+            RECUM_LOG_INFO("UserManager", "loaded user db from: {}{}", upath,
+                           user_manager.loadedFromImage() ? " (users.udb imajı)" : "");
             users_loaded = true;
             break;
         }
     }
     if (!users_loaded) {
-        std::cerr << "[UserManager] WARNING: users.csv could not be loaded; "
-                     "all cards will be treated as unauthorized."
-                  << std::endl;
+        RECUM_LOG_WARN("UserManager",
+                       "users.csv could not be loaded; all cards will be treated as unauthorized.");
+    } else {
+        // users.csv değiştiğinde uygulamayı yeniden başlatmadan tabloyu yenile.
+        user_manager.onReloaded = [](bool ok, const recum12::core::UserReloadMetrics& m) {
+            RECUM_LOG_INFO("UserManager", "reload {} rows={} parse_errors={} ms={}{}",
+                           ok ? "OK" : "FAIL", m.rows_loaded, m.parse_errors, m.last_reload_ms,
+                           m.last_from_image ? " (imaj)" : "");
+        };
+        if (!user_manager.startWatching()) {
+            RECUM_LOG_WARN("UserManager", "inotify watch kurulamadı; "
+                                          "users.csv değişiklikleri yeniden başlatma gerektirir.");
+        }
+    }
+
+    // Kullanıcı/plaka kota motoru (günlük/haftalık/aylık tüketim toplamları)
+    {
+        const auto& qc = settings.quota();
+        recum12::core::QuotaPolicy qp{};
+        qp.daily            = qc.daily;
+        qp.weekly           = qc.weekly;
+        qp.monthly          = qc.monthly;
+        qp.per_plate        = qc.per_plate;
+        qp.user_limit_daily = qc.user_limit_daily;
+        quota_engine.setPolicy(qp);
+
+        const std::string quota_path = app_root + "/configs/quota.dat";
+        if (!quota_engine.open(quota_path)) {
+            RECUM_LOG_WARN("Quota", "{} açılamadı; kota toplamları kalıcı olmayacak.", quota_path);
+        }
     }
 
     // Sayaç dosyasını (repo_log.json) oku / oluştur ve GUI'ye yansıt
@@ -308,178 +434,185 @@ AppRuntime::AppRuntime(MainWindow& ui_)
     pump_store.onStateChanged = [this](const ::core::PumpRuntimeState& s) {
         {
             std::lock_guard<std::mutex> lock(g_pump_store_gui_cache.mtx);
-            g_pump_store_gui_cache.last_state = s;
-            g_pump_store_gui_cache.has_state  = true;
+            auto& c = g_pump_store_gui_cache;
+            c.states[s.slot_index] = s;
+            c.has_state_mask      |= 1u << s.slot_index;
         }
         disp_store.emit();
     };
 
-    disp_store.connect([this]() {
-        ::core::PumpRuntimeState snapshot{};
-        {
-            std::lock_guard<std::mutex> lock(g_pump_store_gui_cache.mtx);
-            if (!g_pump_store_gui_cache.has_state) {
-                return;
-            }
-            snapshot = g_pump_store_gui_cache.last_state;
+    // İstasyon durum makinesi geçişleri (store kilidi altında, core thread'inde
+    // çağrılır). RFID istek/iptal ve zamanlayıcılar hemen uygulanır; GUI ve log
+    // aksiyonları sırayla GUI thread'ine aktarılır.
+    pump_store.onStationTransition = [this](const ::core::StationTransition& tr,
+                                            const ::core::PumpRuntimeState& st) {
+        RECUM_LOG_INFO("Station", "slot={} #{} {} --{}--> {} actions=0x{}", tr.slot, tr.seq,
+                       ::core::StationStateMachine::name(tr.from),
+                       ::core::StationStateMachine::name(tr.event),
+                       ::core::StationStateMachine::name(tr.to), recum12::utils::InfraHex{tr.actions});
+
+        if (tr.actions & ::core::StationAction::RequestCard) {
+            rfid_auth.handleNozzleOut(st.slot);
         }
-
-        using recum12::gui::StatusMessageController;
-
-        // AUTH OK görünümü (Authorized + nozzle_out == true) → level artışı için 10 sn bekle.
-        if (!auth_waiting_for_fill &&
-            snapshot.pump_state == ::core::PumpState::Authorized &&
-            snapshot.nozzle_out) {
-
-            auth_waiting_for_fill = true;
-
-            if (auth_timeout_conn.connected()) {
-                auth_timeout_conn.disconnect();
-            }
-
-            auth_timeout_conn =
-                Glib::signal_timeout().connect_seconds(
-                    [this]() {
-                        // Hâlâ dolum başlamadıysa IDLE'a dön.
-                        if (auth_waiting_for_fill) {
-                            auth_waiting_for_fill = false;
-
-                            // Core tarafında AUTH latch'ini kapat → Authorized state GUI'de IDLE gibi ele alınsın
-                            pump_store.clearAuth();
-
-                            // GUI tarafını temizle
-                            status_ctrl.clear_all();
-                            status_ctrl.set_message(
-                                StatusMessageController::Channel::Pump,
-                                "İşlem Yapılabilir");
-                            ui.apply_idle_view(false);
-                            ui.set_user_id("-------");
-                        }
-                        return false; // one-shot
-                    },
-                    10);
-        }
-
-        // Dolum başladıysa (FILLING veya seviye > 0) bekleme modunu iptal et.
-        if (auth_waiting_for_fill) {
-            if (snapshot.pump_state == ::core::PumpState::Filling ||
-                snapshot.current_fill_volume_l > 0.0) {
-                auth_waiting_for_fill = false;
-                if (auth_timeout_conn.connected()) {
-                    auth_timeout_conn.disconnect();
-                }
-            }
+        if (tr.actions & ::core::StationAction::CancelCard) {
+            rfid_auth.handleNozzleInOrSaleFinished(st.slot);
         }
-        // ---- Tabanca edge'leri ve satış bitişini yakala:
-        //  - GunOn_PC  : nozzle_out 0 → 1
-        //  - GunOff_PC : nozzle_out 1 → 0
-        //  - PumpOff_PC: GunOff_PC ile aynı nozzle OUT→IN edge'inde,
-        //                ama usage log sırası: önce GunOff_PC, sonra PumpOff_PC.
-        //
-        // Not:
-        //  - PumpOff_PC için artık pompa durumuna (FillingCompleted/MaxAmount)
-        //    bakmıyoruz; yalnızca core store'daki snapshot.has_last_fill,
-        //    snapshot.last_fill_volume_l > 0.0 ve snapshot.last_card_auth_ok
-        //    şartlarına göre karar veriyoruz.
-        //  - Böylece parçalı dolumlarda da (tetik ON/OFF yapılırken) her zaman
-        //    GunOn → ... → GunOff → PumpOff sırası korunmuş oluyor.
-
-        const bool nozzle_edge_on  = (!last_nozzle_out && snapshot.nozzle_out);
-        const bool nozzle_edge_off = (last_nozzle_out && !snapshot.nozzle_out);
-
-        // 1) GunOn_PC (tabanca pompadan ayrıldı)
-        if (nozzle_edge_on) {
-            recum12::utils::LogManager::UsageEntry e{};
-            e.processId = 0;
-
-            // Kart bilgisi varsa snapshot üzerinden doldur
-            e.rfid = snapshot.last_card_uid;
-            if (auto urec = user_manager.findByRfid(snapshot.last_card_uid)) {
-                e.firstName = urec->firstName;
-                e.lastName  = urec->lastName;
-                e.plate     = urec->plate;
-                e.limit     = urec->limit;
-            }
 
-            e.fuel    = 0.0;
-            e.logCode = "GunOn_PC";
-            e.sendOk  = "NA";
+        // Zamanlayıcılar: süre dolunca olay yine durum makinesine gider.
+        // Geç kalan timeout'lar tabloda yoksayılır.
+        // Zamanlayıcılar slot başınadır (eşzamanlı satışlar birbirini iptal etmez).
+        using namespace std::chrono_literals;
+        const std::size_t slot = tr.slot;
+        if (tr.actions & (::core::StationAction::CancelFillWait |
+                          ::core::StationAction::StartFillWait)) {
+            timers.cancel(fill_wait_timers[slot]);
+        }
+        if (tr.actions & ::core::StationAction::StartFillWait) {
+            // AUTH sonrası 10 sn içinde dolum başlamazsa yetkiyi düşür
+            fill_wait_timers[slot] = timers.schedule(10s, [this, slot]() {
+                pump_store.dispatch(slot, ::core::StationEvent::FillWaitTimeout);
+            });
+        }
+        // Tabanca çıktı: satış öncesi totalizer sınırı (boştaki fark ayrı kalem olur)
+        if ((tr.actions & ::core::StationAction::LogGunOn) && pump.isOpen()) {
+            pump.queueTotalCounters(st.slot);
+        }
+        // Satış kapandı: beklenen hacim totalizer okumalarıyla aynı (core)
+        // thread'de, kapanış anında deftere girer. GUI'deki PumpOff_PC
+        // yazımını beklerse araya giren boşta okuma satışı iki kaleme böler.
+        // Defteri henüz açılmamış (totalizer'ı okunmamış) slot'un bazı yoktur.
+        // Burada yalnızca bellek; checkpoint book_closed_sales'te yazılır.
+        if ((tr.actions & ::core::StationAction::CloseSale) && tr.slot < recon_open.size() &&
+            recon_open[tr.slot].load(std::memory_order_acquire) &&
+            st.has_last_fill && st.last_fill_volume.isPositive() && st.last_card_auth_ok) {
+            totalizer_recon[tr.slot].onSaleRecorded(st.last_fill_volume);
+        }
+        // Kota toplamı da core thread'inde: GUI dispatcher'ını beklerse araya
+        // giren yeniden kart okutma eski toplamla yetki alırdı. Journal
+        // yazımı (fdatasync) store kilidi dışında, book_closed_sales'te.
+        if ((tr.actions & ::core::StationAction::CloseSale) &&
+            st.has_last_fill && st.last_fill_volume.isPositive() && st.last_card_auth_ok) {
+            closed_sales.push_back(ClosedSale{tr.slot, st.last_card_uid, st.last_fill_volume});
+        }
+        if (tr.actions & ::core::StationAction::StartUnauthTimer) {
+            // 3 sn boyunca "Yetkisiz Kullanıcı" göster
+            timers.cancel(unauth_timers[slot]);
+            unauth_timers[slot] = timers.schedule(3s, [this, slot]() {
+                pump_store.dispatch(slot, ::core::StationEvent::UnauthTimeout);
+            });
+        }
 
-           const bool ok = log_manager.appendUsage(app_root, e);
-            if (!ok) {
-                std::cerr << "[LogManager] WARNING: GunOn_PC usage log yazılamadı\n";
+        StationLogEntry entry;
+        entry.tr           = tr;
+        entry.slot         = st.slot;
+        entry.card_uid     = st.last_card_uid;
+        entry.card_auth_ok = st.last_card_auth_ok;
+        entry.has_sale     = st.has_last_fill;
+        entry.sale_volume  = st.last_fill_volume;
+
+        std::lock_guard<std::mutex> lock(g_pump_store_gui_cache.mtx);
+        auto& c = g_pump_store_gui_cache;
+        if (c.transitions.size() >= PumpStoreGuiCache::kMaxTransitions) {
+            // GUI geride kaldı: en eski satış-dışı geçişi düşür
+            const auto it = std::find_if(c.transitions.begin(), c.transitions.end(),
+                                         [](const StationLogEntry& e) {
+                                             return !(e.tr.actions & ::core::StationAction::CloseSale);
+                                         });
+            if (it != c.transitions.end()) {
+                c.transitions.erase(it);
+                ++c.dropped;
             }
         }
+        c.transitions.push_back(entry);
+    };
 
-        // 2) GunOff_PC (tabanca depoya geri girdi)
-        //    + 3) PumpOff_PC (varsa gerçek satış)
-       if (nozzle_edge_off) {
-            // Önce GunOff_PC logu
-            {
-                recum12::utils::LogManager::UsageEntry e{};
-                e.processId = 0;
-                e.rfid      = snapshot.last_card_uid;
-
-                if (auto urec = user_manager.findByRfid(snapshot.last_card_uid)) {
-                    e.firstName = urec->firstName;
-                    e.lastName  = urec->lastName;
-                    e.plate     = urec->plate;
-                    e.limit     = urec->limit;
-                }
-
-                e.fuel    = 0.0;
-                e.logCode = "GunOff_PC";
-                e.sendOk  = "NA";
+    // Akış anomalileri (store kilidi altında, core thread'inde). Kayıt
+    // disp_store ile GUI thread'inde status + infra log'a yazılır.
+    pump_store.onFlowAnomaly = [this](const ::core::FlowAnomaly& a) {
+        RECUM_LOG_WARN("Flow", "ANOMALY slot={} {} observed_l={} expected_l={} station={}",
+                       a.slot, ::core::FlowAnomalyDetector::name(a.kind), a.observed, a.expected,
+                       ::core::StationStateMachine::name(a.station));
+
+        std::lock_guard<std::mutex> lock(g_pump_store_gui_cache.mtx);
+        auto& c = g_pump_store_gui_cache;
+        if (c.anomaly_count < c.anomalies.size()) {
+            c.anomalies[c.anomaly_count++] = a;
+        }
+    };
 
-                const bool ok = log_manager.appendUsage(app_root, e);
-                if (!ok) {
-                    std::cerr << "[LogManager] WARNING: GunOff_PC usage log yazılamadı\n";
-                }
+    // Tabanca dışarıda akışsız bekleme kontrolü + boşta totalizer okuması
+    // (satış dışı totalizer ilerlemesi = kaçak / yetkisiz dolum).
+    // Workers henüz başlamadı; bundan sonra çark yalnızca core thread'inde.
+    {
+        using namespace std::chrono_literals;
+        flow_check_timer = timers.scheduleEvery(1s, [this]() {
+            pump_store.checkFlowAnomalies();
+        });
+        totals_poll_timer = timers.scheduleEvery(60s, [this]() {
+            if (!pump.isOpen()) {
+                return;
             }
+            const std::size_t n = pump_store.slotCount();
+            for (std::size_t i = 0; i < n; ++i) {
+                pump.queueTotalCounters(pump_store.slotRef(i));
+            }
+        });
+    }
 
-            // Ardından, gerçekten tamamlanmış bir satış varsa PumpOff_PC logu
-            // Not: Pompanın durumunu (FillingCompleted/MaxAmount) artık
-            // kontrol etmiyoruz; resmi litreyi core store'daki
-            // snapshot.last_fill_volume_l üzerinden alıyoruz.
-            if (snapshot.has_last_fill &&
-                snapshot.last_fill_volume_l > 0.0 &&
-                snapshot.last_card_auth_ok) {
-                const double sale_liters = snapshot.last_fill_volume_l; // ölçek bozulmadan
-
-                wait_recs  += 1;
-                vhec_count += 1;
-                repo_fill  += sale_liters;
-
-                recum12::utils::LogManager::UsageEntry e{};
-                e.processId = 0;
-                e.rfid      = snapshot.last_card_uid;
-
-                if (auto urec = user_manager.findByRfid(snapshot.last_card_uid)) {
-                    e.firstName = urec->firstName;
-                    e.lastName  = urec->lastName;
-                    e.plate     = urec->plate;
-                    e.limit     = urec->limit;
-                }
-
-                e.fuel    = sale_liters;
-                e.logCode = "PumpOff_PC";
-                e.sendOk  = "NA";
-
-                const bool ok = log_manager.appendUsage(app_root, e);
-                if (!ok) {
-                    std::cerr << "[LogManager] WARNING: PumpOff_PC usage log yazılamadı"
-                              << " (fuel_l=" << sale_liters << ")\n";
-                }
-
-                save_repo_log();
-                refresh_counters_on_ui();
+    disp_store.connect([this]() {
+        std::array<::core::PumpRuntimeState, ::core::PumpRuntimeStore::kMaxSlots> states{};
+        std::uint32_t state_mask = 0;
+        std::deque<StationLogEntry> pending;
+        std::uint64_t dropped       = 0;
+        std::uint64_t dropped_total = 0;
+        std::array<::core::FlowAnomaly, 8> anomalies{};
+        std::size_t anomaly_n = 0;
+        {
+            std::lock_guard<std::mutex> lock(g_pump_store_gui_cache.mtx);
+            auto& c = g_pump_store_gui_cache;
+            if (c.has_state_mask == 0) {
+                return;
+            }
+            states     = c.states;
+            state_mask = c.has_state_mask;
+            pending.swap(c.transitions);
+            dropped            = c.dropped - c.dropped_reported;
+            dropped_total      = c.dropped;
+            c.dropped_reported = c.dropped;
+
+            for (; anomaly_n < c.anomaly_count; ++anomaly_n) {
+                anomalies[anomaly_n] = c.anomalies[anomaly_n];
             }
+            c.anomaly_count = 0;
         }
 
-        // Bir sonraki frame için nozzle geçmişini güncelle
-        last_nozzle_out = snapshot.nozzle_out;
+        if (dropped > 0) {
+            RECUM_LOG_WARN("Station", "GUI geride kaldı: {} geçiş düşürüldü (toplam {})", dropped,
+                           dropped_total);
+        }
+        // Geçişlerin çıktıları sırayla (log sırası GunOn → GunOff → PumpOff korunur)
+        for (const auto& entry : pending) {
+            apply_station_actions(entry);
+        }
+
+        // Tek pompalı GUI: seçili slot'un görünümü
+        const std::size_t selected = pump_store.selectedSlot();
+        if (state_mask & (1u << selected)) {
+            rs485_adapter.apply(states[selected]);
+        }
 
-        rs485_adapter.apply(snapshot);
+        for (std::size_t i = 0; i < anomaly_n; ++i) {
+            report_flow_anomaly(anomalies[i]);
+        }
+        // Tüm slot'larda anomaliler kalktıysa System kanalındaki uyarıyı kaldır
+        std::uint32_t anomaly_flags = 0;
+        for (const auto& st : states) {
+            anomaly_flags |= st.anomaly_flags;
+        }
+        if (anomaly_msg_shown && anomaly_flags == 0) {
+            status_ctrl.clear_channel(StatusMessageController::Channel::System);
+            anomaly_msg_shown = false;
+        }
     });
 
     // RFID/Auth → GUI status label (lblmsg) köprüsü
@@ -500,25 +633,9 @@ AppRuntime::AppRuntime(MainWindow& ui_)
         }
 
         if (msg == "Yetkisiz Kullanıcı") {
+            // 3 sn'lik uyarı süresi ve IDLE'a dönüş istasyon durum
+            // makinesinde (StartUnauthTimer / UnauthTimeout).
             status_ctrl.set_message(StatusMessageController::Channel::Auth, msg);
-
-            // 3 sn boyunca "Yetkisiz Kullanıcı" göster, sonra tam IDLE'a dön.
-            if (unauth_timeout_conn.connected()) {
-                unauth_timeout_conn.disconnect();
-            }
-
-            unauth_timeout_conn =
-                Glib::signal_timeout().connect_seconds(
-                    [this]() {
-                        status_ctrl.clear_all();
-                        status_ctrl.set_message(
-                            StatusMessageController::Channel::Pump,
-                            "İşlem Yapılabilir");
-                        ui.apply_idle_view(false);
-                        ui.set_user_id("-------");
-                        return false; // one-shot
-                    },
-                    3);
         } else if (msg == "RFID hatası") {
             status_ctrl.set_message(StatusMessageController::Channel::System, msg);
         } else if (msg == "Yetkili Kullanıcı") {
@@ -529,70 +646,97 @@ AppRuntime::AppRuntime(MainWindow& ui_)
         }
     });
 
-    // RFID / AUTH bileşenlerinin bağlanması
-    rfid_reader.open("");
-    rfid_auth.setReader(&rfid_reader);
+    // RFID / AUTH bileşenlerinin bağlanması: her okuyucu kendi pompa/
+    // tabancasına (addr 0 → genel okuyucu) bağlanır, hepsi tek havuzda.
+    for (const auto& rc : settings.rfid()) {
+        auto reader = std::make_unique<recum12::rfid::Pn532Reader>();
+        auto& rfid_reader = *reader;
+
+        recum12::rfid::Pn532Config pc;
+        pc.mode           = rc.hardware_poll ? recum12::rfid::Pn532PollMode::HardwarePoll
+                                             : recum12::rfid::Pn532PollMode::SelectLoop;
+        pc.poll_period_ms = rc.poll_period_ms;
+        pc.poll_count     = rc.poll_count;
+        rfid_reader.setConfig(pc);
+
+        // "backend": "mock" → senaryo oynatan okuyucu (donanımsız test)
+        if (rc.backend != "libnfc") {
+            auto backend = recum12::rfid::makeReaderBackend(rc.backend);
+            if (auto* mock = dynamic_cast<recum12::rfid::MockReaderBackend*>(backend.get())) {
+                if (!rc.script.empty()) {
+                    const fs::path sp(rc.script);
+                    mock->loadScript(sp.is_absolute() ? sp.string()
+                                                      : (fs::path(app_root) / sp).string());
+                }
+            }
+            if (backend) {
+                rfid_reader.setBackend(std::move(backend));
+            } else {
+                RECUM_LOG_ERROR("RFID", "bilinmeyen backend: {}", rc.backend);
+            }
+        }
+        rfid_reader.open(rc.device);
+
+        if (rc.addr == 0) {
+            rfid_auth.setReader(&rfid_reader);
+        } else {
+            rfid_auth.addReader(&rfid_reader, recum12::hw::PumpSlotRef{rc.addr, rc.nozzle});
+        }
+        if (rc.addr == 0) {
+            RECUM_LOG_INFO("RFID", "reader device='{}' → tüm pompalar", rc.device);
+        } else {
+            RECUM_LOG_INFO("RFID", "reader device='{}' → pompa 0x{}/{}", rc.device,
+                           recum12::utils::InfraHex{rc.addr}, rc.nozzle);
+        }
+        rfid_pool.add(&rfid_reader);
+        rfid_readers.push_back(std::move(reader));
+    }
     rfid_auth.setUserManager(&user_manager);
+    rfid_auth.setQuotaEngine(&quota_engine);
 
     rfid_auth.onAuthResult = [this](const recum12::core::AuthContext& a) {
         ::core::AuthContext ctx{};
-        ctx.uid_hex      = a.uid_hex;
+        ctx.slot         = a.slot;
+        ctx.uid          = a.uid;
         ctx.authorized   = a.authorized;
         ctx.user_id      = a.user_id;
         ctx.plate        = a.plate;
         // RFID tarafındaki limit bilgisini core store'a taşı
-        ctx.limit_liters = a.limit_liters;
+        ctx.limit_volume = a.limit_volume;
         pump_store.updateFromRfidAuth(ctx);
 
-        // AUTH cache'i güncelle (sadece başarılı AUTH için user bilgisi tut)
-        last_auth_ok    = false;
-        last_auth_uid.clear();
-        last_auth_first.clear();
-        last_auth_last.clear();
-        last_auth_plate.clear();
-        last_auth_limit = 0;
-
         // PC tarafı usage log: AUTH sonucu (AuthOK_PC / NoAuth_PC)
         recum12::utils::LogManager::UsageEntry e{};
 
-        // Şimdilik transaction id bilgisi çekmiyoruz → 0 sabit
+        // processId: LogManager kalıcı sayaçtan tekil id atar
         e.processId = 0;
 
-        // Kart UID (hex)
-        e.rfid = a.uid_hex;
+        // Kart UID (CSV'ye hex yazılır)
+        e.rfid = a.uid;
 
         // users.csv ile eşleşen kayıt varsa isim/plaka/limit'i doldur
-        if (auto urec = user_manager.findByRfid(a.uid_hex)) {
+        if (auto urec = user_manager.findByRfid(a.uid)) {
             e.firstName = urec->firstName;
             e.lastName  = urec->lastName;
             e.plate     = urec->plate;
             e.limit     = urec->limit; // litre cinsinden int limit (users.csv ile uyumlu)
-
-            if (a.authorized) {
-                last_auth_ok    = true;
-                last_auth_uid   = a.uid_hex;
-                last_auth_first = urec->firstName;
-                last_auth_last  = urec->lastName;
-                last_auth_plate = urec->plate;
-                last_auth_limit = urec->limit;
-            }
         }
 
-        e.fuel    = 0.0; // AUTH anında henüz dolum yok
-        e.logCode = a.authorized ? "AuthOK_PC" : "NoAuth_PC";
+        e.fuel    = recum12::utils::Volume{}; // AUTH anında henüz dolum yok
+        e.logCode = a.authorized     ? "AuthOK_PC"
+                  : a.quota_exceeded ? "NoQuota_PC"
+                                     : "NoAuth_PC";
         // timeStamp boş bırakılırsa appendUsage() içinde ISO-8601 UTC set edilir.
         e.sendOk  = "NA";
 
         const bool ok = log_manager.appendUsage(app_root, e);
         if (!ok) {
-            std::cerr << "[LogManager] WARNING: AUTH usage log yazılamadı ("
-                      << (a.authorized ? "AuthOK_PC" : "NoAuth_PC")
-                      << ", uid=" << a.uid_hex << ")\n";
+            RECUM_LOG_WARN("LogManager", "AUTH usage log yazılamadı ({}, uid={})", e.logCode, a.uid);
         }
     };
 
     rfid_auth.onAuthMessage = [this](const std::string& msg) {
-        std::cout << "[RFID/AuthMsg] " << msg << std::endl;
+        RECUM_LOG_INFO("RFID/AuthMsg", "{}", msg);
 
         {
             std::lock_guard<std::mutex> lock(g_auth_gui_cache.mtx);
@@ -602,8 +746,15 @@ AppRuntime::AppRuntime(MainWindow& ui_)
         disp_auth.emit();
     };
 
+    rfid_auth.onAuthLatency = [this](std::chrono::microseconds us) {
+        const auto st = rfid_auth.latencyStats();
+        RECUM_LOG_INFO("RFID/Auth", "card→AUTHORIZE latency_ms={} (avg={} max={} n={})",
+                       static_cast<double>(us.count()) / 1000.0, st.avg_us / 1000.0,
+                       static_cast<double>(st.max_us) / 1000.0, st.count);
+    };
+
     rfid_auth.onError = [this](const std::string& msg) {
-        std::cerr << "[RFID] " << msg << std::endl;
+        RECUM_LOG_ERROR("RFID", "{}", msg);
 
         {
             std::lock_guard<std::mutex> lock(g_auth_gui_cache.mtx);
@@ -623,22 +774,42 @@ AppRuntime::AppRuntime(MainWindow& ui_)
     for (const auto& cfg : rs485_list) {
         if (cfg.name == "pump" && !cfg.port.empty()) {
             rs485_port = cfg.port;
+
+            // Hattaki pompa/tabancaları store'a slot olarak kaydet; heart-beat
+            // her farklı adrese gider. Listede olmayan çiftler ilk olaylarında
+            // (kapasite elverirse) otomatik eklenir.
+            for (const auto& sc : cfg.slots) {
+                recum12::hw::PumpSlotRef ref{};
+                ref.addr   = sc.addr;
+                ref.nozzle = sc.nozzle;
+                if (pump_store.addSlot(ref) == ::core::PumpRuntimeStore::kNoSlot) {
+                    RECUM_LOG_WARN("RS485", "slot kapasitesi dolu, atlandı (addr=0x{} nozzle={})",
+                                   recum12::utils::InfraHex{sc.addr}, sc.nozzle);
+                }
+                if (std::find(workers.poll_addrs.begin(), workers.poll_addrs.end(), sc.addr) ==
+                    workers.poll_addrs.end()) {
+                    workers.poll_addrs.push_back(sc.addr);
+                }
+            }
             break;
         }
     }
 
+    // Totalizer mutabakatı (slot başına): kayıtlı slot'lar şimdi, hattan
+    // sonradan eklenenler ilk totalizer okumasında açılır.
+    for (std::size_t i = 0; i < pump_store.slotCount(); ++i) {
+        open_recon(i);
+    }
+
     pump.setDevice(rs485_port);
 
     if (!pump.open()) {
-        std::cerr << "Uyarı: RS485 portu açılamadı ("
-                  << pump.device() << ")." << std::endl;
+        RECUM_LOG_ERROR("RS485", "Uyarı: RS485 portu açılamadı ({}).", pump.device());
         ui.apply_error_view("RS485 portu açılamadı, pompa bağlantısı yok.");
         status_ctrl.set_message(StatusMessageController::Channel::System,
                                 "RS485 portu açılamadı, pompa yok.");
     } else {
-        std::cout << "[RS485] port opened: "
-                  << pump.device()
-                  << std::endl;
+        RECUM_LOG_INFO("RS485", "port opened: {}", pump.device());
     }
     // Başlangıç network + RS485 durumunu GUI'deki ikonlara ve IP label'larına yansıt
     const bool rs485_ok =
@@ -662,45 +833,52 @@ AppRuntime::AppRuntime(MainWindow& ui_)
     rfid_auth.setPumpInterface(&pump);
     rfid_auth.attach();
 
-    pump.onStatus = [this](recum12::hw::PumpState st) {
-        pump_store.updateFromPumpStatus(st);
+    pump.onStatus = [this](const recum12::hw::PumpStatusEvent& ev) {
+        pump_store.updateFromPumpStatus(ev);
     };
 
     pump.onFill = [this](const recum12::hw::FillInfo& fi) {
         pump_store.updateFromFill(fi);
-        std::cout << "[PUMP] fill volume_l=" << fi.volume_l
-                  << " amount=" << fi.amount
-                  << std::endl;
+        // Dolum boyunca sık gelir (hot path): DEBUG
+        RECUM_LOG_DEBUG("PUMP", "fill addr=0x{} nozzle={} volume_l={} amount={}",
+                        recum12::utils::InfraHex{fi.slot.addr}, fi.slot.nozzle, fi.volume,
+                        fi.amount);
         // Sayaçlar artık dolum BİTİŞİNDE (nozzle_out 1→0) güncelleniyor.
     };
 
     pump.onTotals = [this](const recum12::hw::TotalCounters& tc) {
         pump_store.updateFromTotals(tc);
-        std::cout << "[PUMP] totals volume_l=" << tc.total_volume_l
-                  << " amount=" << tc.total_amount
-                  << std::endl;
+        RECUM_LOG_INFO("PUMP", "totals addr=0x{} nozzle={} volume_l={} amount={}",
+                       recum12::utils::InfraHex{tc.slot.addr}, tc.slot.nozzle, tc.total_volume,
+                       tc.total_amount);
+
+        // Her tabancanın kendi totalizer'ı ve defteri vardır
+        const std::size_t slot = pump_store.findSlot(tc.slot);
+        if (!open_recon(slot)) {
+            return;
+        }
+        recum12::core::ReconcileEntry e{};
+        if (totalizer_recon[slot].onTotals(tc.total_volume, pump_store.state(slot).sale_active, &e)) {
+            RECUM_LOG_INFO("Recon", "slot={} satış={} beklenen_l={} totalizer_l={} fark_l={}", slot,
+                           e.sales, e.expected, e.reported, e.drift());
+        }
     };
 
     pump.onNozzle = [this](const recum12::hw::NozzleEvent& ev) {
         // Nozzle OUT/IN olayını sadece core store'a yansıt;
-        // GunOn/GunOff logları artık PumpRuntimeState snapshot'ı üzerinden
-        // disp_store handler'ında üretiliyor.
+        // GunOn/GunOff logları ve kart okuma isteği/iptali istasyon durum
+        // makinesinin çıktısıdır (onStationTransition / disp_store).
         pump_store.updateFromNozzle(ev);
-
-        if (ev.nozzle_out) {
-            rfid_auth.handleNozzleOut();
-        } else {
-            rfid_auth.handleNozzleInOrSaleFinished();
-        }
     };
 
     // AUTH butonu handler'ı
     ui.set_auth_handler([this]() {
-        std::cout << "[APP] AUTH handler: AUTHORIZE (DCC=0x06) gönderiliyor" << std::endl;
-        pump.sendStatusPoll(0x06);
+        RECUM_LOG_INFO("APP", "AUTH handler: AUTHORIZE (DCC=0x06) kuyruğa alınıyor");
+        pump.queueStatusPoll(pump_store.slotRef(pump_store.selectedSlot()), 0x06);
     });
 
     // Worker thread'lerini başlat
+    workers.after_store = [this]() { book_closed_sales(); };
     workers.start();
 }
 
@@ -711,9 +889,37 @@ AppRuntime::~AppRuntime()
         net_poll_conn.disconnect();
     }
 
+    // users.csv watcher thread'ini durdur
+    user_manager.stopWatching();
+
     // Worker thread'lerini kapat ve RFID reader'ı kapat
     workers.stop();
-    rfid_reader.close();
+    for (auto& r : rfid_readers) {
+        r->close();
+    }
+
+    // Bekleyen usage satırlarını diske yaz (fdatasync) ve yazıcıyı kapat
+    const auto ws = log_manager.usageWriterStats();
+    if (ws.enqueued > 0) {
+        RECUM_LOG_INFO("LogManager", "usage writer: lines={} batches={} max_batch={} full_waits={} syncs={}",
+                       ws.written, ws.batches, ws.max_batch, ws.full_waits, ws.syncs);
+        RECUM_LOG_INFO("LogManager", "usage writer: enqueue_us(avg/max)={}/{} fsync_us(avg/max)={}/{}",
+                       ws.enqueue_avg_us, ws.enqueue_max_us, ws.sync_avg_us, ws.sync_max_us);
+    }
+    const auto cs = log_manager.usageCacheStats();
+    RECUM_LOG_INFO("LogManager", "usage cache: rows={} bytes={} older_rows={} older_sales={} older_fuel_l={}",
+                   cs.rows, cs.bytes, cs.older.rows, cs.older.sales, cs.older.fuel);
+    log_manager.stopUsageMaintenance();
+    log_manager.closeUsageWriter();
+    // logs.csv her kapanışta yeniden üretilmez; servis isteğe bağlı olarak
+    // "recum12_usage_export" ile alır.
+
+    // Son olarak infra log: bekleyen kayıtlar yazılır, sink durur. Özet
+    // satırı artık yalnızca konsola gider.
+    log_manager.stopInfraLog();
+    const auto is = log_manager.infraLogStats();
+    RECUM_LOG_INFO("LogManager", "infra log: written={} dropped={} rotations={}", is.written,
+                   is.dropped, is.rotations);
 }
 
 void AppRuntime::init_clock()
@@ -726,15 +932,24 @@ void AppRuntime::init_clock()
             tm = *p;
         }
 
-        char date_buf[16] {};
+        const std::string date_buf = local_date(now);
         char time_buf[16] {};
 
-        std::strftime(date_buf, sizeof(date_buf), "%d.%m.%Y", &tm);
         std::strftime(time_buf, sizeof(time_buf), "%H:%M", &tm);
 
         ui.set_date_text(date_buf);
         ui.set_time_text(time_buf);
 
+        // Gün dönümü: açık tüm mutabakat vardiyalarını kapat
+        if (!clock_last_date.empty() && clock_last_date != date_buf) {
+            for (std::size_t i = 0; i < recon_open.size(); ++i) {
+                if (recon_open[i].load(std::memory_order_acquire)) {
+                    close_recon_shift(i);
+                }
+            }
+        }
+        clock_last_date = date_buf;
+
         return true; // timer devam etsin
     };
 
@@ -797,11 +1012,231 @@ void AppRuntime::init_network_poll()
         2);
 }
 
+void AppRuntime::apply_station_actions(const StationLogEntry& entry)
+{
+    namespace A = ::core::StationAction;
+    const ::core::StationTransition& tr = entry.tr;
+
+    // Durum satırı seçili slot'un görünümüdür; loglar her slot için yazılır
+    if ((tr.actions & A::ClearStatus) && tr.slot == pump_store.selectedSlot()) {
+        status_ctrl.clear_all();
+    }
+
+    // ---- Usage log: GunOn_PC → GunOff_PC → PumpOff_PC
+    if (tr.actions & A::LogGunOn) {
+        append_station_usage("GunOn_PC", entry.card_uid, recum12::utils::Volume{});
+    }
+    if (tr.actions & A::LogGunOff) {
+        append_station_usage("GunOff_PC", entry.card_uid, recum12::utils::Volume{});
+    }
+
+    // Satışın akış profili (store'daki kayıt bir kez devralınır)
+    ::core::FlowProfile flow{};
+    const bool has_flow = (tr.actions & A::CloseSale) &&
+                          pump_store.takeFlowProfile(tr.slot, tr.seq, flow);
+
+    // Satış kapandı: resmi litre core store'daki last_fill_volume
+    if ((tr.actions & A::CloseSale) &&
+        entry.has_sale &&
+        entry.sale_volume.isPositive() &&
+        entry.card_auth_ok) {
+        const auto sale_volume = entry.sale_volume; // BCD x100, ölçek bozulmadan
+
+        wait_recs  += 1;
+        vhec_count += 1;
+        repo_fill  += sale_volume;
+
+        // PumpOff_PC satırı ile akış profili aynı processId (+rfid) ile
+        // bağlanır; sayaç açılamazsa eskisi gibi timeStamp ile.
+        const std::string   ts       = recum12::utils::LogManager::nowTimeStamp();
+        const std::uint64_t usage_id = log_manager.allocateUsageId(app_root);
+        append_station_usage("PumpOff_PC", entry.card_uid, sale_volume, ts, usage_id);
+
+        if (has_flow) {
+            flow.sale_ref = usage_id ? std::to_string(usage_id) : ts;
+            flow.rfid     = entry.card_uid;
+            const std::string flow_path = app_root + "/logs/flow/flow_profiles.bin";
+            if (!::core::PumpSaleTracker::append(flow_path, flow)) {
+                RECUM_LOG_WARN("Flow", "akış profili yazılamadı: {}", flow_path);
+            }
+        }
+
+        save_repo_log();
+        refresh_counters_on_ui();
+    }
+
+    // Satış kapandı: loglama bittikten sonra totalizer'ı oku; mutabakat ve
+    // anomali dedektörü satış hacmini bu okumayla karşılaştırır.
+    if ((tr.actions & A::CloseSale) && pump.isOpen()) {
+        pump.queueTotalCounters(entry.slot);
+    }
+}
+
+void AppRuntime::append_station_usage(const char* log_code,
+                                      const recum12::utils::CardUid& card_uid,
+                                      recum12::utils::Volume fuel,
+                                      const std::string& time_stamp,
+                                      std::uint64_t process_id)
+{
+    recum12::utils::LogManager::UsageEntry e{};
+    e.processId = process_id; // 0 → LogManager atar
+    e.timeStamp = time_stamp; // boşsa LogManager doldurur
+
+    // Kart bilgisi varsa geçiş anındaki karttan doldur
+    e.rfid = card_uid;
+    if (auto urec = user_manager.findByRfid(card_uid)) {
+        e.firstName = urec->firstName;
+        e.lastName  = urec->lastName;
+        e.plate     = urec->plate;
+        e.limit     = urec->limit;
+    }
+
+    e.fuel    = fuel;
+    e.logCode = log_code;
+    e.sendOk  = "NA";
+
+    // Satış kapanışı: sale_end modunda bu satırla birlikte sync edilir
+    const bool sale_end = (std::strcmp(log_code, "PumpOff_PC") == 0);
+    if (!log_manager.appendUsage(app_root, e, sale_end)) {
+        RECUM_LOG_WARN("LogManager", "{} usage log yazılamadı (fuel_l={})", log_code, fuel);
+    }
+}
+
+void AppRuntime::report_flow_anomaly(const ::core::FlowAnomaly& a)
+{
+    using recum12::gui::StatusMessageController;
+    using ::core::FlowAnomalyKind;
+
+    const char* text = "Akış anomalisi";
+    switch (a.kind) {
+    case FlowAnomalyKind::UnauthorizedDispense: text = "Yetkisiz dolum algılandı"; break;
+    case FlowAnomalyKind::TotalizerJump:        text = "Satış dışı sayaç artışı";  break;
+    case FlowAnomalyKind::SaleMismatch:         text = "Satış / sayaç uyuşmazlığı"; break;
+    case FlowAnomalyKind::StalledNozzle:        text = "Tabanca açıkta, akış yok"; break;
+    default: break;
+    }
+
+    status_ctrl.set_message(StatusMessageController::Channel::System, text);
+    anomaly_msg_shown = true;
+
+    std::ostringstream details;
+    const auto ref = pump_store.slotRef(a.slot);
+    details << "addr=0x" << std::hex << static_cast<unsigned>(ref.addr) << std::dec
+            << ";nozzle=" << static_cast<unsigned>(ref.nozzle)
+            << ";observed_l=" << a.observed
+            << ";expected_l=" << a.expected
+            << ";station=" << ::core::StationStateMachine::name(a.station);
+
+    if (!log_manager.appendInfra(app_root, "WARN",
+                                 ::core::FlowAnomalyDetector::name(a.kind),
+                                 text, details.str())) {
+        RECUM_LOG_WARN("LogManager", "infra log yazılamadı ({})",
+                       ::core::FlowAnomalyDetector::name(a.kind));
+    }
+}
+
+void AppRuntime::book_closed_sales()
+{
+    if (closed_sales.empty()) {
+        return;
+    }
+    for (const auto& s : closed_sales) {
+        // Mutabakat checkpoint'i (fdatasync) store kilidi dışında; aynı
+        // döngü turunda, sonraki totalizer okumasından önce
+        if (s.slot < recon_open.size() && recon_open[s.slot].load(std::memory_order_acquire) &&
+            !totalizer_recon[s.slot].persistPending()) {
+            RECUM_LOG_WARN("Recon", "slot={} checkpoint yazılamadı", s.slot);
+        }
+        // Kota toplamlarına ekle (bir sonraki AUTH'ta kalan limit buna göre)
+        if (auto urec = user_manager.findByRfid(s.card_uid)) {
+            quota_engine.recordSale(urec->userId, urec->plate, s.volume);
+        }
+    }
+    closed_sales.clear();
+}
+
+bool AppRuntime::open_recon(std::size_t slot)
+{
+    // Başlangıçta ya da core thread'inde (onTotals); GUI yalnızca bayrağı okur
+    if (slot >= recon_open.size()) {
+        return false;
+    }
+    if (recon_open[slot].load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    // Checkpoint tabanca kimliğiyle adlanır: otomatik eklenen slot'ların
+    // indeksi çalışmadan çalışmaya değişebilir
+    const auto ref = pump_store.slotRef(slot);
+    char name[64] {};
+    std::snprintf(name, sizeof(name), "/configs/totalizer_%02X_%u.dat",
+                  static_cast<unsigned>(ref.addr), static_cast<unsigned>(ref.nozzle));
+    const std::string recon_path = app_root + name;
+
+    // Tek sayaçlı eski defter ana slot'a devredilir
+    const std::string legacy_path = app_root + "/configs/totalizer.dat";
+    if (slot == 0 && ::access(recon_path.c_str(), F_OK) != 0 &&
+        ::access(legacy_path.c_str(), F_OK) == 0 &&
+        std::rename(legacy_path.c_str(), recon_path.c_str()) != 0) {
+        RECUM_LOG_WARN("Recon", "{} → {} taşınamadı", legacy_path, recon_path);
+    }
+
+    auto& recon = totalizer_recon[slot];
+    if (!recon.open(recon_path)) {
+        RECUM_LOG_WARN("Recon", "{} açılamadı; mutabakat kalıcı olmayacak.", recon_path);
+    }
+
+    // Core thread'inde (onTotals) kenar tetiklemeli çağrılır
+    recon.onDrift = [this, slot, ref](const recum12::core::ReconcileReport& rep) {
+        std::ostringstream details;
+        details << "addr=0x" << std::hex << static_cast<unsigned>(ref.addr) << std::dec
+                << ";nozzle=" << static_cast<unsigned>(ref.nozzle)
+                << ";expected_l=" << rep.expected << ";reported_l=" << rep.reported
+                << ";drift_l=" << rep.drift() << ";drift_pct=" << rep.driftPercent()
+                << ";recent_drift_l=" << totalizer_recon[slot].recentDrift();
+        // appendInfra sink açıkken konsola da yansıtılır
+        log_manager.appendInfra(app_root, "WARN", "MeterDrift",
+                                "Sayaç kayması (totalizer vs. satış)", details.str());
+    };
+    recon_open[slot].store(true, std::memory_order_release);
+
+    // Uygulama kapalıyken gün döndüyse açık vardiya önceki güne aittir;
+    // saat tick'i yalnızca çalışırken görülen gün dönümünü yakalar.
+    if (local_date(static_cast<std::time_t>(recon.shiftReport().from_unix)) !=
+        local_date(std::time(nullptr))) {
+        close_recon_shift(slot);
+    }
+
+    const auto r = recon.shiftReport();
+    RECUM_LOG_INFO("Recon", "slot={} açık vardiya: satış={} beklenen_l={} totalizer_l={} fark_l={}",
+                   slot, r.sales, r.expected, r.reported, r.drift());
+    return true;
+}
+
+void AppRuntime::close_recon_shift(std::size_t slot)
+{
+    const auto r   = totalizer_recon[slot].closeShift();
+    const auto ref = pump_store.slotRef(slot);
+
+    std::ostringstream details;
+    details << "addr=0x" << std::hex << static_cast<unsigned>(ref.addr) << std::dec
+            << ";nozzle=" << static_cast<unsigned>(ref.nozzle)
+            << ";from=" << r.from_unix << ";to=" << r.to_unix
+            << ";sales=" << r.sales
+            << ";expected_l=" << r.expected << ";reported_l=" << r.reported
+            << ";drift_l=" << r.drift()
+            << ";totalizer_open=" << r.totalizer_open
+            << ";totalizer_close=" << r.totalizer_close;
+
+    log_manager.appendInfra(app_root, "INFO", "ShiftRecon",
+                            "Vardiya sonu totalizer mutabakatı", details.str());
+}
+
 void AppRuntime::refresh_counters_on_ui()
 {
     ui.set_wait_recs(wait_recs);
     ui.set_vehicle_count(vhec_count);
-    ui.set_repo_counter(repo_fill);
+    ui.set_repo_counter(repo_fill.toDouble());
 }
 
 void AppRuntime::load_repo_log()
@@ -823,11 +1258,11 @@ void AppRuntime::load_repo_log()
         oss << in.rdbuf();
         const std::string content = oss.str();
 
-        auto parse_number = [&content](const std::string& key, double def_val) -> double {
+        auto number_text = [&content](const std::string& key) -> std::string {
             auto pos = content.find(key);
-            if (pos == std::string::npos) return def_val;
+            if (pos == std::string::npos) return {};
             pos = content.find(':', pos);
-            if (pos == std::string::npos) return def_val;
+            if (pos == std::string::npos) return {};
             ++pos;
             while (pos < content.size() &&
                    (content[pos] == ' ' || content[pos] == '\t')) {
@@ -839,18 +1274,28 @@ void AppRuntime::load_repo_log()
                     content[end] == '.')) {
                 ++end;
             }
-            if (end <= pos) return def_val;
-            return std::stod(content.substr(pos, end - pos));
+            return content.substr(pos, end - pos);
+        };
+
+        auto parse_number = [&number_text](const std::string& key, double def_val) -> double {
+            const std::string txt = number_text(key);
+            return txt.empty() ? def_val : std::stod(txt);
         };
 
         try {
             double wait_d = parse_number("wait_recs", 0.0);
             double vhec_d = parse_number("vhec_count", 0.0);
-            double repo_d = parse_number("repo_fill", 0.0);
+
+            // repo_fill double'a uğramadan x100 sabit noktaya çözülür
+            recum12::utils::Volume repo_v{};
+            const std::string repo_txt = number_text("repo_fill");
+            if (!repo_txt.empty() && !recum12::utils::Volume::parse(repo_txt, repo_v)) {
+                throw std::invalid_argument("repo_fill");
+            }
 
             wait_recs  = static_cast<std::uint64_t>(wait_d);
             vhec_count = static_cast<std::uint64_t>(vhec_d);
-            repo_fill  = repo_d;
+            repo_fill  = repo_v;
 
             repo_log_path = path;
             loaded = true;
@@ -864,7 +1309,7 @@ void AppRuntime::load_repo_log()
         // Varsayılanlar ve yeni dosya oluşturma
         wait_recs  = 0;
         vhec_count = 0;
-        repo_fill  = 0.0;
+        repo_fill  = recum12::utils::Volume{};
         repo_log_path = candidate_paths[0];
         save_repo_log();
     }
@@ -881,8 +1326,7 @@ void AppRuntime::save_repo_log()
 
     std::ofstream out(repo_log_path, std::ios::trunc);
     if (!out) {
-        std::cerr << "[AppRuntime] WARNING: repo_log.json yazılamadı: "
-                  << repo_log_path << std::endl;
+        RECUM_LOG_WARN("AppRuntime", "repo_log.json yazılamadı: {}", repo_log_path);
         return;
     }
 
@@ -899,7 +1343,7 @@ void AppRuntime::save_repo_log()
     out << "  \"date\": \"" << date_buf << "\",\n";
     out << "  \"wait_recs\": " << wait_recs << ",\n";
     out << "  \"vhec_count\": " << vhec_count << ",\n";
-    out << "  \"repo_fill\": " << std::fixed << std::setprecision(1) << repo_fill << "\n";
+    out << "  \"repo_fill\": " << repo_fill.toString() << "\n";
     out << "}\n";
 }
 } // namespace recum12::gui
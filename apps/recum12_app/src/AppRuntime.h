@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <functional>
+#include <memory>
 #include <thread>
+#include <vector>
 #include <sigc++/connection.h>
 
 #include <glibmm/dispatcher.h>
@@ -14,32 +18,61 @@
 #include "gui/StatusMessageController.h"
 #include "gui/rs485_gui_adapter.h"
 #include "core/PumpRuntimeState.h"
+#include "core/QuotaEngine.h"
 #include "core/RfidAuthController.h"
+#include "core/TimerWheel.h"
+#include "core/TotalizerReconciler.h"
 #include "core/UserManager.h"
 #include "hw/PumpInterfaceLvl3.h"
 #include "rfid/Pn532Reader.h"
+#include "rfid/ReaderPool.h"
 #include "utils/LogManager.h"
 
 namespace recum12::gui {
 
-// RS485 + RFID worker thread'lerinin yaşam döngüsünü yöneten küçük yardımcı yapı.
-//  - running: her iki worker için ortak "çalışıyor mu" bayrağı
-//  - start(): pump açıksa RS485 worker'ı, her durumda RFID worker'ı başlatır
-//  - stop(): bayrağı kapatır ve join() çağırarak thread'leri toplar
+// RS485/core worker thread'i + RFID okuyucu havuzunun yaşam döngüsünü yöneten
+// küçük yardımcı yapı.
+//  - running: core worker'ın "çalışıyor mu" bayrağı
+//  - start(): core (RS485) worker'ı ve RFID havuzunu başlatır
+//  - stop(): bayrağı kapatır, havuzu durdurur ve thread'leri toplar
+//
+// Core (RS485) thread'i aynı zamanda auth stage'i çalıştırır: RFID thread'inin
+// kuyruğa bıraktığı kart olaylarını işler ve pompa TX kuyruğunu boşaltır.
+// Runtime zamanlayıcı çarkı (heart-beat, istasyon timeout'ları) da bu
+// thread'de ilerletilir.
 struct RuntimeWorkers {
-    recum12::hw::PumpInterfaceLvl3& pump;
-    recum12::rfid::Pn532Reader&     rfid_reader;
-    std::atomic<bool>               running{false};
-    std::thread                     rs485_thread;
-    std::thread                     rfid_thread;
-
-    RuntimeWorkers(recum12::hw::PumpInterfaceLvl3& p,
-                   recum12::rfid::Pn532Reader&     r);
+    recum12::hw::PumpInterfaceLvl3&    pump;
+    recum12::rfid::ReaderPool&         rfid_pool;
+    recum12::core::RfidAuthController& rfid_auth;
+    recum12::core::TimerWheel&         timers;
+    std::vector<std::uint8_t>          poll_addrs;   // heart-beat adresleri (boşsa 0x50); start() öncesi
+    // Store kilidi altında biriken disk işleri; core thread'inde kilit
+    // dışında, RX ve zamanlayıcılardan sonra, kart olaylarından önce çağrılır.
+    std::function<void()>              after_store;  // start() öncesi
+    std::atomic<bool>                  running{false};
+    std::thread                        rs485_thread;
+
+    RuntimeWorkers(recum12::hw::PumpInterfaceLvl3&    p,
+                   recum12::rfid::ReaderPool&         r,
+                   recum12::core::RfidAuthController& a,
+                   recum12::core::TimerWheel&         t);
 
     void start();
     void stop();
 };
 
+// GUI thread'inde gecikmeli uygulanan istasyon geçişi. Log/kota aksiyonları
+// geçiş anındaki kart ve satışla yazılır: GUI geride kalırsa slot'un son
+// state'i artık sonraki karta ait olabilir.
+struct StationLogEntry {
+    ::core::StationTransition tr{};
+    recum12::hw::PumpSlotRef  slot{};
+    recum12::utils::CardUid   card_uid{};
+    bool                      card_auth_ok{false};
+    recum12::utils::Volume    sale_volume{};   // son dolum (has_sale ise)
+    bool                      has_sale{false};
+};
+
 // Uygulama runtime'ını temsil eden basit iskelet.
 //  - PumpRuntimeStore, RS485 pump, RFID, UserManager, GUI adapter ve
 //    dispatcher wiring'i burada toplanır.
@@ -51,25 +84,23 @@ struct AppRuntime {
 
     ::core::PumpRuntimeStore  pump_store;
 
-    // LogManager entegrasyonu (logs/log_user/logs.csv için)
+    // LogManager entegrasyonu (logs/log_user/usage/ için)
     recum12::utils::LogManager log_manager;
     std::string                app_root;
 
-
-    // Son başarılı AUTH için basit cache (usage log enrich)
-    bool                       last_auth_ok{false};
-    std::string                last_auth_uid;
-    std::string                last_auth_first;
-    std::string                last_auth_last;
-    std::string                last_auth_plate;
-    int                        last_auth_limit{0};
-
     recum12::comm::NetworkManager    net_manager;
     
     recum12::utils::Settings  settings;
     
     recum12::core::UserManager        user_manager;
-    recum12::rfid::Pn532Reader        rfid_reader;
+    recum12::core::QuotaEngine        quota_engine;   // configs/quota.dat
+    // Totalizer mutabakatı slot (tabanca) başına: configs/totalizer_<AA>_<N>.dat
+    std::array<recum12::core::TotalizerReconciler, ::core::PumpRuntimeStore::kMaxSlots> totalizer_recon;
+    std::array<std::atomic<bool>, ::core::PumpRuntimeStore::kMaxSlots>                  recon_open{};
+    // Okuyucular settings "rfid" listesinden; hepsi tek havuzda servis edilir
+    // (thread sayısı okuyuculardan: HardwarePoll okuyucusu başına bir thread).
+    std::vector<std::unique_ptr<recum12::rfid::Pn532Reader>> rfid_readers;
+    recum12::rfid::ReaderPool         rfid_pool;
     recum12::core::RfidAuthController rfid_auth;
 
     recum12::hw::PumpInterfaceLvl3    pump;
@@ -77,27 +108,43 @@ struct AppRuntime {
     Glib::Dispatcher          disp_store;
     Glib::Dispatcher          disp_auth;
 
+    // Runtime zamanlayıcıları (core thread'inde ilerler). Test/simülasyon
+    // için SteadyClock yerine VirtualClock verilebilir.
+    recum12::core::SteadyClock        runtime_clock;
+    recum12::core::TimerWheel         timers{runtime_clock};
+
     RuntimeWorkers            workers;
 
-    // AUTH OK (Authorized + nozzle_out) sonrası 10 sn level bekleme durumu
-    bool                      auth_waiting_for_fill{false};
-    sigc::connection          auth_timeout_conn;
-    sigc::connection          unauth_timeout_conn; // "Yetkisiz Kullanıcı" 3 sn timeout
+    // İstasyon durum makinesi zamanlayıcıları (StartFillWait / StartUnauthTimer),
+    // slot başına. Yalnızca core thread'inden (onStationTransition) kurulur/iptal edilir.
+    using SlotTimers = std::array<recum12::core::TimerWheel::TimerId,
+                                  ::core::PumpRuntimeStore::kMaxSlots>;
+    SlotTimers                         fill_wait_timers; // AUTH sonrası 10 sn dolum bekleme
+    SlotTimers                         unauth_timers;    // "Yetkisiz Kullanıcı" 3 sn timeout
+    recum12::core::TimerWheel::TimerId flow_check_timer;  // akış anomali kontrolü (1 sn)
+    recum12::core::TimerWheel::TimerId totals_poll_timer; // boşta totalizer okuması (60 sn)
+    bool                      anomaly_msg_shown{false};   // System kanalında anomali uyarısı var mı
 
     // Sayaç / log durumu (configs/repo_log.json)
     std::string               repo_log_path;
     std::uint64_t             wait_recs{0};   // lblwaitrecs
     std::uint64_t             vhec_count{0};  // lblvechs
-    double                    repo_fill{0.0}; // lblcounter (litre)
+    recum12::utils::Volume    repo_fill{};    // lblcounter (litre, x100 sabit nokta)
 
-    // Tarih / saat label'ları için periyodik timer
+    // Tarih / saat label'ları için periyodik timer (gün dönümünde vardiya kapanır)
     sigc::connection          clock_conn;
+    std::string               clock_last_date;
     sigc::connection          net_poll_conn;
-    // Nozzle OUT→IN geçişini takip etmek için önceki nozzle durumu
-    bool                      last_nozzle_out{false};
 
-    // RS485 nozzle event log (GunOn/GunOff) için önceki durum
-    bool                      nozzle_out_logged{false};
+    // Kapanan satışlar: onStationTransition (store kilidi altında) kuyruğa
+    // alır, book_closed_sales kilit dışında mutabakat checkpoint'ini yazar ve
+    // kota toplamlarına işler. Yalnızca core thread'i.
+    struct ClosedSale {
+        std::size_t               slot{0};
+        recum12::utils::CardUid   card_uid{};
+        recum12::utils::Volume    volume{};
+    };
+    std::vector<ClosedSale>   closed_sales;
 
     // RS485 health durumu (ikon + mesaj için edge detection)
     bool                      last_rs485_ok{false};
@@ -109,6 +156,21 @@ struct AppRuntime {
     void load_repo_log();
     void save_repo_log();
     void refresh_counters_on_ui();
+    // Slot'un mutabakat defterini açar (ilk çağrıda); geçersiz slot'ta false
+    bool open_recon(std::size_t slot);
+    // Slot'un mutabakat vardiyasını kapatır ve özeti infra log'a yazar
+    void close_recon_shift(std::size_t slot);
+    // Kuyruktaki kapanan satışları kota toplamlarına yazar (core thread'i)
+    void book_closed_sales();
+    // İstasyon geçişinin GUI/log aksiyonlarını uygular (GUI thread'i)
+    void apply_station_actions(const StationLogEntry& entry);
+    void append_station_usage(const char* log_code,
+                              const recum12::utils::CardUid& card_uid,
+                              recum12::utils::Volume fuel,
+                              const std::string& time_stamp = {},
+                              std::uint64_t process_id = 0);
+    // Akış anomalisini status (System kanalı) + infra log'a yansıtır (GUI thread'i)
+    void report_flow_anomaly(const ::core::FlowAnomaly& a);
     void init_network_poll();    
 };
 
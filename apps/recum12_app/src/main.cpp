@@ -1,4 +1,3 @@
-#include <iostream>
 #include <string>
 #include <gtkmm.h>
 #include <cstdint>
@@ -17,6 +16,7 @@
 #include "gui/MainWindow.h"
 #include "gui/rs485_gui_adapter.h"
 #include "gui/StatusMessageController.h"
+#include "utils/InfraLog.h"
 #include "utils/Version.h"
 #include "core/PumpRuntimeState.h"
 #include "core/RfidAuthController.h"
@@ -47,13 +47,8 @@ int main(int argc, char* argv[])
     }
 
     if (!glade_loaded || !builder) {
-        std::cerr << "Glade yüklenemedi: ";
-        if (load_error.what().size() > 0) {
-            std::cerr << load_error.what();
-        } else {
-            std::cerr << "bilinmeyen hata";
-        }
-        std::cerr << std::endl;
+        const std::string why = load_error.what();
+        RECUM_LOG_ERROR("GUI", "Glade yüklenemedi: {}", why.empty() ? "bilinmeyen hata" : why);
         return 1;
     }
 
@@ -67,7 +62,7 @@ int main(int argc, char* argv[])
 
     auto* window = ui.window();
     if (!window) {
-        std::cerr << "Ana pencere oluşturulamadı." << std::endl;
+        RECUM_LOG_ERROR("GUI", "Ana pencere oluşturulamadı.");
         return 1;
     }
 
@@ -88,7 +83,7 @@ int main(int argc, char* argv[])
     }
 
     if (!css_applied) {
-        std::cerr << "Uyarı: style.css uygulanamadı (hiçbir path çalışmadı)." << std::endl;
+        RECUM_LOG_WARN("GUI", "style.css uygulanamadı (hiçbir path çalışmadı).");
     }
 
     {
@@ -0,0 +1,268 @@
+// CsvScanner ↔ eski satır ayırıcılar karşılaştırması (performans kontrolü).
+//
+// Kullanım:
+//   recum12_csv_bench [usage_mb] [user_rows] [tekrar]
+//   recum12_csv_bench --file <csv> [tekrar]
+//
+// Varsayılan: 16 MB sentetik usage log'u (tırnaklı/virgüllü alanlar dahil)
+// ve 100000 satırlık users.csv. Her veri seti için eski ayırıcı (usage:
+// parseCsvLine, users: getline + istringstream) ve CsvScanner en iyi
+// tekrarla ölçülür; alan sayısı ve içerik özeti eşleşmezse çıkış kodu 1.
+// --file verilen dosyayı iki usage yoluyla da ölçer.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "utils/CsvScanner.h"
+
+namespace {
+
+using recum12::utils::CsvField;
+using recum12::utils::CsvScanner;
+using Clock = std::chrono::steady_clock;
+
+// ---- Eski ayırıcılar (CsvScanner öncesi; karşılaştırma için aynen) ----
+
+// Usage log: tırnak ve "" kaçışı destekli, alan başına kopya
+std::vector<std::string> legacyParseCsvLine(const std::string& line)
+{
+    std::vector<std::string> cols;
+    std::string current;
+    current.reserve(line.size());
+
+    bool inQuotes = false;
+
+    for (std::size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (inQuotes) {
+            if (c == '"') {
+                if (i + 1 < line.size() && line[i + 1] == '"') {
+                    current.push_back('"');
+                    ++i;
+                } else {
+                    inQuotes = false;
+                }
+            } else {
+                current.push_back(c);
+            }
+        } else {
+            if (c == '"') {
+                inQuotes = true;
+            } else if (c == ',') {
+                cols.push_back(current);
+                current.clear();
+            } else {
+                current.push_back(c);
+            }
+        }
+    }
+
+    cols.push_back(current);
+    return cols;
+}
+
+// users.csv: yalnızca virgüle göre böler (tırnak desteği yok)
+std::vector<std::string> legacySplitCsvLine(const std::string& line)
+{
+    std::vector<std::string> out;
+    std::string current;
+    std::istringstream iss(line);
+    while (std::getline(iss, current, ',')) {
+        out.push_back(current);
+    }
+    return out;
+}
+
+// ---- Sentetik veri ----
+
+std::string makeUsageLog(std::size_t bytes)
+{
+    std::string out = "processId,rfid,firstName,lastName,plate,limit,fuel,logCode,timeStamp,sendOk\n";
+    out.reserve(bytes + 256);
+    char line[256];
+    for (std::uint64_t id = 1; out.size() < bytes; ++id) {
+        // Her 8. satırda virgüllü litre ve "" kaçışlı ad (tırnaklı yol)
+        const bool quoted = (id % 8) == 0;
+        const int n = std::snprintf(
+            line, sizeof(line),
+            quoted ? "%llu,04A1B2C3D4E5%02X,\"Ali \"\"Usta\"\"\",Yılmaz,34 ABC %03u,%u,\"%u,%02u\",%s,2026-10-%02uT%02u:%02u:00Z,NA\n"
+                   : "%llu,04A1B2C3D4E5%02X,Ayşe,Demir,34 ABC %03u,%u,%u.%02u,%s,2026-10-%02uT%02u:%02u:00Z,OK\n",
+            static_cast<unsigned long long>(id), static_cast<unsigned>(id & 0xFF),
+            static_cast<unsigned>(id % 1000), static_cast<unsigned>(100 + id % 400),
+            static_cast<unsigned>(id % 90), static_cast<unsigned>(id % 100),
+            (id % 3) ? "PumpOff_PC" : "AUTH_OK", static_cast<unsigned>(1 + id % 28),
+            static_cast<unsigned>(id % 24), static_cast<unsigned>(id % 60));
+        out.append(line, static_cast<std::size_t>(n));
+    }
+    return out;
+}
+
+std::string makeUsersCsv(std::size_t rows)
+{
+    std::string out = "userId,rfid,firstName,lastName,plate,limit,level\n";
+    out.reserve(rows * 64);
+    char line[160];
+    for (std::size_t i = 1; i <= rows; ++i) {
+        const int n = std::snprintf(line, sizeof(line),
+                                    "%zu,%08zX,Mehmet,Kaya,06 KLM %04zu,%zu.%02zu,%zu\n",
+                                    i, 0x10000000u + i, i % 10000, 50 + i % 500, i % 100, i % 5);
+        out.append(line, static_cast<std::size_t>(n));
+    }
+    return out;
+}
+
+// ---- Ölçüm ----
+
+// Alan sayısı + içerik özeti: iki yolun aynı sonucu verdiğini doğrular
+struct Digest {
+    std::uint64_t rows{0};
+    std::uint64_t fields{0};
+    std::uint64_t hash{1469598103934665603ULL};
+
+    void add(const char* p, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(p[i])) * 1099511628211ULL;
+        }
+        hash = (hash ^ 0xFF) * 1099511628211ULL;   // alan sınırı
+        ++fields;
+    }
+    bool operator==(const Digest& o) const
+    {
+        return rows == o.rows && fields == o.fields && hash == o.hash;
+    }
+};
+
+// Eski yollar satırları getline ile alıyordu; '\r' alana dahil değildi
+Digest runLegacy(const std::string& content,
+                 std::vector<std::string> (*split)(const std::string&))
+{
+    Digest d;
+    std::istringstream in(content);
+    std::string line;
+    std::getline(in, line);   // header
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        for (const auto& c : split(line)) {
+            d.add(c.data(), c.size());
+        }
+        ++d.rows;
+    }
+    return d;
+}
+
+Digest runScanner(const std::string& content)
+{
+    Digest d;
+    CsvScanner sc(content);
+    std::vector<CsvField> row;
+    std::string tmp;
+    sc.next(row);   // header
+    while (sc.next(row)) {
+        if (row.size() == 1 && row[0].raw.empty()) {
+            continue;
+        }
+        for (const auto& f : row) {
+            if (f.escaped) {
+                tmp = f.text();
+                d.add(tmp.data(), tmp.size());
+            } else {
+                d.add(f.raw.data(), f.raw.size());
+            }
+        }
+        ++d.rows;
+    }
+    return d;
+}
+
+// En iyi tekrarın süresi (ms)
+double bestOf(int reps, const std::function<Digest()>& fn, Digest& out)
+{
+    double best = 0;
+    for (int i = 0; i < reps; ++i) {
+        const auto t0 = Clock::now();
+        out           = fn();
+        const double ms =
+            std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        best = (i == 0) ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+bool compare(const char* name, const std::string& content, int reps,
+             std::vector<std::string> (*legacy)(const std::string&))
+{
+    Digest a;
+    Digest b;
+    const double msOld = bestOf(reps, [&] { return runLegacy(content, legacy); }, a);
+    const double msNew = bestOf(reps, [&] { return runScanner(content); }, b);
+    const double mb    = static_cast<double>(content.size()) / (1024.0 * 1024.0);
+
+    std::cout << "[bench] " << name << ": " << mb << " MB, " << b.rows << " satır\n"
+              << "  eski       : " << msOld << " ms (" << (mb * 1000.0 / msOld) << " MB/s)\n"
+              << "  CsvScanner : " << msNew << " ms (" << (mb * 1000.0 / msNew) << " MB/s), x"
+              << (msOld / msNew) << "\n";
+
+    if (!(a == b)) {
+        std::cout << "  sonuç farklı: eski satır=" << a.rows << " alan=" << a.fields
+                  << ", yeni satır=" << b.rows << " alan=" << b.fields << "\n";
+        return false;
+    }
+    return true;
+}
+
+int usage(const char* argv0)
+{
+    std::cerr << "Kullanım:\n"
+              << "  " << argv0 << " [usage_mb] [user_rows] [tekrar]\n"
+              << "  " << argv0 << " --file <csv> [tekrar]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc >= 2 && std::strcmp(argv[1], "--file") == 0) {
+        if (argc < 3) {
+            return usage(argv[0]);
+        }
+        std::ifstream ifs(argv[2], std::ios::binary);
+        if (!ifs.is_open()) {
+            std::cerr << "[bench] açılamadı: " << argv[2] << std::endl;
+            return 1;
+        }
+        const std::string content((std::istreambuf_iterator<char>(ifs)),
+                                  std::istreambuf_iterator<char>());
+        const int reps = (argc >= 4) ? std::max(1, std::atoi(argv[3])) : 5;
+        return compare(argv[2], content, reps, legacyParseCsvLine) ? 0 : 1;
+    }
+
+    const long usageMb  = (argc >= 2) ? std::atol(argv[1]) : 16;
+    const long userRows = (argc >= 3) ? std::atol(argv[2]) : 100000;
+    const int  reps     = (argc >= 4) ? std::max(1, std::atoi(argv[3])) : 5;
+    if (usageMb <= 0 || userRows <= 0) {
+        return usage(argv[0]);
+    }
+
+    const std::string usageLog = makeUsageLog(static_cast<std::size_t>(usageMb) * 1024 * 1024);
+    const std::string users    = makeUsersCsv(static_cast<std::size_t>(userRows));
+
+    bool ok = compare("usage log", usageLog, reps, legacyParseCsvLine);
+    ok      = compare("users.csv", users, reps, legacySplitCsvLine) && ok;
+    return ok ? 0 : 1;
+}
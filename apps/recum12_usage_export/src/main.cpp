@@ -0,0 +1,32 @@
+// Usage segmentleri → düz CSV dışa aktarımı (servis / saha raporu için).
+//
+// Kullanım:
+//   recum12_usage_export <appRoot> [out.csv]
+//
+// Segmentler onaylar (sendOk) uygulanmış olarak okunur; çıktı verilmezse
+// <appRoot>/logs/log_user/usage_export.csv. Açılış wal recovery'si yaptığı
+// için uygulama durdurulmuşken çalıştırılır: store uygulamada açıksa
+// (süreç kilidi) export reddedilir.
+#include <iostream>
+#include <string>
+
+#include "utils/LogManager.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Kullanım:\n"
+                  << "  " << argv[0] << " <appRoot> [out.csv]\n";
+        return 2;
+    }
+
+    const std::string appRoot = argv[1];
+    const std::string out     = (argc >= 3) ? std::string(argv[2]) : std::string{};
+
+    recum12::utils::LogManager lm;
+    if (!lm.exportUsageCsv(appRoot, out)) {
+        std::cerr << "[usage_export] usage CSV export başarısız: " << appRoot << std::endl;
+        return 1;
+    }
+    return 0;
+}
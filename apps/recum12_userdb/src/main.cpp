@@ -0,0 +1,85 @@
+// users.csv → users.udb derleyici (saha kurulumu / toplu kart yüklemesi için).
+//
+// Kullanım:
+//   recum12_userdb <users.csv> [users.udb]
+//   recum12_userdb --verify <users.udb> [UID ...]
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "core/UserDbImage.h"
+#include "core/UserManager.h"
+
+namespace {
+
+int usage(const char* argv0)
+{
+    std::cerr << "Kullanım:\n"
+              << "  " << argv0 << " <users.csv> [users.udb]\n"
+              << "  " << argv0 << " --verify <users.udb> [UID ...]\n";
+    return 2;
+}
+
+int verifyImage(int argc, char* argv[])
+{
+    recum12::core::UserDbImage img;
+    if (!img.open(argv[2])) {
+        std::cerr << "[userdb] imaj açılamadı veya bozuk: " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << "[userdb] " << argv[2]
+              << " OK, kayıt=" << img.size()
+              << " csv_size=" << img.stamp().size
+              << std::endl;
+
+    for (int i = 3; i < argc; ++i) {
+        recum12::utils::CardUid uid;
+        if (!recum12::utils::CardUid::parseHex(argv[i], uid)) {
+            std::cout << "  " << argv[i] << " → geçersiz UID" << std::endl;
+            continue;
+        }
+        if (auto u = img.findByRfid(uid)) {
+            std::cout << "  " << uid << " → userId=" << u->userId
+                      << " plate=" << u->plate << std::endl;
+        } else {
+            std::cout << "  " << uid << " → bulunamadı" << std::endl;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        return usage(argv[0]);
+    }
+
+    if (std::strcmp(argv[1], "--verify") == 0) {
+        if (argc < 3) {
+            return usage(argv[0]);
+        }
+        return verifyImage(argc, argv);
+    }
+
+    const std::string csv   = argv[1];
+    const std::string image = (argc >= 3)
+                                  ? std::string(argv[2])
+                                  : recum12::core::UserManager::imagePathFor(csv);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::size_t rows = 0;
+    if (!recum12::core::UserManager::compileUserDb(csv, image, &rows)) {
+        std::cerr << "[userdb] derleme başarısız: " << csv << " → " << image << std::endl;
+        return 1;
+    }
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "[userdb] " << csv << " → " << image
+              << " (" << rows << " kullanıcı, " << ms << " ms)" << std::endl;
+    return 0;
+}
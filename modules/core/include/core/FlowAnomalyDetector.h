@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "core/StationStateMachine.h"
+#include "utils/FixedPoint.h"
+
+namespace recum12::core {
+
+using recum12::utils::Volume;
+
+enum class FlowAnomalyKind : std::uint8_t {
+    UnauthorizedDispense = 0, // yetki/satış yokken hacim arttı
+    TotalizerJump,            // satışlar arasında totalizer ilerledi (kaçak / dış dolum)
+    SaleMismatch,             // satış hacmi ile totalizer farkı tutmuyor
+    StalledNozzle,            // tabanca dışarıda, uzun süredir akış yok
+    Count
+};
+
+// Aktif anomaliler için bit maskesi (PumpRuntimeState::anomaly_flags)
+constexpr std::uint32_t flowAnomalyBit(FlowAnomalyKind k) noexcept
+{
+    return 1u << static_cast<unsigned>(k);
+}
+
+struct FlowAnomaly
+{
+    FlowAnomalyKind                       kind{FlowAnomalyKind::UnauthorizedDispense};
+    std::chrono::steady_clock::time_point at{};
+    Volume                                observed{};  // ölçülen hacim / fark
+    Volume                                expected{};  // beklenen (satış toplamı vb.)
+    StationState                          station{StationState::Idle};
+    std::uint8_t                          slot{0};     // pompa/tabanca slot'u (store doldurur)
+};
+
+struct FlowAnomalyConfig
+{
+    // Hacim karşılaştırmalarında tolerans (BCD x100 → 0.05 L)
+    Volume               tolerance{Volume::fromRaw(5)};
+    // Tabanca dışarıda, akış yokken StalledNozzle'a kadar geçen süre
+    std::chrono::seconds stall_timeout{120};
+};
+
+// Çözülmüş fill / totals olaylarıyla beslenen akış anomali dedektörü.
+//
+//  - Her çağrı O(1): yalnızca son değerler ve satış toplamları tutulur.
+//  - Kararlar çağrı anında verilir; totals satış sınırlarında istendiği
+//    için sapma bir poll döngüsü içinde yakalanır.
+//  - Aynı anomali, koşulu ortadan kalkana kadar bir kez raporlanır.
+//
+// Thread-safe değildir; sahibi (PumpRuntimeStore) kilitler.
+class FlowAnomalyDetector
+{
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    explicit FlowAnomalyDetector(const FlowAnomalyConfig& cfg = FlowAnomalyConfig{})
+        : cfg_(cfg)
+    {
+    }
+
+    void setConfig(const FlowAnomalyConfig& cfg) noexcept { cfg_ = cfg; }
+
+    // Pompa ekranındaki hacim (FillInfo.volume). pump_authorized: pompa
+    // kendi durumunda AUTHORIZED/FILLING (ör. GUI AUTH butonu; status
+    // frame'i DC2'den sonra işlenmiş olabilir).
+    bool onFill(Volume pump_volume, StationState st, bool pump_authorized,
+                time_point now, FlowAnomaly& out);
+
+    // Totalizer okuması. Satış sürerken gelen okumalar karşılaştırılmaz.
+    bool onTotals(Volume total_volume, StationState st, time_point now, FlowAnomaly& out);
+
+    // Satış kapandı: totalizer'ın bir sonraki okumada bu kadar ilerlemesi beklenir.
+    void onSaleClosed(Volume sale_volume) noexcept;
+
+    // Tabanca konumu değişti.
+    void onNozzle(bool nozzle_out, time_point now) noexcept;
+
+    // Periyodik kontrol (StalledNozzle).
+    bool tick(StationState st, time_point now, FlowAnomaly& out);
+
+    void reset() noexcept;
+
+    std::uint32_t activeMask() const noexcept { return active_; }
+
+    static const char* name(FlowAnomalyKind k) noexcept;
+
+private:
+    bool raise(FlowAnomalyKind k, Volume observed, Volume expected,
+               StationState st, time_point now, FlowAnomaly& out) noexcept;
+    void clear(FlowAnomalyKind k) noexcept { active_ &= ~flowAnomalyBit(k); }
+
+    FlowAnomalyConfig cfg_;
+    std::uint32_t     active_{0};
+
+    // onFill
+    Volume            last_fill_{};
+    bool              have_fill_{false};
+    Volume            unauth_base_{};     // yetkisiz akışın başladığı seviye
+
+    // onTotals
+    Volume            last_total_{};
+    bool              have_total_{false};
+    Volume            closed_since_total_{};
+
+    // StalledNozzle
+    bool              nozzle_out_{false};
+    time_point        last_activity_{};   // tabanca çıkışı veya son hacim artışı
+};
+
+} // namespace recum12::core
@@ -1,12 +1,20 @@
 #ifndef CORE_PUMPRUNTIMESTATE_H
 #define CORE_PUMPRUNTIMESTATE_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <mutex>
 #include <string>
 
 // Pompa tarafındaki temel tipler (PumpState, FillInfo, TotalCounters, NozzleEvent)
 // hw modülündeki R07 protokol tanımlarından gelir.
 #include "hw/PumpR07Protocol.h"
+#include "core/FlowAnomalyDetector.h"
+#include "core/PumpSaleTracker.h"
+#include "core/StationStateMachine.h"
+#include "utils/CardUid.h"
 
 namespace core
 {
@@ -16,20 +24,41 @@ using recum12::hw::PumpState;
 using recum12::hw::FillInfo;
 using recum12::hw::TotalCounters;
 using recum12::hw::NozzleEvent;
+using recum12::hw::PumpSlotRef;
+using recum12::hw::PumpStatusEvent;
+using recum12::hw::Volume;
+using recum12::hw::Amount;
+using recum12::utils::CardUid;
+using recum12::core::StationState;
+using recum12::core::StationEvent;
+using recum12::core::StationTransition;
+using recum12::core::StationStateMachine;
+namespace StationAction = recum12::core::StationAction;
+using recum12::core::FlowProfile;
+using recum12::core::PumpSaleTracker;
+using recum12::core::FlowAnomaly;
+using recum12::core::FlowAnomalyKind;
+using recum12::core::FlowAnomalyConfig;
+using recum12::core::FlowAnomalyDetector;
 
 // RFID tarafının pompa state'ine enjekte edeceği bağlam
 struct AuthContext
 {
+    PumpSlotRef slot{};            // kartı isteyen pompa/tabanca
     bool        authorized{false};
-    std::string uid_hex;
+    CardUid     uid{};
     std::string user_id;
     std::string plate;
-    double      limit_liters{0.0};
+    Volume      limit_volume{};
 };
 
-// Uygulama genelinde "tek hakikat" olacak runtime state
+// Tek bir pompa/tabanca slot'unun runtime state'i
 struct PumpRuntimeState
 {
+    // Hangi pompa (adres) + tabanca; slot_index store'daki dizi indeksi
+    PumpSlotRef    slot{};
+    std::uint8_t   slot_index{0};
+
     // Pompa ana durumu
     PumpState      pump_state{};      // Son STATUS frame'den gelen durum
     bool           nozzle_out{false}; // Son nozzle event'e göre
@@ -41,70 +70,164 @@ struct PumpRuntimeState
     //    satış olarak ele alınıyor; ileride CD2 vs 3E ayrımı geldiğinde
     //    current/last mantığı netleştirilecek.
     FillInfo       last_fill{};         // Son satış / dolum bilgisi
-    double         current_fill_volume_l{0.0};
+    Volume         current_fill_volume{};
     bool           has_current_fill{false};
-    double         last_fill_volume_l{0.0};
+    Volume         last_fill_volume{};
     bool           has_last_fill{false};
 
     TotalCounters  totals{};            // TOTALIZER'dan gelen sayaçlar
 
     // RFID & AUTH
-    std::string    last_card_uid;
+    CardUid        last_card_uid{};
     bool           last_card_auth_ok{false};
     std::string    last_card_user_id;
     std::string    last_card_plate;
 
     // Limit bilgisi (RFID karttan gelen)
-    //  - limit_liters             : bu kart için tanımlı limit (0.0 ise limitsiz kabul)
+    //  - limit_volume             : bu kart için tanımlı limit (0 ise limitsiz kabul)
     //  - has_limit                : limit tanımlı mı?
-    //  - remaining_limit_liters   : devam eden satışta kalan limit (has_limit yoksa 0.0)
-    double         limit_liters{0.0};
+    //  - remaining_limit_volume   : devam eden satışta kalan limit (has_limit yoksa 0)
+    Volume         limit_volume{};
     bool           has_limit{false};
-    double         remaining_limit_liters{0.0};
-    // Latch’ler
+    Volume         remaining_limit_volume{};
+    // İstasyon durum makinesinin çıktısı (görünüm ve loglar buna göre sürülür)
+    StationState   station{StationState::Idle};
+
+    // Aktif akış anomalileri (flowAnomalyBit maskesi)
+    std::uint32_t  anomaly_flags{0};
+
+    // Eski latch'ler; artık station'dan türetilir (salt okunur kabul edin)
     bool           auth_active{false};
     bool           sale_active{false};
 };
 
-// Thread-safe olmayan, basit bir store iskeleti.
-// İlk etapta yalnızca RS485 callback'leri tarafından beslenecek,
-// GUI/NET tarafı ise onStateChanged üzerinden dinleyecek.
+// Pompa runtime store'u.
+// RS485/core thread'i pompa, kart ve zamanlayıcı (dispatch) olaylarıyla
+// besler; GUI thread'i yalnızca okur. İç mutex ile korunur.
+// Satış/yetki mantığı StationStateMachine'de; store yalnızca olayları
+// makineye çevirir ve geçişin store'a ait aksiyonlarını uygular.
+//
+// Çoklu pompa / tabanca:
+//  - Her (adres, tabanca) çifti sabit kapasiteli dizide bir slot'tur; her
+//    slot kendi durum makinesini, satış baseline'ını, akış profilini ve
+//    anomali dedektörünü taşır → eşzamanlı satışlar birbirinden bağımsız.
+//  - Olaylar PumpSlotRef ile yönlendirilir; ilk kez görülen çift boş slot
+//    varsa otomatik eklenir, kapasite doluysa olay sayılıp düşürülür.
+//  - Slot 0 varsayılan pompadır (0x50 / nozzle-1). Tek pompalı GUI
+//    selectSlot() ile seçilen slot'un görünümüdür; state() onu döner.
+//
+// Not: onStateChanged / onStationTransition store kilidi altında çağrılır;
+// callback içinde store'a geri çağrı yapılmamalı, iş kısa tutulmalı.
 class PumpRuntimeStore
 {
 public:
-    PumpRuntimeStore() = default;
+    static constexpr std::size_t kMaxSlots = 8;
+    static constexpr std::size_t kNoSlot   = kMaxSlots;
+
+    PumpRuntimeStore();
 
-    // Mevcut state'e salt-okuma erişim
-    const PumpRuntimeState& state() const noexcept;
+    // Slot'u kaydeder (varsa mevcut indeksi döner); kapasite doluysa kNoSlot
+    std::size_t addSlot(const PumpSlotRef& ref);
+    std::size_t findSlot(const PumpSlotRef& ref) const;
+    std::size_t slotCount() const;
+    PumpSlotRef slotRef(std::size_t slot) const;
 
-    // Tüm state'i varsayılana sıfırlar ve değişikliği bildirir
+    // GUI'nin gösterdiği slot (geçersiz indekste false)
+    bool        selectSlot(std::size_t slot);
+    std::size_t selectedSlot() const;
+
+    // Seçili slot'un / belirli bir slot'un state kopyası
+    PumpRuntimeState state() const;
+    PumpRuntimeState state(std::size_t slot) const;
+
+    // Tüm slot'ları varsayılana sıfırlar (kayıtlı slot'lar korunur) ve bildirir
     void reset();
 
     // RS485 protokol callback'lerinden çağrılacak güncelleyiciler
-    void updateFromPumpStatus(PumpState status);
+    // (event içindeki PumpSlotRef'e göre yönlendirilir)
+    void updateFromPumpStatus(const PumpStatusEvent& ev);
     void updateFromFill(const FillInfo& fill);
     void updateFromTotals(const TotalCounters& totals);
     void updateFromNozzle(const NozzleEvent& ev);
     void updateFromRfidAuth(const AuthContext& auth);
 
-    // AUTH latch'ini temizle (timeout vb. durumlarda IDLE'a dönmek için)
+    // Zamanlayıcı vb. doğrudan istasyon olayları (core thread'indeki TimerWheel'den)
+    void dispatch(std::size_t slot, StationEvent ev);
+    void dispatch(StationEvent ev) { dispatch(selectedSlot(), ev); }
+
+    // Periyodik akış kontrolü (tabanca dışarıda akışsız bekleme), tüm
+    // slot'lar; core thread
+    void checkFlowAnomalies();
+    void setFlowAnomalyConfig(const FlowAnomalyConfig& cfg);
+
+    // Seçili slot'un AUTH bilgisini temizle (istasyon durumunu değiştirmez)
     void clearAuth();
-    // State değiştiğinde tetiklenecek callback.
+
+    // CloseSale geçişi (slot, seq) ile kapanan satışın akış profilini devralır.
+    // Satış başına bir kez; seq eşleşmezse (arada yeni satış kapandıysa) false.
+    bool takeFlowProfile(std::size_t slot, std::uint64_t close_seq, FlowProfile& out);
+
+    // Son geçişlerin kopyası (eskiden yeniye); yazılan kayıt sayısı
+    std::size_t stationTrace(StationTransition* out, std::size_t max) const;
+    std::size_t stationTrace(std::size_t slot, StationTransition* out, std::size_t max) const;
+
+    // Slot kapasitesi dolu olduğu için düşürülen olay sayısı
+    std::uint64_t droppedEvents() const;
+
+    // Bir slot'un state'i değiştiğinde tetiklenecek callback
+    // (PumpRuntimeState::slot_index hangi slot olduğunu söyler).
     // Not: Şimdilik her update çağrısından sonra tetiklenir;
     // ileride gerekirse "değişti mi?" kontrolü eklenebilir.
     std::function<void(const PumpRuntimeState&)> onStateChanged;
 
+    // Uygulanan her istasyon geçişinde (yoksayılan olaylarda değil) tetiklenir;
+    // ikinci argüman geçişin slot'unun (geçiş uygulanmış) state'idir; ClearAuth
+    // varsa kart bilgisi bu çağrıdan sonra düşürülür.
+    std::function<void(const StationTransition&, const PumpRuntimeState&)> onStationTransition;
+
+    // Akış anomalisi tespit edildiğinde (her anomali, koşulu kalkana kadar bir kez).
+    std::function<void(const FlowAnomaly&)> onFlowAnomaly;
+
 private:
-    PumpRuntimeState s_{};
-
-    // FillInfo.volume_l totalizer gibi davrandığı durumlar için:
-    //  - fill_baseline_volume_l_ : satış başlangıcındaki total seviye
-    //  - have_fill_baseline_     : baseline alındı mı?
-    //  - last_sale_volume_l_     : son satışın litre miktarı
-    double fill_baseline_volume_l_{0.0};
-    bool   have_fill_baseline_{false};
-    double last_sale_volume_l_{0.0};
-    void notifyStateChanged();
+    struct Slot
+    {
+        PumpRuntimeState    s{};
+        StationStateMachine sm{};
+
+        // FillInfo.volume totalizer gibi davrandığı durumlar için:
+        //  - fill_baseline_volume : satış başlangıcındaki total seviye
+        //  - have_fill_baseline   : baseline alındı mı?
+        //  - last_sale_volume     : son satışın litre miktarı
+        Volume fill_baseline_volume{};
+        bool   have_fill_baseline{false};
+        Volume last_sale_volume{};
+
+        // Satış akış profili: her hacim örneği satış boyunca kaydedilir,
+        // CloseSale'de last_flow'a taşınır.
+        PumpSaleTracker flow{};
+        FlowProfile     last_flow{};
+        std::uint64_t   last_flow_seq{0};
+
+        FlowAnomalyDetector anomaly{};
+    };
+
+    mutable std::mutex  mtx_;
+
+    // Arama yalnızca ids_ üzerinde (slot başına 2 byte); ağır durum slots_'ta
+    std::array<PumpSlotRef, kMaxSlots> ids_{};
+    std::array<Slot, kMaxSlots>        slots_{};
+    std::size_t                        count_{1};
+    std::size_t                        selected_{0};
+    FlowAnomalyConfig                  anomaly_cfg_{};
+    std::uint64_t                      dropped_{0};
+
+    // Kilit tutulurken çağrılır
+    std::size_t addSlotLocked(const PumpSlotRef& ref);
+    Slot*       routeLocked(const PumpSlotRef& ref);
+    void applyEvent(Slot& sl, StationEvent ev);
+    void clearAuthLocked(Slot& sl);
+    void notifyStateChanged(const Slot& sl);
+    void raiseAnomaly(Slot& sl, FlowAnomaly& a);
 };
 
 } // namespace core
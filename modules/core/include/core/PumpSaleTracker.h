@@ -1,11 +1,110 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils/CardUid.h"
+#include "utils/FixedPoint.h"
+
 namespace recum12::core {
 
-class PumpSaleTracker {
+using recum12::utils::CardUid;
+using recum12::utils::Volume;
+
+// Satış içindeki tek hacim örneği (DC2/3E'den çözülen, satış başına göre).
+struct FlowSample
+{
+    std::uint32_t t_ms{0};   // satış başlangıcından itibaren
+    Volume        volume{};  // o ana kadar verilen toplam (baseline'dan fark)
+};
+
+// Bir satışın akış profili. Usage log satırına sale_ref (PumpOff_PC
+// satırının processId'si; eski kayıtlarda timeStamp'i) + rfid ile bağlanır.
+struct FlowProfile
+{
+    std::string             sale_ref;
+    CardUid                 rfid{};
+    std::int64_t            start_unix_ms{0};
+    std::vector<FlowSample> samples;
+};
+
+struct FlowPause
+{
+    std::uint32_t start_ms{0};
+    std::uint32_t duration_ms{0};
+};
+
+// Okuyucu tarafı özet (anlaşmazlıkta "satış nasıl ilerledi" sorusu için).
+struct FlowSummary
+{
+    Volume                 total{};
+    std::uint32_t          duration_ms{0};   // ilk → son örnek
+    std::uint32_t          flowing_ms{0};    // duraklamalar hariç
+    double                 avg_rate_lpm{0.0};
+    double                 peak_rate_lpm{0.0};
+    std::vector<FlowPause> pauses;
+};
+
+// Satış başına akış kaydedici.
+//
+//  - begin() yeni satışta, addSample() her çözülen hacim frame'inde,
+//    finish() satış kapanınca çağrılır. Yalnızca hacmi değişen örnekler
+//    saklanır (tekrarlanan DC2 frame'leri yer kaplamaz); tampon begin'de
+//    ayrılır, örnek başına heap tahsisi yok.
+//  - Dosya formatı (append-only, <appRoot>/logs/flow/flow_profiles.bin):
+//      "RFP1" | u32 body_len | body | u64 fnv1a(body)
+//    body: varint(len)+sale_ref, varint(len)+rfid (hex), varint start_unix_ms,
+//          varint n, sonra her örnek için varint Δt_ms + zigzag varint Δcl.
+//    Tipik bir satış birkaç yüz byte'tır. Okurken yarım yazılmış son kayıt
+//    checksum'dan yakalanıp atlanır.
+//
+// Thread-safe değildir; sahibi (PumpRuntimeStore) kilitler.
+class PumpSaleTracker
+{
 public:
+    using SteadyTime = std::chrono::steady_clock::time_point;
+    using WallTime   = std::chrono::system_clock::time_point;
+
+    // Tek satışta tutulacak en fazla örnek; aşılırsa son örnek güncellenir.
+    static constexpr std::size_t kMaxSamples = 4096;
+
     PumpSaleTracker() = default;
-    // TODO: satış / sayaç mantığı
+
+    void begin(SteadyTime now = std::chrono::steady_clock::now(),
+               WallTime   wall = std::chrono::system_clock::now());
+    void addSample(Volume volume, SteadyTime now = std::chrono::steady_clock::now());
+
+    // Aktif satışı kapatır ve profili out'a taşır; aktif satış yoksa false.
+    bool finish(FlowProfile& out);
+    void abort() noexcept { active_ = false; }
+
+    bool active() const noexcept { return active_; }
+
+    // ---- Kodlama / dosya
+    static void encode(const FlowProfile& p, std::vector<std::uint8_t>& out);
+    static bool decode(const std::uint8_t* data, std::size_t len, FlowProfile& out);
+
+    // Profili dosyanın sonuna ekler (+fdatasync).
+    static bool append(const std::string& path, const FlowProfile& p);
+
+    // Dosyadaki tüm geçerli profilleri okur (bozuk kuyruk atlanır).
+    static bool loadAll(const std::string& path, std::vector<FlowProfile>& out);
+
+    // sale_ref (+ opsiyonel rfid) ile tek profil bulur.
+    static bool find(const std::string& path, const std::string& sale_ref,
+                     const CardUid& rfid, FlowProfile& out);
+
+    // Debi, duraklama ve toplam; pause_ms'den uzun hacim değişmeyen
+    // aralıklar duraklama sayılır.
+    static FlowSummary analyze(const FlowProfile& p, std::uint32_t pause_ms = 3000);
+
+private:
+    bool                    active_{false};
+    SteadyTime              start_{};
+    FlowProfile             cur_{};
 };
 
 } // namespace recum12::core
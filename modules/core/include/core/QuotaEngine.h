@@ -0,0 +1,130 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "utils/FixedPoint.h"
+
+namespace recum12::core {
+
+// Kota pencereleri (yerel saat diliminde takvim bazlı).
+enum class QuotaWindow : std::uint8_t {
+    Daily = 0,
+    Weekly,   // Pazartesi başlangıçlı hafta
+    Monthly,
+    Count
+};
+
+using recum12::utils::Volume;
+
+// Kota politikası. Limit 0 → o pencere limitsiz.
+struct QuotaPolicy
+{
+    Volume       daily{};
+    Volume       weekly{};
+    Volume       monthly{};
+    // true ise aynı limitler plaka bazında da ayrıca uygulanır
+    // (farklı kartlarla aynı araca dolum yapılmasını engeller).
+    bool         per_plate{true};
+    // true ise kullanıcının users.csv litre limiti günlük kota olarak da
+    // uygulanır (daily > 0 ise ikisinin küçüğü): limit satış başına değil,
+    // gün içindeki tüm kart okutmaların toplamına bağlanır.
+    bool         user_limit_daily{true};
+
+    bool unlimited() const noexcept
+    {
+        return !daily.isPositive() && !weekly.isPositive() && !monthly.isPositive();
+    }
+};
+
+// AUTH anındaki kota kararı.
+struct QuotaDecision
+{
+    bool         allowed{true};
+    bool         limited{false};       // herhangi bir pencere limiti uygulandı mı?
+    Volume       remaining{};          // limited ise en kısıtlayıcı kalan miktar
+    QuotaWindow  limiting_window{QuotaWindow::Daily};
+};
+
+// Kullanıcı ve plaka bazında günlük/haftalık/aylık tüketim toplamlarını tutan
+// kota motoru.
+//
+//  - recordSale / check O(1): her anahtar için sadece "dönem id + toplam"
+//    tutulur; dönem değiştiğinde toplam sıfırlanır. Usage log'u taranmaz.
+//  - Kalıcılık: her güncelleme, anahtarın tam durumunu içeren checksum'lı
+//    sabit uzunluklu bir kayıt olarak journal dosyasına eklenir (+fdatasync).
+//    Açılışta son geçerli kayıt kazanır; yarım yazılmış son kayıt atılır.
+//    Journal büyüyünce tmp + rename ile tek bir snapshot'a sıkıştırılır.
+//
+// Thread-safe; check() ve recordSale() core thread'inden çağrılır (kapanan
+// satış, sonraki kart okutmanın kontrolünden önce toplama girer).
+class QuotaEngine
+{
+public:
+    using Clock = std::chrono::system_clock;
+
+    QuotaEngine() = default;
+    ~QuotaEngine();
+
+    QuotaEngine(const QuotaEngine&)            = delete;
+    QuotaEngine& operator=(const QuotaEngine&) = delete;
+
+    void setPolicy(const QuotaPolicy& policy);
+    QuotaPolicy policy() const;
+
+    // Kalıcı dosyayı açar/oluşturur ve mevcut toplamları yükler.
+    bool open(const std::string& path);
+    void close();
+
+    // AUTH anında kota kontrolü (kullanıcı + opsiyonel plaka). user_limit:
+    // kullanıcının users.csv limiti (<= 0 → yok; bkz. user_limit_daily).
+    QuotaDecision check(int userId, const std::string& plate, Volume user_limit = {},
+                        Clock::time_point now = Clock::now()) const;
+
+    // Tamamlanan satışı toplamlara ekler ve kalıcı dosyaya yazar.
+    void recordSale(int userId, const std::string& plate,
+                    Volume volume,
+                    Clock::time_point now = Clock::now());
+
+    // Anahtarın ilgili penceredeki tüketimi (GUI/rapor için).
+    Volume consumed(int userId, QuotaWindow w,
+                          Clock::time_point now = Clock::now()) const;
+
+private:
+    static constexpr std::size_t kWindows = static_cast<std::size_t>(QuotaWindow::Count);
+
+    // consumed_cl: Volume ham değeri (centilitre); journal'a aynen yazılır.
+    struct Bucket
+    {
+        std::uint32_t period[kWindows]{};
+        std::int64_t  consumed_cl[kWindows]{};
+    };
+
+    struct Periods
+    {
+        std::uint32_t id[kWindows]{};
+    };
+
+    static Periods periodsFor(Clock::time_point now);
+    static std::uint64_t userKey(int userId) noexcept;
+    static std::uint64_t plateKey(const std::string& plate) noexcept;
+
+    Volume limitFor(QuotaWindow w, Volume user_limit) const noexcept;
+    void evaluate(const Bucket* b, const Periods& p, Volume user_limit, QuotaDecision& d) const;
+    void addTo(std::uint64_t key, const Periods& p, Volume volume);
+    bool appendRecord(std::uint64_t key, const Bucket& b);
+    bool compact();
+
+    mutable std::mutex                   mtx_;
+    QuotaPolicy                          policy_{};
+    std::unordered_map<std::uint64_t, Bucket> buckets_;
+
+    std::string   path_;
+    int           fd_{-1};
+    std::size_t   journalRecords_{0};
+};
+
+} // namespace recum12::core
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "hw/PumpInterfaceLvl3.h"
+#include "core/QuotaEngine.h"
 #include "core/UserManager.h"
 #include "rfid/Pn532Reader.h"
 #include <chrono>
@@ -13,12 +20,28 @@ namespace recum12::core {
 // RFID kart sonucu hakkında üst katmana iletilecek özet bilgi.
 struct AuthContext
 {
-    std::string uid_hex;    // Okunan kart UID'si (HEX)
+    recum12::hw::PumpSlotRef slot{}; // kartı isteyen pompa/tabanca (AUTHORIZE buraya)
+    CardUid     uid{};      // Okunan kart UID'si
     bool        authorized{false}; // İleride UserManager ile doldurulacak
     std::string user_id;    // Kullanıcı ID / kısa isim
     std::string plate;      // Plaka vb. bilgi
-    // Bu kart için tanımlı litre limiti (0.0 ise sınırsız)
-    double      limit_liters{0.0};
+    // Bu kart için tanımlı litre limiti (0 ise sınırsız)
+    // Kota motoru bağlıysa: min(kart limiti, kalan kota).
+    Volume      limit_volume{};
+    // Kullanıcı tanımlı ama günlük/haftalık/aylık kotası dolmuş
+    bool        quota_exceeded{false};
+};
+
+// Kart algılama → pompa AUTHORIZE frame'inin hatta yazılması arasındaki
+// gecikme istatistikleri (mikrosaniye).
+struct AuthLatencyStats
+{
+    std::uint64_t count{0};
+    std::int64_t  last_us{0};
+    std::int64_t  min_us{0};
+    std::int64_t  max_us{0};
+    double        avg_us{0.0};
+    std::uint64_t dropped_events{0};  // kuyruk doluyken gelen kartlar
 };
 
 class RfidAuthController
@@ -29,22 +52,50 @@ public:
 
     // Bağımlılıkları dışarıdan enjekte ediyoruz.
     void setPumpInterface(recum12::hw::PumpInterfaceLvl3* pump);
+    // Tek okuyucu: tüm pompa/tabancalara hizmet eder.
     void setReader(recum12::rfid::Pn532Reader* reader);
+    // Çoklu ada: okuyucu yalnızca slot'taki pompa/tabancaya bağlı. Kart
+    // isteği önce slot'u birebir eşleşen okuyucuya, yoksa setReader ile
+    // verilen genel okuyucuya gider. attach()'tan önce çağrılmalı.
+    void addReader(recum12::rfid::Pn532Reader* reader,
+                   const recum12::hw::PumpSlotRef& slot);
     void setUserManager(UserManager* users);
+    // Opsiyonel: bağlanırsa AUTH anında kullanıcı/plaka kotası kontrol edilir.
+    void setQuotaEngine(QuotaEngine* quota);
 
     // Bu fonksiyon, reader callback'lerini (onCardDetected / onError)
     // bu controller'a bağlar. setXXX çağrılarından sonra bir kez çağırılmalı.
+    //
+    // Asenkron auth pipeline:
+    //  - RFID worker thread'i kart olayını sadece kuyruğa bırakır ve hemen
+    //    polling'e döner.
+    //  - Core (RS485) thread'i processPending() ile kuyruğu boşaltır:
+    //    kullanıcı arama, kota, onAuthResult ve AUTHORIZE komutu orada çalışır.
+    //  - AUTHORIZE frame'i pompa TX kuyruğundan (bus scheduler) gönderilir.
     void attach();
 
-    // --- Pompa tarafındaki nozzle olayları için üst katmandan çağrılacak API ---
+    // Core thread: kuyrukta kart olayı varsa (veya timeout dolunca) döner.
+    bool waitForPending(std::chrono::milliseconds timeout);
+
+    // Core thread: bekleyen kart olaylarını işler; işlenen olay sayısını döner.
+    std::size_t processPending();
+
+    AuthLatencyStats latencyStats() const;
 
-    // Nozzle OUT olayı: pompa tabancasının yerinden alınması.
-    // Bu durumda RFID kart okuma isteği başlatılır.
-    void handleNozzleOut();
+    // --- İstasyon durum makinesinin RequestCard / CancelCard çıktıları ---
+    // Ne zaman kart okunacağına (ör. yetkili kart sonrası tekrar okuma
+    // yapılmaması) StationStateMachine karar verir; burada ek latch yok.
 
-    // Nozzle IN veya satışın bittiği benzeri durumlar.
-    // Kart okuma isteği iptal edilir, reader Idle'a döner.
+    // Kart okuma isteği başlatır (tipik olarak tabanca pompadan alınınca).
+    // Okunan kart bu pompa/tabancaya AUTHORIZE edilir. Genel okuyucuda
+    // istekler sıraya girer: önceki slot kart beklerken yeni tabanca çıkışı
+    // okuyucuyu yeniden hedeflemez, sırası gelince okunur.
+    void handleNozzleOut(const recum12::hw::PumpSlotRef& slot = {});
+
+    // Slot'un okuyucusundaki kart okuma isteğini iptal eder, reader Idle'a
+    // döner. Slot verilmezse tüm okuyucular.
     void handleNozzleInOrSaleFinished();
+    void handleNozzleInOrSaleFinished(const recum12::hw::PumpSlotRef& slot);
 
     // --- Üst katmana bilgi akışı için callback'ler ---
 
@@ -59,16 +110,53 @@ public:
     // Ör: "RFID: nfc_init failed", "RFID: poll failed, will reconnect" vb.
     std::function<void(const std::string&)> onError;
 
+    // Kart → AUTHORIZE (frame hatta yazıldı) gecikmesi; RS485 thread'inde çağrılır.
+    std::function<void(std::chrono::microseconds)> onAuthLatency;
+
 private:
+    // Okuyucu ↔ pompa/tabanca bağı
+    struct ReaderBinding
+    {
+        recum12::rfid::Pn532Reader* reader{nullptr};
+        recum12::hw::PumpSlotRef    slot{};
+        bool                        any_slot{false};  // setReader: genel okuyucu
+        // Okuması açık isteğin pompa/tabancası; core thread yazar, reader
+        // thread'i kart anında okur (ikisi de queueMtx_ altında)
+        recum12::hw::PumpSlotRef    target{};
+        // Kart bekleyen slot'lar, en eski önde (yalnızca core thread'i)
+        std::deque<recum12::hw::PumpSlotRef> waiting;
+    };
+
+    // Reader thread → core thread kuyruğundaki kart (hangi okuyucudan,
+    // okunduğu anda hangi slot için)
+    struct PendingCard
+    {
+        recum12::rfid::CardEvent ev;
+        std::size_t              binding{0};
+        recum12::hw::PumpSlotRef slot{};
+    };
+
     recum12::hw::PumpInterfaceLvl3* pump_{nullptr};
-    recum12::rfid::Pn532Reader*     reader_{nullptr};
+    std::vector<ReaderBinding>      readers_;
     UserManager*                    users_{nullptr};
+    QuotaEngine*                    quota_{nullptr};
+
+    std::atomic<bool> waiting_for_card_{false};
+
+    // Reader thread → core thread kart kuyruğu
+    static constexpr std::size_t kMaxPendingCards = 8;
+    std::mutex              queueMtx_;
+    std::condition_variable queueCv_;
+    std::deque<PendingCard> pending_;
 
-    bool waiting_for_card_{false};
+    mutable std::mutex      statsMtx_;
+    AuthLatencyStats        stats_{};
 
-    // Yetkili kart sonrası 10 sn boyunca yeni kart okuma isteğini engellemek için
-    bool card_cooldown_active_{false};
-    std::chrono::steady_clock::time_point card_cooldown_until_{};    
+    ReaderBinding* bindingFor(const recum12::hw::PumpSlotRef& slot);
+    void handleCard(const recum12::rfid::CardEvent& ev, const recum12::hw::PumpSlotRef& slot);
+    // Sıradaki bekleyen slot için okumayı açar (yoksa okuyucu boşta kalır)
+    void armNext(ReaderBinding& rb);
+    void recordLatency(std::chrono::microseconds us);
 };
 
 } // namespace recum12::core
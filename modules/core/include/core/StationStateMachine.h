@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace recum12::core {
+
+// İstasyonun (pompa + tabanca + kart yetkisi) tek hakikat durumu.
+// Tabanca konumu durumun parçasıdır; "nozzle out" ayrıca tutulmaz.
+enum class StationState : std::uint8_t {
+    Idle = 0,      // tabanca pompada, yetki yok
+    WaitingCard,   // tabanca dışarıda, kart bekleniyor
+    Authorized,    // kart yetkili, tabanca pompada
+    ReadyToFill,   // kart yetkili, tabanca dışarıda (dolum bekleniyor, 10 sn)
+    Filling,       // pompa FILLING
+    FillDone,      // dolum bitti, tabancanın pompaya dönmesi bekleniyor
+    Unauthorized,  // yetkisiz kart (3 sn uyarı), tabanca dışarıda
+    Count
+};
+
+// Makineye giren olaylar (pompa durumu, tabanca, kart sonucu, zamanlayıcılar).
+enum class StationEvent : std::uint8_t {
+    PumpIdle = 0,     // NotProgrammed / Reset / SwitchedOff / Suspended / Unknown
+    PumpAuthorized,
+    PumpFilling,
+    PumpFillDone,     // FillingCompleted / MaxAmount
+    NozzleOut,
+    NozzleIn,
+    AuthGranted,
+    AuthDenied,
+    FillWaitTimeout,  // yetki sonrası 10 sn içinde dolum başlamadı
+    UnauthTimeout,    // "Yetkisiz Kullanıcı" uyarısının 3 sn'si doldu
+    Count
+};
+
+// Geçişin çıktıları (bit maskesi). Store, GUI ve log katmanı durumu yeniden
+// türetmek yerine bu bitleri uygular.
+namespace StationAction {
+enum : std::uint16_t {
+    None             = 0,
+    StartFillWait    = 1u << 0,  // 10 sn dolum bekleme zamanlayıcısı
+    CancelFillWait   = 1u << 1,
+    StartUnauthTimer = 1u << 2,  // 3 sn "Yetkisiz Kullanıcı"
+    ClearAuth        = 1u << 3,  // store'daki kart/limit bilgisini düşür
+    ClearStatus      = 1u << 4,  // lblmsg kanallarını temizle
+    RequestCard      = 1u << 5,  // RFID okuma isteği
+    CancelCard       = 1u << 6,  // RFID okumayı iptal et
+    LogGunOn         = 1u << 7,  // usage log: GunOn_PC
+    LogGunOff        = 1u << 8,  // usage log: GunOff_PC
+    CloseSale        = 1u << 9,  // usage log: PumpOff_PC + sayaç/kota
+    ResetFillBaseline = 1u << 10 // yeni satış: hacim baseline'ını yeniden al
+};
+} // namespace StationAction
+
+// Tek bir geçiş kaydı (trace + üst katmana bildirim).
+struct StationTransition
+{
+    std::uint64_t                         seq{0};
+    std::chrono::steady_clock::time_point at{};
+    StationState                          from{StationState::Idle};
+    StationState                          to{StationState::Idle};
+    StationEvent                          event{StationEvent::PumpIdle};
+    std::uint16_t                         actions{StationAction::None};
+    std::uint8_t                          slot{0};  // pompa/tabanca slot'u (store doldurur)
+
+    bool changed() const noexcept { return from != to; }
+};
+
+// Derleme zamanında üretilen [durum][olay] tablosu ile çalışan istasyon
+// durum makinesi.
+//
+//  - dispatch() O(1): tek tablo okuması, heap tahsisi yok.
+//  - Tabloda tanımsız hücreler "yoksay" anlamına gelir (ör. eski bir
+//    zamanlayıcının geç gelen timeout'u); bu durumda actions=None döner.
+//  - Son kTraceSize geçiş sabit boyutlu bir halkada tutulur.
+//
+// Thread-safe değildir; sahibi (PumpRuntimeStore) kilitler.
+class StationStateMachine
+{
+public:
+    static constexpr std::size_t kTraceSize = 64;
+
+    StationStateMachine() = default;
+
+    StationState state() const noexcept { return state_; }
+
+    // Olayı uygular; kaydı döner (değişiklik yoksa from == to).
+    StationTransition dispatch(StationEvent ev,
+                               std::chrono::steady_clock::time_point now =
+                                   std::chrono::steady_clock::now()) noexcept;
+
+    // Idle'a döner ve trace'i temizler.
+    void reset() noexcept;
+
+    // En eskiden en yeniye trace kopyası; yazılan kayıt sayısını döner.
+    std::size_t copyTrace(StationTransition* out, std::size_t max) const noexcept;
+
+    // Toplam uygulanan (yoksayılanlar hariç) geçiş sayısı.
+    std::uint64_t transitionCount() const noexcept { return seq_; }
+
+    static const char* name(StationState s) noexcept;
+    static const char* name(StationEvent e) noexcept;
+
+    // Yardımcı sorgular (store'daki eski latch alanları bunlardan türetilir)
+    static bool saleActive(StationState s) noexcept
+    {
+        return s == StationState::Filling || s == StationState::FillDone;
+    }
+    static bool authHeld(StationState s) noexcept
+    {
+        return s == StationState::Authorized || s == StationState::ReadyToFill ||
+               s == StationState::Filling    || s == StationState::FillDone;
+    }
+
+private:
+    StationState                                state_{StationState::Idle};
+    std::uint64_t                               seq_{0};
+    std::array<StationTransition, kTraceSize>   trace_{};
+    std::size_t                                 traceHead_{0};  // sonraki yazma indeksi
+    std::size_t                                 traceCount_{0};
+};
+
+} // namespace recum12::core
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace recum12::core {
+
+// Zaman kaynağı. Üretimde SteadyClock, senaryo/saha simülasyonunda
+// VirtualClock enjekte edilir (24 saatlik vardiya milisaniyeler içinde
+// ileri sarılabilir).
+class Clock
+{
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+    using duration   = std::chrono::steady_clock::duration;
+
+    virtual ~Clock() = default;
+    virtual time_point now() const noexcept = 0;
+};
+
+class SteadyClock final : public Clock
+{
+public:
+    time_point now() const noexcept override { return std::chrono::steady_clock::now(); }
+};
+
+// Elle ilerletilen saat. advance() başka thread'den de çağrılabilir.
+class VirtualClock final : public Clock
+{
+public:
+    explicit VirtualClock(time_point start = time_point{})
+        : ticks_(start.time_since_epoch().count())
+    {
+    }
+
+    time_point now() const noexcept override
+    {
+        return time_point(duration(ticks_.load(std::memory_order_acquire)));
+    }
+
+    void advance(duration d) noexcept
+    {
+        ticks_.fetch_add(d.count(), std::memory_order_acq_rel);
+    }
+
+private:
+    std::atomic<duration::rep> ticks_;
+};
+
+// Hiyerarşik zamanlayıcı çarkı (4 seviye x 64 slot, 10 ms tick).
+//
+//  - schedule / scheduleEvery / cancel O(1): düğümler havuzdan gelir,
+//    slot listeleri intrusive çift bağlıdır.
+//  - Seviye sınırları: 0.64 s / 41 s / 43 dk / ~46 saat; daha uzun
+//    gecikmeler son seviyeye kırpılır.
+//  - advance(), saatin gösterdiği ana kadar vadesi gelen callback'leri
+//    çağırır. Callback içinden yeni zamanlayıcı kurmak/iptal etmek serbesttir.
+//
+// Thread-safe değildir: tüm çağrılar tek bir reactor thread'inden
+// (RS485/core worker) yapılmalıdır.
+class TimerWheel
+{
+public:
+    using Callback = std::function<void()>;
+    using duration = Clock::duration;
+
+    static constexpr std::chrono::milliseconds kTick{10};
+    static constexpr std::size_t kSlotBits = 6;
+    static constexpr std::size_t kSlots    = std::size_t{1} << kSlotBits;
+    static constexpr std::size_t kLevels   = 4;
+
+    struct TimerId
+    {
+        std::uint32_t index{0xFFFFFFFFu};
+        std::uint32_t gen{0};
+
+        bool valid() const noexcept { return index != 0xFFFFFFFFu; }
+    };
+
+    explicit TimerWheel(const Clock& clock);
+
+    TimerWheel(const TimerWheel&)            = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Tek seferlik zamanlayıcı (delay en az 1 tick'e yuvarlanır).
+    TimerId schedule(duration delay, Callback cb);
+
+    // Periyodik zamanlayıcı; ilk tetik period sonra.
+    TimerId scheduleEvery(duration period, Callback cb);
+
+    // Bekleyen zamanlayıcıyı iptal eder ve id'yi geçersiz kılar.
+    bool cancel(TimerId& id) noexcept;
+
+    bool pending(const TimerId& id) const noexcept;
+
+    // Vadesi gelenleri tetikler; tetiklenen callback sayısı.
+    std::size_t advance();
+
+    // Bir sonraki tetiğe kadar üst sınır (reactor bekleme süresi için).
+    // Zamanlayıcı yoksa fallback döner.
+    duration timeUntilNext(duration fallback) const noexcept;
+
+    std::size_t size() const noexcept { return active_; }
+
+    const Clock& clock() const noexcept { return clock_; }
+
+private:
+    static constexpr std::uint32_t kNil = 0xFFFFFFFFu;
+
+    struct Node
+    {
+        std::uint64_t expiry{0};   // mutlak tick
+        std::uint64_t period{0};   // 0 → tek seferlik
+        Callback      cb;
+        std::uint32_t prev{kNil};
+        std::uint32_t next{kNil};
+        std::uint32_t gen{0};
+        std::uint16_t bucket{0};   // level * kSlots + slot
+        bool          active{false};
+    };
+
+    std::uint64_t ticksFor(duration d) const noexcept;
+    std::uint64_t currentTick() const noexcept;
+    std::uint32_t allocNode();
+    void          freeNode(std::uint32_t idx) noexcept;
+    void          link(std::uint32_t idx) noexcept;
+    void          unlink(std::uint32_t idx) noexcept;
+    void          cascade(std::size_t level) noexcept;
+    std::size_t   fireSlot(std::size_t slot);
+
+    const Clock&                            clock_;
+    Clock::time_point                       origin_;
+    std::uint64_t                           nowTick_{0};
+    std::size_t                             active_{0};
+
+    std::deque<Node>                        nodes_;   // referanslar büyürken sabit kalır
+    std::vector<std::uint32_t>              free_;
+    std::array<std::uint32_t, kLevels * kSlots> heads_{};
+};
+
+} // namespace recum12::core
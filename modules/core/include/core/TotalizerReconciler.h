@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "utils/FixedPoint.h"
+
+namespace recum12::core {
+
+using recum12::utils::Volume;
+
+// İki totalizer okuması arasındaki mutabakat kalemi.
+struct ReconcileEntry
+{
+    std::int64_t  at_unix{0};     // ikinci okumanın zamanı
+    Volume        totalizer{};    // ikinci okuma
+    Volume        expected{};     // aradaki loglanmış satışlar
+    Volume        reported{};     // totalizer farkı
+    std::uint32_t sales{0};
+
+    Volume drift() const noexcept { return reported - expected; }
+};
+
+// Vardiya / dönem özeti (kümülatif toplamların farkı, O(1)).
+struct ReconcileReport
+{
+    std::int64_t  from_unix{0};
+    std::int64_t  to_unix{0};
+    Volume        expected{};
+    Volume        reported{};
+    std::uint64_t sales{0};
+    Volume        totalizer_open{};
+    Volume        totalizer_close{};
+
+    Volume drift() const noexcept { return reported - expected; }
+    double driftPercent() const noexcept
+    {
+        return expected.isPositive()
+                   ? 100.0 * static_cast<double>(drift().raw()) / static_cast<double>(expected.raw())
+                   : 0.0;
+    }
+};
+
+struct ReconcileConfig
+{
+    // Son kDriftWindow kalemde |drift| her iki eşiği de aşarsa sayaç kayması
+    Volume drift_abs{Volume::fromRaw(20)};  // 0.20 L
+    double drift_pct{0.5};                  // %
+};
+
+// Totalizer (CD101) okumalarını loglanan satışlarla karşılaştıran mutabakat
+// servisi.
+//
+//  - onSaleRecorded(): kapanan satışın litresi "beklenen"e eklenir (satış
+//    kapanışında, totalizer okumalarıyla aynı thread'den).
+//  - onTotals(): satış dışındaki her okuma bir kalem kapatır
+//    (beklenen vs. totalizer farkı). Kümülatif toplamlar tutulur; vardiya
+//    raporu bu toplamların farkıdır.
+//  - Kayma: son kDriftWindow kalemin toplam farkı eşikleri aşarsa onDrift.
+//  - Kalıcılık: her değişiklik tam çalışma durumunu içeren checksum'lı sabit
+//    uzunluklu bir checkpoint kaydı olarak eklenir (+fdatasync). Satış
+//    kapanışı yalnızca belleği günceller (store kilidi altında çağrılır);
+//    diske persistPending() ya da sonraki checkpoint yazar. Açılışta son
+//    geçerli kayıt kazanır, son kLedgerSize kalem defter olarak geri yüklenir;
+//    usage log yeniden taranmaz. Journal büyüyünce tmp + rename ile sıkıştırılır.
+//
+// Thread-safe; onTotals ve onSaleRecorded core thread'inden çağrılır (aynı
+// thread: kapanan satış, sonraki okumadan önce deftere girer).
+class TotalizerReconciler
+{
+public:
+    using Clock = std::chrono::system_clock;
+
+    static constexpr std::size_t kLedgerSize  = 256;
+    static constexpr std::size_t kDriftWindow = 32;
+
+    TotalizerReconciler() = default;
+    ~TotalizerReconciler();
+
+    TotalizerReconciler(const TotalizerReconciler&)            = delete;
+    TotalizerReconciler& operator=(const TotalizerReconciler&) = delete;
+
+    void setConfig(const ReconcileConfig& cfg);
+
+    // Checkpoint dosyasını açar/oluşturur ve son durumu yükler.
+    bool open(const std::string& path);
+    void close();
+
+    // Kapanan satış (PumpOff_PC satırına yazılacak litre). Disk I/O yapmaz.
+    void onSaleRecorded(Volume volume);
+
+    // Yazılmamış satışları checkpoint'ler (+fdatasync); kilit dışından,
+    // sonraki onTotals'tan önce çağrılmalı. Yazacak yoksa true.
+    bool persistPending();
+
+    // Totalizer okuması; sale_active iken okuma karşılaştırılmaz.
+    // Kalem kapandıysa true döner ve out doldurulur.
+    bool onTotals(Volume total, bool sale_active, ReconcileEntry* out = nullptr,
+                  Clock::time_point now = Clock::now());
+
+    // Açık vardiyanın (son closeShift'ten bu yana) özeti.
+    ReconcileReport shiftReport(Clock::time_point now = Clock::now()) const;
+
+    // Vardiyayı kapatır: özeti döner ve yeni vardiyayı başlatır.
+    ReconcileReport closeShift(Clock::time_point now = Clock::now());
+
+    // Defterin kopyası (eskiden yeniye); yazılan kalem sayısı.
+    std::size_t ledger(ReconcileEntry* out, std::size_t max) const;
+
+    // Son kDriftWindow kalemdeki toplam fark.
+    Volume recentDrift() const;
+
+    // Kayma eşiği aşıldığında (kenar tetiklemeli) çağrılır; kilit dışında.
+    std::function<void(const ReconcileReport&)> onDrift;
+
+private:
+    // Kalıcı çalışma durumu (checkpoint kaydının içeriği)
+    struct State
+    {
+        std::int64_t  totalizer_cl{0};
+        bool          has_totalizer{false};
+        std::int64_t  pending_expected_cl{0};   // son okumadan beri loglanan
+        std::uint32_t pending_sales{0};
+        std::int64_t  cum_expected_cl{0};
+        std::int64_t  cum_reported_cl{0};
+        std::uint64_t cum_sales{0};
+        // Vardiya başlangıcındaki kümülatifler
+        std::int64_t  shift_at{0};
+        std::int64_t  shift_expected_cl{0};
+        std::int64_t  shift_reported_cl{0};
+        std::uint64_t shift_sales{0};
+        std::int64_t  shift_totalizer_cl{0};
+    };
+
+    void pushLedger(const ReconcileEntry& e);
+    bool appendCheckpoint(const ReconcileEntry* e);
+    bool compact();
+    ReconcileReport reportLocked(std::int64_t now_unix) const;
+    bool driftExceededLocked() const;
+
+    mutable std::mutex                        mtx_;
+    ReconcileConfig                           cfg_{};
+    State                                     st_{};
+
+    std::array<ReconcileEntry, kLedgerSize>   ledger_{};
+    std::size_t                               ledgerHead_{0};
+    std::size_t                               ledgerCount_{0};
+    std::int64_t                              windowDriftCl_{0};  // son kDriftWindow kalem
+    bool                                      driftActive_{false};
+
+    std::string   path_;
+    int           fd_{-1};
+    std::size_t   journalRecords_{0};
+    bool          dirty_{false};  // checkpoint'e girmemiş satış var
+};
+
+} // namespace recum12::core
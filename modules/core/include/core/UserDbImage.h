@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/UserManager.h"
+
+namespace recum12::core {
+
+// users.csv kaynağının "parmak izi".
+// İmaj dosyası, derlendiği CSV'nin mtime/size/hash değerlerini saklar;
+// UserManager açılışta bu değerlere bakarak CSV'yi yeniden parse etmeden
+// doğrudan imajı kullanabilir.
+struct UserDbSourceStamp
+{
+    std::uint64_t mtime_ns{0};
+    std::uint64_t size{0};
+    std::uint64_t hash{0};   // FNV-1a 64 (CSV içeriği)
+};
+
+// users.csv'nin derlenmiş, salt-okunur (mmap) ikili imajı.
+//
+// Dosya düzeni (little-endian, Pi/x86 yerel sıra):
+//   [Header]
+//   [DiskRecord x record_count]   → rfid'ye göre sıralı (memcmp)
+//   [string pool]                 → uid (ham byte) / isim / plaka byte'ları
+//
+// Header ve payload ayrı FNV-1a checksum'larla korunur; versiyon/magic
+// uyuşmazsa imaj reddedilir ve CSV'ye geri düşülür.
+class UserDbImage
+{
+public:
+    static constexpr std::uint32_t kVersion = 2;   // v2: UID hex yerine ham byte
+
+    UserDbImage() = default;
+    ~UserDbImage();
+
+    UserDbImage(const UserDbImage&)            = delete;
+    UserDbImage& operator=(const UserDbImage&) = delete;
+    UserDbImage(UserDbImage&& other) noexcept;
+    UserDbImage& operator=(UserDbImage&& other) noexcept;
+
+    // Kullanıcı listesini imaja derler. Önce "<path>.tmp"e yazar, sonra
+    // rename ile atomik olarak yerine koyar.
+    static bool compile(const std::vector<UserRecord>& users,
+                        const UserDbSourceStamp&       stamp,
+                        const std::string&             imagePath);
+
+    // İmajı salt-okunur mmap eder; magic/versiyon/checksum doğrulanır.
+    bool open(const std::string& imagePath);
+    void close();
+    bool isOpen() const noexcept { return base_ != nullptr; }
+
+    const UserDbSourceStamp& stamp() const noexcept { return stamp_; }
+    std::size_t size() const noexcept { return count_; }
+
+    // Sıralı tabloda ikili arama (UID byte'ları üzerinde).
+    std::optional<UserRecord> findByRfid(const CardUid& uid) const;
+
+    // i. kaydı UserRecord olarak üretir (allUsers / debug için).
+    UserRecord recordAt(std::size_t i) const;
+
+    // FNV-1a 64 yardımcıları (CSV hash'i için de kullanılır).
+    static std::uint64_t fnv1a(const void* data, std::size_t len,
+                               std::uint64_t seed = 14695981039346656037ull) noexcept;
+
+private:
+    const std::uint8_t* base_{nullptr};
+    std::size_t         mapLen_{0};
+    std::size_t         count_{0};
+    const void*         records_{nullptr};
+    const char*         pool_{nullptr};
+    std::size_t         poolLen_{0};
+    UserDbSourceStamp   stamp_{};
+};
+
+} // namespace recum12::core
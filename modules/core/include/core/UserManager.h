@@ -2,12 +2,25 @@
 #define RECUM12_CORE_USERMANAGER_H
 
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <optional>
 
+#include "utils/CardUid.h"
+#include "utils/FixedPoint.h"
+
 namespace recum12::core {
 
+using recum12::utils::CardUid;
+using recum12::utils::Volume;
+
 // ReCUm10 UserManager şemasından türetilmiş sade kullanıcı modeli:
 // varsayılan users.csv header:
 //   userId,level,firstName,lastName,plate,limit_liters,rfid
@@ -20,32 +33,98 @@ struct UserRecord
     std::string plate;
     // Eski ReCUm10 uyumluluğu için int limit alanı:
     int         limit    = 0;
-    // Bu projede asıl kullanılan alan (litre cinsinden limit):
-    double      limit_liters {0.0};
-    std::string rfid;        // UPPER normalize edilmiş kart UID'si
+    // Bu projede asıl kullanılan alan (litre limiti, x100 sabit nokta):
+    Volume      limit_volume {};
+    CardUid     rfid;        // kart UID'si (CSV'de hex)
+};
+
+class UserDbImage;
+
+// users.csv yeniden yükleme metrikleri (hot-reload izleme/teşhis için).
+struct UserReloadMetrics
+{
+    std::uint64_t reload_count{0};     // başarılı yükleme sayısı (ilk yükleme dahil)
+    std::uint64_t reload_failures{0};  // başarısız yükleme denemeleri
+    double        last_reload_ms{0.0}; // son yüklemenin süresi
+    std::size_t   rows_loaded{0};      // son tablodaki kullanıcı sayısı
+    std::size_t   parse_errors{0};     // son CSV parse'ında atlanan/bozuk satır/alan
+    bool          last_from_image{false};
+    std::chrono::system_clock::time_point last_reload_at{};
 };
 
 class UserManager
 {
 public:
     UserManager();
+    ~UserManager();
+
+    UserManager(const UserManager&)            = delete;
+    UserManager& operator=(const UserManager&) = delete;
 
     // users.csv dosyasını yükler.
     // Başlık küçük-büyük harf duyarsız olarak çözülür, asgari:
     //   userId, level, firstName, lastName, plate, limit, rfid
+    //
+    // Önce CSV'nin yanındaki derlenmiş imaj (users.udb) denenir; imajın
+    // kaydettiği mtime/size (veya içerik hash'i) CSV ile uyuşuyorsa CSV
+    // hiç parse edilmeden imaj mmap edilir. Aksi halde CSV parse edilir ve
+    // imaj bir sonraki açılış için yeniden derlenir.
+    //
+    // Yeni tablo hazır olunca atomik shared_ptr swap ile yayınlanır; o anda
+    // çalışan findByRfid çağrıları eski tabloyu kullanmaya devam eder.
     bool loadUsers(const std::string& path);
 
-    const std::vector<UserRecord>& allUsers() const noexcept { return users_; }
+    // Tüm kullanıcıların anlık kopyası.
+    std::vector<UserRecord> allUsers() const;
+
+    // RFID kart UID'si ile kullanıcı bulur.
+    // Kilit almaz; arka planda reload sürerken de beklemeden döner.
+    std::optional<UserRecord> findByRfid(const CardUid& uid) const;
+
+    // Yayındaki tablo imajdan mı geldi? (teşhis/log için)
+    bool loadedFromImage() const;
 
-    // RFID kart UID'si (hex) ile kullanıcı bulur.
-    // Giriş case-insensitive; içerde UPPER normalize edilir.
-    std::optional<UserRecord> findByRfid(const std::string& uidHex) const;
+    // --- Hot-reload (inotify) ---
+
+    // loadUsers ile verilen dosyanın klasörünü inotify ile izler; dosya
+    // yazılıp kapatıldığında veya üzerine rename edildiğinde arka plan
+    // thread'inde tabloyu yeniden kurar. loadUsers'tan sonra çağrılmalı.
+    bool startWatching();
+    void stopWatching();
+
+    UserReloadMetrics metrics() const;
+
+    // Arka plan reload'u bittiğinde (başarılı/başarısız) watcher thread'inden çağrılır.
+    std::function<void(bool ok, const UserReloadMetrics&)> onReloaded;
+
+    // users.csv → users.udb yolu (aynı klasör, uzantı .udb).
+    static std::string imagePathFor(const std::string& csvPath);
+
+    // CSV'yi parse edip imaja derler (recum12_userdb aracı da bunu kullanır).
+    static bool compileUserDb(const std::string& csvPath,
+                              const std::string& imagePath,
+                              std::size_t*       rowCount = nullptr);
 
 private:
-    std::vector<UserRecord> users_;
-    std::string             path_;
+    struct Table;
+
+    // Yayındaki tablo: std::atomic_load/atomic_store ile erişilir.
+    std::shared_ptr<const Table> table_;
+
+    std::string                  path_;
+    std::mutex                   reloadMtx_;   // aynı anda tek rebuild
+
+    mutable std::mutex           metricsMtx_;
+    UserReloadMetrics            metrics_{};
+
+    // inotify watcher
+    int                          inotifyFd_{-1};
+    int                          wakeFd_{-1};   // stopWatching() için eventfd
+    std::atomic<bool>            watching_{false};
+    std::thread                  watchThread_;
 
-    static std::string normalize(const std::string& s);
+    bool reload(const std::string& path);
+    void watchLoop(std::string dir, std::string file);
 };
 
 } // namespace recum12::core
@@ -0,0 +1,144 @@
+#include "core/FlowAnomalyDetector.h"
+
+namespace recum12::core {
+
+namespace {
+
+// Yetki verilmiş ya da satış sürüyorsa hacim artışı meşrudur
+// (Authorized/ReadyToFill'de FILLING status'undan önce gelen DC2 dahil).
+bool flowAllowed(StationState st) noexcept
+{
+    return StationStateMachine::authHeld(st);
+}
+
+Volume absDiff(Volume a, Volume b) noexcept
+{
+    return (a > b) ? (a - b) : (b - a);
+}
+
+} // namespace
+
+bool FlowAnomalyDetector::raise(FlowAnomalyKind k, Volume observed, Volume expected,
+                                StationState st, time_point now, FlowAnomaly& out) noexcept
+{
+    const std::uint32_t bit = flowAnomalyBit(k);
+    if (active_ & bit) {
+        return false; // zaten raporlandı
+    }
+    active_ |= bit;
+
+    out.kind     = k;
+    out.at       = now;
+    out.observed = observed;
+    out.expected = expected;
+    out.station  = st;
+    return true;
+}
+
+bool FlowAnomalyDetector::onFill(Volume pump_volume, StationState st, bool pump_authorized,
+                                 time_point now, FlowAnomaly& out)
+{
+    const bool increased = have_fill_ && pump_volume > last_fill_;
+    if (!have_fill_ || pump_volume < last_fill_) {
+        // İlk okuma veya yeni satışta ekran sıfırlandı
+        unauth_base_ = pump_volume;
+    }
+    last_fill_ = pump_volume;
+    have_fill_ = true;
+
+    if (increased) {
+        last_activity_ = now;
+        clear(FlowAnomalyKind::StalledNozzle);
+    }
+
+    if (pump_authorized || flowAllowed(st)) {
+        unauth_base_ = pump_volume;
+        clear(FlowAnomalyKind::UnauthorizedDispense);
+        return false;
+    }
+
+    const Volume leaked = (pump_volume - unauth_base_).clampedNonNegative();
+    if (leaked > cfg_.tolerance) {
+        return raise(FlowAnomalyKind::UnauthorizedDispense, leaked, Volume{}, st, now, out);
+    }
+    return false;
+}
+
+bool FlowAnomalyDetector::onTotals(Volume total_volume, StationState st, time_point now,
+                                   FlowAnomaly& out)
+{
+    if (StationStateMachine::saleActive(st)) {
+        return false; // satış ortasında: kapanıştan sonraki okuma karşılaştırılır
+    }
+
+    if (!have_total_) {
+        last_total_         = total_volume;
+        have_total_         = true;
+        closed_since_total_ = Volume{};
+        return false;
+    }
+
+    const Volume delta    = total_volume - last_total_;
+    const Volume expected = closed_since_total_;
+
+    last_total_         = total_volume;
+    closed_since_total_ = Volume{};
+
+    if (absDiff(delta, expected) <= cfg_.tolerance) {
+        clear(FlowAnomalyKind::TotalizerJump);
+        clear(FlowAnomalyKind::SaleMismatch);
+        return false;
+    }
+
+    const FlowAnomalyKind k = expected.isZero() ? FlowAnomalyKind::TotalizerJump
+                                                : FlowAnomalyKind::SaleMismatch;
+    // Her tutarsız okuma ayrı bir olaydır (fark bir sonraki okumaya taşınmaz)
+    clear(k);
+    return raise(k, delta, expected, st, now, out);
+}
+
+void FlowAnomalyDetector::onSaleClosed(Volume sale_volume) noexcept
+{
+    closed_since_total_ += sale_volume.clampedNonNegative();
+}
+
+void FlowAnomalyDetector::onNozzle(bool nozzle_out, time_point now) noexcept
+{
+    if (nozzle_out && !nozzle_out_) {
+        last_activity_ = now;
+    }
+    if (!nozzle_out) {
+        clear(FlowAnomalyKind::StalledNozzle);
+    }
+    nozzle_out_ = nozzle_out;
+}
+
+bool FlowAnomalyDetector::tick(StationState st, time_point now, FlowAnomaly& out)
+{
+    if (!nozzle_out_ || cfg_.stall_timeout.count() <= 0) {
+        return false;
+    }
+    if (now - last_activity_ < cfg_.stall_timeout) {
+        return false;
+    }
+    return raise(FlowAnomalyKind::StalledNozzle, Volume{}, Volume{}, st, now, out);
+}
+
+void FlowAnomalyDetector::reset() noexcept
+{
+    const FlowAnomalyConfig cfg = cfg_;
+    *this = FlowAnomalyDetector(cfg);
+}
+
+const char* FlowAnomalyDetector::name(FlowAnomalyKind k) noexcept
+{
+    switch (k) {
+    case FlowAnomalyKind::UnauthorizedDispense: return "UnauthorizedDispense";
+    case FlowAnomalyKind::TotalizerJump:        return "TotalizerJump";
+    case FlowAnomalyKind::SaleMismatch:         return "SaleMismatch";
+    case FlowAnomalyKind::StalledNozzle:        return "StalledNozzle";
+    default:                                    return "?";
+    }
+}
+
+} // namespace recum12::core
@@ -3,182 +3,467 @@
 namespace core
 {
 
-const PumpRuntimeState& PumpRuntimeStore::state() const noexcept
+namespace
 {
-    return s_;
+
+StationEvent eventForPumpState(PumpState st)
+{
+    switch (st) {
+    case PumpState::Authorized:       return StationEvent::PumpAuthorized;
+    case PumpState::Filling:          return StationEvent::PumpFilling;
+    case PumpState::FillingCompleted:
+    case PumpState::MaxAmount:        return StationEvent::PumpFillDone;
+    default:                          return StationEvent::PumpIdle;
+    }
 }
 
-void PumpRuntimeStore::reset()
+} // namespace
+
+PumpRuntimeStore::PumpRuntimeStore()
+{
+    // Slot 0: varsayılan pompa (R07_DEFAULT_ADDR / nozzle-1)
+    ids_[0]                 = PumpSlotRef{};
+    slots_[0].s.slot        = ids_[0];
+    slots_[0].s.slot_index  = 0;
+}
+
+// ---------------------------------------------------------------------
+// Slot yönetimi
+// ---------------------------------------------------------------------
+
+std::size_t PumpRuntimeStore::addSlotLocked(const PumpSlotRef& ref)
+{
+    for (std::size_t i = 0; i < count_; ++i) {
+        if (ids_[i] == ref) {
+            return i;
+        }
+    }
+    if (count_ == kMaxSlots) {
+        return kNoSlot;
+    }
+
+    const std::size_t i = count_++;
+    ids_[i]   = ref;
+    slots_[i] = Slot{};
+    slots_[i].s.slot       = ref;
+    slots_[i].s.slot_index = static_cast<std::uint8_t>(i);
+    slots_[i].anomaly.setConfig(anomaly_cfg_);
+    return i;
+}
+
+PumpRuntimeStore::Slot* PumpRuntimeStore::routeLocked(const PumpSlotRef& ref)
 {
-    s_ = PumpRuntimeState{};
-    fill_baseline_volume_l_ = 0.0;
-    have_fill_baseline_     = false;
-    last_sale_volume_l_     = 0.0;
-    // limit alanları PumpRuntimeState default ctor'uyla zaten sıfırlanıyor
-    notifyStateChanged();
+    const std::size_t i = addSlotLocked(ref);
+    if (i == kNoSlot) {
+        ++dropped_;
+        return nullptr;
+    }
+    return &slots_[i];
 }
 
-void PumpRuntimeStore::updateFromPumpStatus(PumpState status)
+std::size_t PumpRuntimeStore::addSlot(const PumpSlotRef& ref)
 {
-    s_.pump_state = status;
+    std::lock_guard<std::mutex> lock(mtx_);
+    return addSlotLocked(ref);
+}
 
-    switch (status) {
-    case PumpState::Filling:
-        // FILLING'e girerken yeni satış için baseline'ı sıfırla
-        if (!s_.sale_active) {
-            have_fill_baseline_ = false;
-            last_sale_volume_l_ = 0.0;
+std::size_t PumpRuntimeStore::findSlot(const PumpSlotRef& ref) const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (std::size_t i = 0; i < count_; ++i) {
+        if (ids_[i] == ref) {
+            return i;
         }
-        s_.sale_active = true;
-        break;
+    }
+    return kNoSlot;
+}
 
-    case PumpState::FillingCompleted:
-    case PumpState::MaxAmount:
-        // Dolum tamamlandı; ancak satış, tabanca pompaya girene kadar
-        // aktif kalsın. sale_active latch'i nozzle OUT→IN geçişine taşındı.
-        break;
+std::size_t PumpRuntimeStore::slotCount() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return count_;
+}
+
+PumpSlotRef PumpRuntimeStore::slotRef(std::size_t slot) const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return (slot < count_) ? ids_[slot] : PumpSlotRef{};
+}
+
+bool PumpRuntimeStore::selectSlot(std::size_t slot)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (slot >= count_) {
+        return false;
+    }
+    selected_ = slot;
+    notifyStateChanged(slots_[slot]);
+    return true;
+}
+
+std::size_t PumpRuntimeStore::selectedSlot() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return selected_;
+}
+
+PumpRuntimeState PumpRuntimeStore::state() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return slots_[selected_].s;
+}
+
+PumpRuntimeState PumpRuntimeStore::state(std::size_t slot) const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return (slot < count_) ? slots_[slot].s : PumpRuntimeState{};
+}
+
+std::uint64_t PumpRuntimeStore::droppedEvents() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return dropped_;
+}
+
+void PumpRuntimeStore::reset()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (std::size_t i = 0; i < count_; ++i) {
+        Slot& sl = slots_[i];
+        // limit alanları PumpRuntimeState default ctor'uyla zaten sıfırlanıyor
+        sl.s = PumpRuntimeState{};
+        sl.s.slot       = ids_[i];
+        sl.s.slot_index = static_cast<std::uint8_t>(i);
+        sl.sm.reset();
+        sl.fill_baseline_volume = Volume{};
+        sl.have_fill_baseline   = false;
+        sl.last_sale_volume     = Volume{};
+        sl.flow.abort();
+        sl.last_flow_seq        = 0;
+        sl.anomaly.reset();
+        notifyStateChanged(sl);
+    }
+}
+
+// ---------------------------------------------------------------------
+// Olaylar
+// ---------------------------------------------------------------------
+
+void PumpRuntimeStore::applyEvent(Slot& sl, StationEvent ev)
+{
+    StationTransition tr = sl.sm.dispatch(ev);
+    if (tr.seq == 0) {
+        return; // tabloda tanımsız → yoksayıldı
+    }
+    tr.slot = sl.s.slot_index;
+
+    // Store'a ait aksiyonlar burada; GUI/log aksiyonları onStationTransition'da
+    if (tr.actions & StationAction::ResetFillBaseline) {
+        sl.have_fill_baseline = false;
+        sl.last_sale_volume   = Volume{};
+        sl.flow.begin();
+    }
+    if (tr.actions & StationAction::CloseSale) {
+        if (sl.flow.finish(sl.last_flow)) {
+            sl.last_flow_seq = tr.seq;
+        }
+        // Bir sonraki totalizer okuması bu satış kadar ilerlemeli
+        sl.anomaly.onSaleClosed(sl.last_sale_volume);
+    }
 
-    case PumpState::Reset:
-    case PumpState::SwitchedOff:
-        // Hard stop durumları: satış latch'ini burada da kapatmak güvenli.
-        s_.sale_active = false;
-        break;
+    sl.s.station     = tr.to;
+    sl.s.sale_active = StationStateMachine::saleActive(tr.to);
+    sl.s.auth_active = StationStateMachine::authHeld(tr.to) && sl.s.last_card_auth_ok &&
+                       !(tr.actions & StationAction::ClearAuth);
 
-    default:
-        // Diğer durumlarda latch'i olduğu gibi bırak
-        break;
+    // Kart bilgisi bildirimden sonra düşer: kapanan satışın satırları
+    // (PumpOff_PC, kota) o satışın kartıyla yazılır.
+    if (onStationTransition) {
+        onStationTransition(tr, sl.s);
+    }
+    if (tr.actions & StationAction::ClearAuth) {
+        clearAuthLocked(sl);
     }
+}
 
-    notifyStateChanged();
+void PumpRuntimeStore::updateFromPumpStatus(const PumpStatusEvent& ev)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Slot* sl = routeLocked(ev.slot);
+    if (!sl) {
+        return;
+    }
+    sl->s.pump_state = ev.state;
+    applyEvent(*sl, eventForPumpState(ev.state));
+    notifyStateChanged(*sl);
 }
 
 void PumpRuntimeStore::updateFromFill(const FillInfo& fill)
 {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Slot* slp = routeLocked(fill.slot);
+    if (!slp) {
+        return;
+    }
+    Slot&             sl = *slp;
+    PumpRuntimeState& s  = sl.s;
+
     // Ham FillInfo'yu sakla (genellikle totalizer seviyesi)
-    s_.last_fill = fill;
+    s.last_fill = fill;
+
+    FlowAnomaly anomaly{};
+    const bool pump_authorized = s.pump_state == PumpState::Authorized ||
+                                 s.pump_state == PumpState::Filling;
+    if (sl.anomaly.onFill(fill.volume, s.station, pump_authorized,
+                          std::chrono::steady_clock::now(), anomaly)) {
+        raiseAnomaly(sl, anomaly);
+    }
 
-    const double total = fill.volume_l;
+    const Volume total = fill.volume;
 
-    if (s_.sale_active) {
+    if (s.sale_active) {
         // İlk FillInfo geldiğinde baseline al
-        if (!have_fill_baseline_) {
-            fill_baseline_volume_l_ = total;
-            have_fill_baseline_     = true;
+        if (!sl.have_fill_baseline) {
+            sl.fill_baseline_volume = total;
+            sl.have_fill_baseline   = true;
         }
 
-        double cur = total - fill_baseline_volume_l_;
-        if (cur < 0.0) {
-            cur = 0.0;
-        }
+        // Tamsayı fark: BCD x100 değerler bire bir korunur (0.7/0.8 L kayması yok)
+        const Volume cur = (total - sl.fill_baseline_volume).clampedNonNegative();
 
-        s_.current_fill_volume_l = cur;
-        s_.has_current_fill      = true;
+        s.current_fill_volume = cur;
+        s.has_current_fill    = true;
+
+        // Akış profili (yalnızca hacmi değişen örnekler saklanır)
+        sl.flow.addSample(cur);
 
         // Son satışın litre miktarı
-        last_sale_volume_l_   = cur;
-        s_.last_fill_volume_l = cur;
-        s_.has_last_fill      = true;
-
-
-        // Limit takibi: limit_liters > 0 ise kalan litreyi hesapla
-        if (s_.limit_liters > 0.0) {
-            double remaining = s_.limit_liters - last_sale_volume_l_;
-            if (remaining < 0.0) {
-                remaining = 0.0;
-            }
-            s_.remaining_limit_liters = remaining;
+        sl.last_sale_volume = cur;
+        s.last_fill_volume  = cur;
+        s.has_last_fill     = true;
+
+
+        // Limit takibi: limit > 0 ise kalan litreyi hesapla
+        if (s.limit_volume.isPositive()) {
+            s.remaining_limit_volume =
+                (s.limit_volume - sl.last_sale_volume).clampedNonNegative();
         } else {
-            s_.remaining_limit_liters = 0.0;
+            s.remaining_limit_volume = Volume{};
         }
     } else {
         // Aktif satış yokken gelen FillInfo'lar:
-        // current_fill'i sıfırda tut, last_fill_volume_l önceki satış miktarı olsun.
-        s_.current_fill_volume_l = 0.0;
-        s_.has_current_fill      = false;
-        // s_.last_fill_volume_l / has_last_fill'e dokunmuyoruz.
+        // current_fill'i sıfırda tut, last_fill_volume önceki satış miktarı olsun.
+        s.current_fill_volume = Volume{};
+        s.has_current_fill    = false;
+        // s.last_fill_volume / has_last_fill'e dokunmuyoruz.
         // Aktif satış yokken:
         //  - limit tanımlıysa (has_limit) kalan limit = tam limit
-        //  - aksi halde 0.0
-        if (s_.has_limit) {
-            s_.remaining_limit_liters = s_.limit_liters;
+        //  - aksi halde 0
+        if (s.has_limit) {
+            s.remaining_limit_volume = s.limit_volume;
         } else {
-            s_.remaining_limit_liters = 0.0;
+            s.remaining_limit_volume = Volume{};
         }
     }
 
-    notifyStateChanged();
+    s.anomaly_flags = sl.anomaly.activeMask();
+    notifyStateChanged(sl);
 }
 
 void PumpRuntimeStore::updateFromTotals(const TotalCounters& totals)
 {
-    s_.totals = totals;
-    notifyStateChanged();
+    std::lock_guard<std::mutex> lock(mtx_);
+    Slot* sl = routeLocked(totals.slot);
+    if (!sl) {
+        return;
+    }
+    sl->s.totals = totals;
+
+    FlowAnomaly anomaly{};
+    if (sl->anomaly.onTotals(totals.total_volume, sl->s.station,
+                             std::chrono::steady_clock::now(), anomaly)) {
+        raiseAnomaly(*sl, anomaly);
+    }
+    sl->s.anomaly_flags = sl->anomaly.activeMask();
+    notifyStateChanged(*sl);
 }
 
 void PumpRuntimeStore::updateFromNozzle(const NozzleEvent& ev)
 {
-    const bool prev_nozzle_out = s_.nozzle_out;
-    s_.nozzle_out = ev.nozzle_out;
-
-    // Nozzle OUT → IN geçişi:
-    //  - Dolum döngüsü kapanıyor kabul edip current_fill'i sıfırla.
-    //  - Artık satış latch'ini de burada kapat (resmi litre son 3x02 frame'lerinden
-    //    gelmiş olacak).
-    if (prev_nozzle_out && !s_.nozzle_out) {
-        s_.current_fill_volume_l = 0.0;
-        s_.has_current_fill      = false;
-        // Bir sonraki satışta yeniden baseline alınacak
-        have_fill_baseline_      = false;
-
-        // Satış burada bitti kabul ediliyor; sale_active latch'ini kapat.
-        s_.sale_active = false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    Slot* slp = routeLocked(ev.slot);
+    if (!slp) {
+        return;
+    }
+    Slot&             sl = *slp;
+    PumpRuntimeState& s  = sl.s;
+
+    const bool prev_nozzle_out = s.nozzle_out;
+    s.nozzle_out = ev.nozzle_out;
+    sl.anomaly.onNozzle(ev.nozzle_out, std::chrono::steady_clock::now());
+    s.anomaly_flags = sl.anomaly.activeMask();
+
+    // Seviye değişmediyse (tekrarlanan frame) olay üretme
+    if (prev_nozzle_out != s.nozzle_out) {
+        if (!s.nozzle_out) {
+            // Nozzle OUT → IN: dolum döngüsü kapanıyor, current_fill'i sıfırla.
+            // Satışın kapanışı (CloseSale) durum makinesinin çıktısıdır.
+            s.current_fill_volume = Volume{};
+            s.has_current_fill    = false;
+            // Bir sonraki satışta yeniden baseline alınacak
+            sl.have_fill_baseline = false;
+        }
+        applyEvent(sl, s.nozzle_out ? StationEvent::NozzleOut : StationEvent::NozzleIn);
     }
 
-    notifyStateChanged();
+    notifyStateChanged(sl);
 }
 
 void PumpRuntimeStore::updateFromRfidAuth(const AuthContext& auth)
 {
-    s_.last_card_uid       = auth.uid_hex;
-    s_.last_card_user_id   = auth.user_id;
-    s_.last_card_plate     = auth.plate;
-    s_.last_card_auth_ok   = auth.authorized;
-    s_.auth_active         = auth.authorized;
+    std::lock_guard<std::mutex> lock(mtx_);
+    Slot* slp = routeLocked(auth.slot);
+    if (!slp) {
+        return;
+    }
+    PumpRuntimeState& s = slp->s;
+
+    s.last_card_uid       = auth.uid;
+    s.last_card_user_id   = auth.user_id;
+    s.last_card_plate     = auth.plate;
+    s.last_card_auth_ok   = auth.authorized;
 
     // Karttan gelen limit bilgisini store'a taşı
-    s_.limit_liters = auth.limit_liters;
-    s_.has_limit    = (auth.limit_liters > 0.0);
+    s.limit_volume = auth.limit_volume;
+    s.has_limit    = auth.limit_volume.isPositive();
 
     // Yeni AUTH sonrası, henüz satış başlamadığı için kalan limit = tam limit
-    if (s_.has_limit) {
-        s_.remaining_limit_liters = s_.limit_liters;
+    if (s.has_limit) {
+        s.remaining_limit_volume = s.limit_volume;
     } else {
-        s_.remaining_limit_liters = 0.0;
+        s.remaining_limit_volume = Volume{};
+    }
+
+    applyEvent(*slp, auth.authorized ? StationEvent::AuthGranted : StationEvent::AuthDenied);
+    notifyStateChanged(*slp);
+}
+
+void PumpRuntimeStore::dispatch(std::size_t slot, StationEvent ev)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (slot >= count_) {
+        return;
+    }
+    Slot& sl = slots_[slot];
+    const std::uint64_t before = sl.sm.transitionCount();
+    applyEvent(sl, ev);
+    if (sl.sm.transitionCount() != before) {
+        notifyStateChanged(sl);
+    }
+}
+
+void PumpRuntimeStore::checkFlowAnomalies()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    const auto now = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count_; ++i) {
+        Slot& sl = slots_[i];
+        FlowAnomaly anomaly{};
+        if (sl.anomaly.tick(sl.s.station, now, anomaly)) {
+            raiseAnomaly(sl, anomaly);
+            notifyStateChanged(sl);
+        }
     }
+}
 
-    notifyStateChanged();
+void PumpRuntimeStore::setFlowAnomalyConfig(const FlowAnomalyConfig& cfg)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    anomaly_cfg_ = cfg;
+    for (auto& sl : slots_) {
+        sl.anomaly.setConfig(cfg);
+    }
 }
 
 void PumpRuntimeStore::clearAuth()
 {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Slot& sl = slots_[selected_];
+    clearAuthLocked(sl);
+    notifyStateChanged(sl);
+}
+
+void PumpRuntimeStore::clearAuthLocked(Slot& sl)
+{
+    PumpRuntimeState& s = sl.s;
+
     // AUTH latch'ini kapat, son kartı "yetkisiz" say.
-    s_.auth_active       = false;
-    s_.last_card_auth_ok = false;
+    s.auth_active       = false;
+    s.last_card_auth_ok = false;
 
     // Limit bilgisini de sıfırla
-    s_.limit_liters            = 0.0;
-    s_.has_limit               = false;
-    s_.remaining_limit_liters  = 0.0;
+    s.limit_volume            = Volume{};
+    s.has_limit               = false;
+    s.remaining_limit_volume  = Volume{};
     // (uid / user_id / plate alanlarını şimdilik koruyoruz;
     //  GUI tarafı plaka label'ını zaten kendisi "-------" yapıyor.)
+}
+
+bool PumpRuntimeStore::takeFlowProfile(std::size_t slot, std::uint64_t close_seq,
+                                       FlowProfile& out)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (slot >= count_) {
+        return false;
+    }
+    Slot& sl = slots_[slot];
+    if (sl.last_flow_seq == 0 || sl.last_flow_seq != close_seq) {
+        return false;
+    }
+    out              = std::move(sl.last_flow);
+    sl.last_flow     = FlowProfile{};
+    sl.last_flow_seq = 0;
+    return true;
+}
+
+std::size_t PumpRuntimeStore::stationTrace(StationTransition* out, std::size_t max) const
+{
+    std::size_t slot = 0;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        slot = selected_;
+    }
+    return stationTrace(slot, out, max);
+}
 
-    notifyStateChanged();
+std::size_t PumpRuntimeStore::stationTrace(std::size_t slot, StationTransition* out,
+                                           std::size_t max) const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (slot >= count_) {
+        return 0;
+    }
+    // Makinenin kendi trace'i slot bilmez; kopyada işaretlenir
+    const std::size_t n = slots_[slot].sm.copyTrace(out, max);
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i].slot = static_cast<std::uint8_t>(slot);
+    }
+    return n;
+}
+
+void PumpRuntimeStore::raiseAnomaly(Slot& sl, FlowAnomaly& a)
+{
+    a.slot = sl.s.slot_index;
+    sl.s.anomaly_flags = sl.anomaly.activeMask();
+    if (onFlowAnomaly) {
+        onFlowAnomaly(a);
+    }
 }
 
-void PumpRuntimeStore::notifyStateChanged()
+void PumpRuntimeStore::notifyStateChanged(const Slot& sl)
 {
     if (onStateChanged) {
-        onStateChanged(s_);
+        onStateChanged(sl.s);
     }
 }
 
@@ -1,7 +1,362 @@
 #include "core/PumpSaleTracker.h"
+#include "core/UserDbImage.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace recum12::core {
 
-// Şimdilik boş
+namespace {
+
+constexpr char        kMagic[4] = {'R', 'F', 'P', '1'};
+constexpr std::size_t kFrameOverhead = sizeof(kMagic) + sizeof(std::uint32_t) + sizeof(std::uint64_t);
+// Tek kayıt için makul üst sınır (kMaxSamples * en kötü örnek boyu + metin)
+constexpr std::uint32_t kMaxBody = 1u << 20;
+
+// Peak debi için en kısa pencere (DC2 frame'leri arası jitter'ı yumuşatır)
+constexpr std::uint32_t kPeakWindowMs = 1000;
+
+void putVarint(std::vector<std::uint8_t>& out, std::uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+bool getVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint64_t& v)
+{
+    v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (p == end) {
+            return false;
+        }
+        const std::uint8_t b = *p++;
+        v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::uint64_t zigzag(std::int64_t v)
+{
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t v)
+{
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+void putString(std::vector<std::uint8_t>& out, const std::string& s)
+{
+    putVarint(out, s.size());
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+bool getString(const std::uint8_t*& p, const std::uint8_t* end, std::string& s)
+{
+    std::uint64_t n = 0;
+    if (!getVarint(p, end, n) || n > static_cast<std::uint64_t>(end - p)) {
+        return false;
+    }
+    s.assign(reinterpret_cast<const char*>(p), static_cast<std::size_t>(n));
+    p += n;
+    return true;
+}
+
+bool writeAll(int fd, const void* data, std::size_t len)
+{
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    while (len > 0) {
+        const ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p   += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+double ratePerMinute(std::int64_t centiliters, std::uint32_t ms)
+{
+    if (ms == 0) {
+        return 0.0;
+    }
+    return (static_cast<double>(centiliters) / Volume::kScale) * 60000.0 / ms;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------
+// Kayıt
+// ---------------------------------------------------------------------
+
+void PumpSaleTracker::begin(SteadyTime now, WallTime wall)
+{
+    active_ = true;
+    start_  = now;
+
+    cur_.sale_ref.clear();
+    cur_.rfid = CardUid{};
+    cur_.start_unix_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             wall.time_since_epoch()).count();
+    cur_.samples.clear();
+    cur_.samples.reserve(256);
+}
+
+void PumpSaleTracker::addSample(Volume volume, SteadyTime now)
+{
+    if (!active_) {
+        return;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_);
+    const std::uint32_t t_ms =
+        (elapsed.count() > 0) ? static_cast<std::uint32_t>(elapsed.count()) : 0;
+
+    auto& s = cur_.samples;
+    if (!s.empty() && s.back().volume == volume) {
+        return; // tekrarlanan frame / duraklama: sadece değişimler saklanır
+    }
+    if (s.size() >= kMaxSamples) {
+        s.back() = FlowSample{t_ms, volume};
+        return;
+    }
+    s.push_back(FlowSample{t_ms, volume});
+}
 
+bool PumpSaleTracker::finish(FlowProfile& out)
+{
+    if (!active_) {
+        return false;
+    }
+    active_ = false;
+    out = std::move(cur_);
+    cur_ = FlowProfile{};
+    return true;
 }
+
+// ---------------------------------------------------------------------
+// Kodlama
+// ---------------------------------------------------------------------
+
+void PumpSaleTracker::encode(const FlowProfile& p, std::vector<std::uint8_t>& out)
+{
+    out.clear();
+
+    std::vector<std::uint8_t> body;
+    body.reserve(32 + p.sale_ref.size() + 2 * p.rfid.size() + p.samples.size() * 3);
+
+    putString(body, p.sale_ref);
+    putString(body, p.rfid.toHex());
+    putVarint(body, zigzag(p.start_unix_ms));
+    putVarint(body, p.samples.size());
+
+    std::uint32_t prev_t  = 0;
+    std::int64_t  prev_cl = 0;
+    for (const auto& s : p.samples) {
+        // Zaman monoton; hacim normalde artar ama sayaç sıfırlanabilir → zigzag
+        const std::uint32_t dt = (s.t_ms >= prev_t) ? (s.t_ms - prev_t) : 0;
+        putVarint(body, dt);
+        putVarint(body, zigzag(s.volume.raw() - prev_cl));
+        prev_t += dt;
+        prev_cl = s.volume.raw();
+    }
+
+    const std::uint32_t len = static_cast<std::uint32_t>(body.size());
+    const std::uint64_t sum = UserDbImage::fnv1a(body.data(), body.size());
+
+    out.reserve(kFrameOverhead + body.size());
+    out.insert(out.end(), std::begin(kMagic), std::end(kMagic));
+    for (unsigned i = 0; i < 4; ++i) {
+        out.push_back(static_cast<std::uint8_t>(len >> (8 * i)));
+    }
+    out.insert(out.end(), body.begin(), body.end());
+    for (unsigned i = 0; i < 8; ++i) {
+        out.push_back(static_cast<std::uint8_t>(sum >> (8 * i)));
+    }
+}
+
+bool PumpSaleTracker::decode(const std::uint8_t* data, std::size_t len, FlowProfile& out)
+{
+    const std::uint8_t*       p   = data;
+    const std::uint8_t* const end = data + len;
+
+    out = FlowProfile{};
+
+    std::uint64_t v = 0;
+    std::string   rfid;
+    if (!getString(p, end, out.sale_ref) || !getString(p, end, rfid) ||
+        !CardUid::parseHex(rfid, out.rfid) || !getVarint(p, end, v)) {
+        return false;
+    }
+    out.start_unix_ms = unzigzag(v);
+
+    std::uint64_t n = 0;
+    // Her örnek en az 2 byte → sahte büyük n ile tahsis yapma
+    if (!getVarint(p, end, n) || n > static_cast<std::uint64_t>(end - p) / 2) {
+        return false;
+    }
+    out.samples.reserve(static_cast<std::size_t>(n));
+
+    std::uint64_t t  = 0;
+    std::int64_t  cl = 0;
+    for (std::uint64_t i = 0; i < n; ++i) {
+        std::uint64_t dt = 0, dv = 0;
+        if (!getVarint(p, end, dt) || !getVarint(p, end, dv)) {
+            return false;
+        }
+        t  += dt;
+        cl += unzigzag(dv);
+        out.samples.push_back(FlowSample{static_cast<std::uint32_t>(t), Volume::fromRaw(cl)});
+    }
+    return p == end;
+}
+
+// ---------------------------------------------------------------------
+// Dosya
+// ---------------------------------------------------------------------
+
+bool PumpSaleTracker::append(const std::string& path, const FlowProfile& p)
+{
+    std::vector<std::uint8_t> frame;
+    encode(p, frame);
+
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = writeAll(fd, frame.data(), frame.size());
+    if (ok) {
+        ok = (::fdatasync(fd) == 0);
+    }
+    ::close(fd);
+    return ok;
+}
+
+bool PumpSaleTracker::loadAll(const std::string& path, std::vector<FlowProfile>& out)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    const std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(in)),
+                                         std::istreambuf_iterator<char>());
+
+    std::size_t off = 0;
+    while (off + kFrameOverhead <= data.size()) {
+        if (std::memcmp(data.data() + off, kMagic, sizeof(kMagic)) != 0) {
+            // Senkron kaybı: bir sonraki magic'e ilerle
+            ++off;
+            continue;
+        }
+
+        std::uint32_t len = 0;
+        for (unsigned i = 0; i < 4; ++i) {
+            len |= static_cast<std::uint32_t>(data[off + 4 + i]) << (8 * i);
+        }
+        if (len > kMaxBody || off + kFrameOverhead + len > data.size()) {
+            break; // yarım yazılmış son kayıt
+        }
+
+        const std::uint8_t* body = data.data() + off + 8;
+        std::uint64_t sum = 0;
+        for (unsigned i = 0; i < 8; ++i) {
+            sum |= static_cast<std::uint64_t>(body[len + i]) << (8 * i);
+        }
+
+        FlowProfile p;
+        if (sum == UserDbImage::fnv1a(body, len) && decode(body, len, p)) {
+            out.push_back(std::move(p));
+            off += kFrameOverhead + len;
+        } else {
+            ++off;
+        }
+    }
+    return true;
+}
+
+bool PumpSaleTracker::find(const std::string& path, const std::string& sale_ref,
+                           const CardUid& rfid, FlowProfile& out)
+{
+    std::vector<FlowProfile> all;
+    if (!loadAll(path, all)) {
+        return false;
+    }
+    // Aynı saniyede iki kapanış olasılığına karşı en yeni kayıt kazanır
+    for (auto it = all.rbegin(); it != all.rend(); ++it) {
+        if (it->sale_ref == sale_ref && (rfid.empty() || it->rfid == rfid)) {
+            out = std::move(*it);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------
+// Analiz
+// ---------------------------------------------------------------------
+
+FlowSummary PumpSaleTracker::analyze(const FlowProfile& p, std::uint32_t pause_ms)
+{
+    FlowSummary r{};
+    const auto& s = p.samples;
+    if (s.empty()) {
+        return r;
+    }
+
+    r.total       = s.back().volume;
+    r.duration_ms = s.back().t_ms - s.front().t_ms;
+
+    std::uint32_t paused_ms = 0;
+    for (std::size_t i = 1; i < s.size(); ++i) {
+        const std::uint32_t gap = s[i].t_ms - s[i - 1].t_ms;
+        if (gap >= pause_ms) {
+            r.pauses.push_back(FlowPause{s[i - 1].t_ms, gap});
+            paused_ms += gap;
+        }
+    }
+    r.flowing_ms = r.duration_ms - paused_ms;
+
+    // Ortalama: ilk örnekten son örneğe akan miktar / akış süresi
+    const std::int64_t flowed_cl = s.back().volume.raw() - s.front().volume.raw();
+    r.avg_rate_lpm = ratePerMinute(flowed_cl, r.flowing_ms);
+
+    // Peak: duraklama içermeyen, en az kPeakWindowMs'lik pencereler
+    std::size_t lo = 0;
+    for (std::size_t hi = 1; hi < s.size(); ++hi) {
+        if (s[hi].t_ms - s[hi - 1].t_ms >= pause_ms) {
+            lo = hi;
+            continue;
+        }
+        while (lo + 1 < hi && s[hi].t_ms - s[lo + 1].t_ms >= kPeakWindowMs) {
+            ++lo;
+        }
+        const std::uint32_t span = s[hi].t_ms - s[lo].t_ms;
+        if (span >= kPeakWindowMs) {
+            const double rate = ratePerMinute(s[hi].volume.raw() - s[lo].volume.raw(), span);
+            if (rate > r.peak_rate_lpm) {
+                r.peak_rate_lpm = rate;
+            }
+        }
+    }
+    if (r.peak_rate_lpm < r.avg_rate_lpm) {
+        r.peak_rate_lpm = r.avg_rate_lpm;
+    }
+    return r;
+}
+
+} // namespace recum12::core
@@ -0,0 +1,430 @@
+#include "core/QuotaEngine.h"
+#include "core/UserDbImage.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/InfraLog.h"
+
+namespace recum12::core {
+
+namespace {
+
+constexpr char          kMagic[8]  = {'R', 'C', 'U', 'M', 'Q', 'T', 'A', '\0'};
+constexpr std::uint32_t kVersion   = 1;
+
+struct DiskHeader
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t record_size;
+};
+
+// Bir anahtarın (kullanıcı/plaka) tam durumu; journal'a olduğu gibi eklenir.
+struct DiskRecord
+{
+    std::uint64_t key;
+    std::uint32_t period[3];
+    std::uint32_t reserved;
+    std::int64_t  consumed_cl[3];
+    std::uint64_t checksum;       // bu alan hariç kayıt
+};
+
+static_assert(sizeof(DiskHeader) == 16, "DiskHeader layout degisti");
+static_assert(sizeof(DiskRecord) == 56, "DiskRecord layout degisti");
+
+std::uint64_t recordChecksum(const DiskRecord& r)
+{
+    return UserDbImage::fnv1a(&r, offsetof(DiskRecord, checksum));
+}
+
+// 1970-01-01'den itibaren gün sayısı (proleptik Gregoryen, H. Hinnant).
+std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d)
+{
+    y -= (m <= 2) ? 1 : 0;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+bool writeAll(int fd, const void* data, std::size_t len)
+{
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    while (len > 0) {
+        const ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p   += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+QuotaEngine::~QuotaEngine()
+{
+    close();
+}
+
+void QuotaEngine::setPolicy(const QuotaPolicy& policy)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    policy_ = policy;
+}
+
+QuotaPolicy QuotaEngine::policy() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return policy_;
+}
+
+QuotaEngine::Periods QuotaEngine::periodsFor(Clock::time_point now)
+{
+    const std::time_t t = Clock::to_time_t(now);
+    std::tm lt{};
+    localtime_r(&t, &lt);
+
+    const std::int64_t days =
+        daysFromCivil(lt.tm_year + 1900,
+                      static_cast<unsigned>(lt.tm_mon + 1),
+                      static_cast<unsigned>(lt.tm_mday));
+
+    Periods p{};
+    p.id[static_cast<std::size_t>(QuotaWindow::Daily)]   = static_cast<std::uint32_t>(days);
+    // 1970-01-01 Perşembe → +3 ile haftalar Pazartesi'den başlar.
+    p.id[static_cast<std::size_t>(QuotaWindow::Weekly)]  = static_cast<std::uint32_t>((days + 3) / 7);
+    p.id[static_cast<std::size_t>(QuotaWindow::Monthly)] =
+        static_cast<std::uint32_t>((lt.tm_year + 1900) * 12 + lt.tm_mon);
+    return p;
+}
+
+std::uint64_t QuotaEngine::userKey(int userId) noexcept
+{
+    // Üst bit 1 → kullanıcı anahtarı
+    return (1ull << 63) | static_cast<std::uint32_t>(userId);
+}
+
+std::uint64_t QuotaEngine::plateKey(const std::string& plate) noexcept
+{
+    // Plakayı boşluk/büyük-küçük harf farkından bağımsız hash'le; üst bit 0.
+    std::uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : plate) {
+        if (c == ' ' || c == '-') {
+            continue;
+        }
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<unsigned char>(c - 'a' + 'A');
+        }
+        h = UserDbImage::fnv1a(&c, 1, h);
+    }
+    return h & ~(1ull << 63);
+}
+
+Volume QuotaEngine::limitFor(QuotaWindow w, Volume user_limit) const noexcept
+{
+    switch (w) {
+    case QuotaWindow::Daily:
+        // Kullanıcı limiti günlük kota: politika limiti de varsa küçüğü
+        if (policy_.user_limit_daily && user_limit.isPositive() &&
+            (!policy_.daily.isPositive() || user_limit < policy_.daily)) {
+            return user_limit;
+        }
+        return policy_.daily;
+    case QuotaWindow::Weekly:  return policy_.weekly;
+    case QuotaWindow::Monthly: return policy_.monthly;
+    default:                   return Volume{};
+    }
+}
+
+bool QuotaEngine::open(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    buckets_.clear();
+    journalRecords_ = 0;
+    path_ = path;
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0) {
+        return false;
+    }
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(st.st_size));
+    std::size_t got = 0;
+    while (got < data.size()) {
+        const ssize_t n = ::pread(fd_, data.data() + got, data.size() - got,
+                                  static_cast<off_t>(got));
+        if (n <= 0) {
+            break;
+        }
+        got += static_cast<std::size_t>(n);
+    }
+    data.resize(got);
+
+    DiskHeader h{};
+    if (data.size() < sizeof(h) ||
+        (std::memcpy(&h, data.data(), sizeof(h)),
+         std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 ||
+         h.version != kVersion || h.record_size != sizeof(DiskRecord))) {
+        // Boş veya tanınmayan dosya → sıfırdan başla.
+        DiskHeader fresh{};
+        std::memcpy(fresh.magic, kMagic, sizeof(kMagic));
+        fresh.version     = kVersion;
+        fresh.record_size = sizeof(DiskRecord);
+        if (::ftruncate(fd_, 0) != 0 || !writeAll(fd_, &fresh, sizeof(fresh))) {
+            return false;
+        }
+        ::fdatasync(fd_);
+        return true;
+    }
+
+    // Journal'ı baştan oynat: her anahtar için son geçerli kayıt kazanır.
+    std::size_t off = sizeof(DiskHeader);
+    while (off + sizeof(DiskRecord) <= data.size()) {
+        DiskRecord r{};
+        std::memcpy(&r, data.data() + off, sizeof(r));
+        if (r.checksum != recordChecksum(r)) {
+            break; // yarım/bozuk kayıt → buradan sonrasını at
+        }
+        Bucket& b = buckets_[r.key];
+        for (std::size_t w = 0; w < kWindows; ++w) {
+            b.period[w]      = r.period[w];
+            b.consumed_cl[w] = r.consumed_cl[w];
+        }
+        ++journalRecords_;
+        off += sizeof(DiskRecord);
+    }
+
+    if (off != data.size()) {
+        // Torn write: son bozuk kaydı kes.
+        if (::ftruncate(fd_, static_cast<off_t>(off)) == 0) {
+            ::fdatasync(fd_);
+        }
+    }
+
+    // Journal anahtar sayısına göre çok büyüdüyse açılışta sıkıştır.
+    if (journalRecords_ > 4 * buckets_.size() + 256) {
+        compact();
+    }
+    return true;
+}
+
+void QuotaEngine::close()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void QuotaEngine::evaluate(const Bucket* b, const Periods& p, Volume user_limit,
+                           QuotaDecision& d) const
+{
+    for (std::size_t w = 0; w < kWindows; ++w) {
+        const auto win   = static_cast<QuotaWindow>(w);
+        const auto limit = limitFor(win, user_limit);
+        if (!limit.isPositive()) {
+            continue;
+        }
+
+        const Volume used = Volume::fromRaw(
+            (b && b->period[w] == p.id[w]) ? b->consumed_cl[w] : 0);
+        const Volume remaining = (limit - used).clampedNonNegative();
+
+        if (!d.limited || remaining < d.remaining) {
+            d.limited         = true;
+            d.remaining       = remaining;
+            d.limiting_window = win;
+        }
+    }
+    if (d.limited && !d.remaining.isPositive()) {
+        d.allowed = false;
+    }
+}
+
+QuotaDecision QuotaEngine::check(int userId, const std::string& plate, Volume user_limit,
+                                 Clock::time_point now) const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    QuotaDecision d{};
+    if (policy_.unlimited() && !(policy_.user_limit_daily && user_limit.isPositive())) {
+        return d;
+    }
+
+    const Periods p = periodsFor(now);
+
+    auto find = [this](std::uint64_t key) -> const Bucket* {
+        auto it = buckets_.find(key);
+        return (it != buckets_.end()) ? &it->second : nullptr;
+    };
+
+    evaluate(find(userKey(userId)), p, user_limit, d);
+    if (policy_.per_plate && !plate.empty()) {
+        evaluate(find(plateKey(plate)), p, user_limit, d);
+    }
+    return d;
+}
+
+void QuotaEngine::addTo(std::uint64_t key, const Periods& p, Volume volume)
+{
+    Bucket& b = buckets_[key];
+    for (std::size_t w = 0; w < kWindows; ++w) {
+        if (b.period[w] != p.id[w]) {
+            // Yeni dönem → pencere toplamını sıfırla
+            b.period[w]      = p.id[w];
+            b.consumed_cl[w] = 0;
+        }
+        b.consumed_cl[w] += volume.raw();
+    }
+    if (!appendRecord(key, b)) {
+        RECUM_LOG_WARN("Quota", "kota kaydı yazılamadı ({})", path_);
+    }
+}
+
+void QuotaEngine::recordSale(int userId, const std::string& plate,
+                             Volume volume,
+                             Clock::time_point now)
+{
+    if (!volume.isPositive()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    const Periods p = periodsFor(now);
+
+    addTo(userKey(userId), p, volume);
+    if (!plate.empty()) {
+        addTo(plateKey(plate), p, volume);
+    }
+
+    if (journalRecords_ > 4 * buckets_.size() + 256) {
+        compact();
+    }
+}
+
+Volume QuotaEngine::consumed(int userId, QuotaWindow w,
+                             Clock::time_point now) const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    const auto it = buckets_.find(userKey(userId));
+    if (it == buckets_.end()) {
+        return Volume{};
+    }
+    const auto idx = static_cast<std::size_t>(w);
+    const Periods p = periodsFor(now);
+    return Volume::fromRaw(
+        (it->second.period[idx] == p.id[idx]) ? it->second.consumed_cl[idx] : 0);
+}
+
+bool QuotaEngine::appendRecord(std::uint64_t key, const Bucket& b)
+{
+    if (fd_ < 0) {
+        return false;
+    }
+
+    DiskRecord r{};
+    r.key = key;
+    for (std::size_t w = 0; w < kWindows; ++w) {
+        r.period[w]      = b.period[w];
+        r.consumed_cl[w] = b.consumed_cl[w];
+    }
+    r.checksum = recordChecksum(r);
+
+    if (!writeAll(fd_, &r, sizeof(r))) {
+        return false;
+    }
+    ++journalRecords_;
+    return ::fdatasync(fd_) == 0;
+}
+
+bool QuotaEngine::compact()
+{
+    // mtx_ çağıran tarafından tutuluyor.
+    if (path_.empty()) {
+        return false;
+    }
+
+    const std::string tmp = path_ + ".tmp";
+    const int tfd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (tfd < 0) {
+        return false;
+    }
+
+    DiskHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version     = kVersion;
+    h.record_size = sizeof(DiskRecord);
+    bool ok = writeAll(tfd, &h, sizeof(h));
+
+    // Haftalık ve aylık dönemi geçmiş anahtarlar artık hiçbir pencereyi
+    // etkilemez; snapshot'a taşınmaz.
+    const Periods now = periodsFor(Clock::now());
+    constexpr auto kW = static_cast<std::size_t>(QuotaWindow::Weekly);
+    constexpr auto kM = static_cast<std::size_t>(QuotaWindow::Monthly);
+
+    std::size_t written = 0;
+    for (auto it = buckets_.begin(); ok && it != buckets_.end(); ) {
+        const Bucket& b = it->second;
+        if (b.period[kW] != now.id[kW] && b.period[kM] != now.id[kM]) {
+            it = buckets_.erase(it);
+            continue;
+        }
+        DiskRecord r{};
+        r.key = it->first;
+        for (std::size_t w = 0; w < kWindows; ++w) {
+            r.period[w]      = b.period[w];
+            r.consumed_cl[w] = b.consumed_cl[w];
+        }
+        r.checksum = recordChecksum(r);
+        ok = writeAll(tfd, &r, sizeof(r));
+        ++written;
+        ++it;
+    }
+
+    ok = ok && ::fsync(tfd) == 0;
+    ::close(tfd);
+
+    if (!ok || std::rename(tmp.c_str(), path_.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    // Yeni dosyayı append modunda yeniden aç.
+    const int nfd = ::open(path_.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    if (nfd < 0) {
+        return false;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_             = nfd;
+    journalRecords_ = written;
+    return true;
+}
+
+} // namespace recum12::core
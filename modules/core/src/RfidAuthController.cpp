@@ -1,5 +1,6 @@
 #include "core/RfidAuthController.h"
-#include <iostream>
+#include "utils/InfraLog.h"
+#include <algorithm>
 #include <chrono>
 
 namespace recum12::core {
@@ -17,7 +18,40 @@ void RfidAuthController::setPumpInterface(PumpInterfaceLvl3* pump)
 
 void RfidAuthController::setReader(Pn532Reader* reader)
 {
-    reader_ = reader;
+    if (!reader) {
+        return;
+    }
+    ReaderBinding rb;
+    rb.reader   = reader;
+    rb.any_slot = true;
+    readers_.push_back(rb);
+}
+
+void RfidAuthController::addReader(Pn532Reader* reader, const recum12::hw::PumpSlotRef& slot)
+{
+    if (!reader) {
+        return;
+    }
+    ReaderBinding rb;
+    rb.reader = reader;
+    rb.slot   = slot;
+    rb.target = slot;
+    readers_.push_back(rb);
+}
+
+RfidAuthController::ReaderBinding*
+RfidAuthController::bindingFor(const recum12::hw::PumpSlotRef& slot)
+{
+    ReaderBinding* fallback = nullptr;
+    for (auto& rb : readers_) {
+        if (!rb.any_slot && rb.slot == slot) {
+            return &rb;
+        }
+        if (rb.any_slot && !fallback) {
+            fallback = &rb;
+        }
+    }
+    return fallback;
 }
 
 void RfidAuthController::setUserManager(UserManager* users)
@@ -25,118 +59,235 @@ void RfidAuthController::setUserManager(UserManager* users)
     users_ = users;
 }
 
+void RfidAuthController::setQuotaEngine(QuotaEngine* quota)
+{
+    quota_ = quota;
+}
+
 void RfidAuthController::attach()
 {
-    if (!reader_) {
+    if (readers_.empty()) {
         if (onError) {
             onError("RfidAuthController: reader is not set");
         }
         return;
     }
 
-    // Pn532Reader kart okuma callback'i:
-    reader_->onCardDetected = [this](const CardEvent& ev) {
-        waiting_for_card_ = false;
-
-        // Debug: kart UID'sini ham haliyle logla
-        std::cout << "[RFID/Auth] card detected, raw uid_hex="
-                  << ev.uid_hex << std::endl;
-
-        AuthContext ctx;
-        ctx.uid_hex = ev.uid_hex;
-
-        // UserManager varsa: gerçek kullanıcı doğrulaması
-        if (users_) {
-            auto u = users_->findByRfid(ev.uid_hex);
-            if (u) {
-                ctx.authorized = true;
-                // İş kuralı: user_id alanına numeric userId string olarak yazıyoruz.
-                ctx.user_id    = std::to_string(u->userId);
-                ctx.plate      = u->plate;
-                // users.csv'deki litre limitini bağlama taşı.
-                // 0 veya negatifse "limitsiz" kabul edilecek.
-                ctx.limit_liters = u->limit_liters;
-            } else {
-                ctx.authorized = false;
-                ctx.user_id.clear();
-                ctx.plate.clear();
-                std::cout << "[RFID/Auth] uid not found in users.csv"
-                          << std::endl;
+    for (std::size_t i = 0; i < readers_.size(); ++i) {
+        Pn532Reader* reader = readers_[i].reader;
+
+        // Pn532Reader kart okuma callback'i (RFID worker thread'i):
+        // sadece kuyruğa bırak; reader hemen deselect edip polling'e dönsün.
+        reader->onCardDetected = [this, i](const CardEvent& ev) {
+            {
+                std::lock_guard<std::mutex> lock(queueMtx_);
+                if (pending_.size() >= kMaxPendingCards) {
+                    std::lock_guard<std::mutex> slock(statsMtx_);
+                    ++stats_.dropped_events;
+                    return;
+                }
+                pending_.push_back(PendingCard{ev, i, readers_[i].target});
             }
-        } else {
-            // UserManager henüz bağlanmamışsa eski saha test davranışı:
-            // tüm kartları "yetkili" kabul et.
-            ctx.authorized = true;
+            queueCv_.notify_one();
+        };
+
+        // Pn532Reader hata callback'i:
+        reader->onError = [this](const std::string& msg) {
+            waiting_for_card_ = false;
+            if (onError) {
+                onError(msg);
+            }
+            if (onAuthMessage) {
+                onAuthMessage("RFID hatası");
             }
+        };
+    }
+}
+
+bool RfidAuthController::waitForPending(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(queueMtx_);
+    return queueCv_.wait_for(lock, timeout, [this] { return !pending_.empty(); });
+}
 
-        if (onAuthResult) {
-            onAuthResult(ctx);
+std::size_t RfidAuthController::processPending()
+{
+    std::deque<PendingCard> batch;
+    {
+        std::lock_guard<std::mutex> lock(queueMtx_);
+        batch.swap(pending_);
+    }
+
+    for (const auto& pc : batch) {
+        ReaderBinding& rb = readers_[pc.binding];
+        // Kart, okunduğu andaki (okuması açık) isteğe aittir. İstek kuyruk
+        // boşaltılmadan kapandıysa (tabanca yerine kondu / iptal) kart
+        // bayattır: canlı istek yokken pompa AUTHORIZE edilmez.
+        if (rb.waiting.empty() || !(rb.waiting.front() == pc.slot)) {
+            RECUM_LOG_INFO("RFID/Auth", "uid={} pump=0x{}/{}: istek kapanmış, kart yok sayıldı",
+                           pc.ev.uid, recum12::utils::InfraHex{pc.slot.addr},
+                           static_cast<unsigned>(pc.slot.nozzle));
+            continue;
         }
+        rb.waiting.pop_front();
+        armNext(rb);
+        handleCard(pc.ev, pc.slot);
+    }
+    return batch.size();
+}
 
-        if (onAuthMessage) {
-            if (ctx.authorized) {
-                // Üst katman bu mesajı lblmsg vb. alana basabilir.
-                onAuthMessage("Yetkili Kullanıcı");
-            } else {
-                onAuthMessage("Yetkisiz Kullanıcı");
+AuthLatencyStats RfidAuthController::latencyStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMtx_);
+    return stats_;
+}
+
+void RfidAuthController::recordLatency(std::chrono::microseconds us)
+{
+    {
+        std::lock_guard<std::mutex> lock(statsMtx_);
+        const auto v = static_cast<std::int64_t>(us.count());
+        stats_.last_us = v;
+        if (stats_.count == 0 || v < stats_.min_us) stats_.min_us = v;
+        if (stats_.count == 0 || v > stats_.max_us) stats_.max_us = v;
+        ++stats_.count;
+        stats_.avg_us += (static_cast<double>(v) - stats_.avg_us) /
+                         static_cast<double>(stats_.count);
+    }
+    if (onAuthLatency) {
+        onAuthLatency(us);
+    }
+}
+
+// Core thread: sıradaki slot için okuyucuyu hedefle ve okumayı aç.
+void RfidAuthController::armNext(ReaderBinding& rb)
+{
+    if (rb.waiting.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMtx_);
+        rb.target = rb.waiting.front();
+    }
+    // Önceki kart okuyucuyu CardPresent'te bırakmış olabilir: önce Idle'a çek
+    rb.reader->cancelRead();
+    rb.reader->requestRead();
+    waiting_for_card_ = true;
+}
+
+// Core thread: tek bir kart olayının yetki kontrolü + pompa komutu.
+void RfidAuthController::handleCard(const CardEvent& ev, const recum12::hw::PumpSlotRef& slot)
+{
+    waiting_for_card_ = false;
+
+    // Kart UID'si ikili taşınır; hex'e çevrim log sink'inde
+    RECUM_LOG_INFO("RFID/Auth", "card detected, uid={} reader={} pump=0x{}/{}",
+                   ev.uid, ev.source, recum12::utils::InfraHex{slot.addr},
+                   static_cast<unsigned>(slot.nozzle));
+
+    AuthContext ctx;
+    ctx.slot    = slot;
+    ctx.uid     = ev.uid;
+
+    // UserManager varsa: gerçek kullanıcı doğrulaması
+    if (users_) {
+        auto u = users_->findByRfid(ev.uid);
+        if (u) {
+            ctx.authorized = true;
+            // İş kuralı: user_id alanına numeric userId string olarak yazıyoruz.
+            ctx.user_id    = std::to_string(u->userId);
+            ctx.plate      = u->plate;
+            // users.csv'deki litre limitini bağlama taşı.
+            // 0 veya negatifse "limitsiz" kabul edilecek.
+            ctx.limit_volume = u->limit_volume;
+
+            // Kota motoru: daha önceki satışlar bu pencerelerde ne kadar
+            // tükettiyse kalan miktarla sınırla (tekrar kart okutma açığı).
+            if (quota_) {
+                const auto q = quota_->check(u->userId, u->plate, u->limit_volume);
+                if (!q.allowed) {
+                    ctx.authorized     = false;
+                    ctx.quota_exceeded = true;
+                    RECUM_LOG_INFO("RFID/Auth", "quota exhausted for userId={}", u->userId);
+                } else if (q.limited) {
+                    if (!ctx.limit_volume.isPositive() ||
+                        q.remaining < ctx.limit_volume) {
+                        ctx.limit_volume = q.remaining;
+                    }
+                }
             }
+        } else {
+            ctx.authorized = false;
+            ctx.user_id.clear();
+            ctx.plate.clear();
+            RECUM_LOG_INFO("RFID/Auth", "uid not found in users.csv");
         }
+    } else {
+        // UserManager henüz bağlanmamışsa eski saha test davranışı:
+        // tüm kartları "yetkili" kabul et.
+        ctx.authorized = true;
+    }
 
-        // Kart yetkili ise pompaya AUTHORIZE (CD1, DCC=0x06) isteği gönder.
-        // Not: Şimdilik her kart için AUTHORIZE gidiyor; UserManager
-        // entegre olduğunda sadece gerçekten yetkili kartlarda çağrılacak.
-        if (ctx.authorized && pump_) {
-            std::cout << "[RFID/Auth] authorized → sending AUTHORIZE (DCC=0x06)"
-                      << std::endl;
-            pump_->sendStatusPoll(0x06);
-            if (onAuthMessage) {
-                onAuthMessage("Yetkili kart → pompa AUTHORIZE edildi");
-            }
+    if (onAuthResult) {
+        onAuthResult(ctx);
+    }
 
-            // 10 sn boyunca tekrar kart okuma kapalı (cooldown başlat)
-            card_cooldown_active_ = true;
-            card_cooldown_until_ =
-                std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    if (onAuthMessage) {
+        if (ctx.authorized) {
+            // Üst katman bu mesajı lblmsg vb. alana basabilir.
+            onAuthMessage("Yetkili Kullanıcı");
+        } else {
+            onAuthMessage("Yetkisiz Kullanıcı");
         }
-    };
+    }
 
-    // Pn532Reader hata callback'i:
-    reader_->onError = [this](const std::string& msg) {
-        waiting_for_card_ = false;
-        if (onError) {
-            onError(msg);
+    // Kart yetkili ise pompaya AUTHORIZE (CD1, DCC=0x06) isteği gönder.
+    // Not: Şimdilik her kart için AUTHORIZE gidiyor; UserManager
+    // entegre olduğunda sadece gerçekten yetkili kartlarda çağrılacak.
+    if (ctx.authorized && pump_) {
+        RECUM_LOG_INFO("RFID/Auth", "authorized → queueing AUTHORIZE (DCC=0x06)");
+
+        // Bus scheduler: frame RS485 thread'i tarafından yazıldığında
+        // kart → AUTHORIZE gecikmesini ölç.
+        const auto detected_at = ev.detected_at;
+        const bool queued = pump_->queueStatusPoll(slot, 0x06, [this, detected_at](bool ok) {
+            if (ok) {
+                recordLatency(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - detected_at));
+            }
+        });
+        if (!queued) {
+            RECUM_LOG_WARN("RFID/Auth", "AUTHORIZE could not be queued (port closed?)");
         }
         if (onAuthMessage) {
-            onAuthMessage("RFID hatası");
+            onAuthMessage("Yetkili kart → pompa AUTHORIZE edildi");
         }
-    };
+    }
 }
 
-void RfidAuthController::handleNozzleOut()
+void RfidAuthController::handleNozzleOut(const recum12::hw::PumpSlotRef& slot)
 {
-    if (!reader_) {
+    ReaderBinding* rb = bindingFor(slot);
+    if (!rb) {
         if (onError) {
-            onError("RfidAuthController::handleNozzleOut: reader is not set");
+            onError("RfidAuthController::handleNozzleOut: no reader for pump slot");
         }
         return;
     }
 
-    // Yetkili bir karttan sonra 10 sn boyunca yeni kart okuma kapalı (cooldown).
-    if (card_cooldown_active_) {
-        auto now = std::chrono::steady_clock::now();
-        if (now < card_cooldown_until_) {
-            std::cout << "[RFID/Auth] handleNozzleOut ignored (cooldown active)"
-                      << std::endl;
-            return;
-        } else {
-            // Cooldown süresi doldu, normal akışa devam edebiliriz.
-            card_cooldown_active_ = false;
-        }
+    // Aynı slot zaten sırada: tekrar eden tabanca çıkışı
+    if (std::find(rb->waiting.begin(), rb->waiting.end(), slot) != rb->waiting.end()) {
+        return;
+    }
+    rb->waiting.push_back(slot);
+    if (rb->waiting.size() > 1) {
+        // Genel okuyucu önceki slot için kart bekliyor: hedef değişmez
+        RECUM_LOG_INFO("RFID/Auth", "pump=0x{}/{} kart sırasında ({}. istek)",
+                       recum12::utils::InfraHex{slot.addr}, static_cast<unsigned>(slot.nozzle),
+                       rb->waiting.size());
+    } else {
+        armNext(*rb);
     }
-
-    // Nozzle OUT → kart okuma isteği başlat.
-    reader_->requestRead();
-    waiting_for_card_ = true;
 
     if (onAuthMessage) {
         // Üst katman bunu "Kart Okutun" veya benzeri bir mesaja çevirebilir.
@@ -146,8 +297,9 @@ void RfidAuthController::handleNozzleOut()
 
 void RfidAuthController::handleNozzleInOrSaleFinished()
 {
-    if (reader_) {
-        reader_->cancelRead();
+    for (auto& rb : readers_) {
+        rb.waiting.clear();
+        rb.reader->cancelRead();
     }
     waiting_for_card_ = false;
 
@@ -157,4 +309,27 @@ void RfidAuthController::handleNozzleInOrSaleFinished()
     }
 }
 
+void RfidAuthController::handleNozzleInOrSaleFinished(const recum12::hw::PumpSlotRef& slot)
+{
+    ReaderBinding* rb = bindingFor(slot);
+    if (rb) {
+        const auto it = std::find(rb->waiting.begin(), rb->waiting.end(), slot);
+        if (it != rb->waiting.end()) {
+            // Okuması açık istek iptal → sıradakine geç; sıradakiler etkilenmez
+            const bool was_armed = (it == rb->waiting.begin());
+            rb->waiting.erase(it);
+            if (was_armed) {
+                rb->reader->cancelRead();
+                armNext(*rb);
+            }
+        }
+    }
+    waiting_for_card_ = rb && !rb->waiting.empty();
+
+    if (onAuthMessage) {
+        // Tipik idle mesajı: "İşlem Yok".
+        onAuthMessage("İşlem yok");
+    }
+}
+
 } // namespace recum12::core
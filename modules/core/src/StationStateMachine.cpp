@@ -0,0 +1,192 @@
+#include "core/StationStateMachine.h"
+
+namespace recum12::core {
+
+namespace {
+
+constexpr std::size_t kStates = static_cast<std::size_t>(StationState::Count);
+constexpr std::size_t kEvents = static_cast<std::size_t>(StationEvent::Count);
+
+struct Cell
+{
+    StationState  next;
+    std::uint16_t actions;
+    bool          defined;
+};
+
+using Table = std::array<std::array<Cell, kEvents>, kStates>;
+
+using S = StationState;
+using E = StationEvent;
+namespace A = StationAction;
+
+constexpr std::size_t idx(S s) { return static_cast<std::size_t>(s); }
+constexpr std::size_t idx(E e) { return static_cast<std::size_t>(e); }
+
+// Geçiş tablosu. Burada yazılmayan (state, event) çiftleri yoksayılır.
+constexpr Table makeTable()
+{
+    Table t{};
+    for (std::size_t s = 0; s < kStates; ++s) {
+        for (std::size_t e = 0; e < kEvents; ++e) {
+            t[s][e] = Cell{static_cast<S>(s), A::None, false};
+        }
+    }
+
+    auto on = [&t](S from, E ev, S to, std::uint16_t actions) {
+        t[idx(from)][idx(ev)] = Cell{to, actions, true};
+    };
+
+    // Yeni satışa giriş: baseline sıfırlanır, dolum bekleme zamanlayıcısı düşer
+    constexpr std::uint16_t kStartSale = A::ResetFillBaseline | A::CancelFillWait;
+    // Tabanca pompaya döndü → satış kapanır; kart yetkisi bu satışla biter
+    // (sonraki kartsız satış önceki kullanıcıya yazılmaz)
+    constexpr std::uint16_t kEndSale   = A::LogGunOff | A::CloseSale | A::CancelCard |
+                                         A::ClearAuth;
+
+    // --- Idle: tabanca pompada, yetki yok ---
+    on(S::Idle, E::NozzleOut,       S::WaitingCard,  A::LogGunOn | A::RequestCard);
+    on(S::Idle, E::AuthGranted,     S::Authorized,   A::StartFillWait);
+    on(S::Idle, E::AuthDenied,      S::Idle,         A::ClearAuth | A::StartUnauthTimer);
+    on(S::Idle, E::PumpFilling,     S::Filling,      kStartSale);
+    on(S::Idle, E::UnauthTimeout,   S::Idle,         A::ClearStatus);
+
+    // --- WaitingCard: tabanca dışarıda, kart bekleniyor ---
+    on(S::WaitingCard, E::NozzleIn,    S::Idle,         A::LogGunOff | A::CancelCard);
+    on(S::WaitingCard, E::AuthGranted, S::ReadyToFill,  A::StartFillWait);
+    on(S::WaitingCard, E::AuthDenied,  S::Unauthorized, A::ClearAuth | A::StartUnauthTimer);
+    on(S::WaitingCard, E::PumpFilling, S::Filling,      kStartSale);
+
+    // --- Authorized: kart yetkili, tabanca pompada ---
+    on(S::Authorized, E::NozzleOut,       S::ReadyToFill, A::LogGunOn);
+    on(S::Authorized, E::AuthGranted,     S::Authorized,  A::StartFillWait);
+    on(S::Authorized, E::AuthDenied,      S::Idle,        A::ClearAuth | A::StartUnauthTimer);
+    on(S::Authorized, E::PumpFilling,     S::Filling,     kStartSale);
+    on(S::Authorized, E::FillWaitTimeout, S::Idle,        A::ClearAuth | A::ClearStatus);
+
+    // --- ReadyToFill: kart yetkili, tabanca dışarıda ---
+    on(S::ReadyToFill, E::NozzleIn,        S::Authorized,  A::LogGunOff | A::CancelCard);
+    on(S::ReadyToFill, E::AuthGranted,     S::ReadyToFill, A::StartFillWait);
+    on(S::ReadyToFill, E::PumpFilling,     S::Filling,     kStartSale);
+    on(S::ReadyToFill, E::FillWaitTimeout, S::WaitingCard,
+       A::ClearAuth | A::ClearStatus | A::RequestCard);
+
+    // --- Filling ---
+    on(S::Filling, E::PumpFillDone, S::FillDone, A::None);
+    // Reset / SwitchedOff: hard stop, satış tabanca dönünce kapanır
+    on(S::Filling, E::PumpIdle,     S::FillDone, A::None);
+    // Parçalı dolum: tabanca dolum sırasında pompaya döndü
+    on(S::Filling, E::NozzleIn,     S::Idle,     kEndSale);
+
+    // --- FillDone: satış bitti, tabanca hâlâ dışarıda ---
+    on(S::FillDone, E::NozzleIn,    S::Idle,    kEndSale);
+    on(S::FillDone, E::PumpFilling, S::Filling, A::None); // aynı satış devam ediyor
+
+    // --- Unauthorized: 3 sn uyarı, tabanca dışarıda ---
+    on(S::Unauthorized, E::UnauthTimeout, S::WaitingCard, A::ClearStatus | A::RequestCard);
+    on(S::Unauthorized, E::NozzleIn,      S::Idle,        A::LogGunOff | A::CancelCard | A::ClearStatus);
+    on(S::Unauthorized, E::AuthGranted,   S::ReadyToFill, A::StartFillWait | A::ClearStatus);
+    on(S::Unauthorized, E::PumpFilling,   S::Filling,     kStartSale);
+
+    return t;
+}
+
+constexpr Table kTable = makeTable();
+
+// Temel sözleşmeler derleme anında doğrulanır.
+static_assert(kTable[idx(S::Idle)][idx(E::NozzleOut)].next == S::WaitingCard,
+              "Idle + NozzleOut → WaitingCard olmali");
+static_assert(kTable[idx(S::FillDone)][idx(E::NozzleIn)].actions & A::CloseSale,
+              "Satis tabanca pompaya donunce kapanmali");
+static_assert(kTable[idx(S::FillDone)][idx(E::NozzleIn)].actions & A::ClearAuth,
+              "Satis kapaninca kart yetkisi dusmeli");
+static_assert(!kTable[idx(S::Filling)][idx(E::FillWaitTimeout)].defined,
+              "Dolum sirasinda eski timeout yoksayilmali");
+
+} // namespace
+
+StationTransition StationStateMachine::dispatch(StationEvent ev,
+                                                std::chrono::steady_clock::time_point now) noexcept
+{
+    StationTransition tr{};
+    tr.at    = now;
+    tr.from  = state_;
+    tr.to    = state_;
+    tr.event = ev;
+
+    if (ev >= StationEvent::Count) {
+        return tr;
+    }
+
+    const Cell& c = kTable[idx(state_)][idx(ev)];
+    if (!c.defined) {
+        return tr; // yoksay: durum ve trace değişmez
+    }
+
+    tr.to      = c.next;
+    tr.actions = c.actions;
+    tr.seq     = ++seq_;
+    state_     = c.next;
+
+    trace_[traceHead_] = tr;
+    traceHead_ = (traceHead_ + 1) % kTraceSize;
+    if (traceCount_ < kTraceSize) {
+        ++traceCount_;
+    }
+    return tr;
+}
+
+void StationStateMachine::reset() noexcept
+{
+    state_      = StationState::Idle;
+    seq_        = 0;
+    traceHead_  = 0;
+    traceCount_ = 0;
+}
+
+std::size_t StationStateMachine::copyTrace(StationTransition* out, std::size_t max) const noexcept
+{
+    if (!out || max == 0) {
+        return 0;
+    }
+    const std::size_t n     = (traceCount_ < max) ? traceCount_ : max;
+    // En yeni n kaydı, eskiden yeniye sırayla yaz
+    const std::size_t start = (traceHead_ + kTraceSize - n) % kTraceSize;
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = trace_[(start + i) % kTraceSize];
+    }
+    return n;
+}
+
+const char* StationStateMachine::name(StationState s) noexcept
+{
+    switch (s) {
+    case StationState::Idle:         return "Idle";
+    case StationState::WaitingCard:  return "WaitingCard";
+    case StationState::Authorized:   return "Authorized";
+    case StationState::ReadyToFill:  return "ReadyToFill";
+    case StationState::Filling:      return "Filling";
+    case StationState::FillDone:     return "FillDone";
+    case StationState::Unauthorized: return "Unauthorized";
+    default:                         return "?";
+    }
+}
+
+const char* StationStateMachine::name(StationEvent e) noexcept
+{
+    switch (e) {
+    case StationEvent::PumpIdle:        return "PumpIdle";
+    case StationEvent::PumpAuthorized:  return "PumpAuthorized";
+    case StationEvent::PumpFilling:     return "PumpFilling";
+    case StationEvent::PumpFillDone:    return "PumpFillDone";
+    case StationEvent::NozzleOut:       return "NozzleOut";
+    case StationEvent::NozzleIn:        return "NozzleIn";
+    case StationEvent::AuthGranted:     return "AuthGranted";
+    case StationEvent::AuthDenied:      return "AuthDenied";
+    case StationEvent::FillWaitTimeout: return "FillWaitTimeout";
+    case StationEvent::UnauthTimeout:   return "UnauthTimeout";
+    default:                            return "?";
+    }
+}
+
+} // namespace recum12::core
@@ -0,0 +1,265 @@
+#include "core/TimerWheel.h"
+
+#include <utility>
+
+namespace recum12::core {
+
+namespace {
+
+constexpr std::uint64_t kSlotMask = TimerWheel::kSlots - 1;
+
+// Seviye l'nin kapsadığı tick aralığı: 64^(l+1)
+constexpr std::uint64_t levelSpan(std::size_t level)
+{
+    return std::uint64_t{1} << (TimerWheel::kSlotBits * (level + 1));
+}
+
+constexpr std::uint64_t kMaxDelayTicks = levelSpan(TimerWheel::kLevels - 1) - 1;
+
+} // namespace
+
+TimerWheel::TimerWheel(const Clock& clock)
+    : clock_(clock)
+    , origin_(clock.now())
+{
+    heads_.fill(kNil);
+}
+
+std::uint64_t TimerWheel::ticksFor(duration d) const noexcept
+{
+    const auto tick = std::chrono::duration_cast<duration>(kTick).count();
+    if (d.count() <= 0) {
+        return 1;
+    }
+    // Yukarı yuvarla: zamanlayıcı asla erken tetiklenmesin
+    std::uint64_t t = static_cast<std::uint64_t>((d.count() + tick - 1) / tick);
+    if (t == 0) {
+        t = 1;
+    }
+    return (t > kMaxDelayTicks) ? kMaxDelayTicks : t;
+}
+
+std::uint64_t TimerWheel::currentTick() const noexcept
+{
+    const auto elapsed = clock_.now() - origin_;
+    if (elapsed.count() <= 0) {
+        return 0;
+    }
+    const auto tick = std::chrono::duration_cast<duration>(kTick).count();
+    return static_cast<std::uint64_t>(elapsed.count() / tick);
+}
+
+std::uint32_t TimerWheel::allocNode()
+{
+    if (!free_.empty()) {
+        const std::uint32_t idx = free_.back();
+        free_.pop_back();
+        return idx;
+    }
+    nodes_.emplace_back();
+    return static_cast<std::uint32_t>(nodes_.size() - 1);
+}
+
+void TimerWheel::freeNode(std::uint32_t idx) noexcept
+{
+    Node& n  = nodes_[idx];
+    n.active = false;
+    n.cb     = nullptr;
+    ++n.gen;
+    --active_;
+    free_.push_back(idx); // kapasite allocNode'da zaten ayrıldı
+}
+
+void TimerWheel::link(std::uint32_t idx) noexcept
+{
+    Node& n = nodes_[idx];
+
+    const std::uint64_t delta = (n.expiry > nowTick_) ? (n.expiry - nowTick_) : 0;
+    std::size_t level = 0;
+    while (level + 1 < kLevels && delta >= levelSpan(level)) {
+        ++level;
+    }
+    const std::size_t slot =
+        static_cast<std::size_t>((n.expiry >> (kSlotBits * level)) & kSlotMask);
+
+    n.bucket = static_cast<std::uint16_t>(level * kSlots + slot);
+    n.prev   = kNil;
+    n.next   = heads_[n.bucket];
+    if (n.next != kNil) {
+        nodes_[n.next].prev = idx;
+    }
+    heads_[n.bucket] = idx;
+}
+
+void TimerWheel::unlink(std::uint32_t idx) noexcept
+{
+    Node& n = nodes_[idx];
+    if (n.prev != kNil) {
+        nodes_[n.prev].next = n.next;
+    } else {
+        heads_[n.bucket] = n.next;
+    }
+    if (n.next != kNil) {
+        nodes_[n.next].prev = n.prev;
+    }
+    n.prev = kNil;
+    n.next = kNil;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(duration delay, Callback cb)
+{
+    // Çark boşsa saate hizala. Doluysa reactor birkaç tick geride olabilir;
+    // expiry yine gerçek "şimdi"ye göre hesaplanır (asla erken tetiklenmez).
+    const std::uint64_t realNow = currentTick();
+    if (active_ == 0 && realNow > nowTick_) {
+        nowTick_ = realNow;
+    }
+    const std::uint64_t base = (realNow > nowTick_) ? realNow : nowTick_;
+
+    const std::uint32_t idx = allocNode();
+    if (free_.capacity() < nodes_.size()) {
+        free_.reserve(nodes_.size());
+    }
+
+    Node& n  = nodes_[idx];
+    n.expiry = base + ticksFor(delay);
+    n.period = 0;
+    n.cb     = std::move(cb);
+    n.active = true;
+    ++active_;
+    link(idx);
+
+    return TimerId{idx, n.gen};
+}
+
+TimerWheel::TimerId TimerWheel::scheduleEvery(duration period, Callback cb)
+{
+    TimerId id = schedule(period, std::move(cb));
+    nodes_[id.index].period = ticksFor(period);
+    return id;
+}
+
+bool TimerWheel::pending(const TimerId& id) const noexcept
+{
+    return id.valid() && id.index < nodes_.size() &&
+           nodes_[id.index].active && nodes_[id.index].gen == id.gen;
+}
+
+bool TimerWheel::cancel(TimerId& id) noexcept
+{
+    if (!pending(id)) {
+        id = TimerId{};
+        return false;
+    }
+    unlink(id.index);
+    freeNode(id.index);
+    id = TimerId{};
+    return true;
+}
+
+void TimerWheel::cascade(std::size_t level) noexcept
+{
+    const std::size_t slot =
+        static_cast<std::size_t>((nowTick_ >> (kSlotBits * level)) & kSlotMask);
+    const std::size_t bucket = level * kSlots + slot;
+
+    std::uint32_t idx = heads_[bucket];
+    heads_[bucket] = kNil;
+    while (idx != kNil) {
+        const std::uint32_t next = nodes_[idx].next;
+        link(idx); // artık daha alt bir seviyeye düşer
+        idx = next;
+    }
+}
+
+std::size_t TimerWheel::fireSlot(std::size_t slot)
+{
+    std::size_t fired = 0;
+
+    // Callback'ler yeni zamanlayıcı kurabilir/iptal edebilir; bu yüzden
+    // listeyi her seferinde baştan alıyoruz (yeni kurulanlar >= now+1 tick).
+    while (heads_[slot] != kNil) {
+        const std::uint32_t idx = heads_[slot];
+        unlink(idx);
+
+        Node& n = nodes_[idx];
+        const std::uint32_t gen = n.gen;
+        Callback cb = std::move(n.cb);
+
+        if (n.period > 0) {
+            n.expiry += n.period;
+            if (n.expiry <= nowTick_) {
+                n.expiry = nowTick_ + 1;
+            }
+            link(idx);
+        } else {
+            freeNode(idx);
+        }
+
+        ++fired;
+        if (cb) {
+            cb();
+        }
+
+        // Periyodik ve kendi kendini iptal etmediyse callback'i geri koy
+        Node& after = nodes_[idx];
+        if (after.active && after.gen == gen && after.period > 0 && !after.cb) {
+            after.cb = std::move(cb);
+        }
+    }
+    return fired;
+}
+
+std::size_t TimerWheel::advance()
+{
+    const std::uint64_t target = currentTick();
+    std::size_t fired = 0;
+
+    while (nowTick_ < target) {
+        if (active_ == 0) {
+            // Boş çark: doğrudan hedefe atla (sanal saatte saatler sürebilir)
+            nowTick_ = target;
+            break;
+        }
+
+        ++nowTick_;
+
+        // Üst seviyelerden başlayarak sınırdaki slotları aşağı indir
+        for (std::size_t level = kLevels - 1; level >= 1; --level) {
+            const std::uint64_t mask = (std::uint64_t{1} << (kSlotBits * level)) - 1;
+            if ((nowTick_ & mask) == 0) {
+                cascade(level);
+            }
+        }
+
+        fired += fireSlot(static_cast<std::size_t>(nowTick_ & kSlotMask));
+    }
+    return fired;
+}
+
+TimerWheel::duration TimerWheel::timeUntilNext(duration fallback) const noexcept
+{
+    if (active_ == 0) {
+        return fallback;
+    }
+
+    const auto tick = std::chrono::duration_cast<duration>(kTick);
+
+    // Seviye 0'daki en yakın dolu slot; yoksa en az bir tam tur bekle
+    std::uint64_t ticks = kSlots;
+    for (std::uint64_t i = 1; i <= kSlots; ++i) {
+        if (heads_[static_cast<std::size_t>((nowTick_ + i) & kSlotMask)] != kNil) {
+            ticks = i;
+            break;
+        }
+    }
+
+    const auto due     = origin_ + tick * static_cast<std::int64_t>(nowTick_ + ticks);
+    const auto remains = due - clock_.now();
+    if (remains.count() <= 0) {
+        return duration::zero();
+    }
+    return (remains < fallback) ? remains : fallback;
+}
+
+} // namespace recum12::core
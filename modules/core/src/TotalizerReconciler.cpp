@@ -0,0 +1,513 @@
+#include "core/TotalizerReconciler.h"
+#include "core/UserDbImage.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace recum12::core {
+
+namespace {
+
+constexpr char          kMagic[8] = {'R', 'C', 'U', 'M', 'T', 'O', 'T', '\0'};
+constexpr std::uint32_t kVersion  = 1;
+
+constexpr std::uint32_t kFlagHasTotalizer = 1u << 0;
+constexpr std::uint32_t kFlagEntry        = 1u << 1;
+
+struct DiskHeader
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t record_size;
+};
+
+// Tam çalışma durumu + (varsa) bu checkpoint'te kapanan kalem.
+struct DiskRecord
+{
+    std::int64_t  at_unix;
+    std::int64_t  totalizer_cl;
+    std::int64_t  pending_expected_cl;
+    std::int64_t  cum_expected_cl;
+    std::int64_t  cum_reported_cl;
+    std::uint64_t cum_sales;
+    std::int64_t  shift_at;
+    std::int64_t  shift_expected_cl;
+    std::int64_t  shift_reported_cl;
+    std::uint64_t shift_sales;
+    std::int64_t  shift_totalizer_cl;
+    std::int64_t  entry_expected_cl;
+    std::int64_t  entry_reported_cl;
+    std::uint32_t pending_sales;
+    std::uint32_t entry_sales;
+    std::uint32_t flags;
+    std::uint32_t reserved;
+    std::uint64_t checksum;       // bu alan hariç kayıt
+};
+
+static_assert(sizeof(DiskHeader) == 16, "DiskHeader layout degisti");
+static_assert(sizeof(DiskRecord) == 128, "DiskRecord layout degisti");
+
+std::uint64_t recordChecksum(const DiskRecord& r)
+{
+    return UserDbImage::fnv1a(&r, offsetof(DiskRecord, checksum));
+}
+
+bool writeAll(int fd, const void* data, std::size_t len)
+{
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    while (len > 0) {
+        const ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p   += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+std::int64_t toUnix(TotalizerReconciler::Clock::time_point t)
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+}
+
+std::int64_t absCl(std::int64_t v)
+{
+    return (v < 0) ? -v : v;
+}
+
+} // namespace
+
+TotalizerReconciler::~TotalizerReconciler()
+{
+    close();
+}
+
+void TotalizerReconciler::setConfig(const ReconcileConfig& cfg)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    cfg_ = cfg;
+}
+
+bool TotalizerReconciler::open(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    st_             = State{};
+    ledgerHead_     = 0;
+    ledgerCount_    = 0;
+    windowDriftCl_  = 0;
+    driftActive_    = false;
+    journalRecords_ = 0;
+    dirty_          = false;
+    path_           = path;
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct stat sb{};
+    if (::fstat(fd_, &sb) != 0) {
+        return false;
+    }
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(sb.st_size));
+    std::size_t got = 0;
+    while (got < data.size()) {
+        const ssize_t n = ::pread(fd_, data.data() + got, data.size() - got,
+                                  static_cast<off_t>(got));
+        if (n <= 0) {
+            break;
+        }
+        got += static_cast<std::size_t>(n);
+    }
+    data.resize(got);
+
+    DiskHeader h{};
+    if (data.size() < sizeof(h) ||
+        (std::memcpy(&h, data.data(), sizeof(h)),
+         std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 ||
+         h.version != kVersion || h.record_size != sizeof(DiskRecord))) {
+        // Boş veya tanınmayan dosya → sıfırdan başla (ilk okuma baseline olur).
+        DiskHeader fresh{};
+        std::memcpy(fresh.magic, kMagic, sizeof(kMagic));
+        fresh.version     = kVersion;
+        fresh.record_size = sizeof(DiskRecord);
+        if (::ftruncate(fd_, 0) != 0 || !writeAll(fd_, &fresh, sizeof(fresh))) {
+            return false;
+        }
+        ::fdatasync(fd_);
+        st_.shift_at = toUnix(Clock::now());
+        return true;
+    }
+
+    // Son geçerli checkpoint durumu kazanır; kalemler deftere sırayla girer.
+    std::size_t off = sizeof(DiskHeader);
+    while (off + sizeof(DiskRecord) <= data.size()) {
+        DiskRecord r{};
+        std::memcpy(&r, data.data() + off, sizeof(r));
+        if (r.checksum != recordChecksum(r)) {
+            break; // yarım/bozuk kayıt → buradan sonrasını at
+        }
+
+        st_.totalizer_cl        = r.totalizer_cl;
+        st_.has_totalizer       = (r.flags & kFlagHasTotalizer) != 0;
+        st_.pending_expected_cl = r.pending_expected_cl;
+        st_.pending_sales       = r.pending_sales;
+        st_.cum_expected_cl     = r.cum_expected_cl;
+        st_.cum_reported_cl     = r.cum_reported_cl;
+        st_.cum_sales           = r.cum_sales;
+        st_.shift_at            = r.shift_at;
+        st_.shift_expected_cl   = r.shift_expected_cl;
+        st_.shift_reported_cl   = r.shift_reported_cl;
+        st_.shift_sales         = r.shift_sales;
+        st_.shift_totalizer_cl  = r.shift_totalizer_cl;
+
+        if (r.flags & kFlagEntry) {
+            ReconcileEntry e{};
+            e.at_unix   = r.at_unix;
+            e.totalizer = Volume::fromRaw(r.totalizer_cl);
+            e.expected  = Volume::fromRaw(r.entry_expected_cl);
+            e.reported  = Volume::fromRaw(r.entry_reported_cl);
+            e.sales     = r.entry_sales;
+            pushLedger(e);
+        }
+
+        ++journalRecords_;
+        off += sizeof(DiskRecord);
+    }
+
+    if (off != data.size()) {
+        // Torn write: son bozuk kaydı kes.
+        if (::ftruncate(fd_, static_cast<off_t>(off)) == 0) {
+            ::fdatasync(fd_);
+        }
+    }
+
+    driftActive_ = driftExceededLocked();
+
+    if (journalRecords_ > 4 * kLedgerSize) {
+        compact();
+    }
+    return true;
+}
+
+void TotalizerReconciler::close()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void TotalizerReconciler::onSaleRecorded(Volume volume)
+{
+    if (!volume.isPositive()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    st_.pending_expected_cl += volume.raw();
+    st_.pending_sales       += 1;
+    dirty_                   = true;
+}
+
+bool TotalizerReconciler::persistPending()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!dirty_) {
+        return true;
+    }
+    return appendCheckpoint(nullptr);
+}
+
+bool TotalizerReconciler::onTotals(Volume total, bool sale_active, ReconcileEntry* out,
+                                   Clock::time_point now)
+{
+    ReconcileReport drift_report{};
+    bool            drift_edge = false;
+    ReconcileEntry  e{};
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (sale_active) {
+            return false; // satış ortası: kalem sınırı değil
+        }
+
+        if (!st_.has_totalizer) {
+            // İlk okuma: baseline. Öncesinde loglanan satışlar karşılaştırılamaz.
+            st_.has_totalizer       = true;
+            st_.totalizer_cl        = total.raw();
+            st_.pending_expected_cl = 0;
+            st_.pending_sales       = 0;
+            if (st_.shift_totalizer_cl == 0) {
+                st_.shift_totalizer_cl = total.raw();
+            }
+            appendCheckpoint(nullptr);
+            return false;
+        }
+
+        const std::int64_t reported = total.raw() - st_.totalizer_cl;
+        if (reported == 0 && st_.pending_expected_cl == 0) {
+            return false; // değişiklik yok: kalem açma
+        }
+
+        e.at_unix   = toUnix(now);
+        e.totalizer = total;
+        e.expected  = Volume::fromRaw(st_.pending_expected_cl);
+        e.reported  = Volume::fromRaw(reported);
+        e.sales     = st_.pending_sales;
+
+        st_.totalizer_cl         = total.raw();
+        st_.cum_expected_cl     += st_.pending_expected_cl;
+        st_.cum_reported_cl     += reported;
+        st_.cum_sales           += st_.pending_sales;
+        st_.pending_expected_cl  = 0;
+        st_.pending_sales        = 0;
+
+        pushLedger(e);
+        appendCheckpoint(&e);
+
+        const bool exceeded = driftExceededLocked();
+        drift_edge   = exceeded && !driftActive_;
+        driftActive_ = exceeded;
+        if (drift_edge) {
+            drift_report = reportLocked(e.at_unix);
+        }
+    }
+
+    if (out) {
+        *out = e;
+    }
+    if (drift_edge && onDrift) {
+        onDrift(drift_report);
+    }
+    return true;
+}
+
+ReconcileReport TotalizerReconciler::shiftReport(Clock::time_point now) const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return reportLocked(toUnix(now));
+}
+
+ReconcileReport TotalizerReconciler::closeShift(Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    const ReconcileReport r = reportLocked(toUnix(now));
+
+    st_.shift_at           = r.to_unix;
+    st_.shift_expected_cl  = st_.cum_expected_cl;
+    st_.shift_reported_cl  = st_.cum_reported_cl;
+    st_.shift_sales        = st_.cum_sales;
+    st_.shift_totalizer_cl = st_.totalizer_cl;
+    appendCheckpoint(nullptr);
+    return r;
+}
+
+std::size_t TotalizerReconciler::ledger(ReconcileEntry* out, std::size_t max) const
+{
+    if (!out || max == 0) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    const std::size_t n     = (ledgerCount_ < max) ? ledgerCount_ : max;
+    const std::size_t start = (ledgerHead_ + kLedgerSize - n) % kLedgerSize;
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = ledger_[(start + i) % kLedgerSize];
+    }
+    return n;
+}
+
+Volume TotalizerReconciler::recentDrift() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return Volume::fromRaw(windowDriftCl_);
+}
+
+void TotalizerReconciler::pushLedger(const ReconcileEntry& e)
+{
+    // Kayan pencere toplamı O(1): pencereden düşen kalemi çıkar
+    if (ledgerCount_ >= kDriftWindow) {
+        const ReconcileEntry& old =
+            ledger_[(ledgerHead_ + kLedgerSize - kDriftWindow) % kLedgerSize];
+        windowDriftCl_ -= old.drift().raw();
+    }
+    windowDriftCl_ += e.drift().raw();
+
+    ledger_[ledgerHead_] = e;
+    ledgerHead_ = (ledgerHead_ + 1) % kLedgerSize;
+    if (ledgerCount_ < kLedgerSize) {
+        ++ledgerCount_;
+    }
+}
+
+bool TotalizerReconciler::driftExceededLocked() const
+{
+    const std::size_t n = (ledgerCount_ < kDriftWindow) ? ledgerCount_ : kDriftWindow;
+    std::int64_t expected_cl = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        expected_cl += ledger_[(ledgerHead_ + kLedgerSize - 1 - i) % kLedgerSize].expected.raw();
+    }
+
+    const std::int64_t drift = absCl(windowDriftCl_);
+    if (drift <= cfg_.drift_abs.raw()) {
+        return false;
+    }
+    if (expected_cl <= 0) {
+        return true; // satış yokken sayaç ilerlemiş
+    }
+    return 100.0 * static_cast<double>(drift) / static_cast<double>(expected_cl) > cfg_.drift_pct;
+}
+
+ReconcileReport TotalizerReconciler::reportLocked(std::int64_t now_unix) const
+{
+    ReconcileReport r{};
+    r.from_unix       = st_.shift_at;
+    r.to_unix         = now_unix;
+    r.expected        = Volume::fromRaw(st_.cum_expected_cl - st_.shift_expected_cl);
+    r.reported        = Volume::fromRaw(st_.cum_reported_cl - st_.shift_reported_cl);
+    r.sales           = st_.cum_sales - st_.shift_sales;
+    r.totalizer_open  = Volume::fromRaw(st_.shift_totalizer_cl);
+    r.totalizer_close = Volume::fromRaw(st_.totalizer_cl);
+    return r;
+}
+
+bool TotalizerReconciler::appendCheckpoint(const ReconcileEntry* e)
+{
+    // mtx_ çağıran tarafından tutuluyor.
+    if (fd_ < 0) {
+        return false;
+    }
+
+    DiskRecord r{};
+    r.at_unix             = e ? e->at_unix : toUnix(Clock::now());
+    r.totalizer_cl        = st_.totalizer_cl;
+    r.pending_expected_cl = st_.pending_expected_cl;
+    r.cum_expected_cl     = st_.cum_expected_cl;
+    r.cum_reported_cl     = st_.cum_reported_cl;
+    r.cum_sales           = st_.cum_sales;
+    r.shift_at            = st_.shift_at;
+    r.shift_expected_cl   = st_.shift_expected_cl;
+    r.shift_reported_cl   = st_.shift_reported_cl;
+    r.shift_sales         = st_.shift_sales;
+    r.shift_totalizer_cl  = st_.shift_totalizer_cl;
+    r.pending_sales       = st_.pending_sales;
+    r.flags               = st_.has_totalizer ? kFlagHasTotalizer : 0;
+    if (e) {
+        r.flags            |= kFlagEntry;
+        r.entry_expected_cl = e->expected.raw();
+        r.entry_reported_cl = e->reported.raw();
+        r.entry_sales       = e->sales;
+    }
+    r.checksum = recordChecksum(r);
+
+    if (!writeAll(fd_, &r, sizeof(r))) {
+        return false;
+    }
+    ++journalRecords_;
+    const bool ok = ::fdatasync(fd_) == 0;
+    // Kayıt tam durumu taşır: bekleyen satışlar da artık diskte
+    dirty_ = dirty_ && !ok;
+
+    if (journalRecords_ > 4 * kLedgerSize) {
+        compact();
+    }
+    return ok;
+}
+
+bool TotalizerReconciler::compact()
+{
+    // mtx_ çağıran tarafından tutuluyor.
+    if (path_.empty()) {
+        return false;
+    }
+
+    const std::string tmp = path_ + ".tmp";
+    const int tfd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (tfd < 0) {
+        return false;
+    }
+
+    DiskHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version     = kVersion;
+    h.record_size = sizeof(DiskRecord);
+    bool ok = writeAll(tfd, &h, sizeof(h));
+
+    // Defterdeki kalemler + en sonda güncel durum (açılışta son kayıt kazanır).
+    DiskRecord base{};
+    base.totalizer_cl        = st_.totalizer_cl;
+    base.pending_expected_cl = st_.pending_expected_cl;
+    base.cum_expected_cl     = st_.cum_expected_cl;
+    base.cum_reported_cl     = st_.cum_reported_cl;
+    base.cum_sales           = st_.cum_sales;
+    base.shift_at            = st_.shift_at;
+    base.shift_expected_cl   = st_.shift_expected_cl;
+    base.shift_reported_cl   = st_.shift_reported_cl;
+    base.shift_sales         = st_.shift_sales;
+    base.shift_totalizer_cl  = st_.shift_totalizer_cl;
+    base.pending_sales       = st_.pending_sales;
+    base.flags               = st_.has_totalizer ? kFlagHasTotalizer : 0;
+
+    std::size_t written = 0;
+    const std::size_t start = (ledgerHead_ + kLedgerSize - ledgerCount_) % kLedgerSize;
+    for (std::size_t i = 0; ok && i < ledgerCount_; ++i) {
+        const ReconcileEntry& e = ledger_[(start + i) % kLedgerSize];
+        DiskRecord r = base;
+        r.at_unix           = e.at_unix;
+        r.totalizer_cl      = e.totalizer.raw();
+        r.flags            |= kFlagEntry;
+        r.entry_expected_cl = e.expected.raw();
+        r.entry_reported_cl = e.reported.raw();
+        r.entry_sales       = e.sales;
+        r.checksum          = recordChecksum(r);
+        ok = writeAll(tfd, &r, sizeof(r));
+        ++written;
+    }
+    if (ok) {
+        DiskRecord r = base;
+        r.at_unix  = toUnix(Clock::now());
+        r.checksum = recordChecksum(r);
+        ok = writeAll(tfd, &r, sizeof(r));
+        ++written;
+    }
+
+    ok = ok && ::fsync(tfd) == 0;
+    ::close(tfd);
+
+    if (!ok || std::rename(tmp.c_str(), path_.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    // Yeni dosyayı append modunda yeniden aç.
+    const int nfd = ::open(path_.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    if (nfd < 0) {
+        return false;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_             = nfd;
+    journalRecords_ = written;
+    return true;
+}
+
+} // namespace recum12::core
@@ -0,0 +1,353 @@
+#include "core/UserDbImage.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// mmap / POSIX dosya API'si
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace recum12::core {
+
+namespace {
+
+constexpr char kMagic[8] = {'R', 'C', 'U', 'M', 'U', 'D', 'B', '\0'};
+
+// Disk üzerindeki sabit uzunluklu başlık.
+struct DiskHeader
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::uint64_t csv_mtime_ns;
+    std::uint64_t csv_size;
+    std::uint64_t csv_hash;
+    std::uint32_t record_count;
+    std::uint32_t record_size;
+    std::uint64_t records_offset;
+    std::uint64_t pool_offset;
+    std::uint64_t pool_size;
+    std::uint64_t payload_checksum; // records + pool
+    std::uint64_t header_checksum;  // bu alan hariç başlık
+};
+
+// Tek kullanıcı kaydı; string alanlar pool içindeki (offset, len) çiftleri.
+struct DiskRecord
+{
+    std::uint32_t uid_off;
+    std::uint32_t first_off;
+    std::uint32_t last_off;
+    std::uint32_t plate_off;
+    std::uint16_t uid_len;
+    std::uint16_t first_len;
+    std::uint16_t last_len;
+    std::uint16_t plate_len;
+    std::int32_t  user_id;
+    std::int32_t  level;
+    std::int32_t  limit;
+    std::int32_t  reserved;
+    std::int64_t  limit_cl;        // litre limiti, x100 (centilitre)
+};
+
+static_assert(sizeof(DiskRecord) == 48, "DiskRecord layout degisti");
+
+std::uint64_t headerChecksum(const DiskHeader& h)
+{
+    return UserDbImage::fnv1a(&h, offsetof(DiskHeader, header_checksum));
+}
+
+std::string_view viewOf(const char* pool, std::uint32_t off, std::uint16_t len)
+{
+    return std::string_view(pool + off, len);
+}
+
+// UID'nin ham byte'ları; pool'da bu haliyle saklanır. string_view
+// karşılaştırması (char_traits<char>) memcmp gibi unsigned çalıştığından
+// sıra CardUid::operator< ile aynıdır.
+std::string_view uidBytes(const CardUid& uid)
+{
+    return std::string_view(reinterpret_cast<const char*>(uid.data()), uid.size());
+}
+
+} // namespace
+
+UserDbImage::~UserDbImage()
+{
+    close();
+}
+
+UserDbImage::UserDbImage(UserDbImage&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+UserDbImage& UserDbImage::operator=(UserDbImage&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        base_     = other.base_;
+        mapLen_   = other.mapLen_;
+        count_    = other.count_;
+        records_  = other.records_;
+        pool_     = other.pool_;
+        poolLen_  = other.poolLen_;
+        stamp_    = other.stamp_;
+
+        other.base_    = nullptr;
+        other.mapLen_  = 0;
+        other.count_   = 0;
+        other.records_ = nullptr;
+        other.pool_    = nullptr;
+        other.poolLen_ = 0;
+    }
+    return *this;
+}
+
+std::uint64_t UserDbImage::fnv1a(const void* data, std::size_t len,
+                                 std::uint64_t seed) noexcept
+{
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    std::uint64_t h = seed;
+    for (std::size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool UserDbImage::compile(const std::vector<UserRecord>& users,
+                          const UserDbSourceStamp&       stamp,
+                          const std::string&             imagePath)
+{
+    // 1) rfid'ye göre sıralı index (boş UID'ler başa düşer; findByRfid
+    //    boş aramayı zaten reddettiği için sorun değil).
+    std::vector<std::size_t> order(users.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&users](std::size_t a, std::size_t b) {
+                         return users[a].rfid < users[b].rfid;
+                     });
+
+    // 2) String pool + kayıtlar
+    std::string pool;
+    std::vector<DiskRecord> records;
+    records.reserve(users.size());
+
+    auto put = [&pool](std::string_view s, std::uint32_t& off, std::uint16_t& len) {
+        const std::size_t n = std::min<std::size_t>(s.size(), 0xFFFFu);
+        off = static_cast<std::uint32_t>(pool.size());
+        len = static_cast<std::uint16_t>(n);
+        pool.append(s.data(), n);
+    };
+
+    for (std::size_t idx : order) {
+        const auto& u = users[idx];
+        DiskRecord r{};
+        put(uidBytes(u.rfid), r.uid_off, r.uid_len);
+        put(u.firstName, r.first_off, r.first_len);
+        put(u.lastName,  r.last_off,  r.last_len);
+        put(u.plate,     r.plate_off, r.plate_len);
+        r.user_id  = u.userId;
+        r.level    = u.level;
+        r.limit    = u.limit;
+        r.limit_cl = u.limit_volume.raw();
+        records.push_back(r);
+    }
+
+    if (pool.size() > 0xFFFFFFFFull) {
+        return false; // 32-bit offset sınırı
+    }
+
+    // 3) Başlık
+    DiskHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version        = kVersion;
+    h.header_size    = sizeof(DiskHeader);
+    h.csv_mtime_ns   = stamp.mtime_ns;
+    h.csv_size       = stamp.size;
+    h.csv_hash       = stamp.hash;
+    h.record_count   = static_cast<std::uint32_t>(records.size());
+    h.record_size    = sizeof(DiskRecord);
+    h.records_offset = sizeof(DiskHeader);
+    h.pool_offset    = h.records_offset + records.size() * sizeof(DiskRecord);
+    h.pool_size      = pool.size();
+
+    std::uint64_t sum = fnv1a(records.data(), records.size() * sizeof(DiskRecord));
+    sum               = fnv1a(pool.data(), pool.size(), sum);
+    h.payload_checksum = sum;
+    h.header_checksum  = headerChecksum(h);
+
+    // 4) Geçici dosyaya yaz + fsync + rename (yarım imaj asla görünmesin)
+    const std::string tmpPath = imagePath + ".tmp";
+    std::FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) {
+        return false;
+    }
+
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1;
+    if (ok && !records.empty()) {
+        ok = std::fwrite(records.data(), sizeof(DiskRecord), records.size(), f) == records.size();
+    }
+    if (ok && !pool.empty()) {
+        ok = std::fwrite(pool.data(), 1, pool.size(), f) == pool.size();
+    }
+    ok = ok && std::fflush(f) == 0 && ::fsync(::fileno(f)) == 0;
+    ok = (std::fclose(f) == 0) && ok;
+
+    if (!ok || std::rename(tmpPath.c_str(), imagePath.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool UserDbImage::open(const std::string& imagePath)
+{
+    close();
+
+    const int fd = ::open(imagePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 ||
+        static_cast<std::size_t>(st.st_size) < sizeof(DiskHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    const std::size_t len = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // mapping fd'den bağımsız yaşar
+    if (p == MAP_FAILED) {
+        return false;
+    }
+
+    const auto* base = static_cast<const std::uint8_t*>(p);
+    DiskHeader h{};
+    std::memcpy(&h, base, sizeof(h));
+
+    const bool headerOk =
+        std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 &&
+        h.version == kVersion &&
+        h.header_size == sizeof(DiskHeader) &&
+        h.record_size == sizeof(DiskRecord) &&
+        h.header_checksum == headerChecksum(h) &&
+        h.records_offset == sizeof(DiskHeader) &&
+        h.pool_offset == h.records_offset +
+                         static_cast<std::uint64_t>(h.record_count) * sizeof(DiskRecord) &&
+        h.pool_offset + h.pool_size == len;
+
+    if (!headerOk) {
+        ::munmap(p, len);
+        return false;
+    }
+
+    std::uint64_t sum = fnv1a(base + h.records_offset,
+                              static_cast<std::size_t>(h.pool_offset - h.records_offset));
+    sum               = fnv1a(base + h.pool_offset,
+                              static_cast<std::size_t>(h.pool_size), sum);
+    if (sum != h.payload_checksum) {
+        ::munmap(p, len);
+        return false;
+    }
+
+    base_    = base;
+    mapLen_  = len;
+    count_   = h.record_count;
+    records_ = base + h.records_offset;
+    pool_    = reinterpret_cast<const char*>(base + h.pool_offset);
+    poolLen_ = static_cast<std::size_t>(h.pool_size);
+
+    stamp_.mtime_ns = h.csv_mtime_ns;
+    stamp_.size     = h.csv_size;
+    stamp_.hash     = h.csv_hash;
+
+    // Sayfalar rastgele erişilecek (ikili arama)
+    ::madvise(const_cast<std::uint8_t*>(base_), mapLen_, MADV_RANDOM);
+    return true;
+}
+
+void UserDbImage::close()
+{
+    if (base_) {
+        ::munmap(const_cast<std::uint8_t*>(base_), mapLen_);
+    }
+    base_    = nullptr;
+    mapLen_  = 0;
+    count_   = 0;
+    records_ = nullptr;
+    pool_    = nullptr;
+    poolLen_ = 0;
+    stamp_   = UserDbSourceStamp{};
+}
+
+std::optional<UserRecord> UserDbImage::findByRfid(const CardUid& uid) const
+{
+    if (!base_ || uid.empty()) {
+        return std::nullopt;
+    }
+    const std::string_view wanted = uidBytes(uid);
+
+    // Kayıtlar hizalı olmayabilir diye memcpy ile okuyoruz (ARM güvenli).
+    auto recAt = [this](std::size_t i) {
+        DiskRecord r{};
+        std::memcpy(&r,
+                    static_cast<const std::uint8_t*>(records_) + i * sizeof(DiskRecord),
+                    sizeof(r));
+        return r;
+    };
+
+    std::size_t lo = 0;
+    std::size_t hi = count_;
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        const DiskRecord  r   = recAt(mid);
+        if (viewOf(pool_, r.uid_off, r.uid_len) < wanted) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo < count_) {
+        const DiskRecord r = recAt(lo);
+        if (viewOf(pool_, r.uid_off, r.uid_len) == wanted) {
+            return recordAt(lo);
+        }
+    }
+    return std::nullopt;
+}
+
+UserRecord UserDbImage::recordAt(std::size_t i) const
+{
+    UserRecord u{};
+    if (!base_ || i >= count_) {
+        return u;
+    }
+
+    DiskRecord r{};
+    std::memcpy(&r,
+                static_cast<const std::uint8_t*>(records_) + i * sizeof(DiskRecord),
+                sizeof(r));
+
+    u.userId       = r.user_id;
+    u.level        = r.level;
+    u.firstName    = std::string(viewOf(pool_, r.first_off, r.first_len));
+    u.lastName     = std::string(viewOf(pool_, r.last_off,  r.last_len));
+    u.plate        = std::string(viewOf(pool_, r.plate_off, r.plate_len));
+    u.limit        = r.limit;
+    u.limit_volume = Volume::fromRaw(r.limit_cl);
+    const std::string_view uid = viewOf(pool_, r.uid_off, r.uid_len);
+    u.rfid         = CardUid::fromBytes(reinterpret_cast<const std::uint8_t*>(uid.data()),
+                                        uid.size());
+    return u;
+}
+
+} // namespace recum12::core
@@ -1,20 +1,33 @@
 // Basit CSV okuma için:
 #include "core/UserManager.h"
+#include "core/UserDbImage.h"
+#include "utils/CsvScanner.h"
+#include <charconv>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace recum12::core {
 
 namespace {
 
-std::string trimCopy(std::string s)
+using recum12::utils::CsvField;
+using recum12::utils::CsvScanner;
+
+std::string_view trimView(std::string_view s)
 {
     const char* ws = " \t\r\n";
     auto b = s.find_first_not_of(ws);
     auto e = s.find_last_not_of(ws);
-    if (b == std::string::npos) {
+    if (b == std::string_view::npos) {
         return {};
     }
     return s.substr(b, e - b + 1);
@@ -34,61 +47,74 @@ std::string upperCopy(std::string s)
     return s;
 }
 
-// Çok basit CSV splitter (virgüle göre böler, tırnaklı karmaşık durumları
-// şimdilik desteklemiyoruz; users.csv buna göre düzenlenecek).
-std::vector<std::string> splitCsvLine(const std::string& line)
+// Alanın kırpılmış değeri ("" kaçışı varsa unescape edilir).
+std::string fieldText(const CsvField& f)
 {
-    std::vector<std::string> out;
-    std::string current;
-    std::istringstream iss(line);
-    while (std::getline(iss, current, ',')) {
-        out.push_back(current);
+    if (!f.escaped) {
+        return std::string(trimView(f.raw));
     }
-    return out;
+    return std::string(trimView(f.text()));
+}
+
+// std::stoi gibi: baştaki boşluk ve '+' kabul, sondaki artık yok sayılır.
+bool parseIntField(const CsvField& f, int& out)
+{
+    std::string_view s = trimView(f.raw);
+    if (!s.empty() && s.front() == '+') {
+        s.remove_prefix(1);
+    }
+    const auto r = std::from_chars(s.data(), s.data() + s.size(), out);
+    return r.ec == std::errc{} && r.ptr != s.data();
 }
 
 } // namespace
 
 UserManager::UserManager() = default;
+UserManager::~UserManager()
+{
+    stopWatching();
+}
+
+namespace {
 
-std::string UserManager::normalize(const std::string& s)
+// CSV dosyasının mtime/size bilgisini okur (hash hariç).
+bool statCsv(const std::string& path, UserDbSourceStamp& stamp)
 {
-    // UID normalizasyonu:
-    //  - baştaki/sondaki whitespace'leri at
-    //  - içerdeki boşluk, ':' ve '-' karakterlerini tamamen kaldır
-    //  - kalanları UPPER case'e çevir
-    //
-    // Böylece aşağıdakilerin hepsi aynı değere normalize olur:
-    //   "32A0AB04"
-    //   "32 A0 AB 04"
-    //   "32:A0:AB:04"
-    //   "32-a0-ab-04"
-    std::string cleaned;
-    cleaned.reserve(s.size());
-    for (char c : trimCopy(s)) {
-        if (c == ' ' || c == ':' || c == '-') continue;
-        cleaned.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0) {
+        return false;
     }
-    return cleaned;
+    stamp.mtime_ns = static_cast<std::uint64_t>(st.st_mtim.tv_sec) * 1000000000ull +
+                     static_cast<std::uint64_t>(st.st_mtim.tv_nsec);
+    stamp.size     = static_cast<std::uint64_t>(st.st_size);
+    return true;
 }
 
-bool UserManager::loadUsers(const std::string& path)
+bool readWholeFile(const std::string& path, std::string& out)
 {
-    path_ = path;
-    users_.clear();
-
-    std::ifstream in(path);
+    std::ifstream in(path, std::ios::binary);
     if (!in.good()) {
         return false;
     }
+    std::ostringstream oss;
+    oss << in.rdbuf();
+    out = oss.str();
+    return true;
+}
 
-    std::string headerLine;
-    if (!std::getline(in, headerLine)) {
-        return false;
-    }
+// users.csv içeriğini UserRecord listesine çevirir.
+//  - errors: atlanan satır + parse edilemeyen (boş olmayan) sayısal alan sayısı
+bool parseUsersCsv(const std::string& content,
+                   std::vector<UserRecord>& users,
+                   std::size_t* errors = nullptr)
+{
+    users.clear();
+    std::size_t errCount = 0;
 
-    auto hdr = splitCsvLine(headerLine);
-    if (hdr.empty()) {
+    // Alanlar content'e işaret eder; satır başına kopya yalnızca string kolonlarda
+    CsvScanner scanner(content);
+    std::vector<CsvField> hdr;
+    if (!scanner.next(hdr) || hdr.empty()) {
         return false;
     }
 
@@ -101,7 +127,7 @@ bool UserManager::loadUsers(const std::string& path)
     int idxRfid    = -1;
 
     for (size_t i = 0; i < hdr.size(); ++i) {
-        const auto h = lowerCopy(trimCopy(hdr[i]));
+        const auto h = lowerCopy(fieldText(hdr[i]));
         if (h == "userid"   || h == "user_id" || h == "idn")  idxUserId = static_cast<int>(i);
         else if (h == "level"   || h == "role")               idxLevel  = static_cast<int>(i);
         else if (h == "firstname" || h == "first_name")       idxFirst  = static_cast<int>(i);
@@ -117,54 +143,336 @@ bool UserManager::loadUsers(const std::string& path)
         return false;
     }
 
-    std::string line;
-    while (std::getline(in, line)) {
-        if (line.empty()) continue;
-        auto cols = splitCsvLine(line);
-        if (static_cast<int>(cols.size()) <= idxUserId) continue;
+    std::vector<CsvField> cols;
+    while (scanner.next(cols)) {
+        if (cols.size() == 1 && !cols[0].quoted && trimView(cols[0].raw).empty()) continue;
+        if (static_cast<int>(cols.size()) <= idxUserId) { ++errCount; continue; }
 
         UserRecord u{};
-        try { u.userId = std::stoi(trimCopy(cols[idxUserId])); }
-        catch (...) { u.userId = 0; }
-        if (u.userId <= 0) continue;
+        if (!parseIntField(cols[idxUserId], u.userId)) { u.userId = 0; }
+        if (u.userId <= 0) { ++errCount; continue; }
 
         if (idxLevel >= 0 && idxLevel < static_cast<int>(cols.size())) {
-            try { u.level = std::stoi(trimCopy(cols[idxLevel])); }
-            catch (...) { u.level = 4; }
+            if (!parseIntField(cols[idxLevel], u.level)) { u.level = 4; ++errCount; }
         }
-        if (idxFirst >= 0 && idxFirst < static_cast<int>(cols.size()))  u.firstName = trimCopy(cols[idxFirst]);
-        if (idxLast  >= 0 && idxLast  < static_cast<int>(cols.size()))  u.lastName  = trimCopy(cols[idxLast]);
-        if (idxPlate >= 0 && idxPlate < static_cast<int>(cols.size()))  u.plate     = trimCopy(cols[idxPlate]);
+        if (idxFirst >= 0 && idxFirst < static_cast<int>(cols.size()))  u.firstName = fieldText(cols[idxFirst]);
+        if (idxLast  >= 0 && idxLast  < static_cast<int>(cols.size()))  u.lastName  = fieldText(cols[idxLast]);
+        if (idxPlate >= 0 && idxPlate < static_cast<int>(cols.size()))  u.plate     = fieldText(cols[idxPlate]);
         if (idxLimit >= 0 && idxLimit < static_cast<int>(cols.size())) {
-            try {
-                const auto limitStr = trimCopy(cols[idxLimit]);
-                // Litre cinsinden double olarak oku
-                u.limit_liters = std::stod(limitStr);
-                // Eski kodlar için int limit'i de doldur
-                u.limit        = static_cast<int>(u.limit_liters);
-            } catch (...) {
-                u.limit_liters = 0.0;
+            const std::string_view limitStr = trimView(cols[idxLimit].raw);
+            // Litre limitini double'a uğramadan x100 sabit noktaya çöz
+            if (Volume::parse(limitStr, u.limit_volume)) {
+                // Eski kodlar için int limit'i de doldur (tam litre, kesir atılır)
+                u.limit = static_cast<int>(u.limit_volume.raw() / Volume::kScale);
+            } else {
+                u.limit_volume = Volume{};
                 u.limit        = 0;
+                if (!limitStr.empty()) {
+                    ++errCount;
+                }
             }
         }
         if (idxRfid >= 0 && idxRfid < static_cast<int>(cols.size())) {
-            u.rfid = normalize(cols[idxRfid]); // UPPER normalize
+            // "32A0AB04", "32 a0 ab 04", "32:A0:AB:04" ... aynı UID'ye çözülür
+            if (!CardUid::parseHex(cols[idxRfid].raw, u.rfid)) {
+                ++errCount;
+            }
+        }
+
+        users.push_back(std::move(u));
+    }
+
+    if (errors) {
+        *errors = errCount;
+    }
+    return true;
+}
+
+} // namespace
+
+// Yayındaki kullanıcı tablosu: ya mmap imaj ya da bellekteki liste.
+// Bir kez kurulduktan sonra değişmez (immutable); okuyucular kilitsiz paylaşır.
+struct UserManager::Table
+{
+    std::unique_ptr<UserDbImage> image;
+    std::vector<UserRecord>      rows;   // imaj yazılamadıysa fallback
+    std::size_t                  parseErrors{0};
+
+    bool fromImage() const noexcept { return image != nullptr; }
+    std::size_t size() const noexcept { return image ? image->size() : rows.size(); }
+};
+
+std::string UserManager::imagePathFor(const std::string& csvPath)
+{
+    const auto slash = csvPath.find_last_of('/');
+    const auto dot   = csvPath.find_last_of('.');
+    if (dot != std::string::npos &&
+        (slash == std::string::npos || dot > slash)) {
+        return csvPath.substr(0, dot) + ".udb";
+    }
+    return csvPath + ".udb";
+}
+
+bool UserManager::compileUserDb(const std::string& csvPath,
+                                const std::string& imagePath,
+                                std::size_t*       rowCount)
+{
+    UserDbSourceStamp stamp{};
+    std::string       content;
+    if (!statCsv(csvPath, stamp) || !readWholeFile(csvPath, content)) {
+        return false;
+    }
+    stamp.hash = UserDbImage::fnv1a(content.data(), content.size());
+
+    std::vector<UserRecord> users;
+    if (!parseUsersCsv(content, users)) {
+        return false;
+    }
+    if (rowCount) {
+        *rowCount = users.size();
+    }
+    return UserDbImage::compile(users, stamp, imagePath);
+}
+
+bool UserManager::loadUsers(const std::string& path)
+{
+    path_ = path;
+    return reload(path);
+}
+
+bool UserManager::reload(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(reloadMtx_);
+    const auto t0 = std::chrono::steady_clock::now();
+
+    auto table = std::make_shared<Table>();
+    bool ok    = false;
+
+    const std::string imagePath = imagePathFor(path);
+    auto image = std::make_unique<UserDbImage>();
+    const bool haveImage = image->open(imagePath);
+
+    UserDbSourceStamp stamp{};
+    const bool haveCsv = statCsv(path, stamp);
+    std::string content;
+
+    // 1) Hızlı yol: imaj CSV ile birebir aynı mtime/size'a sahip.
+    //    CSV yoksa (sahaya sadece imaj kopyalandıysa) imajı olduğu gibi kullan.
+    if (haveImage &&
+        (!haveCsv ||
+         (image->stamp().mtime_ns == stamp.mtime_ns &&
+          image->stamp().size == stamp.size))) {
+        table->image = std::move(image);
+        ok = true;
+    } else if (haveCsv && readWholeFile(path, content)) {
+        stamp.hash = UserDbImage::fnv1a(content.data(), content.size());
+
+        if (haveImage &&
+            image->stamp().size == stamp.size &&
+            image->stamp().hash == stamp.hash) {
+            // 2) mtime değişmiş ama içerik aynı (touch, kopyalama vb.) → yine imaj.
+            table->image = std::move(image);
+            ok = true;
+        } else {
+            // 3) Yavaş yol: CSV'yi parse et, bir sonraki açılış için imajı derle.
+            image.reset();
+            std::vector<UserRecord> parsed;
+            if (parseUsersCsv(content, parsed, &table->parseErrors)) {
+                auto fresh = std::make_unique<UserDbImage>();
+                if (UserDbImage::compile(parsed, stamp, imagePath) &&
+                    fresh->open(imagePath)) {
+                    table->image = std::move(fresh);
+                } else {
+                    // İmaj yazılamadıysa (salt-okunur FS vb.) bellekteki listeyle devam.
+                    table->rows = std::move(parsed);
+                }
+                ok = true;
+            }
+        }
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - t0).count();
+
+    std::lock_guard<std::mutex> mlock(metricsMtx_);
+    metrics_.last_reload_ms = ms;
+    metrics_.last_reload_at = std::chrono::system_clock::now();
+    if (!ok) {
+        // Başarısız reload'da yayındaki (eski) tablo korunur.
+        ++metrics_.reload_failures;
+        return false;
+    }
+
+    ++metrics_.reload_count;
+    metrics_.rows_loaded     = table->size();
+    metrics_.parse_errors    = table->parseErrors;
+    metrics_.last_from_image = table->fromImage();
+
+    std::atomic_store(&table_, std::shared_ptr<const Table>(std::move(table)));
+    return true;
+}
+
+std::vector<UserRecord> UserManager::allUsers() const
+{
+    const auto t = std::atomic_load(&table_);
+    if (!t) {
+        return {};
+    }
+    if (!t->image) {
+        return t->rows;
+    }
+
+    std::vector<UserRecord> out;
+    out.reserve(t->image->size());
+    for (std::size_t i = 0; i < t->image->size(); ++i) {
+        out.push_back(t->image->recordAt(i));
+    }
+    return out;
+}
+
+bool UserManager::loadedFromImage() const
+{
+    const auto t = std::atomic_load(&table_);
+    return t && t->fromImage();
+}
+
+UserReloadMetrics UserManager::metrics() const
+{
+    std::lock_guard<std::mutex> lock(metricsMtx_);
+    return metrics_;
+}
+
+bool UserManager::startWatching()
+{
+    if (watching_.load() || path_.empty()) {
+        return watching_.load();
+    }
+
+    std::string dir  = ".";
+    std::string file = path_;
+    const auto slash = path_.find_last_of('/');
+    if (slash != std::string::npos) {
+        dir  = path_.substr(0, slash);
+        file = path_.substr(slash + 1);
+        if (dir.empty()) {
+            dir = "/";
         }
+    }
+
+    inotifyFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        return false;
+    }
 
-        users_.push_back(std::move(u));
+    // Klasörü izliyoruz: editörler/scp genelde "yaz + rename" yaptığı için
+    // dosyanın kendisine bağlı watch, rename'den sonra kaybolur.
+    if (::inotify_add_watch(inotifyFd_, dir.c_str(),
+                            IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        ::close(inotifyFd_);
+        inotifyFd_ = -1;
+        return false;
+    }
+
+    wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        ::close(inotifyFd_);
+        inotifyFd_ = -1;
+        return false;
     }
 
+    watching_.store(true);
+    watchThread_ = std::thread(&UserManager::watchLoop, this, dir, file);
     return true;
 }
 
-std::optional<UserRecord> UserManager::findByRfid(const std::string& uidHex) const
+void UserManager::stopWatching()
+{
+    if (!watching_.exchange(false)) {
+        return;
+    }
+
+    const std::uint64_t one = 1;
+    (void)!::write(wakeFd_, &one, sizeof(one));
+
+    if (watchThread_.joinable()) {
+        watchThread_.join();
+    }
+
+    ::close(inotifyFd_);
+    ::close(wakeFd_);
+    inotifyFd_ = -1;
+    wakeFd_    = -1;
+}
+
+void UserManager::watchLoop(std::string dir, std::string file)
 {
-    const std::string wanted = normalize(uidHex);
-    if (wanted.empty()) {
+    (void)dir;
+    alignas(inotify_event) char buf[4096];
+
+    // İlgili olay geldikten sonra kısa bir süre sessizlik bekle (debounce):
+    // aynı kaydetme işlemi birden çok olay üretebilir.
+    constexpr int kDebounceMs = 200;
+    bool pending = false;
+
+    while (watching_.load()) {
+        pollfd fds[2] = {
+            { inotifyFd_, POLLIN, 0 },
+            { wakeFd_,    POLLIN, 0 },
+        };
+        const int rc = ::poll(fds, 2, pending ? kDebounceMs : -1);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            break; // stopWatching()
+        }
+
+        if (rc == 0) {
+            // Debounce süresi doldu → rebuild
+            pending = false;
+            const bool ok = reload(path_);
+            if (onReloaded) {
+                onReloaded(ok, metrics());
+            }
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            for (;;) {
+                const ssize_t n = ::read(inotifyFd_, buf, sizeof(buf));
+                if (n <= 0) {
+                    break;
+                }
+                for (char* p = buf; p < buf + n; ) {
+                    const auto* ev = reinterpret_cast<const inotify_event*>(p);
+                    if (ev->len > 0 && file == ev->name) {
+                        pending = true;
+                    }
+                    p += sizeof(inotify_event) + ev->len;
+                }
+            }
+        }
+    }
+}
+
+std::optional<UserRecord> UserManager::findByRfid(const CardUid& uid) const
+{
+    if (uid.empty()) {
         return std::nullopt;
     }
-    for (const auto& u : users_) {
-        if (!u.rfid.empty() && u.rfid == wanted) {
+
+    const auto t = std::atomic_load(&table_);
+    if (!t) {
+        return std::nullopt;
+    }
+    if (t->image) {
+        return t->image->findByRfid(uid);
+    }
+    for (const auto& u : t->rows) {
+        if (u.rfid == uid) {
             return u;
         }
     }
@@ -1,18 +1,18 @@
 #include "gui/MainWindow.h"
+#include "utils/InfraLog.h"
 
-#include <iostream>
 #include <vector>
 #include <sstream>
 #include <gdkmm/pixbuf.h>
 
-// Not: ikon yüklerken hata alırsak stderr'e loglayıp sessizce devam ediyoruz.
+// Not: ikon yüklerken hata alırsak infra log'a yazıp sessizce devam ediyoruz.
 namespace recum12::gui {
 
 MainWindow::MainWindow(const Glib::RefPtr<Gtk::Builder>& builder)
     : builder_(builder)
 {
     if (!builder_) {
-        std::cerr << "MainWindow: builder is null" << std::endl;
+        RECUM_LOG_ERROR("GUI", "MainWindow: builder is null");
         return;
     }
 
@@ -32,7 +32,7 @@ MainWindow::MainWindow(const Glib::RefPtr<Gtk::Builder>& builder)
     }
 
     if (!root_window_) {
-        std::cerr << "MainWindow: root window bulunamadı." << std::endl;
+        RECUM_LOG_ERROR("GUI", "MainWindow: root window bulunamadı.");
         return;
     }
 
@@ -111,13 +111,13 @@ bool MainWindow::apply_css_from_file(const std::string& css_path)
     try {
         css->load_from_path(css_path);
     } catch (const Glib::Error& ex) {
-        std::cerr << "CSS yüklenemedi (" << css_path << "): " << ex.what() << std::endl;
+        RECUM_LOG_ERROR("GUI", "CSS yüklenemedi ({}): {}", css_path, std::string(ex.what()));
         return false;
     }
 
     auto screen = Gdk::Screen::get_default();
     if (!screen) {
-        std::cerr << "CSS için ekran bulunamadı." << std::endl;
+        RECUM_LOG_ERROR("GUI", "CSS için ekran bulunamadı.");
         return false;
     }
 
@@ -136,8 +136,8 @@ void MainWindow::set_status_message(const Glib::ustring& text)
         lblmsg_->set_text(text);
     }
 
-    // Test için loglayalım:
-    std::cout << "[GUI][lblmsg] <= \"" << text << "\"" << std::endl;
+    // GUI thread'inde her mesajda: kuyruğa bırak, stdout'u bekleme
+    RECUM_LOG_INFO("GUI/lblmsg", "<= \"{}\"", text.raw());
 }
 
 void MainWindow::set_user_id(const Glib::ustring& text)
@@ -173,8 +173,7 @@ namespace {
             img->set(pix);
         }
         catch (const Glib::Error& ex) {
-            std::cerr << "[GUI] icon yüklenemedi (" << path << "): "
-                      << ex.what() << std::endl;
+            RECUM_LOG_WARN("GUI", "icon yüklenemedi ({}): {}", path, std::string(ex.what()));
         }
     }
 }
@@ -411,7 +410,7 @@ void MainWindow::on_auth_clicked()
 {
     // Şimdilik sadece log + status label güncellemesi.
     // Gerçek akışta buradan state machine / pompa auth tetiklenecek.
-    std::cout << "[GUI] AUTH butonuna basıldı (btnauth)" << std::endl;
+    RECUM_LOG_INFO("GUI", "AUTH butonuna basıldı (btnauth)");
 
     // Bu bir auth mesajı, pompa durumundan ayrı ele alınacak.
     set_status_message("Yetki isteği gönderiliyor (AUTH)..."); // geçici mesaj
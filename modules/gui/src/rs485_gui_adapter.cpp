@@ -2,14 +2,12 @@
 #include "gui/MainWindow.h"
 #include "gui/StatusMessageController.h"
 #include "core/PumpRuntimeState.h"
-#include "hw/PumpR07Protocol.h"
+#include "utils/InfraLog.h"
 
 #include <glibmm/ustring.h>
-#include <iostream>
 
 namespace recum12::gui {
 
-using recum12::hw::PumpState;
 using Channel = StatusMessageController::Channel;
 
 Rs485GuiAdapter::Rs485GuiAdapter(MainWindow& ui,
@@ -21,78 +19,72 @@ Rs485GuiAdapter::Rs485GuiAdapter(MainWindow& ui,
 
 void Rs485GuiAdapter::apply(const ::core::PumpRuntimeState& s)
 {
-    const PumpState st          = s.pump_state;
-    const bool      nozzle_out  { s.nozzle_out };
-    const bool      auth_active { s.auth_active };
+    using ::core::StationState;
+    using ::core::StationStateMachine;
+
+    // Görünüm yalnızca istasyon durum makinesinin çıktısından sürülür;
+    // pompa durumu / latch'ler burada yeniden yorumlanmaz.
+    const StationState st         = s.station;
+    const bool         auth_active{ s.auth_active };
 
     // CORE sözleşmesi:
-    //  - current_fill_volume_l / has_current_fill : devam eden satış seviyesi
-    //  - last_fill_volume_l   / has_last_fill    : son tamamlanmış satış seviyesi
-    const double    cur_l      = s.current_fill_volume_l;
+    //  - current_fill_volume / has_current_fill : devam eden satış seviyesi
+    //  - last_fill_volume   / has_last_fill    : son tamamlanmış satış seviyesi
+    // Ondalığa çevrim yalnızca burada (GUI kenarı) yapılır.
+    const double    cur_l      = s.current_fill_volume.toDouble();
     const bool      has_cur    = s.has_current_fill;
-    const double    last_l     = s.last_fill_volume_l;
+    const double    last_l     = s.last_fill_volume.toDouble();
     const bool      has_last   = s.has_last_fill;
 
     // RFID / AUTH bilgileri
     const bool      auth_ok          = s.last_card_auth_ok;
-    const std::string& user_id       = s.last_card_user_id;
     const std::string& plate         = s.last_card_plate;
-    std::cout << "[GUI][PumpState] st=" << static_cast<int>(st)
-              << " nozzle_out=" << nozzle_out
-              << " cur_l=" << (has_cur ? cur_l : -1.0)
-              << " last_l=" << (has_last ? last_l : -1.0)
-              << std::endl;
+    // Her store güncellemesinde çağrılır: yalnızca DEBUG derlemede
+    RECUM_LOG_DEBUG("GUI/Station", "st={} pump={} cur_l={} last_l={}",
+                    StationStateMachine::name(st), static_cast<int>(s.pump_state),
+                    has_cur ? cur_l : -1.0, has_last ? last_l : -1.0);
 
     switch (st) {
-    case PumpState::NotProgrammed:
-    case PumpState::Reset:
-    case PumpState::SwitchedOff:
-    case PumpState::Suspended:
-    case PumpState::Unknown:
+    case StationState::Idle:
     default:
-        ui_.apply_idle_view(nozzle_out);
-        if (nozzle_out) {
-            // Excel satır 1
-            status_.set_message(Channel::Pump,
-                "Tabancayı depoya yerleştiriniz ve kartı Okutunuz");
-        } else {
-            // Excel satır 0
-            status_.set_message(Channel::Pump,
-                "İşlem Yapılabilir");
+        ui_.apply_idle_view(false);
+        // Parçalı dolumda FillDone'a uğramadan Idle'a dönülebilir;
+        // son satış litresi lastfuel etiketinde kalsın.
+        if (has_last) {
+            ui_.set_last_fuel_value(last_l);
         }
+        // Excel satır 0
+        status_.set_message(Channel::Pump,
+            "İşlem Yapılabilir");
         break;
 
-    case PumpState::Authorized:
-        // AUTH latch'i kapalı ise (timeout vb.) bu durumu IDLE gibi ele al.
-        if (!auth_active) {
-            ui_.apply_idle_view(nozzle_out);
-            if (nozzle_out) {
-                // Excel satır 1
-                status_.set_message(Channel::Pump,
-                    "Tabancayı depoya yerleştiriniz ve kartı Okutunuz");
-            } else {
-                // Excel satır 0
-                status_.set_message(Channel::Pump,
-                    "İşlem Yapılabilir");
-            }
-        } else {
-            ui_.apply_auth_ok_view(nozzle_out);
-            if (nozzle_out) {
-                // Excel satır 3
-                status_.set_message(Channel::Pump,
-                    "Doluma başlayabilirsiniz.");
-            } else {
-                // Excel satır 2
-                status_.set_message(Channel::Pump,
-                    "Dolum Bekleniyor");
-            }
-        }
+    case StationState::WaitingCard:
+    case StationState::Unauthorized:
+        // "Yetkisiz Kullanıcı" Auth kanalında; Pump kanalı kart ister.
+        ui_.apply_idle_view(true);
+        // Excel satır 1
+        status_.set_message(Channel::Pump,
+            "Tabancayı depoya yerleştiriniz ve kartı Okutunuz");
+        break;
+
+    case StationState::Authorized:
+        ui_.apply_auth_ok_view(false);
+        // Excel satır 2
+        status_.set_message(Channel::Pump,
+            "Dolum Bekleniyor");
+        break;
+
+    case StationState::ReadyToFill:
+        ui_.apply_auth_ok_view(true);
+        // Excel satır 3
+        status_.set_message(Channel::Pump,
+            "Doluma başlayabilirsiniz.");
         break;
 
-    case PumpState::Filling: {
+    case StationState::Filling: {
         // Devam eden satış: mümkünse current, yoksa last
         const double use_l = has_cur ? cur_l : (has_last ? last_l : 0.0);
-        ui_.apply_filling_view(nozzle_out, use_l);
+        ui_.apply_filling_view(true, use_l);
 
         if (use_l > 0.0) {
             // Excel satır 4
@@ -106,25 +98,13 @@ void Rs485GuiAdapter::apply(const ::core::PumpRuntimeState& s)
         break;
     }
 
-    case PumpState::FillingCompleted:
-    case PumpState::MaxAmount: {
-        // Satış tamamlandı: son tamamlanmış satışın litresini göster
+    case StationState::FillDone: {
+        // Satış tamamlandı, tabanca hâlâ dışarıda: son satışın litresini göster
         const double use_l = has_last ? last_l : 0.0;
-        if (nozzle_out) {
-            // Nozzle hâlâ dışarıda → kullanıcıya tabancayı depoya koy mesajı.
-            ui_.apply_fill_done_view(true, use_l);
-            // Excel satır 6
-            status_.set_message(Channel::Pump,
-                "Dolum tamamlandı, tabancayı depoya yerleştiriniz.");
-        } else {
-            // Nozzle IN → satış tamamen bitti, sistemi IDLE kabul et.
-            //  - last_l, fill_done_view ile lastfuel etiketine yazılıyor
-            //  - level her zamanki gibi 0.0 yapılıyor
-            ui_.apply_fill_done_view(false, use_l);
-            // Artık yeni işleme hazırız.
-            status_.set_message(Channel::Pump,
-                "İşlem Yapılabilir");
-        }
+        ui_.apply_fill_done_view(true, use_l);
+        // Excel satır 6
+        status_.set_message(Channel::Pump,
+            "Dolum tamamlandı, tabancayı depoya yerleştiriniz.");
         break;
     }
     }
@@ -137,7 +117,7 @@ void Rs485GuiAdapter::apply(const ::core::PumpRuntimeState& s)
     //      * sadece user_id varsa:   "USER"
     //      * sadece plate varsa:     "PLAKA"
     //  - aksi halde:
-    //      * FillingCompleted / MaxAmount durumunda  → "::::"
+    //      * FillDone durumunda                      → "::::"
     //      * diğer tüm durumlarda                    → "-------"
     Glib::ustring user_text;
 
@@ -147,7 +127,7 @@ void Rs485GuiAdapter::apply(const ::core::PumpRuntimeState& s)
     }
 
     if (user_text.empty()) {
-        if (st == PumpState::FillingCompleted || st == PumpState::MaxAmount) {
+        if (st == StationState::FillDone) {
             user_text = "::::";
         } else {
             user_text = "-------";
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -38,21 +42,44 @@ public:
     // MIN-POLL (heart-beat): 50 20 FA (→ 50 70 FA MIN-ACK beklenir)
     // Not: Adres olarak R07_DEFAULT_ADDR (0x50) kullanılır.
     bool sendMinPoll();
+    // Hattaki diğer pompalar için (0x50..0x6F)
+    bool sendMinPoll(Byte addr);
 
     // PRESET VOLUME (CD3): litre bazlı preset (0.1 .. 250.0 L aralığı)
-    bool sendPresetVolume(double liters);
+    bool sendPresetVolume(Volume volume);
 
     // TOTAL COUNTERS (CD101 / 0x65)
     bool sendTotalCounters();
 
+    // --- Bus scheduler (TX kuyruğu) ---
+    //
+    // Seri hattı yalnızca RS485 worker thread'i yazar; diğer thread'ler
+    // (auth stage, GUI butonu vb.) komutlarını kuyruğa bırakır ve hemen döner.
+    // done callback'i frame yazıldıktan sonra RS485 thread'inde çağrılır.
+    using TxDoneCb = std::function<void(bool ok)>;
+
+    bool queueFrame(Frame frame, TxDoneCb done = {});
+    bool queueStatusPoll(std::uint8_t dcc, TxDoneCb done = {});
+    bool queueTotalCounters(TxDoneCb done = {});
+    // Belirli pompa adresi + tabanca için (çoklu pompa / tabanca)
+    bool queueStatusPoll(const PumpSlotRef& slot, std::uint8_t dcc, TxDoneCb done = {});
+    bool queueTotalCounters(const PumpSlotRef& slot, TxDoneCb done = {});
+
+    // Kuyruktaki komutları sırayla yazar; yazılan komut sayısını döner.
+    // Totalizer yanıtı tabanca taşımadığından adres başına tek istek uçuştadır:
+    // aynı adrese sonraki istek yanıt (ya da kTotalsReplyTimeout) gelene kadar
+    // kuyrukta bekler.
+    // Yalnızca RS485 worker thread'inden çağrılmalı.
+    std::size_t flushTxQueue();
+
     // --- RX tarafı: dıştaki okuma döngüsü ham frame'i buraya verir ---
     void handleReceivedFrame(const Frame& frame);
 
     // --- Olay callback'leri (PumpR07Protocol'unkileri dışarı taşır) ---
-    std::function<void(PumpState)>            onStatus;
-    std::function<void(const FillInfo&)>      onFill;
-    std::function<void(const TotalCounters&)> onTotals;
-    std::function<void(const NozzleEvent&)>   onNozzle;
+    std::function<void(const PumpStatusEvent&)> onStatus;
+    std::function<void(const FillInfo&)>        onFill;
+    std::function<void(const TotalCounters&)>   onTotals;
+    std::function<void(const NozzleEvent&)>     onNozzle;
 
 private:
     bool writeFrame(const Frame& frame);
@@ -63,6 +90,23 @@ private:
 
     // RS-485 RX için biriktirilen ham byte'lar (frame kesme için).
     std::vector<Byte> m_rxBuffer;
+
+    struct TxCommand {
+        Frame       frame;
+        TxDoneCb    done;
+        PumpSlotRef totals{};         // totalizer isteğiyse sorulan slot
+        bool        isTotals{false};
+    };
+    static constexpr std::size_t kMaxTxQueue = 32;
+    static constexpr std::chrono::milliseconds kTotalsReplyTimeout{500};
+    static constexpr std::size_t kAddrCount = R07_MAX_ADDR - R07_DEFAULT_ADDR + 1;
+
+    std::mutex            m_txMtx;
+    std::deque<TxCommand> m_txQueue;
+
+    // Adres başına uçuştaki totalizer isteğinin gönderim anı (RS485 thread'i)
+    std::array<std::chrono::steady_clock::time_point, kAddrCount> m_totalsSentAt{};
+    std::array<bool, kAddrCount>                                   m_totalsInFlight{};
 };
 
 } // namespace recum12::hw
@@ -7,8 +7,15 @@
 #include <string>
 #include <vector>
 
+#include "utils/FixedPoint.h"
+
 namespace recum12::hw {
 
+// Hacim (centilitre) ve tutar (kuruş) BCD x100 ham değerini taşır;
+// double'a çevrim yalnızca GUI/export kenarında yapılır.
+using recum12::utils::Volume;
+using recum12::utils::Amount;
+
 enum class PumpState {
     Unknown = 0,
     NotProgrammed,
@@ -21,17 +28,41 @@ enum class PumpState {
     Suspended
 };
 
+constexpr std::uint8_t R07_DEFAULT_ADDR   = 0x50;  // Varsayılan istasyon adresi (YAT loglarına göre)
+constexpr std::uint8_t R07_MAX_ADDR       = 0x6F;  // DART pompa adresleri: 0x50..0x6F
+constexpr std::uint8_t R07_DEFAULT_NOZZLE = 0x01;
+
+// Olayın ait olduğu pompa (hat adresi) + tabanca.
+struct PumpSlotRef {
+    std::uint8_t addr{R07_DEFAULT_ADDR};
+    std::uint8_t nozzle{R07_DEFAULT_NOZZLE};
+
+    bool operator==(const PumpSlotRef& o) const noexcept
+    {
+        return addr == o.addr && nozzle == o.nozzle;
+    }
+    bool operator!=(const PumpSlotRef& o) const noexcept { return !(*this == o); }
+};
+
+struct PumpStatusEvent {
+    PumpSlotRef slot{};
+    PumpState   state{PumpState::Unknown};
+};
+
 struct FillInfo {
-    double volume_l{0.0};
-    double amount{0.0};
+    PumpSlotRef slot{};
+    Volume volume{};
+    Amount amount{};
 };
 
 struct TotalCounters {
-    double total_volume_l{0.0};
-    double total_amount{0.0};
+    PumpSlotRef slot{};
+    Volume total_volume{};
+    Amount total_amount{};
 };
 
 struct NozzleEvent {
+    PumpSlotRef slot{};
     bool nozzle_out{false};
 };
 class PumpR07Protocol {
@@ -45,14 +76,16 @@ public:
 
     // STATUS (CD1) – Python'daki _send_cd1 karşılığı olacak
     Frame makeStatusPollFrame(Byte addr, Byte dcc) const;
+    // Belirli pompa + tabanca için STATUS (ör. AUTHORIZE)
+    Frame makeStatusPollFrame(const PumpSlotRef& slot, Byte dcc) const;
     // Varsayılan pompa adresi (R07_DEFAULT_ADDR) ile STATUS
     Frame makeStatusPollFrame(Byte dcc) const;
     // PRESET VOLUME (CD3) – Python _send_cd3_preset_volume
-    Frame makePresetVolumeFrame(double liters,
+    Frame makePresetVolumeFrame(Volume volume,
                                 Byte addr,
                                 Byte nozzle) const;
     // Varsayılan addr + nozzle-1 ile preset volume (Python'daki tipik kullanım)
-    Frame makePresetVolumeFrame(double liters) const;
+    Frame makePresetVolumeFrame(Volume volume) const;
 
     // TOTAL COUNTERS (CD101 / 0x65) – Python tarafındaki sayaç sorgusu
     Frame makeTotalCountersFrame(Byte addr,
@@ -73,8 +106,12 @@ public:
 
     // ---- Olay callback'leri ----
 
+    // Olaylar PumpSlotRef ile gelir: adres frame'den, tabanca ise o adresin
+    // son DC3 NOZIO'sundaki aktif tabancadır (DC1/DC2/totalizer frame'leri
+    // tabanca numarası taşımaz).
+
     // Pompa durum değişimi (AUTHORIZED, FILLING, COMPLETED vb.)
-    std::function<void(PumpState)>             onStatus;
+    std::function<void(const PumpStatusEvent&)> onStatus;
 
     // Satış (FILL-RECORD) güncellemesi
     std::function<void(const FillInfo&)>       onFill;
@@ -85,9 +122,23 @@ public:
     // Tabanca içeri/dışarı olayı
     std::function<void(const NozzleEvent&)>    onNozzle;
 
+    // Adresin aktif tabancası (DC3 görülmediyse R07_DEFAULT_NOZZLE)
+    PumpSlotRef slotFor(Byte addr) const noexcept;
+
+    // Adrese gönderilen TOTAL COUNTERS isteğinin tabancası: sıradaki 0x3D
+    // yanıtı (tabanca taşımaz) bu tabancaya yazılır. nozzle 0 → beklenti yok
+    // (yanıt aktif tabancaya gider).
+    void expectTotals(Byte addr, Byte nozzle) noexcept;
+
 private:
-    // Şimdilik iç durum tutmuyoruz; Python tarafındaki state machine
-    // daha sonra buraya veya ayrı bir sınıfa taşınacak.
+    static constexpr std::size_t kAddrCount = R07_MAX_ADDR - R07_DEFAULT_ADDR + 1;
+
+    void emitStatus(Byte addr, PumpState st);
+
+    // Adres başına son seçilen tabanca (0 → henüz DC3 gelmedi)
+    std::array<Byte, kAddrCount> m_activeNozzle{};
+    // Adres başına yanıtı beklenen totalizer isteğinin tabancası (0 → yok)
+    std::array<Byte, kAddrCount> m_totalsNozzle{};
 };
 
 // Protocol-level helper functions shared with RS-485 controller.
@@ -113,7 +164,6 @@ std::array<std::uint8_t, 4> intToBcd4(std::uint32_t value) noexcept;
 constexpr std::uint8_t R07_ETX   = 0x03;
 constexpr std::uint8_t R07_TRAIL = 0xFA;
 
-constexpr std::uint8_t R07_DEFAULT_ADDR   = 0x50;  // Varsayılan istasyon adresi (YAT loglarına göre)
 constexpr std::uint8_t R07_MIN_POLL_CODE  = 0x20;  // 50 20 FA → MIN-POLL
 constexpr std::uint8_t R07_MIN_ACK_CODE   = 0xC0;  // 50 C0 FA → MIN-ACK
 
@@ -176,12 +226,22 @@ R07ParseResult parseR07Frame(
 std::vector<std::uint8_t> makeR07MinPoll(std::uint8_t addr = R07_DEFAULT_ADDR);
 std::vector<std::uint8_t> makeR07MinAck (std::uint8_t addr = R07_DEFAULT_ADDR);
 
-// CD1 komutu: [ADDR][0x30][NOZ=0x01][LEN=0x01][DCC] + CRC + ETX + TRAIL
+// CD1 komutu: [ADDR][0x30][NOZ][LEN=0x01][DCC] + CRC + ETX + TRAIL
 std::vector<std::uint8_t> makeR07Cd1Frame(
     std::uint8_t addr,
     std::uint8_t dcc,
+    std::uint8_t nozzle,
     R07CrcOrder crcOrder = R07CrcOrder::LoHi);
 
+// Varsayılan nozzle-1 ile CD1
+inline std::vector<std::uint8_t> makeR07Cd1Frame(
+    std::uint8_t addr,
+    std::uint8_t dcc,
+    R07CrcOrder crcOrder = R07CrcOrder::LoHi)
+{
+    return makeR07Cd1Frame(addr, dcc, R07_DEFAULT_NOZZLE, crcOrder);
+}
+
 inline std::vector<std::uint8_t> makeR07Cd1Frame(
     std::uint8_t dcc,
     R07CrcOrder crcOrder = R07CrcOrder::LoHi)
@@ -2,8 +2,8 @@
 #include <cerrno>
 
 #include <cstring>
-#include <iostream>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
 
 // Raspberry Pi / Linux seri port için POSIX API
@@ -11,6 +11,8 @@
 #include <termios.h>
 #include <unistd.h>
 
+#include "utils/InfraLog.h"
+
 namespace recum12::hw {
 
 PumpInterfaceLvl3::PumpInterfaceLvl3()
@@ -19,9 +21,9 @@ PumpInterfaceLvl3::PumpInterfaceLvl3()
     , m_proto{}
 {
     // PumpR07Protocol olaylarını L3 seviyesine forward et
-    m_proto.onStatus = [this](PumpState st) {
+    m_proto.onStatus = [this](const PumpStatusEvent& ev) {
         if (onStatus) {
-            onStatus(st);
+            onStatus(ev);
         }
     };
     m_proto.onFill = [this](const FillInfo& fi) {
@@ -30,6 +32,10 @@ PumpInterfaceLvl3::PumpInterfaceLvl3()
         }
     };
     m_proto.onTotals = [this](const TotalCounters& tc) {
+        // Yanıt geldi: aynı adrese bekleyen sonraki istek gönderilebilir
+        if (tc.slot.addr >= R07_DEFAULT_ADDR && tc.slot.addr <= R07_MAX_ADDR) {
+            m_totalsInFlight[tc.slot.addr - R07_DEFAULT_ADDR] = false;
+        }
         if (onTotals) {
             onTotals(tc);
         }
@@ -63,9 +69,7 @@ bool PumpInterfaceLvl3::open()
     // Not: Raspberry Pi üzerinde /dev/ttyUSBx veya /dev/ttyAMA0 vb.
     int fd = ::open(m_device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
     if (fd < 0) {
-        std::cerr << "[PumpL3] open fail " << m_device
-                  << ": " << std::strerror(errno)
-                  << std::endl;
+        RECUM_LOG_ERROR("PumpL3", "open fail {}: {}", m_device, std::strerror(errno));
         return false;
     }
 
@@ -95,9 +99,7 @@ bool PumpInterfaceLvl3::open()
     }
 
     m_fd = fd;
-    std::cerr << "[PumpL3] open ok " << m_device
-              << " fd=" << m_fd
-              << std::endl;
+    RECUM_LOG_INFO("PumpL3", "open ok {} fd={}", m_device, m_fd);
 
     return true;
 }
@@ -114,7 +116,12 @@ bool PumpInterfaceLvl3::sendMinPoll()
 {
     // Heart-beat: MIN-POLL (50 20 FA) gönderir.
     // Adres: R07_DEFAULT_ADDR (PumpR07Protocol.h içinde, 0x50)
-    Frame fr = m_proto.makeMinPoll(R07_DEFAULT_ADDR);
+    return sendMinPoll(R07_DEFAULT_ADDR);
+}
+
+bool PumpInterfaceLvl3::sendMinPoll(Byte addr)
+{
+    Frame fr = m_proto.makeMinPoll(addr);
     return writeFrame(fr);
 }
 
@@ -170,9 +177,7 @@ bool PumpInterfaceLvl3::pollOnceRx()
         if (frame_len >= 3U) {
             Frame fr(m_rxBuffer.begin(), m_rxBuffer.begin() + frame_len);
             if (!fr.empty()) {
-                std::cerr << "[PumpL3/RX] bytes=" << fr.size()
-                          << " hex=" << toHex(fr)
-                          << std::endl;
+                RECUM_LOG_DEBUG("PumpL3/RX", "bytes={} hex={}", fr.size(), toHex(fr));
 
                 m_proto.parseFrame(fr);
                 any_dispatched = true;
@@ -202,9 +207,7 @@ bool PumpInterfaceLvl3::writeFrame(const Frame& frame)
         return oss.str();
     };
 
-    std::cerr << "[PumpL3/TX] bytes=" << frame.size()
-              << " hex=" << toHex(frame)
-              << std::endl;
+    RECUM_LOG_DEBUG("PumpL3/TX", "bytes={} hex={}", frame.size(), toHex(frame));
 
     const std::uint8_t* data = frame.data();
     std::size_t         left = frame.size();
@@ -232,18 +235,105 @@ bool PumpInterfaceLvl3::sendStatusPoll(std::uint8_t dcc)
     return writeFrame(fr);
 }
 
-bool PumpInterfaceLvl3::sendPresetVolume(double liters)
+bool PumpInterfaceLvl3::sendPresetVolume(Volume volume)
 {
-    Frame fr = m_proto.makePresetVolumeFrame(liters);
+    Frame fr = m_proto.makePresetVolumeFrame(volume);
     return writeFrame(fr);
 }
 
 bool PumpInterfaceLvl3::sendTotalCounters()
 {
     Frame fr = m_proto.makeTotalCountersFrame();
+    m_proto.expectTotals(R07_DEFAULT_ADDR, R07_DEFAULT_NOZZLE);
     return writeFrame(fr);
 }
 
+bool PumpInterfaceLvl3::queueFrame(Frame frame, TxDoneCb done)
+{
+    if (m_fd < 0 || frame.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_txMtx);
+    if (m_txQueue.size() >= kMaxTxQueue) {
+        RECUM_LOG_WARN("PumpL3/TX", "queue full, frame dropped");
+        return false;
+    }
+    m_txQueue.push_back(TxCommand{std::move(frame), std::move(done)});
+    return true;
+}
+
+bool PumpInterfaceLvl3::queueStatusPoll(std::uint8_t dcc, TxDoneCb done)
+{
+    return queueFrame(m_proto.makeStatusPollFrame(dcc), std::move(done));
+}
+
+bool PumpInterfaceLvl3::queueTotalCounters(TxDoneCb done)
+{
+    return queueTotalCounters(PumpSlotRef{}, std::move(done));
+}
+
+bool PumpInterfaceLvl3::queueStatusPoll(const PumpSlotRef& slot, std::uint8_t dcc, TxDoneCb done)
+{
+    return queueFrame(m_proto.makeStatusPollFrame(slot, dcc), std::move(done));
+}
+
+bool PumpInterfaceLvl3::queueTotalCounters(const PumpSlotRef& slot, TxDoneCb done)
+{
+    if (m_fd < 0 || slot.addr < R07_DEFAULT_ADDR || slot.addr > R07_MAX_ADDR) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_txMtx);
+    if (m_txQueue.size() >= kMaxTxQueue) {
+        RECUM_LOG_WARN("PumpL3/TX", "queue full, frame dropped");
+        return false;
+    }
+    TxCommand cmd{m_proto.makeTotalCountersFrame(slot.addr, slot.nozzle), std::move(done)};
+    cmd.totals   = slot;
+    cmd.isTotals = true;
+    m_txQueue.push_back(std::move(cmd));
+    return true;
+}
+
+std::size_t PumpInterfaceLvl3::flushTxQueue()
+{
+    std::deque<TxCommand> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_txMtx);
+        pending.swap(m_txQueue);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    std::deque<TxCommand> deferred;
+    std::size_t written = 0;
+    for (auto& cmd : pending) {
+        if (cmd.isTotals) {
+            const std::size_t i = cmd.totals.addr - R07_DEFAULT_ADDR;
+            if (m_totalsInFlight[i] && now - m_totalsSentAt[i] < kTotalsReplyTimeout) {
+                deferred.push_back(std::move(cmd)); // önceki yanıt bekleniyor
+                continue;
+            }
+            // Yanıt kaybolduysa beklenti yeni istekle değişir
+            m_proto.expectTotals(cmd.totals.addr, cmd.totals.nozzle);
+            m_totalsInFlight[i] = true;
+            m_totalsSentAt[i]   = now;
+        }
+        const bool ok = writeFrame(cmd.frame);
+        ++written;
+        if (cmd.done) {
+            cmd.done(ok);
+        }
+    }
+
+    if (!deferred.empty()) {
+        // Sıra korunur: ertelenenler bu arada kuyruğa eklenenlerin önüne
+        std::lock_guard<std::mutex> lock(m_txMtx);
+        m_txQueue.insert(m_txQueue.begin(), std::make_move_iterator(deferred.begin()),
+                         std::make_move_iterator(deferred.end()));
+    }
+    return written;
+}
+
 void PumpInterfaceLvl3::handleReceivedFrame(const Frame& frame)
 {
     if (frame.empty()) {
@@ -165,9 +165,9 @@ std::vector<std::uint8_t> makeR07MinAck(std::uint8_t addr)
 std::vector<std::uint8_t> makeR07Cd1Frame(
     std::uint8_t addr,
     std::uint8_t dcc,
+    std::uint8_t nozzle,
     R07CrcOrder crcOrder)
 {
-    constexpr std::uint8_t nozzle     = 0x01;  // Şimdilik sabit nozzle-1
     constexpr std::uint8_t len_header = 0x01;  // DCC alanı 1 byte
 
     std::vector<std::uint8_t> payload;
@@ -187,8 +187,9 @@ R07ParseResult parseR07Frame(
         return r;
     }
 
-    // MIN çerçeve: [0x50][0x20/0xC0/0x70][TRAIL]
-    if (len == 3 && frame[0] == 0x50 && frame[2] == R07_TRAIL) {
+    // MIN çerçeve: [ADDR 0x50..0x6F][0x20/0xC0/0x70][TRAIL]
+    if (len == 3 && frame[0] >= R07_DEFAULT_ADDR && frame[0] <= R07_MAX_ADDR &&
+        frame[2] == R07_TRAIL) {
         r.valid = true;
         r.is_min_frame = true;
         r.addr = frame[0];
@@ -255,6 +256,13 @@ PumpR07Protocol::makeStatusPollFrame(PumpR07Protocol::Byte addr,
     return makeR07Cd1Frame(addr, dcc, R07CrcOrder::LoHi);
 }
 
+PumpR07Protocol::Frame
+PumpR07Protocol::makeStatusPollFrame(const PumpSlotRef& slot,
+                                     PumpR07Protocol::Byte dcc) const
+{
+    return makeR07Cd1Frame(slot.addr, dcc, slot.nozzle, R07CrcOrder::LoHi);
+}
+
 PumpR07Protocol::Frame
 PumpR07Protocol::makeStatusPollFrame(PumpR07Protocol::Byte dcc) const
 {
@@ -263,7 +271,7 @@ PumpR07Protocol::makeStatusPollFrame(PumpR07Protocol::Byte dcc) const
 }
 
 PumpR07Protocol::Frame
-PumpR07Protocol::makePresetVolumeFrame(double liters,
+PumpR07Protocol::makePresetVolumeFrame(Volume volume,
                                        PumpR07Protocol::Byte addr,
                                        PumpR07Protocol::Byte /*nozzle*/) const
 {
@@ -274,18 +282,18 @@ PumpR07Protocol::makePresetVolumeFrame(double liters,
     // Örnek:
     //   5X 30 03 04 00 00 08 00 CRCLO CRCHI 03 FA
 
-    // 1) Litre değerini güvenli aralığa sıkıştır
-    if (liters < 0.1) {
-        liters = 0.1;
+    // 1) Hacmi güvenli aralığa sıkıştır (x100 ölçek: 0.10 L = 10, 250.00 L = 25000)
+    constexpr Volume kMin = Volume::fromRaw(10);
+    constexpr Volume kMax = Volume::fromUnits(250);
+    if (volume < kMin) {
+        volume = kMin;
     }
-    if (liters > 250.0) {
-        liters = 250.0;
+    if (volume > kMax) {
+        volume = kMax;
     }
 
-    // 2) Litreyi x100 ölçeğe çevir (8.00 L → 800) ve en yakın tam sayıya yuvarla
-    const double scaled = liters * 100.0;
-    const std::uint32_t raw =
-        static_cast<std::uint32_t>(scaled + 0.5); // round(liters*100)
+    // 2) Volume zaten x100 ölçekte (8.00 L → 800); yuvarlama gerekmiyor
+    const std::uint32_t raw = static_cast<std::uint32_t>(volume.raw());
 
     // 3) 4-byte BCD'e çevir
     const auto vol_bcd = intToBcd4(raw);
@@ -313,12 +321,12 @@ PumpR07Protocol::makePresetVolumeFrame(double liters,
 }
 
 PumpR07Protocol::Frame
-PumpR07Protocol::makePresetVolumeFrame(double liters) const
+PumpR07Protocol::makePresetVolumeFrame(Volume volume) const
 {
     // Python tarafında nozzle şu an sabit 0x01; burada da aynı varsayılanı
     // kullanarak kısayol sağlıyoruz.
     constexpr PumpR07Protocol::Byte nozzle = 0x01;
-    return makePresetVolumeFrame(liters, R07_DEFAULT_ADDR, nozzle);
+    return makePresetVolumeFrame(volume, R07_DEFAULT_ADDR, nozzle);
 }
 
 PumpR07Protocol::Frame
@@ -393,6 +401,37 @@ PumpR07Protocol::makeMinAck(PumpR07Protocol::Byte addr) const
     return makeR07MinAck(addr);
 }
 
+PumpSlotRef PumpR07Protocol::slotFor(PumpR07Protocol::Byte addr) const noexcept
+{
+    PumpSlotRef ref{};
+    ref.addr = addr;
+    if (addr >= R07_DEFAULT_ADDR && addr <= R07_MAX_ADDR) {
+        const Byte noz = m_activeNozzle[addr - R07_DEFAULT_ADDR];
+        if (noz != 0u) {
+            ref.nozzle = noz;
+        }
+    }
+    return ref;
+}
+
+void PumpR07Protocol::expectTotals(PumpR07Protocol::Byte addr,
+                                   PumpR07Protocol::Byte nozzle) noexcept
+{
+    if (addr >= R07_DEFAULT_ADDR && addr <= R07_MAX_ADDR) {
+        m_totalsNozzle[addr - R07_DEFAULT_ADDR] = nozzle;
+    }
+}
+
+void PumpR07Protocol::emitStatus(PumpR07Protocol::Byte addr, PumpState st)
+{
+    if (onStatus) {
+        PumpStatusEvent ev{};
+        ev.slot  = slotFor(addr);
+        ev.state = st;
+        onStatus(ev);
+    }
+}
+
 void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
 {
     // Düşük seviye çözümleme: ham frame'i R07ParseResult'a çevir.
@@ -448,9 +487,7 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
             default:   mapped = PumpState::Unknown;            break;
             }
 
-            if (onStatus) {
-                onStatus(mapped);
-            }
+            emitStatus(res.addr, mapped);
         }
         break;
     }    
@@ -480,9 +517,7 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
             default:   mapped = PumpState::Unknown;            break;
             }
 
-            if (onStatus) {
-                onStatus(mapped);
-            }
+            emitStatus(res.addr, mapped);
         }
         break;
     }
@@ -506,9 +541,7 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
             default:   mapped = PumpState::Unknown;            break;
             }
 
-            if (onStatus) {
-                onStatus(mapped);
-            }
+            emitStatus(res.addr, mapped);
         }
         break;
     }
@@ -522,6 +555,7 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
             const bool nozzle_out = (res.payload[0] != 0x00);
             if (onNozzle) {
                 NozzleEvent ev{};
+                ev.slot       = slotFor(res.addr);
                 ev.nozzle_out = nozzle_out;
                 onNozzle(ev);
             }
@@ -540,11 +574,13 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
         //   [PRICE_BCD0][PRICE_BCD1][PRICE_BCD2][NOZIO]
         //
         // NOZIO baytında:
+        //   - Bit0..3 = seçilen tabanca numarası (0 → değişiklik yok)
         //   - Bit4 = 1 → nozzle OUT
         //   - Bit4 = 0 → nozzle IN
         //
-        // Biz şimdilik sadece nozzle_out bilgisini NozzleEvent ile dışarı veriyoruz.
-        if (onNozzle && !res.payload.empty()) {
+        // Tabanca numarası adresin aktif tabancası olarak saklanır; sonraki
+        // DC1/DC2/totalizer olayları bu tabancaya yazılır.
+        if (!res.payload.empty()) {
             const auto&        p = res.payload;
             const std::size_t  n = p.size();
             if (n >= 6) {
@@ -561,11 +597,19 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
 
                     // Bit4: 1 → OUT, 0 → IN
                     const bool nozzle_out = ((nozio & 0x10u) != 0u);
+                    const Byte nozzle     = static_cast<Byte>(nozio & 0x0Fu);
 
-                    NozzleEvent ev{};
-                    ev.nozzle_out = nozzle_out;
+                    if (nozzle != 0u && res.addr >= R07_DEFAULT_ADDR &&
+                        res.addr <= R07_MAX_ADDR) {
+                        m_activeNozzle[res.addr - R07_DEFAULT_ADDR] = nozzle;
+                    }
 
-                    onNozzle(ev);
+                    if (onNozzle) {
+                        NozzleEvent ev{};
+                        ev.slot       = slotFor(res.addr);
+                        ev.nozzle_out = nozzle_out;
+                        onNozzle(ev);
+                    }
                 }
             }
         }
@@ -600,8 +644,9 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
                     const std::uint32_t amo_raw = bcd4ToInt(amo_bcd); // x100
 
                     FillInfo fi{};
-                    fi.volume_l = static_cast<double>(vol_raw) / 100.0;
-                    fi.amount   = static_cast<double>(amo_raw) / 100.0;
+                    fi.slot   = slotFor(res.addr);
+                    fi.volume = Volume::fromRaw(vol_raw);
+                    fi.amount = Amount::fromRaw(amo_raw);
 
                     onFill(fi);
                     emitted = true;
@@ -640,8 +685,17 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
                         const std::uint32_t vol_raw = bcd4ToInt(vol_bcd); // x100
                         const std::uint32_t amo_raw = bcd4ToInt(amo_bcd); // x100
                         TotalCounters tc{};
-                        tc.total_volume_l = static_cast<double>(vol_raw) / 100.0;
-                        tc.total_amount   = static_cast<double>(amo_raw) / 100.0;
+                        tc.slot = slotFor(res.addr);
+                        // Yanıt, aktif tabancaya değil sorulan tabancaya aittir
+                        if (res.addr >= R07_DEFAULT_ADDR && res.addr <= R07_MAX_ADDR) {
+                            Byte& asked = m_totalsNozzle[res.addr - R07_DEFAULT_ADDR];
+                            if (asked != 0u) {
+                                tc.slot.nozzle = asked;
+                                asked          = 0u;
+                            }
+                        }
+                        tc.total_volume = Volume::fromRaw(vol_raw);
+                        tc.total_amount = Amount::fromRaw(amo_raw);
                         onTotals(tc);
                         emitted = true;
                     }
@@ -655,8 +709,8 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
         // Python _update_dc_from_payload içindeki FILL-RECORD decode'ına paralel:
         //  - payload: [TRANS][LNG][DATA...] blokları
         //  - satış satırı için tipik blok: TRANS=0x02, LNG=0x08
-        //      DATA[0:4] → VOL (ml x100, BCD)  → litre için /100
-        //      DATA[4:8] → AMO (para x100, BCD)→ para birimi için /100
+        //      DATA[0:4] → VOL (litre x100, BCD)  → Volume ham değeri
+        //      DATA[4:8] → AMO (para x100, BCD)   → Amount ham değeri
         if (onFill && !res.payload.empty()) {
             const auto& p = res.payload;
             const std::size_t n = p.size();
@@ -680,8 +734,9 @@ void PumpR07Protocol::parseFrame(const PumpR07Protocol::Frame& frame)
                     const std::uint32_t vol_raw = bcd4ToInt(vol_bcd); // x100
                     const std::uint32_t amo_raw = bcd4ToInt(amo_bcd); // x100
                     FillInfo fi{};
-                    fi.volume_l = static_cast<double>(vol_raw) / 100.0;
-                    fi.amount   = static_cast<double>(amo_raw) / 100.0;
+                    fi.slot   = slotFor(res.addr);
+                    fi.volume = Volume::fromRaw(vol_raw);
+                    fi.amount = Amount::fromRaw(amo_raw);
                     onFill(fi);
                     emitted = true;
                 }
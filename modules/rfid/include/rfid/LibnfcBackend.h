@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+
+#include "rfid/ReaderBackend.h"
+
+// libnfc ileri bildirimleri (header'a <nfc/nfc.h> taşımıyoruz)
+struct nfc_context;
+struct nfc_device;
+
+namespace recum12::rfid {
+
+// PN532 (I2C/SPI/UART) üzerinden libnfc backend'i.
+class LibnfcBackend : public ReaderBackend {
+public:
+    LibnfcBackend() = default;
+    ~LibnfcBackend() override;
+
+    LibnfcBackend(const LibnfcBackend&)            = delete;
+    LibnfcBackend& operator=(const LibnfcBackend&) = delete;
+
+    bool open(const std::string& connstring, std::string& error) override;
+    void close() override;
+    bool isOpen() const override { return dev_ != nullptr; }
+
+    int  poll(const Pn532Config& cfg, CardUid& uid) override;
+    void release() override;
+    void abort() override;
+
+    const char* name() const override { return "libnfc"; }
+
+private:
+    nfc_context*  ctx_{nullptr};
+    nfc_device*   dev_{nullptr};
+};
+
+} // namespace recum12::rfid
@@ -0,0 +1,88 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "rfid/ReaderBackend.h"
+
+namespace recum12::rfid {
+
+// Senaryo adımı: okuyucu kart beklemeye başladıktan delay sonra olur.
+struct MockSwipe {
+    enum class Kind {
+        Card,       // uid okutuldu
+        NoCard,     // bu bekleme kartsız biter (poll 0 döner)
+        PollError,  // iletişim hatası (poll < 0)
+        OpenError,  // sonraki open() başarısız
+    };
+
+    Kind                      kind{Kind::Card};
+    std::chrono::milliseconds delay{0};
+    CardUid                   uid{};
+};
+
+// libnfc'siz, senaryo oynatan okuyucu backend'i (donanımsız auth testi ve
+// pompa simülatörü ile uçtan uca gecikme ölçümü için).
+//
+//  - Adımlar sırayla tüketilir; bir adımın delay'i okuyucunun o adım için
+//    ilk poll() çağrısından itibaren sayılır (gerçek "kart bekleniyor →
+//    kart okutuldu" süresi).
+//  - HardwarePoll'da poll() adım zamanına kadar (en fazla cfg.pollWindow())
+//    bloklar ve abort() ile kesilir; SelectLoop'ta hemen döner.
+//  - OpenError adımı poll()'da iletişim hatası olarak görünür, tüketilmez;
+//    ardından gelen open() onu tüketip başarısız olur.
+//  - loop açıksa tüketilen adım kuyruğun sonuna döner.
+//
+// Senaryo dosyası (satır başına bir adım, '#' yorum):
+//   <delay_ms> <uid-hex>     → kart  (örn. "1200 04:A1:B2:C3")
+//   <delay_ms> none          → kartsız bekleme
+//   <delay_ms> error         → poll hatası
+//   <delay_ms> open_error    → yeniden açma hatası
+//   loop                     → senaryo sonunda başa dön
+//
+// push() her thread'den çağrılabilir (testte canlı kart okutma).
+class MockReaderBackend : public ReaderBackend {
+public:
+    MockReaderBackend() = default;
+
+    // Senaryo dosyasını kuyruğa ekler. Dosya açılamazsa veya bir satır
+    // çözülemezse false (geçerli satırlar yine de eklenir).
+    bool loadScript(const std::string& path);
+
+    void push(const MockSwipe& step);
+    void setLoop(bool loop);
+    std::size_t pending() const;
+
+    bool open(const std::string& connstring, std::string& error) override;
+    void close() override;
+    bool isOpen() const override;
+
+    int  poll(const Pn532Config& cfg, CardUid& uid) override;
+    void abort() override;
+
+    const char* name() const override { return "mock"; }
+
+    // Tek satırı çözer (loadScript ve testler için). "loop" satırı için
+    // is_loop = true döner, step doldurulmaz.
+    static bool parseLine(const std::string& line, MockSwipe& step, bool& is_loop);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void consumeLocked();
+
+    mutable std::mutex       mtx_;
+    std::condition_variable  cv_;
+    std::deque<MockSwipe>    script_;
+    bool                     loop_{false};
+    bool                     open_{false};
+    bool                     aborted_{false};
+    // Baştaki adımın süresi başladı mı?
+    bool                     armed_{false};
+    Clock::time_point        armedAt_{};
+};
+
+} // namespace recum12::rfid
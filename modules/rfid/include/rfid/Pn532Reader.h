@@ -1,11 +1,14 @@
 #pragma once
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 
-// libnfc ileri bildirimleri (header'a <nfc/nfc.h> taşımıyoruz)
-struct nfc_context;
-struct nfc_device;
+#include "rfid/ReaderBackend.h"
+#include "utils/CardUid.h"
 
 namespace recum12::rfid {
 
@@ -16,19 +19,42 @@ enum class ReaderState {
     Error
 };
 
+// requestRead() → kart algılama süresi (time-to-detect) istatistiği.
+struct DetectStats {
+    std::uint64_t count{0};
+    std::int64_t  last_us{0};
+    std::int64_t  min_us{0};
+    std::int64_t  max_us{0};
+    double        avg_us{0.0};
+};
+
 struct CardEvent {
-    std::string uid_hex;   // Ör: "04AABBCCDD..."
-    std::string source;    // Ör: "pn532"
+    CardUid     uid;                 // ikili UID (hex yalnızca log/CSV kenarında)
+    const char* source{"pn532"};     // statik ad (backend: "libnfc" / "mock")
+    // Kartın algılandığı an (card → AUTHORIZE gecikmesi ölçümü için)
+    std::chrono::steady_clock::time_point detected_at{};
 };
 
 class Pn532Reader {
 public:
+    // Varsayılan backend libnfc'dir; libnfc'siz derlemede (RECUM12_WITH_LIBNFC
+    // kapalı) senaryosu boş mock backend kullanılır.
     Pn532Reader();
+    explicit Pn532Reader(std::unique_ptr<ReaderBackend> backend);
     ~Pn532Reader();
 
-    // PN532 cihazını (I2C/SPI/UART) açar. Şimdilik her zaman true dönen stub.
+    // Backend'i değiştirir (örn. settings'te "backend": "mock"). Eski
+    // backend kapatılır; worker çalışmıyorken çağrılmalı.
+    void setBackend(std::unique_ptr<ReaderBackend> backend);
+    ReaderBackend* backend() noexcept { return backend_.get(); }
+
+    // Okuyucuyu açar (libnfc connstring; boş → ilk bulunan cihaz).
     bool open(const std::string& device);
 
+    // Arama yöntemi / periyodu; open()'dan önce veya Idle iken çağrılmalı.
+    void setConfig(const Pn532Config& cfg);
+    const Pn532Config& config() const noexcept { return cfg_; }
+
     // Cihazı kapatır, kaynakları serbest bırakır.
     void close();
 
@@ -37,29 +63,53 @@ public:
     void requestRead();
 
     // Okuma tamamlandıktan veya iptal/timeout sonrası tekrar Idle duruma geçmek için.
+    // HardwarePoll'da süren donanım taraması da kesilir (her thread'den çağrılabilir).
     void cancelRead();
 
     // Periyodik olarak çağrılacak fonksiyon.
     // NOT: Yalnızca state_ == WaitingCard iken kart arama yapar;
     // Idle durumunda hiçbir şey yapmaz (talep yoksa okuma yok).
-    void pollOnce();
+    // Donanım taraması yapıp beklediyse true döner (çağıran ek uyku
+    // yapmadan tekrar çağırabilir).
+    bool pollOnce();
+
+    // requestRead() → kart algılama süreleri (mevcut mod için).
+    DetectStats detectStats() const;
 
     // Okuyucunun mevcut durumu.
     ReaderState state() const noexcept;
 
     // Kart okunduğunda tetiklenecek callback.
+    // Not: RFID worker thread'inde çağrılır; callback yalnızca olayı kuyruğa
+    // bırakmalı, ağır işi (kullanıcı arama, pompa komutu, log) yapmamalı.
     std::function<void(const CardEvent&)>    onCardDetected;
 
     // Hata durumunda tetiklenecek callback (örn. iletişim hatası).
     std::function<void(const std::string&)>  onError;
 
+    // requestRead() okuyucuyu WaitingCard'a aldığında (çağıran thread'de);
+    // ReaderPool bununla bekleyen worker'ı uyandırır.
+    std::function<void()>                    onReadRequested;
+
 private:
-    ReaderState   state_{ReaderState::Idle};
+    void recordDetect(std::chrono::steady_clock::time_point detected_at);
+
+    // requestRead/cancelRead başka thread'lerden (core/GUI) çağrılabilir.
+    std::atomic<ReaderState> state_{ReaderState::Idle};
     std::string   device_;
+    Pn532Config   cfg_{};
+    std::unique_ptr<ReaderBackend> backend_;
+
+    // requestRead anı (steady_clock, ns); time-to-detect başlangıcı
+    std::atomic<std::int64_t> requestedAtNs_{0};
+
+    // Süren backend poll()'unu başka thread'den kesmek için: polling_ bu
+    // kilit altında (abort yalnızca tarama sürerken yapılır).
+    std::mutex    abortMtx_;
+    bool          polling_{false};
 
-    // libnfc context / device
-    nfc_context*  ctx_{nullptr};
-    nfc_device*   dev_{nullptr};
+    mutable std::mutex statsMtx_;
+    DetectStats        stats_{};
 };
 
 } // namespace recum12::rfid
@@ -0,0 +1,90 @@
+#pragma once
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "utils/CardUid.h"
+
+namespace recum12::rfid {
+
+using recum12::utils::CardUid;
+
+// Kart arama yöntemi.
+enum class Pn532PollMode {
+    // Host döngüsü: her pollOnce() ISO14443A sonra B için tek seferlik
+    // nfc_initiator_select_passive_target (eski davranış).
+    SelectLoop,
+    // Donanım taraması: nfc_initiator_poll_target ile PN532 modülasyon
+    // listesini kendisi periyodik tarar; host yalnızca sonucu bekler.
+    // cancelRead() beklemeyi nfc_abort_command ile keser.
+    HardwarePoll,
+};
+
+struct Pn532Config {
+    Pn532PollMode mode{Pn532PollMode::HardwarePoll};
+    // HardwarePoll: modülasyon başına tarama periyodu (PN532 150 ms
+    // birimiyle çalışır; 150..2250 ms'e yuvarlanır).
+    int           poll_period_ms{150};
+    // HardwarePoll: tek pollOnce() çağrısındaki tarama turu (1..254).
+    // Tur bitince çağrı kart bulamadan döner; uzun tur = daha az host
+    // uyanması, kapanışta abort ile kesilir.
+    int           poll_count{20};
+
+    // PN532 InAutoPoll periyodu 150 ms birimindedir (1..15)
+    static constexpr int kPeriodUnitMs = 150;
+    // Taranan modülasyon sayısı (ISO14443A + ISO14443B)
+    static constexpr int kModulationCount = 2;
+
+    int periodUnits() const noexcept
+    {
+        const int u = (poll_period_ms + kPeriodUnitMs / 2) / kPeriodUnitMs;
+        return u < 1 ? 1 : (u > 15 ? 15 : u);
+    }
+    int rounds() const noexcept
+    {
+        return poll_count < 1 ? 1 : (poll_count > 254 ? 254 : poll_count);
+    }
+    // HardwarePoll'da tek çağrının en uzun süresi
+    std::chrono::milliseconds pollWindow() const noexcept
+    {
+        return std::chrono::milliseconds(rounds() * periodUnits() * kPeriodUnitMs *
+                                         kModulationCount);
+    }
+};
+
+// Kart okuyucunun donanım tarafı. Pn532Reader durum makinesini (Idle /
+// WaitingCard / CardPresent), istatistiği ve callback'leri tutar; kartın
+// nereden geldiği (libnfc, senaryo) backend'e aittir.
+//
+// Thread modeli: abort() dışındaki tüm çağrılar RFID worker thread'inden
+// gelir. abort() başka thread'den, yalnızca poll() sürerken çağrılır.
+class ReaderBackend {
+public:
+    virtual ~ReaderBackend() = default;
+
+    // Cihazı açar; hata durumunda error doldurulur.
+    virtual bool open(const std::string& connstring, std::string& error) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // Kart arar (cfg.mode'a göre tek seçim veya bloklayan tarama).
+    //  > 0 : kart bulundu; uid dolu (desteklenmeyen tipte boş kalabilir)
+    //  = 0 : kart yok, tur bitti veya abort edildi
+    //  < 0 : iletişim hatası (çağıran close() edip Error'a geçer)
+    virtual int poll(const Pn532Config& cfg, CardUid& uid) = 0;
+
+    // Bulunan kartın seçimini bırakır.
+    virtual void release() {}
+
+    // Süren poll()'u keser.
+    virtual void abort() = 0;
+
+    // Log için kısa ad ("libnfc", "mock")
+    virtual const char* name() const = 0;
+};
+
+// "libnfc" | "mock" → backend. libnfc'siz derlemede (RECUM12_WITH_LIBNFC
+// kapalı) veya bilinmeyen türde nullptr döner.
+std::unique_ptr<ReaderBackend> makeReaderBackend(const std::string& kind);
+
+} // namespace recum12::rfid
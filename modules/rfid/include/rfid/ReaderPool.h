@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rfid/Pn532Reader.h"
+
+namespace recum12::rfid {
+
+// Birden çok Pn532Reader'ı okuyucu başına thread açmadan servis eden küçük
+// havuz.
+//
+//  - Yalnızca kart bekleyen (WaitingCard) okuyucular poll edilir; Idle
+//    okuyucu maliyetsizdir. requestRead() havuzu hemen uyandırır.
+//  - Okuyucular round-robin seçilir; bir okuyucu aynı anda tek worker'da.
+//  - HardwarePoll'da pollOnce() bir tarama turu boyunca bloklar
+//    (poll_count × periyot × modülasyon; varsayılanla ~6 sn). Thread sayısı
+//    verilmezse okuyuculardan türetilir: her HardwarePoll okuyucusuna bir
+//    thread, SelectLoop okuyucularına ortak bir thread → bir okuyucunun
+//    turu diğerini bekletmez. Sabit sayı verilirse ve bekleyen okuyucu
+//    sayısı bunu aşabiliyorsa poll_count küçük tutulmalı.
+//  - SelectLoop'ta okuyucu başına kSelectInterval aralıkla seçim yapılır
+//    (eski rfid_worker ile aynı tempo).
+class ReaderPool {
+public:
+    static constexpr std::chrono::milliseconds kSelectInterval{100};
+
+    // threads 0 → start()'ta eklenen okuyuculardan türetilir.
+    explicit ReaderPool(std::size_t threads = 0);
+    ~ReaderPool();
+
+    ReaderPool(const ReaderPool&)            = delete;
+    ReaderPool& operator=(const ReaderPool&) = delete;
+
+    // start()'tan önce çağrılmalı; okuyucunun ömrü havuzdan uzun olmalı.
+    void add(Pn532Reader* reader);
+    std::size_t size() const noexcept { return entries_.size(); }
+
+    void start();
+    // Süren taramaları keser (cancelRead) ve worker'ları bekler.
+    void stop();
+
+    // Bekleyen worker'ları uyandırır (requestRead sonrası otomatik).
+    void wake();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        Pn532Reader*      reader{nullptr};
+        bool              busy{false};
+        Clock::time_point next_at{};   // SelectLoop temposu
+    };
+
+    void run();
+
+    std::size_t              threads_;
+    std::vector<Entry>       entries_;
+    std::size_t              next_{0};    // round-robin başlangıcı
+    bool                     running_{false};
+    std::mutex               mtx_;
+    std::condition_variable  cv_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace recum12::rfid
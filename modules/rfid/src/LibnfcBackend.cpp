@@ -0,0 +1,134 @@
+#include "rfid/LibnfcBackend.h"
+
+#include "utils/InfraLog.h"
+
+// libnfc
+#include <nfc/nfc.h>
+
+namespace recum12::rfid {
+
+namespace {
+
+// Eski RFIDReader ile aynı sıra: önce ISO14443A, sonra ISO14443B
+const nfc_modulation kModulations[Pn532Config::kModulationCount] = {
+    { NMT_ISO14443A, NBR_106 },
+    { NMT_ISO14443B, NBR_106 },
+};
+
+} // namespace
+
+LibnfcBackend::~LibnfcBackend()
+{
+    close();
+}
+
+bool LibnfcBackend::open(const std::string& connstring, std::string& error)
+{
+    // 1) Context yoksa kur
+    if (!ctx_) {
+        RECUM_LOG_INFO("PN532", "nfc_init()");
+        nfc_init(&ctx_);
+        if (!ctx_) {
+            error = "RFID: nfc_init failed";
+            return false;
+        }
+    }
+
+    // 2) Device yoksa aç
+    if (!dev_) {
+        dev_ = nfc_open(ctx_, connstring.empty() ? nullptr : connstring.c_str());
+        if (!dev_) {
+            error = "RFID: nfc_open failed";
+            return false;
+        }
+
+        if (nfc_initiator_init(dev_) < 0) {
+            error = "RFID: nfc_initiator_init failed, closing device";
+            nfc_close(dev_);
+            dev_ = nullptr;
+            return false;
+        }
+
+        // PN532/libnfc ayarları – eski RFIDReader.cpp ile uyumlu
+        nfc_device_set_property_bool(dev_, NP_AUTO_ISO14443_4, false);
+        nfc_device_set_property_bool(dev_, NP_HANDLE_CRC,       true);
+        nfc_device_set_property_bool(dev_, NP_HANDLE_PARITY,    true);
+        nfc_device_set_property_bool(dev_, NP_ACTIVATE_FIELD,   true);
+        nfc_device_set_property_bool(dev_, NP_INFINITE_SELECT,  false);
+
+        RECUM_LOG_INFO("PN532", "device opened OK");
+    }
+    return true;
+}
+
+void LibnfcBackend::close()
+{
+    if (dev_) {
+        nfc_close(dev_);
+        dev_ = nullptr;
+    }
+    if (ctx_) {
+        nfc_exit(ctx_);
+        ctx_ = nullptr;
+    }
+}
+
+int LibnfcBackend::poll(const Pn532Config& cfg, CardUid& uid)
+{
+    if (!dev_) {
+        return -1;
+    }
+
+    nfc_target nt{};
+    int res = 0;
+
+    if (cfg.mode == Pn532PollMode::HardwarePoll) {
+        res = nfc_initiator_poll_target(dev_, kModulations, Pn532Config::kModulationCount,
+                                        static_cast<std::uint8_t>(cfg.rounds()),
+                                        static_cast<std::uint8_t>(cfg.periodUnits()), &nt);
+        // İptal (cancelRead) veya tur bitti → kart yok, hata değil
+        if (res == NFC_EOPABORTED || res == NFC_ETIMEOUT) {
+            res = 0;
+        }
+    } else {
+        // ISO14443A, bulunamazsa ISO14443B – tek seferlik seçim
+        for (int i = 0; i < Pn532Config::kModulationCount && res == 0; ++i) {
+            res = nfc_initiator_select_passive_target(dev_, kModulations[i], nullptr, 0, &nt);
+        }
+    }
+
+    if (res <= 0) {
+        return res;
+    }
+
+    switch (nt.nm.nmt) {
+        case NMT_ISO14443A:
+            uid = CardUid::fromBytes(nt.nti.nai.abtUid, nt.nti.nai.szUidLen);
+            break;
+        case NMT_ISO14443B:
+            // PUPI genelde 4 byte
+            uid = CardUid::fromBytes(nt.nti.nbi.abtPupi, 4);
+            break;
+        default:
+            // Desteklenmeyen kart tipi: UID yok, olay üretilmez
+            uid = CardUid{};
+            break;
+    }
+    return res;
+}
+
+void LibnfcBackend::release()
+{
+    if (dev_) {
+        nfc_initiator_deselect_target(dev_);
+    }
+}
+
+void LibnfcBackend::abort()
+{
+    if (dev_) {
+        nfc_abort_command(dev_);
+    }
+}
+
+} // namespace recum12::rfid
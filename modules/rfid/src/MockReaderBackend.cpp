@@ -0,0 +1,218 @@
+#include "rfid/MockReaderBackend.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "utils/InfraLog.h"
+
+namespace recum12::rfid {
+
+bool MockReaderBackend::parseLine(const std::string& line, MockSwipe& step, bool& is_loop)
+{
+    is_loop = false;
+
+    std::istringstream iss(line);
+    std::string first;
+    if (!(iss >> first)) {
+        return false;
+    }
+    if (first == "loop") {
+        is_loop = true;
+        return true;
+    }
+
+    long delay_ms = 0;
+    try {
+        std::size_t used = 0;
+        delay_ms = std::stol(first, &used);
+        if (used != first.size() || delay_ms < 0) {
+            return false;
+        }
+    } catch (...) {
+        return false;
+    }
+
+    // UID "04 A1 B2 C3" gibi boşluklu da yazılabilir → satırın kalanı
+    std::string rest;
+    std::getline(iss, rest);
+    const auto b = rest.find_first_not_of(" \t");
+    rest = (b == std::string::npos) ? std::string{} : rest.substr(b);
+    while (!rest.empty() && (rest.back() == '\r' || rest.back() == ' ' || rest.back() == '\t')) {
+        rest.pop_back();
+    }
+
+    MockSwipe s;
+    s.delay = std::chrono::milliseconds(delay_ms);
+    if (rest == "none") {
+        s.kind = MockSwipe::Kind::NoCard;
+    } else if (rest == "error") {
+        s.kind = MockSwipe::Kind::PollError;
+    } else if (rest == "open_error") {
+        s.kind = MockSwipe::Kind::OpenError;
+    } else if (!CardUid::parseHex(rest, s.uid) || s.uid.empty()) {
+        return false;
+    }
+    step = s;
+    return true;
+}
+
+bool MockReaderBackend::loadScript(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        RECUM_LOG_ERROR("RFID/mock", "script açılamadı: {}", path);
+        return false;
+    }
+
+    bool        ok     = true;
+    bool        looped = false;
+    std::size_t added  = 0;
+    std::string line;
+    for (std::size_t lineNo = 1; std::getline(in, line); ++lineNo) {
+        const auto b = line.find_first_not_of(" \t\r");
+        if (b == std::string::npos || line[b] == '#') {
+            continue;
+        }
+        MockSwipe step;
+        bool      is_loop = false;
+        if (!parseLine(line, step, is_loop)) {
+            RECUM_LOG_WARN("RFID/mock", "{}:{} çözülemedi: {}", path, lineNo, line);
+            ok = false;
+            continue;
+        }
+        if (is_loop) {
+            looped = true;
+        } else {
+            push(step);
+            ++added;
+        }
+    }
+
+    if (looped) {
+        setLoop(true);
+    }
+    RECUM_LOG_INFO("RFID/mock", "{}: {} adım{}", path, added, looped ? " (loop)" : "");
+    return ok;
+}
+
+void MockReaderBackend::push(const MockSwipe& step)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        script_.push_back(step);
+    }
+    cv_.notify_all();
+}
+
+void MockReaderBackend::setLoop(bool loop)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    loop_ = loop;
+}
+
+std::size_t MockReaderBackend::pending() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return script_.size();
+}
+
+bool MockReaderBackend::open(const std::string& /*connstring*/, std::string& error)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!script_.empty() && script_.front().kind == MockSwipe::Kind::OpenError) {
+        consumeLocked();
+        error = "RFID: mock open failure (script)";
+        return false;
+    }
+    open_    = true;
+    aborted_ = false;
+    return true;
+}
+
+void MockReaderBackend::close()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    open_ = false;
+}
+
+bool MockReaderBackend::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return open_;
+}
+
+void MockReaderBackend::consumeLocked()
+{
+    if (loop_) {
+        script_.push_back(script_.front());
+    }
+    script_.pop_front();
+    armed_ = false;
+}
+
+int MockReaderBackend::poll(const Pn532Config& cfg, CardUid& uid)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (!open_) {
+        return -1;
+    }
+
+    const auto start    = Clock::now();
+    const auto deadline = (cfg.mode == Pn532PollMode::HardwarePoll)
+                              ? start + cfg.pollWindow()
+                              : start;
+
+    for (;;) {
+        if (aborted_) {
+            aborted_ = false;
+            return 0;
+        }
+
+        const auto now  = Clock::now();
+        auto       wake = deadline;
+        if (!script_.empty()) {
+            if (!armed_) {
+                armed_   = true;
+                armedAt_ = now;
+            }
+            const MockSwipe& s   = script_.front();
+            const auto       due = armedAt_ + s.delay;
+            if (now >= due) {
+                switch (s.kind) {
+                case MockSwipe::Kind::Card:
+                    uid = s.uid;
+                    consumeLocked();
+                    return 1;
+                case MockSwipe::Kind::NoCard:
+                    consumeLocked();
+                    return 0;
+                case MockSwipe::Kind::PollError:
+                    consumeLocked();
+                    return -1;
+                case MockSwipe::Kind::OpenError:
+                    // open() tüketecek
+                    armed_ = false;
+                    return -1;
+                }
+            }
+            wake = std::min(wake, due);
+        }
+
+        if (now >= deadline) {
+            return 0; // tur bitti (SelectLoop'ta hemen)
+        }
+        cv_.wait_until(lock, wake);
+    }
+}
+
+void MockReaderBackend::abort()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        aborted_ = true;
+    }
+    cv_.notify_all();
+}
+
+} // namespace recum12::rfid
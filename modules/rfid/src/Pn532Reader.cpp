@@ -1,76 +1,69 @@
 ﻿#include "rfid/Pn532Reader.h"
 
-#include <sstream>
-#include <iomanip>
-#include <iostream>
-
-// libnfc
-#include <nfc/nfc.h>
+#include "rfid/MockReaderBackend.h"
+#include "utils/InfraLog.h"
 
 namespace recum12::rfid {
 
 namespace {
 
-// Eski RFIDReader::to_hex ile aynı mantık:
-std::string to_hex(const unsigned char* data, size_t len)
+std::int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* modeName(Pn532PollMode m)
 {
-    std::ostringstream ss;
-    ss << std::uppercase << std::hex << std::setfill('0');
-    for (size_t i = 0; i < len; ++i) {
-        ss << std::setw(2) << static_cast<unsigned int>(data[i]);
+    return (m == Pn532PollMode::HardwarePoll) ? "poll_target" : "select";
+}
+
+std::unique_ptr<ReaderBackend> defaultBackend()
+{
+    auto b = makeReaderBackend("libnfc");
+    if (!b) {
+        RECUM_LOG_WARN("PN532", "libnfc desteği yok, mock backend kullanılıyor");
+        b = std::make_unique<MockReaderBackend>();
     }
-    return ss.str();
+    return b;
 }
 
 } // namespace
 
-Pn532Reader::Pn532Reader() = default;
+Pn532Reader::Pn532Reader()
+    : backend_(defaultBackend())
+{
+}
+
+Pn532Reader::Pn532Reader(std::unique_ptr<ReaderBackend> backend)
+    : backend_(backend ? std::move(backend) : defaultBackend())
+{
+}
 
 Pn532Reader::~Pn532Reader()
 {
     close();
 }
 
-bool Pn532Reader::open(const std::string& device)
+void Pn532Reader::setBackend(std::unique_ptr<ReaderBackend> backend)
 {
-    device_ = device;
-
-    // 1) Context yoksa kur
-    if (!ctx_) {
-        std::cout << "[PN532] nfc_init()\n";
-        nfc_init(&ctx_);
-        if (!ctx_) {
-            if (onError) onError("RFID: nfc_init failed");
-            state_ = ReaderState::Error;
-            return false;
-        }
+    if (!backend) {
+        return;
     }
+    close();
+    backend_ = std::move(backend);
+    RECUM_LOG_INFO("PN532", "backend={}", backend_->name());
+}
 
-    // 2) Device yoksa aç
-    if (!dev_) {
-        dev_ = nfc_open(ctx_, device_.empty() ? nullptr : device_.c_str());
-        if (!dev_) {
-            if (onError) onError("RFID: nfc_open failed");
-            state_ = ReaderState::Error;
-            return false;
-        }
-
-        if (nfc_initiator_init(dev_) < 0) {
-            if (onError) onError("RFID: nfc_initiator_init failed, closing device");
-            nfc_close(dev_);
-            dev_ = nullptr;
-            state_ = ReaderState::Error;
-            return false;
-        }
-
-        // PN532/libnfc ayarları – eski RFIDReader.cpp ile uyumlu
-        nfc_device_set_property_bool(dev_, NP_AUTO_ISO14443_4, false);
-        nfc_device_set_property_bool(dev_, NP_HANDLE_CRC,       true);
-        nfc_device_set_property_bool(dev_, NP_HANDLE_PARITY,    true);
-        nfc_device_set_property_bool(dev_, NP_ACTIVATE_FIELD,   true);
-        nfc_device_set_property_bool(dev_, NP_INFINITE_SELECT,  false);
+bool Pn532Reader::open(const std::string& device)
+{
+    device_ = device;
 
-        std::cout << "[PN532] device opened OK\n";
+    std::string error;
+    if (!backend_->open(device_, error)) {
+        if (onError) onError(error);
+        state_ = ReaderState::Error;
+        return false;
     }
 
     // Başarılı init → Idle'a dön
@@ -78,16 +71,21 @@ bool Pn532Reader::open(const std::string& device)
     return true;
 }
 
-void Pn532Reader::close()
+void Pn532Reader::setConfig(const Pn532Config& cfg)
 {
-    if (dev_) {
-        nfc_close(dev_);
-        dev_ = nullptr;
-    }
-    if (ctx_) {
-        nfc_exit(ctx_);
-        ctx_ = nullptr;
+    if (cfg.mode != cfg_.mode) {
+        // İstatistik mod başınadır (karşılaştırma için)
+        std::lock_guard<std::mutex> lock(statsMtx_);
+        stats_ = DetectStats{};
     }
+    cfg_ = cfg;
+    RECUM_LOG_INFO("PN532", "mode={} period_ms={} count={}", modeName(cfg_.mode),
+                   cfg_.poll_period_ms, cfg_.poll_count);
+}
+
+void Pn532Reader::close()
+{
+    backend_->close();
     state_ = ReaderState::Idle;
 }
 
@@ -95,95 +93,139 @@ void Pn532Reader::requestRead()
 {
     // Yalnızca Idle durumundan kart bekleme moduna geç.
     // Hata durumunda (Error) üst katman yeniden open() çağırmalıdır.
-    if (state_ == ReaderState::Idle) {
-        state_ = ReaderState::WaitingCard;
+    ReaderState expected = ReaderState::Idle;
+    if (state_.compare_exchange_strong(expected, ReaderState::WaitingCard)) {
+        requestedAtNs_.store(steadyNowNs(), std::memory_order_relaxed);
+        if (onReadRequested) {
+            onReadRequested();
+        }
     }
 }
 
 void Pn532Reader::cancelRead()
 {
     // Kart bekleme veya kart bulundu durumundan tekrar Idle'a dön.
-    if (state_ == ReaderState::WaitingCard ||
-        state_ == ReaderState::CardPresent) {
-        state_ = ReaderState::Idle;
+    ReaderState expected = ReaderState::WaitingCard;
+    if (!state_.compare_exchange_strong(expected, ReaderState::Idle)) {
+        expected = ReaderState::CardPresent;
+        state_.compare_exchange_strong(expected, ReaderState::Idle);
+    }
+
+    // Donanım taraması sürüyorsa kes; backend poll() kartsız (0) döner.
+    std::lock_guard<std::mutex> lock(abortMtx_);
+    if (polling_) {
+        backend_->abort();
     }
 }
 
-void Pn532Reader::pollOnce()
+bool Pn532Reader::pollOnce()
 {
     // 1) Kart okuma isteği yoksa hiçbir şey yapma
     if (state_ != ReaderState::WaitingCard) {
-        return;
+        return false;
     }
 
     // 2) Gerekirse cihazı yeniden açmayı dene
-    if (!ctx_ || !dev_) {
+    if (!backend_->isOpen()) {
         if (!open(device_)) {
             // open() hata mesajını onError ile iletmiş olacak
-            return;
+            return false;
         }
     }
 
-    // 3) Kart seç – önce ISO14443A, sonra ISO14443B
-    nfc_target nt{};
-    const nfc_modulation nmA = { NMT_ISO14443A, NBR_106 };
-    const nfc_modulation nmB = { NMT_ISO14443B, NBR_106 };
-
-    int res = nfc_initiator_select_passive_target(dev_, nmA, nullptr, 0, &nt);
-    if (res == 0) {
-        res = nfc_initiator_select_passive_target(dev_, nmB, nullptr, 0, &nt);
+    // 3) Kart ara
+    const bool waited = (cfg_.mode == Pn532PollMode::HardwarePoll);
+    {
+        // Kilit altında tekrar bak: cancelRead araya girdiyse tarama başlatma
+        std::lock_guard<std::mutex> lock(abortMtx_);
+        if (state_ != ReaderState::WaitingCard) {
+            return false;
+        }
+        polling_ = true;
+    }
+    CardUid uid;
+    const int res = backend_->poll(cfg_, uid);
+    {
+        std::lock_guard<std::mutex> lock(abortMtx_);
+        polling_ = false;
     }
 
     if (res < 0) {
         // Hata: cihazı kapat, durumu Error yap ve üst kata haber ver
         if (onError) onError("RFID: poll failed, will reconnect");
-        nfc_close(dev_);
-        dev_ = nullptr;
+        backend_->close();
         state_ = ReaderState::Error;
-        return;
+        return waited;
     }
 
     if (res == 0) {
         // Kart yok → WaitingCard durumunda kal, sadece sessizce çık
-        return;
+        return waited;
     }
 
-    // 4) Kart bulundu → UID çek
-    std::string uid;
-    switch (nt.nm.nmt) {
-        case NMT_ISO14443A:
-            if (nt.nti.nai.szUidLen > 0) {
-                uid = to_hex(nt.nti.nai.abtUid, nt.nti.nai.szUidLen);
-            }
-            break;
-        case NMT_ISO14443B:
-            // PUPI genelde 4 byte
-            uid = to_hex(nt.nti.nbi.abtPupi, 4);
-            break;
-        default:
-            uid = "UNKNOWN";
-            break;
+    // Tarama sürerken okuma iptal edildiyse bulunan kartı bırak
+    if (state_ != ReaderState::WaitingCard) {
+        backend_->release();
+        return waited;
     }
 
+    // 4) Kart bulundu (UID ikili; hex'e çevrim log/CSV kenarında).
+    //    Desteklenmeyen kart tipinde UID boştur, olay üretilmez.
     if (!uid.empty()) {
         CardEvent ev;
-        ev.uid_hex = uid;
-        ev.source  = "pn532";
+        ev.uid         = uid;
+        ev.source      = backend_->name();
+        ev.detected_at = std::chrono::steady_clock::now();
+        recordDetect(ev.detected_at);
+
+        // Kart bulundu → CardPresent durumuna geç (callback'ten önce: auth
+        // stage olayı işlerken cancelRead() çağırırsa Idle'a dönebilsin).
+        // Üst katman işini bitirince cancelRead() çağırıp Idle'a döndürecek.
+        state_ = ReaderState::CardPresent;
 
-        // GUI / üst katman burada:
-        //  - user listesinde yetki kontrolü yapacak
-        //  - lblmsg / lbluserid / imgvhec güncelleyecek
+        // Üst katman (RfidAuthController) olayı yalnızca kuyruğa alır;
+        // yetki kontrolü / pompa komutu core thread'inde yapılır.
         if (onCardDetected) {
             onCardDetected(ev);
         }
-
-        // Kart bulundu → CardPresent durumuna geç.
-        // Üst katman işini bitirince cancelRead() çağırıp Idle'a döndürecek.
-        state_ = ReaderState::CardPresent;
     }
 
     // 5) Seçimi bırak
-    nfc_initiator_deselect_target(dev_);
+    backend_->release();
+    return waited;
+}
+
+void Pn532Reader::recordDetect(std::chrono::steady_clock::time_point detected_at)
+{
+    const std::int64_t req_ns = requestedAtNs_.load(std::memory_order_relaxed);
+    if (req_ns == 0) {
+        return;
+    }
+    const std::int64_t v =
+        (std::chrono::duration_cast<std::chrono::nanoseconds>(
+             detected_at.time_since_epoch()).count() - req_ns) / 1000;
+
+    DetectStats st;
+    {
+        std::lock_guard<std::mutex> lock(statsMtx_);
+        stats_.last_us = v;
+        if (stats_.count == 0 || v < stats_.min_us) stats_.min_us = v;
+        if (stats_.count == 0 || v > stats_.max_us) stats_.max_us = v;
+        ++stats_.count;
+        stats_.avg_us += (static_cast<double>(v) - stats_.avg_us) /
+                         static_cast<double>(stats_.count);
+        st = stats_;
+    }
+    RECUM_LOG_INFO("PN532", "time-to-detect_ms={} mode={} (avg={} min={} max={} n={})",
+                   static_cast<double>(v) / 1000.0, modeName(cfg_.mode), st.avg_us / 1000.0,
+                   static_cast<double>(st.min_us) / 1000.0,
+                   static_cast<double>(st.max_us) / 1000.0, st.count);
+}
+
+DetectStats Pn532Reader::detectStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMtx_);
+    return stats_;
 }
 
 ReaderState Pn532Reader::state() const noexcept
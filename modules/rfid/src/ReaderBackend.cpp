@@ -0,0 +1,23 @@
+#include "rfid/ReaderBackend.h"
+
+#include "rfid/MockReaderBackend.h"
+#if RECUM12_WITH_LIBNFC
+#include "rfid/LibnfcBackend.h"
+#endif
+
+namespace recum12::rfid {
+
+std::unique_ptr<ReaderBackend> makeReaderBackend(const std::string& kind)
+{
+    if (kind == "mock") {
+        return std::make_unique<MockReaderBackend>();
+    }
+#if RECUM12_WITH_LIBNFC
+    if (kind == "libnfc" || kind.empty()) {
+        return std::make_unique<LibnfcBackend>();
+    }
+#endif
+    return nullptr;
+}
+
+} // namespace recum12::rfid
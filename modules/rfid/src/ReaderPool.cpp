@@ -0,0 +1,127 @@
+#include "rfid/ReaderPool.h"
+
+#include <algorithm>
+
+#include "utils/InfraLog.h"
+
+namespace recum12::rfid {
+
+ReaderPool::ReaderPool(std::size_t threads)
+    : threads_(threads)
+{
+}
+
+ReaderPool::~ReaderPool()
+{
+    stop();
+}
+
+void ReaderPool::add(Pn532Reader* reader)
+{
+    if (!reader) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (running_) {
+        return; // worker'lar entries_'e işaretçi tutuyor
+    }
+    reader->onReadRequested = [this] { wake(); };
+    entries_.push_back(Entry{reader, false, {}});
+}
+
+void ReaderPool::start()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+
+    // Bloklayan HardwarePoll turu okuyucu başına bir thread ister;
+    // SelectLoop okuyucuları kısa seçimlerle tek thread'i paylaşır
+    std::size_t hw = 0;
+    for (const auto& e : entries_) {
+        if (e.reader->config().mode == Pn532PollMode::HardwarePoll) {
+            ++hw;
+        }
+    }
+    const std::size_t wanted = (threads_ > 0) ? threads_ : hw + (hw < entries_.size() ? 1 : 0);
+    // Okuyucudan fazla thread anlamsız
+    const std::size_t n =
+        std::min(std::max<std::size_t>(wanted, 1), std::max<std::size_t>(entries_.size(), 1));
+    for (std::size_t i = 0; i < n; ++i) {
+        workers_.emplace_back(&ReaderPool::run, this);
+    }
+    RECUM_LOG_INFO("RFID", "reader pool started: readers={} threads={}", entries_.size(), n);
+}
+
+void ReaderPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+
+    // Süren donanım taramalarını kes (yoksa worker tur bitene kadar bekler)
+    for (auto& e : entries_) {
+        e.reader->cancelRead();
+    }
+    for (auto& t : workers_) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+    workers_.clear();
+}
+
+void ReaderPool::wake()
+{
+    // Kilit: worker durum kontrolü ile bekleme arasında uyandırma kaybolmasın
+    { std::lock_guard<std::mutex> lock(mtx_); }
+    cv_.notify_all();
+}
+
+void ReaderPool::run()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (running_) {
+        const auto  now     = Clock::now();
+        auto        wake_at = now + kSelectInterval;
+        Entry*      pick    = nullptr;
+        const std::size_t n = entries_.size();
+
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t i = (next_ + k) % n;
+            Entry& e = entries_[i];
+            if (e.busy || e.reader->state() != ReaderState::WaitingCard) {
+                continue;
+            }
+            if (e.next_at > now) {
+                wake_at = std::min(wake_at, e.next_at);
+                continue;
+            }
+            pick  = &e;
+            next_ = (i + 1) % n;
+            break;
+        }
+
+        if (!pick) {
+            cv_.wait_until(lock, wake_at);
+            continue;
+        }
+
+        pick->busy = true;
+        lock.unlock();
+        const bool waited = pick->reader->pollOnce();
+        lock.lock();
+        pick->busy    = false;
+        // Donanım taraması zaten bekledi; select'te eski tempo
+        pick->next_at = waited ? Clock::time_point{} : Clock::now() + kSelectInterval;
+    }
+}
+
+} // namespace recum12::rfid
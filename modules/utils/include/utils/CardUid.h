@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace recum12::utils {
+
+// RFID kart UID'si: uzunluk + en fazla 10 byte (ISO14443A tek/çift/üçlü
+// boy, ISO14443B PUPI). Heap kullanmaz; kopyası 11 byte'tır.
+//
+// Okuyucudan store/auth/log'a kadar ikili olarak taşınır; hex'e çevrim
+// yalnızca CSV / GUI / terminal kenarında (toHex, operator<<) yapılır.
+//
+// Sıralama byte'lar üzerinde sözlük sırasıdır (kısa önek önce gelir); bu,
+// büyük harf hex metinlerinin string sırasıyla aynıdır.
+class CardUid
+{
+public:
+    static constexpr std::size_t kMaxLen = 10;
+
+    constexpr CardUid() noexcept = default;
+
+    // Ham UID byte'larından; len > kMaxLen ise boş UID döner.
+    static CardUid fromBytes(const std::uint8_t* data, std::size_t len) noexcept
+    {
+        CardUid u;
+        if (data && len <= kMaxLen) {
+            std::memcpy(u.bytes_.data(), data, len);
+            u.len_ = static_cast<std::uint8_t>(len);
+        }
+        return u;
+    }
+
+    // "04A1B2C3", "04 a1 b2 c3", "04:A1:B2:C3", "04-a1-b2-c3" biçimlerini
+    // çözer (baş/son boşluklar, ' ', ':' ve '-' yoksayılır, harf duyarsız).
+    // Tek sayıda hane, geçersiz karakter veya kMaxLen'i aşan UID'de false;
+    // out'a dokunmaz. Boş metin geçerlidir (boş UID).
+    static bool parseHex(std::string_view s, CardUid& out) noexcept
+    {
+        CardUid u;
+        int     hi = -1;
+        for (char c : s) {
+            if (c == ' ' || c == ':' || c == '-' || c == '\t' || c == '\r' || c == '\n') {
+                continue;
+            }
+            const int v = hexValue(c);
+            if (v < 0) {
+                return false;
+            }
+            if (hi < 0) {
+                hi = v;
+                continue;
+            }
+            if (u.len_ == kMaxLen) {
+                return false;
+            }
+            u.bytes_[u.len_++] = static_cast<std::uint8_t>((hi << 4) | v);
+            hi = -1;
+        }
+        if (hi >= 0) {
+            return false;
+        }
+        out = u;
+        return true;
+    }
+
+    std::size_t          size()  const noexcept { return len_; }
+    bool                 empty() const noexcept { return len_ == 0; }
+    const std::uint8_t*  data()  const noexcept { return bytes_.data(); }
+
+    // Büyük harf hex (ayraçsız). out en az 2 * kMaxLen byte olmalı;
+    // yazılan karakter sayısını döner (sonlandırıcı yazılmaz).
+    std::size_t toHex(char* out) const noexcept
+    {
+        static constexpr char kDigits[] = "0123456789ABCDEF";
+        for (std::size_t i = 0; i < len_; ++i) {
+            out[2 * i]     = kDigits[bytes_[i] >> 4];
+            out[2 * i + 1] = kDigits[bytes_[i] & 0x0F];
+        }
+        return 2 * static_cast<std::size_t>(len_);
+    }
+
+    std::string toHex() const
+    {
+        char buf[2 * kMaxLen];
+        return std::string(buf, toHex(buf));
+    }
+
+    // FNV-1a (uzunluk dahil)
+    std::size_t hash() const noexcept
+    {
+        std::uint64_t h = 14695981039346656037ull;
+        h = (h ^ len_) * 1099511628211ull;
+        for (std::size_t i = 0; i < len_; ++i) {
+            h = (h ^ bytes_[i]) * 1099511628211ull;
+        }
+        return static_cast<std::size_t>(h);
+    }
+
+    friend bool operator==(const CardUid& a, const CardUid& b) noexcept
+    {
+        return a.len_ == b.len_ && std::memcmp(a.bytes_.data(), b.bytes_.data(), a.len_) == 0;
+    }
+    friend bool operator!=(const CardUid& a, const CardUid& b) noexcept { return !(a == b); }
+    friend bool operator<(const CardUid& a, const CardUid& b) noexcept
+    {
+        return std::lexicographical_compare(a.bytes_.begin(), a.bytes_.begin() + a.len_,
+                                            b.bytes_.begin(), b.bytes_.begin() + b.len_);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const CardUid& u)
+    {
+        char buf[2 * kMaxLen];
+        return os.write(buf, static_cast<std::streamsize>(u.toHex(buf)));
+    }
+
+private:
+    static constexpr int hexValue(char c) noexcept
+    {
+        return (c >= '0' && c <= '9') ? c - '0'
+             : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+             : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                                      : -1;
+    }
+
+    std::array<std::uint8_t, kMaxLen> bytes_{};
+    std::uint8_t                      len_{0};
+};
+
+} // namespace recum12::utils
+
+namespace std {
+template <>
+struct hash<recum12::utils::CardUid>
+{
+    std::size_t operator()(const recum12::utils::CardUid& u) const noexcept { return u.hash(); }
+};
+} // namespace std
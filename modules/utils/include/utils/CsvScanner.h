@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace recum12::utils {
+
+// Tek CSV alanı: kaynak tampona işaret eder (kopya yok).
+//  - Tırnaklı alanda dış tırnaklar hariç içerik; "" kaçışları olduğu gibi
+//    durur (escaped). Yalnızca o durumda text() yeni string üretir.
+//  - Satır sonundaki '\r' alana dahil edilmez.
+struct CsvField {
+    std::string_view raw;
+    bool             quoted{false};
+    bool             escaped{false};   // içerikte "" var → unescape gerekli
+
+    // escaped değilse raw doğrudan değerdir.
+    std::string text() const;
+    void        appendTo(std::string& out) const;
+};
+
+// Ayraç / tırnak / satır sonu taraması SIMD ile (SSE2, NEON; yoksa skaler)
+// yapılan CSV ayrıştırıcı. Alanlar kaynak tampona ofsettir; tampon
+// ayrıştırma boyunca yaşamalıdır.
+//
+//   CsvScanner sc(content);
+//   std::vector<CsvField> row;
+//   while (sc.next(row)) { ... }
+//
+// RFC 4180'e yakın: tırnaklı alan ayraç ve satır sonu içerebilir; tırnaksız
+// alandaki '"' düz karakterdir; kapanış tırnağından sonra ayraca kadar
+// gelen artıklar atılır.
+class CsvScanner {
+public:
+    explicit CsvScanner(std::string_view buf, char delim = ',') noexcept
+        : buf_(buf), delim_(delim)
+    {
+    }
+
+    // Sıradaki kaydı row'a yazar (row yeniden kullanılır); bitti → false.
+    // Boş satırlar tek boş alanlı kayıt olarak döner.
+    bool next(std::vector<CsvField>& row);
+
+    // Kalan tamponun başı (ör. header atlandıktan sonra).
+    std::size_t offset() const noexcept { return pos_; }
+
+    // Tek satırı (satır sonu yok) alanlara ayırır; alan sayısını döner.
+    static std::size_t splitRow(std::string_view line, std::vector<CsvField>& row,
+                                char delim = ',');
+
+    // p..end arasında ilk delim, '"' ya da '\n'; yoksa end.
+    static const char* findSpecial(const char* p, const char* end, char delim) noexcept;
+
+private:
+    std::string_view buf_;
+    std::size_t      pos_{0};
+    char             delim_;
+};
+
+} // namespace recum12::utils
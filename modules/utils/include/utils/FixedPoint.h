@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace recum12::utils {
+
+// x100 ölçekli, tamsayı tabanlı sabit noktalı değer.
+//
+// Pompa protokolü hacim ve tutarı BCD x100 olarak taşır; bu tip ham değeri
+// (centilitre / kuruş) bozmadan store, limit aritmetiği, kota ve loglara
+// kadar taşır. double'a çevrim yalnızca GUI / export kenarında yapılmalı.
+//
+// Tag parametresi, hacim ile tutarın birbirine karıştırılmasını derleme
+// anında engeller (Volume + Amount derlenmez).
+template <typename Tag>
+class Fixed
+{
+public:
+    using rep = std::int64_t;
+    static constexpr rep kScale = 100;
+
+    constexpr Fixed() noexcept = default;
+
+    // Ham x100 değerden (BCD decode, kalıcı kayıtlar)
+    static constexpr Fixed fromRaw(rep raw) noexcept { return Fixed(raw); }
+
+    // Tam birimden (ör. 5 L → 500)
+    static constexpr Fixed fromUnits(rep units) noexcept { return Fixed(units * kScale); }
+
+    // Yalnızca konfig/CSV kenarı için: en yakın x100 değere yuvarlar.
+    static Fixed fromDouble(double v) noexcept
+    {
+        return Fixed(static_cast<rep>(std::llround(v * static_cast<double>(kScale))));
+    }
+
+    // "12", "12.3", "12,34", "-0.5" gibi ondalık metni double'a uğramadan
+    // çözer. 2 haneden fazla kesir varsa yarım yukarı yuvarlanır.
+    // Geçersiz metinde false döner, out'a dokunmaz.
+    static bool parse(std::string_view s, Fixed& out) noexcept
+    {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+            s.remove_prefix(1);
+        }
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' ||
+                              s.back() == '\r' || s.back() == '\n')) {
+            s.remove_suffix(1);
+        }
+        if (s.empty()) {
+            return false;
+        }
+
+        bool neg = false;
+        if (s.front() == '-' || s.front() == '+') {
+            neg = (s.front() == '-');
+            s.remove_prefix(1);
+        }
+
+        rep  whole     = 0;
+        rep  frac      = 0;
+        int  fracDigits = 0;
+        bool roundUp   = false;
+        bool inFrac    = false;
+        bool anyDigit  = false;
+
+        for (char c : s) {
+            if (c == '.' || c == ',') {
+                if (inFrac) {
+                    return false;
+                }
+                inFrac = true;
+                continue;
+            }
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            anyDigit = true;
+            const int d = c - '0';
+            if (!inFrac) {
+                if (whole > (std::numeric_limits<rep>::max() - 9) / 10) {
+                    return false;
+                }
+                whole = whole * 10 + d;
+            } else if (fracDigits < 2) {
+                frac = frac * 10 + d;
+                ++fracDigits;
+            } else if (fracDigits == 2) {
+                roundUp = (d >= 5);
+                ++fracDigits;
+            }
+        }
+        if (!anyDigit) {
+            return false;
+        }
+
+        while (fracDigits < 2) {
+            frac *= 10;
+            ++fracDigits;
+        }
+
+        // whole * kScale + frac (+ yuvarlama, en çok kScale) taşmamalı
+        if (whole > (std::numeric_limits<rep>::max() - kScale) / kScale) {
+            return false;
+        }
+        rep raw = whole * kScale + frac + (roundUp ? 1 : 0);
+        out = Fixed(neg ? -raw : raw);
+        return true;
+    }
+
+    constexpr rep raw() const noexcept { return raw_; }
+
+    // GUI / export kenarı için
+    constexpr double toDouble() const noexcept
+    {
+        return static_cast<double>(raw_) / static_cast<double>(kScale);
+    }
+
+    constexpr bool isZero() const noexcept     { return raw_ == 0; }
+    constexpr bool isPositive() const noexcept { return raw_ > 0; }
+
+    // Negatif sonuçları sıfıra kırpar (kalan limit vb.)
+    constexpr Fixed clampedNonNegative() const noexcept
+    {
+        return raw_ < 0 ? Fixed() : *this;
+    }
+
+    // ---- Aritmetik (aynı Tag) ----
+    constexpr Fixed& operator+=(Fixed o) noexcept { raw_ += o.raw_; return *this; }
+    constexpr Fixed& operator-=(Fixed o) noexcept { raw_ -= o.raw_; return *this; }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) noexcept { return Fixed(a.raw_ + b.raw_); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) noexcept { return Fixed(a.raw_ - b.raw_); }
+    friend constexpr Fixed operator*(Fixed a, rep k) noexcept   { return Fixed(a.raw_ * k); }
+
+    friend constexpr bool operator==(Fixed a, Fixed b) noexcept { return a.raw_ == b.raw_; }
+    friend constexpr bool operator!=(Fixed a, Fixed b) noexcept { return a.raw_ != b.raw_; }
+    friend constexpr bool operator< (Fixed a, Fixed b) noexcept { return a.raw_ <  b.raw_; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) noexcept { return a.raw_ <= b.raw_; }
+    friend constexpr bool operator> (Fixed a, Fixed b) noexcept { return a.raw_ >  b.raw_; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) noexcept { return a.raw_ >= b.raw_; }
+
+    // "12.34" biçiminde ondalık metin (2 hane, '.' ayraç).
+    std::string toString() const
+    {
+        char buf[32];
+        const rep a = raw_ < 0 ? -raw_ : raw_;
+        std::snprintf(buf, sizeof(buf), "%s%lld.%02lld",
+                      raw_ < 0 ? "-" : "",
+                      static_cast<long long>(a / kScale),
+                      static_cast<long long>(a % kScale));
+        return std::string(buf);
+    }
+
+private:
+    constexpr explicit Fixed(rep raw) noexcept : raw_(raw) {}
+
+    rep raw_{0};
+};
+
+// Loglar için: "12.34"
+template <typename Tag>
+std::ostream& operator<<(std::ostream& os, Fixed<Tag> v)
+{
+    return os << v.toString();
+}
+
+struct VolumeTag {};
+struct AmountTag {};
+
+// Hacim: centilitre (x100 litre)
+using Volume = Fixed<VolumeTag>;
+// Tutar: para biriminin alt birimi (x100, kuruş)
+using Amount = Fixed<AmountTag>;
+
+} // namespace recum12::utils
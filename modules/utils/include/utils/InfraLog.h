@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "utils/CardUid.h"
+#include "utils/FixedPoint.h"
+
+// Derleme anı seviye süzgeci: altındaki RECUM_LOG_* çağrıları argümanlarıyla
+// birlikte koddan çıkar (argümanlar hesaplanmaz). 0 DEBUG, 1 INFO, 2 WARN,
+// 3 ERROR. CMake: -DRECUM12_INFRA_MIN_LEVEL=0 (geliştirme).
+#ifndef RECUM12_INFRA_MIN_LEVEL
+#define RECUM12_INFRA_MIN_LEVEL 1
+#endif
+
+namespace recum12::utils {
+
+enum class InfraLevel : std::uint8_t { Debug = 0, Info = 1, Warn = 2, Error = 3 };
+
+// Sayıyı hex yazdırmak için (ör. pompa adresi): RECUM_LOG_INFO("PUMP", "addr=0x{}", InfraHex{a})
+struct InfraHex {
+    std::uint64_t value;
+};
+
+// Tek argüman: sayılar ham değer, metinler kaydın text tamponuna kopya.
+struct InfraArg {
+    enum Kind : std::uint8_t { None, I64, U64, F64, Bool, Char, Hex, Fixed2, Str, Uid };
+
+    Kind          kind{None};
+    std::uint16_t off{0};      // Str / Uid: text içindeki konum
+    std::uint16_t len{0};
+    union {
+        std::int64_t  i;
+        std::uint64_t u;
+        double        d;
+    } v{};
+};
+
+// Halkadaki sabit boyutlu kayıt. Biçimlendirme (şablon + argümanlar → metin)
+// yazan thread'de değil, sink thread'inde yapılır; code ve fmt bu yüzden
+// statik ömürlü olmalıdır (string literal).
+struct InfraRecord {
+    static constexpr std::size_t kMaxArgs   = 8;
+    static constexpr std::size_t kTextBytes = 224;   // metin argümanları (taşan kısım kesilir)
+
+    std::int64_t  ts_ns{0};            // system_clock, epoch'tan ns
+    const char*   code{nullptr};
+    const char*   fmt{nullptr};        // "{}" yer tutuculu şablon
+    InfraLevel    level{InfraLevel::Info};
+    std::uint8_t  nargs{0};
+    std::uint16_t textLen{0};
+    InfraArg      args[kMaxArgs];
+    char          text[kTextBytes];
+
+    void begin(InfraLevel lv, const char* c, const char* f, std::int64_t ts) noexcept
+    {
+        ts_ns      = ts;
+        code       = c;
+        fmt        = f;
+        level      = lv;
+        nargs      = 0;
+        textLen    = 0;
+    }
+
+    std::string_view textOf(const InfraArg& a) const noexcept
+    {
+        return std::string_view(text + a.off, a.len);
+    }
+
+    // Eklenen argümanın indeksi; yer yoksa -1.
+    template <class T>
+    int add(const T& value) noexcept
+    {
+        if (nargs >= kMaxArgs) {
+            return -1;
+        }
+        InfraArg& a = args[nargs];
+        a           = InfraArg{};
+        using U     = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            a.kind = InfraArg::Bool;
+            a.v.u  = value ? 1 : 0;
+        } else if constexpr (std::is_same_v<U, char>) {
+            a.kind = InfraArg::Char;
+            a.v.u  = static_cast<unsigned char>(value);
+        } else if constexpr (std::is_enum_v<U>) {
+            a.kind = InfraArg::I64;
+            a.v.i  = static_cast<std::int64_t>(value);
+        } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            a.kind = InfraArg::I64;
+            a.v.i  = value;
+        } else if constexpr (std::is_integral_v<U>) {
+            a.kind = InfraArg::U64;
+            a.v.u  = value;
+        } else if constexpr (std::is_floating_point_v<U>) {
+            a.kind = InfraArg::F64;
+            a.v.d  = value;
+        } else if constexpr (std::is_same_v<U, InfraHex>) {
+            a.kind = InfraArg::Hex;
+            a.v.u  = value.value;
+        } else if constexpr (std::is_same_v<U, CardUid>) {
+            a.kind = InfraArg::Uid;  // hex'e çevrim sink'te
+            copyText(a, std::string_view(reinterpret_cast<const char*>(value.data()), value.size()));
+        } else if constexpr (std::is_same_v<U, Volume> || std::is_same_v<U, Amount>) {
+            a.kind = InfraArg::Fixed2;
+            a.v.i  = value.raw();
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            a.kind = InfraArg::Str;
+            copyText(a, std::string_view(value));
+        } else {
+            static_assert(!sizeof(U), "InfraLog: desteklenmeyen argüman tipi");
+        }
+        return nargs++;
+    }
+
+private:
+    void copyText(InfraArg& a, std::string_view s) noexcept
+    {
+        std::size_t n = std::min(s.size(), kTextBytes - textLen);
+        // Kesilen metin UTF-8 karakterin ortasında bitmesin
+        while (n > 0 && n < s.size() && (static_cast<unsigned char>(s[n]) & 0xC0) == 0x80) {
+            --n;
+        }
+        std::memcpy(text + textLen, s.data(), n);
+        a.off    = textLen;
+        a.len    = static_cast<std::uint16_t>(n);
+        textLen += static_cast<std::uint16_t>(n);
+    }
+};
+
+struct InfraSinkConfig {
+    std::size_t   ring_records{256};        // thread başına halka (2'nin kuvvetine yuvarlanır)
+    std::uint64_t max_bytes{1024 * 1024};   // dosya bunu aşınca döndürülür
+    int           keep_files{5};            // recumLogs.1.csv .. recumLogs.N.csv
+    bool          console{true};            // satırları stdout/stderr'e de (toplu) yaz
+    InfraLevel    min_level{InfraLevel::Info};  // çalışma anı süzgeci
+    std::chrono::milliseconds interval{100};    // sink uyanma periyodu
+};
+
+struct InfraLogStats {
+    std::uint64_t written{0};     // dosyaya yazılan satır
+    std::uint64_t dropped{0};     // halka dolu olduğu için düşen kayıt
+    std::uint64_t rotations{0};
+    std::size_t   threads{0};     // kayıtlı halka (yazan thread) sayısı
+};
+
+// Altyapı (infra) logu: timeStamp,level,code,message,details CSV'si.
+//
+//   RECUM_LOG_INFO("RS485", "port opened: {} @ {}", dev, baud);
+//
+// Her yazan thread'in kendi tek-üretici/tek-tüketici halkası vardır: yazma
+// kilit, sistem çağrısı ya da bellek ayırma yapmaz; halka doluysa kayıt
+// düşürülür ve sayılır (hot path hiç beklemez). Sink thread'i halkaları
+// periyodik boşaltır, kayıtları zamana göre sıralayıp biçimlendirir,
+// dosyaya toplu yazar ve max_bytes'ta döndürür.
+//
+// start() öncesi (ya da stop() sonrası) kayıtlar senkron olarak konsola
+// yazılır; dosyaya gitmez.
+class InfraLog {
+public:
+    static constexpr bool enabled(InfraLevel level) noexcept
+    {
+        return static_cast<int>(level) >= RECUM12_INFRA_MIN_LEVEL;
+    }
+
+    static bool start(const std::string& csvPath, const InfraSinkConfig& cfg);
+    // Bekleyen kayıtları yazar, sink thread'ini durdurur.
+    static void stop();
+    static bool running() noexcept;
+    static InfraLogStats stats();
+
+    static void setMinLevel(InfraLevel level) noexcept;
+    static bool passes(InfraLevel level) noexcept;
+    static const char* levelName(InfraLevel level) noexcept;
+
+    template <class... Args>
+    static void write(InfraLevel level, const char* code, const char* fmt, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= InfraRecord::kMaxArgs, "InfraLog: en fazla 8 argüman");
+        if (!passes(level)) {
+            return;
+        }
+        InfraRecord* r = claim();
+        if (!r) {
+            return; // halka dolu
+        }
+        r->begin(level, code, fmt, nowNs());
+        (r->add(args), ...);
+        publish();
+    }
+
+    // Dinamik code/message/details (LogManager::appendInfra). Halkadan
+    // değil kilitli bir kuyruktan geçer: metin kesilmez. Kayıt süzgeçte
+    // elendiyse ya da kuyruk doluysa false.
+    static bool writeText(InfraLevel level, std::string_view code, std::string_view message,
+                          std::string_view details);
+
+    // Sink ve senkron yol için: kaydın mesajı (şablon + argümanlar)
+    static void formatMessage(const InfraRecord& r, std::string& out);
+
+private:
+    static std::int64_t nowNs() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Bu thread'in halkasında sıradaki boş yuva (sink yoksa thread-yerel
+    // geçici kayıt); halka dolu → nullptr.
+    static InfraRecord* claim() noexcept;
+    // claim edilen kaydı yayınlar (sink yoksa konsola yazar).
+    static void publish() noexcept;
+};
+
+} // namespace recum12::utils
+
+#define RECUM_LOG(level, code, ...)                                          \
+    do {                                                                     \
+        if constexpr (::recum12::utils::InfraLog::enabled(level)) {          \
+            ::recum12::utils::InfraLog::write(level, code, __VA_ARGS__);     \
+        }                                                                    \
+    } while (0)
+
+#define RECUM_LOG_DEBUG(code, ...) RECUM_LOG(::recum12::utils::InfraLevel::Debug, code, __VA_ARGS__)
+#define RECUM_LOG_INFO(code, ...)  RECUM_LOG(::recum12::utils::InfraLevel::Info, code, __VA_ARGS__)
+#define RECUM_LOG_WARN(code, ...)  RECUM_LOG(::recum12::utils::InfraLevel::Warn, code, __VA_ARGS__)
+#define RECUM_LOG_ERROR(code, ...) RECUM_LOG(::recum12::utils::InfraLevel::Error, code, __VA_ARGS__)
@@ -1,15 +1,30 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
+#include "utils/CardUid.h"
+#include "utils/FixedPoint.h"
+#include "utils/InfraLog.h"
+#include "utils/SequenceAllocator.h"
+#include "utils/UsageAckJournal.h"
+#include "utils/UsageCursor.h"
+#include "utils/UsageLogWriter.h"
+#include "utils/UsageSegmentLog.h"
+
 namespace recum12::utils {
 
 class LogManager {
 public:
-    LogManager() = default;
+    LogManager();
+    ~LogManager();
 
     // ------------------------------------------------------------------
     // 1) Common appRoot & scaffold
@@ -22,26 +37,40 @@ public:
     // 3) bulunamazsa current_path() döner
     static std::string detectAppRoot();
 
+    // Usage satırlarında kullanılan ISO-8601 UTC zaman damgası.
+    // Satırı başka bir kayda (ör. akış profili) bağlamak için önceden alınabilir.
+    static std::string nowTimeStamp();
+
     // Zorunlu klasör ve dosyaları oluşturur:
     // - <appRoot>/logs/recumLogs.csv
-    // - <appRoot>/logs/log_user/logs.csv (yoksa header yazar)
+    // - <appRoot>/logs/log_user/
+    // - <appRoot>/logs/flow/ (satış akış profilleri)
     // fuel.csv yalnızca retention'da kullanılır; scaffold zorunlu değildir.
     static bool ensureScaffold(const std::string& appRoot);
 
     // ------------------------------------------------------------------
-    // 2) Usage logs: <appRoot>/logs/log_user/logs.csv
+    // 2) Usage logs: <appRoot>/logs/log_user/usage/ (UsageSegmentLog)
+    //
+    //    Kayıtlar length + CRC32 çerçeveli, günlük (ve 1 MiB'ta bölünen)
+    //    segmentlerde tutulur; manifest.csv her segmentin id/zaman aralığını
+    //    taşır. Açılışta yalnızca wal.log taranıp yarım son kayıt kesilir.
+    //    Bakım thread'i mühürlü segmentleri zlib ile sıkıştırır ve saklama
+    //    süresini aşanları siler (startUsageMaintenance). Düz CSV
+    //    exportUsageCsv ile istendiğinde üretilir (servis:
+    //    recum12_usage_export). Eski logs.csv ilk açılışta bir kez
+    //    segmentlere taşınıp logs.csv.migrated olarak emekli edilir.
     // ------------------------------------------------------------------
 
     struct UsageEntry {
         // Şema sırası:
         // processId,rfid,firstName,lastName,plate,limit,fuel,logCode,timeStamp,sendOk
-        int         processId{0};
-        std::string rfid;
+        std::uint64_t processId{0};  // 0 → appendUsage kalıcı sayaçtan atar
+        CardUid     rfid{};        // CSV'de hex
         std::string firstName;
         std::string lastName;
         std::string plate;
         int         limit{0};
-        double      fuel{0.0};
+        Volume      fuel{};        // litre, x100 sabit nokta (CSV'de "12.34")
         std::string logCode;
         std::string timeStamp; // ISO-8601 UTC
         std::string sendOk;    // "Yes" | "No" | "NA"
@@ -49,29 +78,205 @@ public:
 
     using UsageAppendCb = std::function<void(const UsageEntry&)>;
 
+    // Bellekteki son kayıtlar penceresi. Pencereden çıkan satırlar
+    // UsageSummary'ye katlanır; kaydın aslı her zaman segmentlerde.
+    struct UsageCacheWindow {
+        std::size_t max_rows{10000};  // en fazla bu kadar satır (0 → yalnızca özet)
+        int         max_days{0};      // > 0 → yalnızca son max_days gün (bugün dahil, UTC)
+    };
+
+    // Pencere dışına düşmüş satırların özeti
+    struct UsageSummary {
+        std::size_t rows{0};
+        std::size_t sales{0};       // PumpOff_PC satırı
+        Volume      fuel{};
+        std::string firstTs;        // ISO olmayan eski satırlar hariç
+        std::string lastTs;
+    };
+
+    struct UsageCacheStats {
+        std::size_t  rows{0};       // penceredeki satır
+        std::size_t  bytes{0};      // tahmini: UsageEntry + string heap'leri
+        UsageSummary older;         // older.rows: özete katlanan toplam satır
+    };
+
     // Yeni bir log satırı eklendiğinde çalışacak opsiyonel callback.
     void setOnUsageAppended(UsageAppendCb cb);
 
-    // Bellek cache'ine ekler + configs/logs.csv dosyasına tek satır append eder.
-    bool appendUsage(const std::string& appRoot, const UsageEntry& e);
+    // Bellek cache penceresini ayarlar; mevcut satırlar hemen kırpılır.
+    void setUsageCacheWindow(const UsageCacheWindow& window);
+    UsageCacheStats usageCacheStats() const;
+    // Penceredeki satırların kopyası (eskiden yeniye).
+    std::vector<UsageEntry> recentUsage() const;
 
-    // Tüm usage loglarını configs/logs.csv'den okur ve out'a doldurur.
-    // Eski 9 kolonlu satırlarda sendOk alanını "NA" kabul eder.
+    // Asenkron yazıcıyı başlatır: wal.log kalıcı fd ile açık kalır ve
+    // appendUsage çerçeveyi yalnızca kuyruğa bırakır. Açılmazsa appendUsage
+    // senkron yola (aç-yaz-kapat) düşer.
+    bool openUsageWriter(const std::string& appRoot, const UsageWriterConfig& cfg);
+    // Bekleyen satırları yazar + sync eder ve yazıcıyı kapatır.
+    void closeUsageWriter();
+    // Düşük öncelikli bakım thread'ini başlatır: mühürlü segmentleri
+    // sıkıştırır, retention_days'ten eski segmentleri siler.
+    bool startUsageMaintenance(const std::string& appRoot,
+                               const UsageSegmentLog::MaintenancePolicy& policy);
+    void stopUsageMaintenance();
+    // Kuyruktaki satırlar diske sync edilene kadar bekler.
+    bool flushUsage();
+    UsageWriterStats usageWriterStats() const;
+
+    // Bellek cache penceresine ekler + wal.log'a tek çerçeve append eder. Yazıcı
+    // açıksa kuyruğa bırakıp hemen döner; sale_end (PumpOff satırı)
+    // OnSaleEnd dayanıklılığında sync noktasıdır (sync beklenir; başarısızsa
+    // satır cache'e girse de false döner). Kaydın (UTC) günü wal'dakinden
+    // farklıysa ya da wal UsageSegmentLog::kSegmentBytes'ı aştıysa wal önce
+    // mühürlenir.
+    bool appendUsage(const std::string& appRoot, const UsageEntry& e,
+                     bool sale_end = false);
+
+    // loadUsage / loadUsageRange / exportUsageCsv'nin segmentleri paralel
+    // çözdüğü worker sayısı (varsayılan 4; 1 → tek thread, eski davranış).
+    void setUsageLoadWorkers(unsigned workers);
+
+    // Tüm usage kayıtlarını segmentlerden okur ve out'a doldurur; bellek
+    // cache'i pencereye sığan son satırlar + özet olarak yeniden kurulur.
+    // Eski 9 kolonlu satırlarda sendOk alanını "NA" kabul eder. Henüz
+    // segmentlere işlenmemiş onaylar (logs.ack) okurken uygulanır.
+    // Segmentler worker havuzunda çözülür, sonuç segment (= kayıt) sırasıdır;
+    // throughput (MB/s, worker sayısı) stdout'a raporlanır. Yüzlerce MB
+    // geçmişte saniyeler sürebilir: UI thread'inden çağrılmamalı.
     bool loadUsage(const std::string& appRoot,
                    std::vector<UsageEntry>& out) const;
 
-    // Belirli bir satırda (processId + timeStamp eşleşmesi) sendOk alanını günceller.
-    // 9 kolonlu satırlarda sendOk yoksa 10. kolon olarak eklenir.
+    // timeStamp'i [fromTs, toTs] aralığındaki kayıtlar (ISO-8601 string
+    // karşılaştırması; boş sınır → açık, ISO olmayan eski satırlar hariç).
+    // Yalnızca manifest aralığı kesişen segmentler açılır; bellek cache'i
+    // değişmez.
+    // Örn. tek gün: "2026-01-31", "2026-01-31T23:59:59Z".
+    bool loadUsageRange(const std::string& appRoot,
+                        const std::string& fromTs,
+                        const std::string& toTs,
+                        std::vector<UsageEntry>& out) const;
+
+    // Segmentler üzerinde akış halinde okuma: satırlar kopyalanmadan
+    // UsageRowView olarak gelir, süzgeç (zaman aralığı → segment seçimi;
+    // rfid / plate / logCode → satır) ayrıştırmadan önce uygulanır. Rapor ve
+    // dışa aktarım için; bellek kullanımı kayıt sayısından bağımsız.
+    UsageCursor openUsageCursor(const std::string& appRoot,
+                                const UsageFilter& filter = {}) const;
+
+    // Segmentlerden (onaylar uygulanmış) CSV üretir: cursor ile akış
+    // halinde tmp'ye yazılır + fsync + rename.
+    // outPath boşsa <appRoot>/logs/log_user/usage_export.csv.
+    bool exportUsageCsv(const std::string& appRoot,
+                        const std::string& outPath = {}) const;
+
+    // processId'li satırın sendOk onayını logs.ack journal'ına ekler (O(1),
+    // segmentler yeniden yazılmaz). Journal kAckCompactThreshold kayda
+    // ulaşınca onaylar segmentlere işlenir. processId 0 (sayaç öncesi eski
+    // satırlar) onaylanamaz.
+    bool ackUsage(const std::string& appRoot,
+                  std::uint64_t processId,
+                  const std::string& sendOk);
+
+    // Eski arayüz: processId artık tekil olduğundan timeStamp yalnızca
+    // uyumluluk için; doğrudan ackUsage(processId).
     bool updateUsageSendOk(const std::string& appRoot,
-                           int processId,
+                           std::uint64_t processId,
                            const std::string& timeStamp,
                            const std::string& sendOk);
 
+    // Kalıcı sayaçtan sıradaki processId (logs/log_user/usage.seq).
+    // Satırı başka bir kayda bağlamak için önceden alınabilir; 0 → hata.
+    std::uint64_t allocateUsageId(const std::string& appRoot);
+
+    // Bekleyen onayları segmentlere işler (yalnızca etkilenen segmentler,
+    // tmp + rename) ve journal'ı boşaltır. openUsageWriter açılışta ve
+    // ackUsage eşikte çağırır.
+    bool compactUsageAcks(const std::string& appRoot);
+
+    // Segmentlere henüz işlenmemiş onay kaydı sayısı.
+    std::size_t usageAckBacklog() const;
+
+    static constexpr std::size_t kAckCompactThreshold = 4096;
+
+    // ------------------------------------------------------------------
+    // 3) Infra logs: <appRoot>/logs/recumLogs.csv
+    //
+    //    Modüller RECUM_LOG_INFO("RS485", "port opened: {}", dev) gibi
+    //    (utils/InfraLog.h) yazar: kayıt thread'in kilitsiz halkasına ham
+    //    argümanlarla düşer, biçimlendirme + dosya yazımı sink thread'inde.
+    //    Sink açık değilken kayıtlar yalnızca konsola (senkron) gider.
+    // ------------------------------------------------------------------
+
+    // Sink'i başlatır: recumLogs.csv'ye toplu yazar, cfg.max_bytes'ta
+    // recumLogs.1.csv ... olarak döndürür.
+    bool startInfraLog(const std::string& appRoot, const InfraSinkConfig& cfg);
+    // Bekleyen kayıtları yazar + sink'i durdurur (destructor da çağırır).
+    void stopInfraLog();
+    InfraLogStats infraLogStats() const;
+
+    // timeStamp,level,code,message,details şemasında tek satır ekler.
+    // level: "DEBUG" | "INFO" | "WARN" | "ERROR". Sink açıksa kuyruğa
+    // bırakır (satır sink'te yazılır), değilse dosyaya doğrudan ekler.
+    bool appendInfra(const std::string& appRoot,
+                     const std::string& level,
+                     const std::string& code,
+                     const std::string& message,
+                     const std::string& details = {});
+
 private:
-    // Usage cache + callback
-    mutable std::mutex usageMtx_;
-    mutable std::vector<UsageEntry> usageRows_;
+    // appendMtx_ tutulurken (seed için usage log açık olmalı)
+    bool openUsageSeq(const std::string& appRoot);
+    std::uint64_t allocateUsageIdLocked(const std::string& appRoot);
+    // appendMtx_ tutulurken: segment store'u açar (+ recovery, ilk göç)
+    bool openUsageLog(const std::string& appRoot) const;
+    bool sealUsageLocked();
+    // appendMtx_ altında alınan yazıcı kopyası (yoksa null)
+    std::shared_ptr<UsageLogWriter> usageWriter() const;
+    // Journal'ı okur, segment listesinin anlık görüntüsünü alır
+    bool snapshotUsage(const std::string& appRoot, const UsageFilter& filter,
+                       UsageSegmentLog::Snapshot& snap,
+                       std::shared_ptr<const UsageCursor::AckMap>& acks) const;
+    bool readUsage(const std::string& appRoot, const UsageFilter& filter,
+                   std::vector<UsageEntry>& out,
+                   UsageCursor::Stats* stats = nullptr) const;
+    // usageMtx_ tutulurken: pencere dışına düşenleri özete katlar
+    void trimUsageCacheLocked() const;
+    void foldUsageLocked(const UsageEntry& e) const;
+    bool openAckJournal(const std::string& appRoot);
+    bool compactAcksLocked(const std::string& appRoot);
+
+    // Infra log dosyası için yazma kilidi (sink kapalıyken)
+    std::mutex infraMtx_;
+    bool       infraStarted_{false};
+
+    // Usage cache (son satırlar penceresi + eskilerin özeti) + callback
+    mutable std::mutex              usageMtx_;
+    mutable std::deque<UsageEntry>  usageRows_;
+    UsageCacheWindow                usageWindow_{};
+    mutable UsageSummary            usageOlder_{};
+    mutable std::size_t             usageCacheBytes_{0};
     UsageAppendCb onUsageAppended_{};
+
+    // Paralel okuma worker sayısı (setUsageLoadWorkers)
+    std::atomic<unsigned> usageLoadWorkers_{4};
+
+    // wal.log asenkron yazıcısı (openUsageWriter ile). Pointer appendMtx_
+    // altında okunur/değişir; flush/stats kilit dışında kopya üzerinden
+    // (closeUsageWriter'ın reset'i çalışan flush'ı düşürmez).
+    std::shared_ptr<UsageLogWriter> usageWriter_;
+    std::string                     usageWriterRoot_;
+
+    // processId ataması + çerçevenin wal'a/kuyruğa girişi aynı sırada olsun;
+    // mühürleme/compaction/okuma segment listesini bununla korur
+    mutable std::mutex              appendMtx_;
+    mutable UsageSegmentLog         usageLog_;
+    std::mutex                      seqMtx_;
+    SequenceAllocator               usageSeq_;
+
+    // sendOk onay journal'ı (logs/log_user/logs.ack)
+    std::mutex                      ackMtx_;
+    UsageAckJournal                 ackJournal_;
 };
 
 } // namespace recum12::utils
\ No newline at end of file
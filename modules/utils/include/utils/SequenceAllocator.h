@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace recum12::utils {
+
+// Kalıcı, monoton artan 64-bit id üreteci (usage kayıtlarının processId'si).
+//
+//  - Sayaç küçük bir dosyada mmap ile tutulur. Her next() diske yazmaz:
+//    block kadar id'lik aralık önceden ayrılır, sınır dosyaya yazılıp
+//    msync(MS_SYNC) edilir; aralık bitene kadar id'ler bellekten verilir.
+//  - Çökme sonrası açılışta ayrılmış sınırın bir fazlasından devam edilir:
+//    id asla tekrar verilmez, en fazla block-1 id'lik boşluk oluşur. Temiz
+//    close() kullanılmayan aralığı geri yazar.
+//  - Sınır iki slota dönüşümlü yazılır (gen + checksum); yarım yazılmış
+//    slot atılır, diğer slot geçerli kalır.
+//  - Dosya yok/tanınmıyor/iki slot da bozuksa ya da sınır floor'un
+//    gerisindeyse floor'dan devam edilir (floor: store'daki en büyük id).
+//
+// Thread-safe.
+class SequenceAllocator {
+public:
+    SequenceAllocator() = default;
+    ~SequenceAllocator();
+
+    SequenceAllocator(const SequenceAllocator&)            = delete;
+    SequenceAllocator& operator=(const SequenceAllocator&) = delete;
+
+    // Dosyayı açar/oluşturur. block: bir msync ile ayrılan id sayısı (>= 1).
+    // floor: daha önce verildiği bilinen en büyük id; sayaç bunun altına inmez.
+    bool open(const std::string& path, std::uint32_t block = 64,
+              std::uint64_t floor = 0);
+    void close();
+    bool isOpen() const;
+    const std::string& path() const noexcept { return path_; }
+
+    // Sıradaki id (1'den başlar); kalıcı sınır yazılamazsa 0.
+    std::uint64_t next();
+
+    // Şimdiye kadar verilmiş olabilecek en büyük id (yoksa 0).
+    std::uint64_t last() const;
+
+private:
+    bool reserveLocked(std::uint64_t limit);
+
+    mutable std::mutex mtx_;
+    std::string        path_;
+    int                fd_{-1};
+    void*              map_{nullptr};
+    std::uint32_t      block_{64};
+    std::uint64_t      next_{1};     // sıradaki id
+    std::uint64_t      limit_{0};    // diske yazılmış son ayrılmış id
+    std::uint64_t      gen_{0};      // son yazılan slot nesli
+};
+
+} // namespace recum12::utils
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include "utils/FixedPoint.h"
+
 namespace recum12::utils {
 
 struct RemotePortsConfig {
@@ -18,6 +20,12 @@ struct RemoteConfig {
     std::vector<std::string>  prefer_iface{}; // Örn: {"eth0","wlan0","ppp0"}
 };
 
+// Hattaki bir pompa (DART adresi 0x50..0x6F) + tabanca
+struct PumpSlotConfig {
+    std::uint8_t addr{0x50};
+    std::uint8_t nozzle{1};
+};
+
 struct Rs485Config {
     std::string  name{"pump"};
     std::string  port{"/dev/ttyUSB0"};
@@ -25,6 +33,51 @@ struct Rs485Config {
     int          data_bits{8};
     char         parity{'O'};   // 'O', 'E', 'N' vb.
     int          stop_bits{1};
+    // Bu hattaki pompa/tabancalar (boşsa yalnızca 0x50 / nozzle-1)
+    std::vector<PumpSlotConfig> slots{};
+};
+
+// PN532 kart okuyucu. Birden çok okuyucu varsa her biri bir pompa/tabancaya
+// bağlanır; addr == 0 → tüm pompalara hizmet eden genel okuyucu.
+struct RfidConfig {
+    std::string  backend{"libnfc"};    // "libnfc" | "mock"
+    std::string  script{};             // mock: senaryo dosyası (appRoot'a göre)
+    std::string  device{};             // libnfc connstring; boş → ilk bulunan
+    bool         hardware_poll{true};  // "mode": "poll_target" | "select"
+    int          poll_period_ms{150};  // poll_target: tarama periyodu
+    int          poll_count{20};       // poll_target: çağrı başına tur
+    std::uint8_t addr{0};              // bağlı pompa (0x50..0x6F), 0 → genel
+    std::uint8_t nozzle{1};            // bağlı tabanca
+};
+
+// Kullanıcı/plaka bazlı tüketim kotası (litre; 0 → o pencere limitsiz).
+struct QuotaConfig {
+    Volume  daily{};
+    Volume  weekly{};
+    Volume  monthly{};
+    bool    per_plate{true};
+    bool    user_limit_daily{true};   // users.csv limiti aynı zamanda günlük kota
+};
+
+// logs.csv asenkron yazıcısı (UsageLogWriter).
+struct UsageLogConfig {
+    std::string  durability{"interval"};  // "record" | "interval" | "sale_end"
+    int          interval_ms{200};        // interval: en geç bu kadar ms'de bir fdatasync
+    int          queue{1024};             // kuyruk kapasitesi (satır)
+    int          retention_days{0};       // mühürlü segment saklama süresi; 0 → sınırsız
+    bool         compress{true};          // mühürlü segmentleri arka planda zlib'le
+    int          load_workers{4};         // yükleme/export'ta segmentleri paralel çözen thread
+    int          cache_rows{10000};       // bellekte tutulan son satır sayısı
+    int          cache_days{0};           // > 0 → bellekte yalnızca son N gün; 0 → sınırsız
+};
+
+// recumLogs.csv altyapı logu (InfraLog sink'i).
+struct InfraLogConfig {
+    std::string  min_level{"INFO"};       // "DEBUG" | "INFO" | "WARN" | "ERROR" (çalışma anı)
+    int          ring_records{256};       // thread başına halka kapasitesi (kayıt)
+    int          max_kb{1024};            // dosya bu boyu aşınca döndürülür
+    int          keep_files{5};           // saklanan eski dosya (recumLogs.N.csv)
+    bool         console{true};           // satırları konsola da yaz
 };
 
 class Settings {
@@ -41,10 +94,19 @@ public:
 
     const RemoteConfig& remote() const noexcept { return remote_; }
     const std::vector<Rs485Config>& rs485() const noexcept { return rs485_; }
+    const QuotaConfig& quota() const noexcept { return quota_; }
+    // "rfid": {...} tek okuyucu veya [{...}, ...] okuyucu listesi (en az bir)
+    const std::vector<RfidConfig>& rfid() const noexcept { return rfid_; }
+    const UsageLogConfig& usageLog() const noexcept { return usage_log_; }
+    const InfraLogConfig& infraLog() const noexcept { return infra_log_; }
 
 private:
     RemoteConfig              remote_{};
     std::vector<Rs485Config>  rs485_{};
+    QuotaConfig               quota_{};
+    std::vector<RfidConfig>   rfid_{};
+    UsageLogConfig            usage_log_{};
+    InfraLogConfig            infra_log_{};
 };
 
 } // namespace recum12::utils
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace recum12::utils {
+
+// logs.csv satırlarının sunucu onayları (sendOk) için append-only journal.
+//
+//  - Her onay, satırın processId'si (SequenceAllocator) + sendOk içeren
+//    checksum'lı sabit uzunluklu bir kayıt olarak eklenir (+fdatasync).
+//    logs.csv'ye dokunulmaz → onay maliyeti dosya boyundan bağımsız.
+//  - Okumada aynı id için son geçerli kayıt kazanır; yarım yazılmış son kayıt
+//    atılır.
+//  - Onaylar logs.csv'ye işlendikten (LogManager::compactUsageAcks) sonra
+//    reset() ile boşaltılır. Arada çökme olursa journal yeniden uygulanır;
+//    uygulama idempotent.
+//
+// Thread-safe.
+class UsageAckJournal {
+public:
+    static constexpr std::size_t kSendOkMax = 7;   // "Yes" | "No" | "NA"
+
+    UsageAckJournal() = default;
+    ~UsageAckJournal();
+
+    UsageAckJournal(const UsageAckJournal&)            = delete;
+    UsageAckJournal& operator=(const UsageAckJournal&) = delete;
+
+    // Dosyayı açar/oluşturur; bozuk son kaydı keser.
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const;
+    const std::string& path() const noexcept { return path_; }
+
+    // sendOk en fazla kSendOkMax karakter.
+    bool append(std::uint64_t processId, const std::string& sendOk);
+
+    // Journal'ı yalnızca header'a indirir (onaylar logs.csv'ye işlendi).
+    bool reset();
+
+    // Dosyadaki geçerli kayıt sayısı.
+    std::size_t records() const;
+
+    // Açık fd gerektirmeden dosyayı okur: processId → son sendOk.
+    // Dosya yoksa boş map ile true döner.
+    static bool readAll(const std::string& path,
+                        std::unordered_map<std::uint64_t, std::string>& out);
+
+private:
+    mutable std::mutex mtx_;
+    std::string        path_;
+    int                fd_{-1};
+    std::size_t        records_{0};
+    bool               torn_{false};   // yarım kayıt kesilemedi: reset()'e kadar ekleme yok
+};
+
+} // namespace recum12::utils
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/CardUid.h"
+#include "utils/CsvScanner.h"
+#include "utils/FixedPoint.h"
+#include "utils/UsageSegmentLog.h"
+
+namespace recum12::utils {
+
+// Tek usage satırının sahipsiz görüntüsü. Alanlar segment tamponuna (mmap
+// ya da açılmış .log.z) işaret eder; cursor sonraki satıra geçince ya da
+// yok olunca geçersizdir. Tırnaklı alanlar dış tırnaksız tutulur; ""
+// kaçışı olanları text() gerektiğinde unescape eder (CsvField ile aynı).
+struct UsageRowView {
+    enum Col : std::size_t {
+        ProcessId, Rfid, FirstName, LastName, Plate, Limit, Fuel, LogCode, TimeStamp, SendOk,
+        kCols
+    };
+
+    std::array<std::string_view, kCols> cols{};
+    std::uint16_t    escaped{0};      // bit c → cols[c] "" kaçışı içeriyor
+    std::uint64_t    processId{0};
+    std::string_view payload;         // ham CSV satırı ('\n' yok)
+    bool             acked{false};    // sendOk journal'dan (logs.ack) geldi
+
+    std::string_view raw(Col c) const noexcept { return cols[c]; }
+    // Unescape edilmiş alan (kaçış yoksa düz kopya).
+    std::string text(Col c) const;
+    // Kaçış içermeyen alanlarda kopyasız karşılaştırma.
+    bool equals(Col c, std::string_view v) const;
+
+    CardUid rfid() const noexcept;
+    Volume  fuel() const noexcept;
+    int     limit() const noexcept;
+};
+
+// Satırlar açılmadan (segment) ve kopyalanmadan (satır) uygulanan süzgeç.
+// Boş alan → o kolon için koşul yok.
+struct UsageFilter {
+    std::string fromTs;     // ISO-8601 UTC, dahil (ISO olmayan satırlar hariç)
+    std::string toTs;
+    CardUid     rfid{};
+    std::string plate;
+    std::string logCode;
+
+    bool ranged() const noexcept { return !fromTs.empty() || !toTs.empty(); }
+};
+
+// Usage segmentleri üzerinde ileri yönlü, sabit bellekli okuma.
+//
+//   auto cur = logManager.openUsageCursor(appRoot, filter);
+//   UsageRowView row;
+//   while (cur.next(row)) { ... }
+//
+// Açılıştaki segment listesini (UsageSegmentLog::snapshot) gezer: açık
+// segmentler mmap edilir, .log.z tek seferde açılır; bellekte aynı anda
+// tek segment bulunur. Satır süzgeçten geçmeden hiçbir alan ayrıştırılmaz
+// ya da kopyalanmaz. Onaylar (logs.ack) açılışta okunup sendOk'a uygulanır.
+//
+// Kilit tutmaz; açıldıktan sonra eklenen satırlar görülmeyebilir.
+// Taşınabilir, kopyalanamaz; thread-safe değildir.
+class UsageCursor {
+public:
+    struct Stats {
+        std::size_t segments{0};   // açılan
+        std::size_t skipped{0};    // manifest aralığı nedeniyle açılmayan
+        std::size_t scanned{0};    // çözülen çerçeve
+        std::size_t matched{0};    // süzgeçten geçen satır
+        std::size_t bytes{0};      // açılan segmentlerin (açılmış) boyu
+    };
+
+    // processId → sendOk; paralel okumada parçalar arasında paylaşılır
+    using AckMap = std::unordered_map<std::uint64_t, std::string>;
+
+    UsageCursor();   // boş: next() hep false
+    UsageCursor(UsageSegmentLog::Snapshot snap, UsageFilter filter, AckMap acks);
+    UsageCursor(UsageSegmentLog::Snapshot snap, UsageFilter filter,
+                std::shared_ptr<const AckMap> acks);
+    ~UsageCursor();
+
+    UsageCursor(UsageCursor&&) noexcept;
+    UsageCursor& operator=(UsageCursor&&) noexcept;
+    UsageCursor(const UsageCursor&)            = delete;
+    UsageCursor& operator=(const UsageCursor&) = delete;
+
+    // Sıradaki eşleşen satır; bitti → false.
+    bool next(UsageRowView& row);
+
+    Stats stats() const;
+
+    // payload'ı kolonlara ayırır (kopyasız, CsvScanner). 9 kolonlu eski
+    // satırda sendOk "NA". fields: yeniden kullanılan ara tampon.
+    static bool splitRow(std::string_view payload, UsageRowView& row,
+                         std::vector<CsvField>& fields);
+
+private:
+    struct State;
+    std::unique_ptr<State> st_;
+};
+
+} // namespace recum12::utils
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace recum12::utils {
+
+// Satırların diske kalıcı (fdatasync) yazılma anı.
+enum class UsageDurability {
+    PerRecord,  // her batch yazılır yazılmaz sync (grup commit)
+    Interval,   // en geç interval'de bir sync
+    OnSaleEnd,  // satış kapanış satırı (sync_point) gelince / kapanışta
+};
+
+struct UsageWriterConfig {
+    UsageDurability           durability{UsageDurability::Interval};
+    std::chrono::milliseconds interval{200};
+    std::size_t               queue_capacity{1024};   // satır
+};
+
+struct UsageWriterStats {
+    std::uint64_t enqueued{0};
+    std::uint64_t written{0};         // diske write edilen satır
+    std::uint64_t batches{0};         // write çağrısı
+    std::uint64_t max_batch{0};
+    std::uint64_t full_waits{0};      // kuyruk doluyken bekleyen enqueue
+    std::uint64_t write_errors{0};    // write + fdatasync hataları
+    // enqueue() süresi (kilit + kopya; kuyruk doluysa bekleme dahil)
+    std::int64_t  enqueue_last_us{0};
+    std::int64_t  enqueue_max_us{0};
+    double        enqueue_avg_us{0.0};
+    // fdatasync süresi
+    std::uint64_t syncs{0};
+    std::int64_t  sync_last_us{0};
+    std::int64_t  sync_max_us{0};
+    double        sync_avg_us{0.0};
+};
+
+// Usage wal.log için kalıcı fd'li, grup commit'li asenkron yazıcı.
+//
+//  - enqueue() satırı sınırlı bir halka kuyruğa kopyalar ve döner (çok
+//    üreticili: GUI + core thread). Kuyruk doluysa yer açılana kadar bekler
+//    (kayıt düşürülmez).
+//  - Yazıcı thread'i kuyruktaki tüm satırları tek bir write() ile O_APPEND
+//    fd'ye ekler; durability'ye göre batch başına en fazla bir fdatasync.
+//  - flush() o ana kadar kuyruğa giren her satır yazılıp sync edilene kadar
+//    bekler (okuma / yeniden yazma öncesi ve kapanışta).
+class UsageLogWriter {
+public:
+    UsageLogWriter() = default;
+    ~UsageLogWriter();
+
+    UsageLogWriter(const UsageLogWriter&)            = delete;
+    UsageLogWriter& operator=(const UsageLogWriter&) = delete;
+
+    // Dosyayı açar (yoksa oluşturup header yazar) ve yazıcı thread'ini başlatır.
+    bool open(const std::string& path, const std::string& header,
+              const UsageWriterConfig& cfg);
+    // Bekleyenleri yazar + sync eder, thread'i durdurur, fd'yi kapatır.
+    void close();
+    bool isOpen() const noexcept { return fd_ >= 0; }
+
+    // line dosyaya olduğu gibi eklenir (usage wal'da bir çerçeve).
+    // sync_point: OnSaleEnd'de bu kayıtla sync.
+    bool enqueue(std::string line, bool sync_point = false);
+
+    // Kuyruktaki satırlar yazılıp sync edilene kadar bekler. Bu sürede bir
+    // write veya fdatasync başarısız olduysa false.
+    bool flush();
+    const UsageWriterConfig& config() const noexcept { return cfg_; }
+
+    // Dosya dışarıdan yeniden yazılırken (onay compaction'ı) yazıcıyı
+    // durdurur; dönen kilit bırakılana kadar write yapılmaz. Önce flush().
+    std::unique_lock<std::mutex> lockFile();
+    // Dosya tmp + rename ile değiştirildikten sonra (lockFile() tutulurken)
+    // fd'yi yeni dosyaya çevirir; eski inode'a yazılmaya devam edilmez.
+    bool reopenLocked();
+
+    UsageWriterStats stats() const;
+
+private:
+    struct Item {
+        std::string   line;
+        bool          sync_point{false};
+    };
+
+    void run();
+    bool writeAll(const std::string& buf);
+    bool syncNow();
+
+    UsageWriterConfig        cfg_{};
+    std::string              path_;
+    std::atomic<int>         fd_{-1};
+    std::thread              thread_;
+
+    // Halka kuyruk (cfg_.queue_capacity)
+    mutable std::mutex       mtx_;
+    std::condition_variable  notEmpty_;
+    std::condition_variable  notFull_;
+    std::condition_variable  durable_;
+    std::vector<Item>        ring_;
+    std::size_t              head_{0};
+    std::size_t              count_{0};
+    bool                     stop_{false};
+    std::uint64_t            enqSeq_{0};      // kuyruğa giren son satır
+    std::uint64_t            durableSeq_{0};  // write + sync edilen son satır
+    bool                     forceSync_{false};
+
+    // write/fdatasync ile dışarıdan dosya yeniden yazımı arasında
+    std::mutex               fileMtx_;
+    // Yarım write geri alınamadı: arkasına eklenen çerçeveler açılış
+    // recovery'sinde kesilirdi, yeni satır kabul edilmez
+    std::atomic<bool>        torn_{false};
+
+    UsageWriterStats         stats_{};
+};
+
+} // namespace recum12::utils
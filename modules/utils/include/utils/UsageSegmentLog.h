@@ -0,0 +1,233 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace recum12::utils {
+
+// Usage kayıtlarının çerçeveli (length + CRC32) segment dosyaları.
+//
+//  Dizin düzeni (<appRoot>/logs/log_user/usage/):
+//    seg-00000001.log ...  mühürlenmiş, değişmeyen segmentler
+//    seg-00000001.log.z    arka planda zlib ile sıkıştırılmış segment
+//    wal.log               aktif yazma segmenti (write-ahead tail)
+//    manifest.csv          segment başına seq, kayıt sayısı, id ve zaman aralığı
+//    .lock                 açık store'un süreç kilidi (flock)
+//
+//  Dosya: 24 baytlık header (magic, version, segment seq) + ardışık
+//  çerçeveler: u32 len, u32 crc32(payload), payload. Payload tek bir usage
+//  satırıdır (CSV, '\n' yok); CSV dışa aktarımı doğrudan bunlardan üretilir.
+//  .log.z dosyası aynı baytların tek parça zlib akışıdır.
+//
+//  - Açılışta (recovery) yalnızca wal.log taranır: ilk bozuk/yarım
+//    çerçeveden sonrası kesilir. Mühürlü segmentler manifest'ten okunur;
+//    manifest'te olmayan/uyuşmayan segment bir kez taranıp eklenir.
+//  - seal(): wal.log fsync + rename ile seg-<seq>.log olur, yerine boş
+//    wal.log açılır (rename atomik → çökme sonrası ya eski ya yeni hal).
+//    Çağıran gün değişiminde (needsRotation) ve boyut eşiğinde mühürler.
+//  - rewrite(): kayıtları değişen segment tmp'ye yazılıp fsync + rename ile
+//    değiştirilir (onay compaction'ı). Sıkıştırılmış segment açık .log
+//    olarak geri yazılır; bakım thread'i sonra yeniden sıkıştırır.
+//  - Bakım thread'i (startMaintenance): düşük öncelikte mühürlü segmentleri
+//    sıkıştırır ve saklama süresini aşan segmentleri siler.
+//
+// Store'u aynı anda tek süreç açar: open() dizindeki .lock'u flock ile
+// tutar (close'a kadar). Kilit başkasındaysa open false döner ve busy()
+// true olur; ikinci süreç wal'ı kesmez, tmp/.log.z dosyalarını silmez.
+//
+// Yazma sırası dışarıdan (LogManager + UsageLogWriter) koordine edilir;
+// bu sınıfın kendi kilidi segment listesini ve dosya değişimlerini korur.
+// Okuyucular (UsageCursor) kilit tutmaz: snapshot() + mmap; dosyalar hep
+// rename/unlink ile değiştiğinden açık eşleme geçerli kalır.
+class UsageSegmentLog {
+public:
+    static constexpr std::size_t kHeaderSize      = 24;
+    static constexpr std::size_t kFrameOverhead   = 8;
+    static constexpr std::size_t kMaxPayload      = 64 * 1024;
+    static constexpr std::size_t kSegmentBytes    = 1024 * 1024;  // mühürleme eşiği
+
+    struct RecoveryStats {
+        std::size_t   wal_records{0};
+        std::uint64_t truncated_bytes{0};  // kesilen yarım/bozuk kuyruk
+        bool          wal_recreated{false};
+        std::size_t   segments{0};         // mühürlü segment sayısı
+        std::size_t   rescanned{0};        // manifest'te olmadığı için taranan
+    };
+
+    // Manifest satırı. Zaman damgaları ISO-8601 UTC; aralık min/max'tır
+    // (saat geri alınsa da doğru). ISO olmayan eski satırlarda boş kalır.
+    struct SegmentInfo {
+        std::uint64_t seq{0};
+        bool          compressed{false};
+        std::uint64_t records{0};
+        std::uint64_t raw_bytes{0};        // sıkıştırılmamış dosya boyu
+        std::uint64_t min_id{0};
+        std::uint64_t max_id{0};
+        std::string   min_ts;
+        std::string   max_ts;
+        std::uint64_t untimed{0};          // ISO zaman damgası olmayan kayıt
+    };
+
+    struct MaintenancePolicy {
+        bool                 compress{true};
+        int                  retention_days{0};   // 0 → silme yok
+        std::chrono::seconds period{600};         // seal() ayrıca uyandırır
+    };
+
+    struct MaintenanceStats {
+        std::uint64_t compressed{0};        // sıkıştırılan segment
+        std::uint64_t bytes_in{0};
+        std::uint64_t bytes_out{0};
+        std::uint64_t expired{0};           // saklama süresi dolup silinen
+        std::uint64_t expired_records{0};
+    };
+
+    // Payload'dan processId ve zaman damgası (manifest için).
+    using RecordInfoFn = std::function<void(const std::string& payload,
+                                            std::uint64_t& id, std::string& ts)>;
+
+    UsageSegmentLog() = default;
+    ~UsageSegmentLog();
+
+    UsageSegmentLog(const UsageSegmentLog&)            = delete;
+    UsageSegmentLog& operator=(const UsageSegmentLog&) = delete;
+
+    // Dizini açar/oluşturur, süreç kilidini alır, manifest'i yükler,
+    // wal.log'u kurtarır.
+    bool open(const std::string& dir, RecordInfoFn info);
+    void close();
+    bool isOpen() const;
+    // Son open() store başka bir süreçte açık olduğu için mi başarısız oldu?
+    bool busy() const;
+    const std::string& dir() const noexcept { return dir_; }
+    std::string walPath() const;
+    RecoveryStats recovery() const;
+    std::vector<SegmentInfo> segments() const;
+
+    // Hiç kayıt yok mu (mühürlü segment yok ve wal boş)?
+    bool empty() const;
+    // Manifest ve wal'daki en büyük kayıt id'si (yoksa 0).
+    std::uint64_t maxId() const;
+    // wal.log'daki çerçeve baytları (header hariç; mühürleme eşiği için).
+    std::uint64_t walBytes() const;
+    // ts ile gelen kayıt wal'a girmeden önce mühürlenmeli mi: boyut eşiği
+    // aşıldı ya da wal'daki kayıtlar başka bir (UTC) güne ait.
+    bool needsRotation(const std::string& ts) const;
+    // Yazıcı kuyruğuna bırakılan çerçeveyi wal istatistiğine işler.
+    void noteAppend(std::uint64_t bytes, std::uint64_t id, const std::string& ts);
+
+    // Payload'ı çerçeveleyip out'a ekler.
+    static void appendFrame(std::string& out, const std::string& payload);
+    static std::uint32_t crc32(const void* data, std::size_t len);
+    // "YYYY-MM-DD..." (ISO-8601) mi? Gün/aralık karşılaştırmaları yalnızca bunlarda.
+    static bool isIsoTimeStamp(std::string_view ts);
+
+    // Yazıcı kapalıyken senkron ekleme (wal.log'a O_APPEND).
+    bool append(const std::string& frame, std::uint64_t id, const std::string& ts);
+
+    // wal.log'u mühürler. Çağıran yazıcıyı flush edip dosya kilidini tutar
+    // ve sonrasında yazıcının fd'sini yeni wal.log'a çevirir.
+    bool seal();
+
+    // Okunacak segmentlerin anlık listesi (UsageCursor). fromTs/toTs
+    // (dahil, boş → sınırsız) verilirse yalnızca manifest aralığı kesişen
+    // segmentler alınır; kayıt bazında süzmek cursor'ın işidir. Liste kilit
+    // tutmaz: her parça için yollar sırayla denenir (bakım arada
+    // sıkıştırmış, wal mühürlenmiş olabilir); header seq'i tutmayan dosya
+    // atlanır.
+    struct ReadPart {
+        std::uint64_t seq{0};
+        std::uint64_t raw_bytes{0};                        // .log.z açma ipucu
+        bool          wal{false};
+        std::vector<std::pair<std::string, bool>> paths;   // {yol, sıkıştırılmış}
+    };
+    struct Snapshot {
+        std::vector<ReadPart> parts;    // seq sıralı, wal en sonda
+        std::size_t           skipped{0};
+    };
+    Snapshot snapshot(const std::string& fromTs = {}, const std::string& toTs = {}) const;
+
+    // Cursor'lar için çerçeve çözümü: off'taki çerçeve geçerliyse payload'ı
+    // verir ve sonraki ofseti döner; bozuk/yarım/son → 0.
+    static std::size_t nextFrame(std::string_view file, std::size_t off,
+                                 std::string_view& payload);
+    // Dosya header'ı geçerliyse segment seq'i.
+    static bool fileSeq(std::string_view file, std::uint64_t& seq);
+    // .log.z dosyasını açar (hint: beklenen açık boy).
+    static bool readCompressed(const std::string& path, std::size_t hint, std::string& out);
+
+    // mutate payload'ı değiştirirse true döner. Değişen kaydı olan her
+    // segment tmp + rename ile yeniden yazılır; walRewritten → çağıran
+    // yazıcının fd'sini yenilemeli. mayContain(min_id, max_id) false
+    // dönen segmentler hiç okunmaz.
+    bool rewrite(const std::function<bool(std::string& payload)>& mutate,
+                 const std::function<bool(std::uint64_t, std::uint64_t)>& mayContain,
+                 std::size_t& changed, bool& walRewritten);
+
+    // Boş store'a tek seferde payload listesi yükler (logs.csv göçü): gün /
+    // boyut sınırlarında mühürlü segmentlere bölünür. import.pending işareti
+    // manifest yazılana kadar durur; yarım göç açılışta silinip baştan yapılır.
+    bool importInitial(const std::vector<std::string>& payloads);
+
+    // Arka plan bakımını başlatır/durdurur (tek thread, SCHED_IDLE).
+    bool startMaintenance(const MaintenancePolicy& policy);
+    void stopMaintenance();
+    // Tek bakım turu (thread'in yaptığı; çağıran thread'de çalışır).
+    bool runMaintenance(const MaintenancePolicy& policy);
+    MaintenanceStats maintenanceStats() const;
+
+private:
+    struct Segment {
+        SegmentInfo   info;
+        std::uint64_t gen{0};   // rewrite sayacı: bakım eski içeriği sıkıştırmasın
+    };
+
+    std::string segPath(std::uint64_t seq, bool compressed) const;
+    std::string manifestPath() const;
+    bool createWal(std::uint64_t seq);
+    bool recoverWal();
+    bool loadSegments();
+    bool writeManifestLocked() const;
+    bool readSegment(const SegmentInfo& s, std::string& data) const;
+    bool scanInfo(const std::string& data, SegmentInfo& s) const;
+    void noteRecord(SegmentInfo& s, std::uint64_t id, const std::string& ts) const;
+    bool compressOne(std::uint64_t seq);
+    std::size_t expireBefore(const std::string& cutoffDay);
+    void maintenanceLoop(MaintenancePolicy policy);
+    bool maintenanceStopping();
+
+    // Liste okuyan paylaşımlı; segment/dosya değiştiren her şey özel
+    mutable std::shared_mutex mtx_;
+    std::string               dir_;
+    RecordInfoFn              info_;
+    bool                      open_{false};
+    int                       lockFd_{-1};   // <dir>/.lock (flock)
+    bool                      busy_{false};
+    std::vector<Segment>      sealed_;       // seq sıralı
+    std::uint64_t             walSeq_{1};
+    std::uint64_t             walBytes_{0};
+    SegmentInfo               wal_{};        // wal.log'daki kayıtların aralığı
+    bool                      walTorn_{false};  // append yarım kaldı, geri alınamadı
+    RecoveryStats             recovery_{};
+
+    // Bakım thread'i
+    std::mutex                maintMtx_;
+    std::condition_variable   maintCv_;
+    std::thread               maintThread_;
+    bool                      maintStop_{false};
+    bool                      maintKick_{false};
+    mutable std::mutex        statsMtx_;
+    MaintenanceStats          maintStats_{};
+};
+
+} // namespace recum12::utils
@@ -0,0 +1,152 @@
+#include "utils/CsvScanner.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace recum12::utils {
+
+std::string CsvField::text() const
+{
+    std::string out;
+    appendTo(out);
+    return out;
+}
+
+void CsvField::appendTo(std::string& out) const
+{
+    if (!escaped) {
+        out.append(raw.data(), raw.size());
+        return;
+    }
+    out.reserve(out.size() + raw.size());
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        out.push_back(raw[i]);
+        if (raw[i] == '"' && i + 1 < raw.size() && raw[i + 1] == '"') {
+            ++i; // "" → "
+        }
+    }
+}
+
+const char* CsvScanner::findSpecial(const char* p, const char* end, char delim) noexcept
+{
+#if defined(__SSE2__)
+    const __m128i vd = _mm_set1_epi8(delim);
+    const __m128i vq = _mm_set1_epi8('"');
+    const __m128i vn = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, vd), _mm_cmpeq_epi8(v, vq)),
+                                       _mm_cmpeq_epi8(v, vn));
+        const unsigned bits = static_cast<unsigned>(_mm_movemask_epi8(m));
+        if (bits != 0) {
+            return p + __builtin_ctz(bits);
+        }
+        p += 16;
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const uint8x16_t vd = vdupq_n_u8(static_cast<std::uint8_t>(delim));
+    const uint8x16_t vq = vdupq_n_u8('"');
+    const uint8x16_t vn = vdupq_n_u8('\n');
+    while (end - p >= 16) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(p));
+        const uint8x16_t m = vorrq_u8(vorrq_u8(vceqq_u8(v, vd), vceqq_u8(v, vq)), vceqq_u8(v, vn));
+        // 16 bayt maskeyi 64 bitlik nibble maskesine indir (bayt başına 4 bit)
+        const uint8x8_t n = vshrn_n_u16(vreinterpretq_u16_u8(m), 4);
+        const std::uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(n), 0);
+        if (bits != 0) {
+            return p + (__builtin_ctzll(bits) >> 2);
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == delim || *p == '"' || *p == '\n') {
+            return p;
+        }
+    }
+    return end;
+}
+
+namespace {
+
+// p: kayıt başı. Alanları row'a ekler, kayıttan sonraki konumu döner.
+const char* scanRecord(const char* p, const char* end, char delim, std::vector<CsvField>& row)
+{
+    for (;;) {
+        CsvField f;
+        if (p < end && *p == '"') {
+            // Tırnaklı alan: kapanış tırnağını ara ("" kaçışlarını geç)
+            const char* start = p + 1;
+            const char* q     = start;
+            for (;;) {
+                q = static_cast<const char*>(std::memchr(q, '"', static_cast<std::size_t>(end - q)));
+                if (!q) {
+                    q = end; // kapanmamış tırnak: tamponun sonuna kadar
+                    break;
+                }
+                if (q + 1 < end && q[1] == '"') {
+                    f.escaped = true;
+                    q += 2;
+                    continue;
+                }
+                break;
+            }
+            f.raw    = std::string_view(start, static_cast<std::size_t>(q - start));
+            f.quoted = true;
+            p        = (q < end) ? q + 1 : end;
+            // Kapanıştan sonra ayraç/satır sonuna kadar olan artık atılır
+            while (p < end && *p != delim && *p != '\n') {
+                ++p;
+            }
+        } else {
+            const char* q = CsvScanner::findSpecial(p, end, delim);
+            while (q < end && *q == '"') {
+                q = CsvScanner::findSpecial(q + 1, end, delim); // alan içi tırnak düz karakter
+            }
+            std::size_t len = static_cast<std::size_t>(q - p);
+            if (len > 0 && (q == end || *q == '\n') && p[len - 1] == '\r') {
+                --len; // CRLF
+            }
+            f.raw = std::string_view(p, len);
+            p     = q;
+        }
+        row.push_back(f);
+
+        if (p >= end) {
+            return end;
+        }
+        if (*p == '\n') {
+            return p + 1;
+        }
+        ++p; // ayraç
+    }
+}
+
+} // namespace
+
+bool CsvScanner::next(std::vector<CsvField>& row)
+{
+    row.clear();
+    if (pos_ >= buf_.size()) {
+        return false;
+    }
+    const char* begin = buf_.data();
+    const char* p     = scanRecord(begin + pos_, begin + buf_.size(), delim_, row);
+    pos_              = static_cast<std::size_t>(p - begin);
+    return true;
+}
+
+std::size_t CsvScanner::splitRow(std::string_view line, std::vector<CsvField>& row, char delim)
+{
+    row.clear();
+    scanRecord(line.data(), line.data() + line.size(), delim, row);
+    return row.size();
+}
+
+} // namespace recum12::utils
@@ -0,0 +1,656 @@
+#include "utils/InfraLog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace recum12::utils {
+
+namespace {
+
+const char* const kInfraHeader = "timeStamp,level,code,message,details\n";
+
+// Tek üretici (sahibi thread) / tek tüketici (sink) halkası
+struct Ring {
+    explicit Ring(std::size_t capacity) : slots(capacity), mask(capacity - 1) {}
+
+    std::vector<InfraRecord>   slots;
+    std::size_t                mask;
+    alignas(64) std::atomic<std::uint64_t> head{0};   // üretici yazar
+    alignas(64) std::atomic<std::uint64_t> tail{0};   // sink yazar
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<bool>          orphaned{false};       // sahibi thread bitti
+};
+
+// writeText kaydı: code/message/details serbest uzunlukta (kesilmez).
+// Sıcak yol değil (LogManager::appendInfra); kilitli kuyruktan geçer.
+struct TextRecord {
+    std::int64_t ts_ns{0};
+    InfraLevel   level{InfraLevel::Info};
+    std::string  code;
+    std::string  message;
+    std::string  details;
+};
+
+struct Sink {
+    std::mutex                         mtx;      // rings + texts + cv
+    std::condition_variable            cv;
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::vector<TextRecord>            texts;    // en çok cfg.ring_records
+    std::uint64_t                      textsDropped{0};
+    std::atomic<bool>                  running{false};
+    std::atomic<bool>                  wake{false};
+    std::atomic<std::uint64_t>         generation{0};
+    std::atomic<int>                   minLevel{static_cast<int>(InfraLevel::Info)};
+
+    std::mutex      lifeMtx;                    // start/stop
+    std::thread     thread;
+    InfraSinkConfig cfg;
+    std::string     path;
+    int             fd{-1};
+    std::uint64_t   size{0};
+
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> rotations{0};
+
+    ~Sink();
+};
+
+Sink& sink()
+{
+    static Sink s;
+    return s;
+}
+
+// Thread'in kendi halkası; thread bitince sink boşalttıktan sonra atar.
+struct LocalRing {
+    std::shared_ptr<Ring> ring;
+    std::uint64_t         generation{0};
+    bool                  direct{false};    // son claim sink'siz (scratch) mi
+    InfraRecord           scratch;
+
+    ~LocalRing()
+    {
+        if (ring) {
+            ring->orphaned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local LocalRing tlRing;
+
+std::size_t roundUpPow2(std::size_t n)
+{
+    std::size_t p = 16;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+bool needsQuote(std::string_view s)
+{
+    return s.find_first_of(",\"\r\n") != std::string_view::npos;
+}
+
+void appendCsv(std::string& out, std::string_view s)
+{
+    if (!needsQuote(s)) {
+        out.append(s.data(), s.size());
+        return;
+    }
+    out += '"';
+    for (char c : s) {
+        if (c == '"') {
+            out += '"';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+void appendArg(const InfraRecord& r, const InfraArg& a, std::string& out)
+{
+    char buf[32];
+    switch (a.kind) {
+    case InfraArg::I64:
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), a.v.i).ptr);
+        break;
+    case InfraArg::U64:
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), a.v.u).ptr);
+        break;
+    case InfraArg::Hex:
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), a.v.u, 16).ptr);
+        break;
+    case InfraArg::F64: {
+        const int n = std::snprintf(buf, sizeof(buf), "%g", a.v.d);
+        out.append(buf, n > 0 ? static_cast<std::size_t>(n) : 0);
+        break;
+    }
+    case InfraArg::Bool:
+        out += a.v.u ? "true" : "false";
+        break;
+    case InfraArg::Char:
+        out += static_cast<char>(a.v.u);
+        break;
+    case InfraArg::Fixed2: {
+        // x100 sabit nokta → "12.34"
+        const std::int64_t raw = a.v.i;
+        const std::uint64_t mag =
+            raw < 0 ? static_cast<std::uint64_t>(-(raw + 1)) + 1 : static_cast<std::uint64_t>(raw);
+        if (raw < 0) {
+            out += '-';
+        }
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), mag / 100).ptr);
+        out += '.';
+        out += static_cast<char>('0' + (mag % 100) / 10);
+        out += static_cast<char>('0' + mag % 10);
+        break;
+    }
+    case InfraArg::Str:
+        out += r.textOf(a);
+        break;
+    case InfraArg::Uid: {
+        const std::string_view raw = r.textOf(a);
+        char hex[2 * CardUid::kMaxLen];
+        const CardUid uid =
+            CardUid::fromBytes(reinterpret_cast<const std::uint8_t*>(raw.data()), raw.size());
+        out.append(hex, uid.toHex(hex));
+        break;
+    }
+    case InfraArg::None:
+        break;
+    }
+}
+
+// ts_ns → "2026-01-31T12:34:56.789Z" (saniye kısmı önbellekli)
+void appendTimeStamp(std::int64_t tsNs, std::string& out)
+{
+    static thread_local std::int64_t lastSec = -1;
+    static thread_local char         secBuf[24];
+    static thread_local std::size_t  secLen = 0;
+
+    const std::int64_t sec = tsNs / 1000000000;
+    const int          ms  = static_cast<int>((tsNs / 1000000) % 1000);
+    if (sec != lastSec) {
+        const std::time_t t = static_cast<std::time_t>(sec);
+        std::tm tm{};
+        gmtime_r(&t, &tm);
+        secLen  = std::strftime(secBuf, sizeof(secBuf), "%Y-%m-%dT%H:%M:%S", &tm);
+        lastSec = sec;
+    }
+    out.append(secBuf, secLen);
+    char msBuf[8];
+    std::snprintf(msBuf, sizeof(msBuf), ".%03dZ", ms);
+    out += msBuf;
+}
+
+std::string_view codeOf(const InfraRecord& r)
+{
+    return r.code ? std::string_view(r.code) : std::string_view();
+}
+
+// Konsol satırı: "[code] message (details)"
+void appendConsole(InfraLevel level, std::string_view code, std::string_view message,
+                   std::string_view details, std::string& out)
+{
+    out += '[';
+    out += code;
+    out += "] ";
+    if (level >= InfraLevel::Warn) {
+        out += InfraLog::levelName(level);
+        out += ": ";
+    }
+    out += message;
+    if (!details.empty()) {
+        out += " (";
+        out += details;
+        out += ')';
+    }
+    out += '\n';
+}
+
+bool writeAll(int fd, const std::string& data)
+{
+    const char* p   = data.data();
+    std::size_t len = data.size();
+    while (len > 0) {
+        const ssize_t n = ::write(fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p   += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// recumLogs.csv → recumLogs.<k>.csv
+std::string rotatedPath(const std::string& path, int k)
+{
+    const std::size_t slash = path.find_last_of('/');
+    const std::size_t dot   = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path + '.' + std::to_string(k);
+    }
+    return path.substr(0, dot) + '.' + std::to_string(k) + path.substr(dot);
+}
+
+bool openFile(Sink& s)
+{
+    s.fd = ::open(s.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (s.fd < 0) {
+        std::cerr << "[InfraLog] " << s.path << " açılamadı: " << std::strerror(errno)
+                  << std::endl;
+        return false;
+    }
+    struct stat st{};
+    s.size = (::fstat(s.fd, &st) == 0) ? static_cast<std::uint64_t>(st.st_size) : 0;
+    if (s.size == 0) {
+        const std::string header = kInfraHeader;
+        if (writeAll(s.fd, header)) {
+            s.size = header.size();
+        }
+    }
+    return true;
+}
+
+void rotate(Sink& s)
+{
+    ::close(s.fd);
+    s.fd = -1;
+    if (s.cfg.keep_files <= 0) {
+        std::remove(s.path.c_str());
+    } else {
+        std::remove(rotatedPath(s.path, s.cfg.keep_files).c_str());
+        for (int k = s.cfg.keep_files - 1; k >= 1; --k) {
+            std::rename(rotatedPath(s.path, k).c_str(), rotatedPath(s.path, k + 1).c_str());
+        }
+        std::rename(s.path.c_str(), rotatedPath(s.path, 1).c_str());
+    }
+    s.rotations.fetch_add(1, std::memory_order_relaxed);
+    openFile(s);
+}
+
+// Tüm halkaları bir kez boşaltır: zamana göre sıralar, biçimlendirir, yazar.
+void drain(Sink& s)
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(s.mtx);
+        rings = s.rings;
+    }
+
+    std::vector<const InfraRecord*>             batch;
+    std::vector<std::pair<Ring*, std::uint64_t>> ends;
+    std::vector<TextRecord>                      texts;
+    std::uint64_t                                dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(s.mtx);
+        texts.swap(s.texts);
+        dropped += s.textsDropped;
+        s.textsDropped = 0;
+    }
+    for (const auto& r : rings) {
+        const std::uint64_t t = r->tail.load(std::memory_order_relaxed);
+        const std::uint64_t h = r->head.load(std::memory_order_acquire);
+        for (std::uint64_t i = t; i != h; ++i) {
+            batch.push_back(&r->slots[i & r->mask]);
+        }
+        ends.emplace_back(r.get(), h);
+        dropped += r->dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    if (!batch.empty() || !texts.empty() || dropped > 0) {
+        std::stable_sort(batch.begin(), batch.end(),
+                         [](const InfraRecord* a, const InfraRecord* b) { return a->ts_ns < b->ts_ns; });
+        std::stable_sort(texts.begin(), texts.end(),
+                         [](const TextRecord& a, const TextRecord& b) { return a.ts_ns < b.ts_ns; });
+
+        std::string   csv;
+        std::string   out;
+        std::string   err;
+        std::string   message;
+        std::uint64_t pending = 0; // csv'deki satır
+        // csv'yi dosyaya yazar; max_bytes aşıldıysa döndürür (satır sınırında)
+        const auto flush = [&] {
+            if (s.fd >= 0 && !csv.empty() && writeAll(s.fd, csv)) {
+                s.size += csv.size();
+                s.written.fetch_add(pending, std::memory_order_relaxed);
+            }
+            csv.clear();
+            pending = 0;
+            if (s.fd >= 0 && s.size >= s.cfg.max_bytes) {
+                rotate(s);
+            }
+        };
+        const auto emitLine = [&](std::int64_t ts_ns, InfraLevel level, std::string_view code,
+                                  std::string_view msg, std::string_view details) {
+            appendTimeStamp(ts_ns, csv);
+            csv += ',';
+            csv += InfraLog::levelName(level);
+            csv += ',';
+            appendCsv(csv, code);
+            csv += ',';
+            appendCsv(csv, msg);
+            csv += ',';
+            appendCsv(csv, details);
+            csv += '\n';
+            ++pending;
+            if (s.cfg.console) {
+                appendConsole(level, code, msg, details, level >= InfraLevel::Warn ? err : out);
+            }
+            if (s.size + csv.size() >= s.cfg.max_bytes) {
+                flush();
+            }
+        };
+        const auto emit = [&](const InfraRecord& r) {
+            message.clear();
+            InfraLog::formatMessage(r, message);
+            emitLine(r.ts_ns, r.level, codeOf(r), message, {});
+        };
+        // Halka kayıtları ve metin kayıtları zaman sırasıyla birleştirilir
+        std::size_t ti = 0;
+        for (const InfraRecord* r : batch) {
+            for (; ti < texts.size() && texts[ti].ts_ns <= r->ts_ns; ++ti) {
+                emitLine(texts[ti].ts_ns, texts[ti].level, texts[ti].code, texts[ti].message,
+                         texts[ti].details);
+            }
+            emit(*r);
+        }
+        for (; ti < texts.size(); ++ti) {
+            emitLine(texts[ti].ts_ns, texts[ti].level, texts[ti].code, texts[ti].message,
+                     texts[ti].details);
+        }
+        if (dropped > 0) {
+            InfraRecord note;
+            note.begin(InfraLevel::Warn, "InfraLog", "{} kayıt düşürüldü (halka dolu)",
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count());
+            note.add(dropped);
+            emit(note);
+            s.dropped.fetch_add(dropped, std::memory_order_relaxed);
+        }
+
+        flush();
+        if (!out.empty()) {
+            std::cout << out << std::flush;
+        }
+        if (!err.empty()) {
+            std::cerr << err;
+        }
+    }
+
+    // Yuvalar biçimlendirildi → üreticilere geri ver
+    for (const auto& [r, h] : ends) {
+        r->tail.store(h, std::memory_order_release);
+    }
+
+    // Thread'i bitmiş ve boşalmış halkaları bırak
+    std::lock_guard<std::mutex> lock(s.mtx);
+    s.rings.erase(std::remove_if(s.rings.begin(), s.rings.end(),
+                                 [](const std::shared_ptr<Ring>& r) {
+                                     return r->orphaned.load(std::memory_order_acquire) &&
+                                            r->head.load(std::memory_order_acquire) ==
+                                                r->tail.load(std::memory_order_relaxed);
+                                 }),
+                  s.rings.end());
+}
+
+void stopSink(Sink& s)
+{
+    std::lock_guard<std::mutex> life(s.lifeMtx);
+    if (!s.thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(s.mtx);
+        s.running.store(false, std::memory_order_release);
+    }
+    s.cv.notify_all();
+    s.thread.join();
+    if (s.fd >= 0) {
+        ::fsync(s.fd);
+        ::close(s.fd);
+        s.fd = -1;
+    }
+}
+
+// stop() unutulduysa çıkışta kalanlar yine yazılsın
+Sink::~Sink()
+{
+    stopSink(*this);
+}
+
+void sinkLoop(Sink& s)
+{
+    while (s.running.load(std::memory_order_acquire)) {
+        {
+            std::unique_lock<std::mutex> lock(s.mtx);
+            s.cv.wait_for(lock, s.cfg.interval, [&] {
+                return s.wake.load(std::memory_order_relaxed) ||
+                       !s.running.load(std::memory_order_relaxed);
+            });
+        }
+        s.wake.store(false, std::memory_order_relaxed);
+        drain(s);
+    }
+    drain(s); // stop() öncesi yayınlananlar
+}
+
+} // namespace
+
+const char* InfraLog::levelName(InfraLevel level) noexcept
+{
+    switch (level) {
+    case InfraLevel::Debug: return "DEBUG";
+    case InfraLevel::Info:  return "INFO";
+    case InfraLevel::Warn:  return "WARN";
+    case InfraLevel::Error: return "ERROR";
+    }
+    return "INFO";
+}
+
+void InfraLog::setMinLevel(InfraLevel level) noexcept
+{
+    sink().minLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+bool InfraLog::passes(InfraLevel level) noexcept
+{
+    return static_cast<int>(level) >= sink().minLevel.load(std::memory_order_relaxed);
+}
+
+bool InfraLog::running() noexcept
+{
+    return sink().running.load(std::memory_order_acquire);
+}
+
+bool InfraLog::start(const std::string& csvPath, const InfraSinkConfig& cfg)
+{
+    Sink& s = sink();
+    std::lock_guard<std::mutex> life(s.lifeMtx);
+    if (s.running.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    s.cfg  = cfg;
+    s.cfg.ring_records = roundUpPow2(std::max<std::size_t>(cfg.ring_records, 16));
+    s.cfg.interval     = std::max(cfg.interval, std::chrono::milliseconds(1));
+    s.path = csvPath;
+    if (!openFile(s)) {
+        return false;
+    }
+    s.minLevel.store(static_cast<int>(cfg.min_level), std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(s.mtx);
+        s.rings.clear();
+        s.texts.clear();
+        s.textsDropped = 0;
+    }
+    // Önceki oturumun thread-yerel halkaları yeni kuşakta yeniden kaydolur
+    s.generation.fetch_add(1, std::memory_order_relaxed);
+    s.running.store(true, std::memory_order_release);
+    s.thread = std::thread(sinkLoop, std::ref(s));
+    return true;
+}
+
+void InfraLog::stop()
+{
+    stopSink(sink());
+}
+
+InfraLogStats InfraLog::stats()
+{
+    Sink& s = sink();
+    InfraLogStats st;
+    st.written   = s.written.load(std::memory_order_relaxed);
+    st.dropped   = s.dropped.load(std::memory_order_relaxed);
+    st.rotations = s.rotations.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(s.mtx);
+    st.threads = s.rings.size();
+    return st;
+}
+
+InfraRecord* InfraLog::claim() noexcept
+{
+    Sink& s = sink();
+    LocalRing& tl = tlRing;
+    if (!s.running.load(std::memory_order_acquire)) {
+        tl.direct = true;
+        return &tl.scratch;
+    }
+    tl.direct = false;
+
+    const std::uint64_t gen = s.generation.load(std::memory_order_relaxed);
+    if (!tl.ring || tl.generation != gen) {
+        // Thread'in ilk kaydı: halkayı bir kez kaydet (tek kilitli adım)
+        try {
+            auto ring = std::make_shared<Ring>(s.cfg.ring_records);
+            std::lock_guard<std::mutex> lock(s.mtx);
+            s.rings.push_back(ring);
+            if (tl.ring) {
+                tl.ring->orphaned.store(true, std::memory_order_release);
+            }
+            tl.ring       = std::move(ring);
+            tl.generation = gen;
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    Ring& r = *tl.ring;
+    const std::uint64_t h = r.head.load(std::memory_order_relaxed);
+    if (h - r.tail.load(std::memory_order_acquire) > r.mask) {
+        r.dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &r.slots[h & r.mask];
+}
+
+void InfraLog::publish() noexcept
+{
+    LocalRing& tl = tlRing;
+    if (tl.direct) {
+        // Sink yok: eski std::cout davranışı (senkron, yalnızca konsol)
+        try {
+            std::string message;
+            std::string line;
+            formatMessage(tl.scratch, message);
+            appendConsole(tl.scratch.level, codeOf(tl.scratch), message, {}, line);
+            (tl.scratch.level >= InfraLevel::Warn ? std::cerr : std::cout) << line << std::flush;
+        } catch (...) {
+        }
+        return;
+    }
+
+    Ring& r = *tl.ring;
+    const std::uint64_t h = r.head.load(std::memory_order_relaxed) + 1;
+    r.head.store(h, std::memory_order_release);
+
+    // Halka yarıdan fazla dolduysa sink'i periyodu beklemeden uyandır
+    Sink& s = sink();
+    if ((h - r.tail.load(std::memory_order_relaxed)) * 2 > r.mask + 1 &&
+        !s.wake.exchange(true, std::memory_order_relaxed)) {
+        s.cv.notify_one();
+    }
+}
+
+bool InfraLog::writeText(InfraLevel level, std::string_view code, std::string_view message,
+                         std::string_view details)
+{
+    if (!passes(level)) {
+        return false;
+    }
+    Sink& s = sink();
+    try {
+        if (!s.running.load(std::memory_order_acquire)) {
+            // Sink yok: senkron, yalnızca konsol
+            std::string line;
+            appendConsole(level, code, message, details, line);
+            (level >= InfraLevel::Warn ? std::cerr : std::cout) << line << std::flush;
+            return true;
+        }
+        TextRecord t{nowNs(), level, std::string(code), std::string(message), std::string(details)};
+        std::lock_guard<std::mutex> lock(s.mtx);
+        if (s.texts.size() >= s.cfg.ring_records) {
+            ++s.textsDropped;
+            return false;
+        }
+        s.texts.push_back(std::move(t));
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+void InfraLog::formatMessage(const InfraRecord& r, std::string& out)
+{
+    int next = 0;
+    const auto nextArg = [&]() -> const InfraArg* {
+        return next < r.nargs ? &r.args[next++] : nullptr;
+    };
+
+    const std::string_view fmt = r.fmt ? r.fmt : "";
+    std::size_t pos = 0;
+    while (pos < fmt.size()) {
+        const std::size_t ph = fmt.find("{}", pos);
+        if (ph == std::string_view::npos) {
+            out.append(fmt.data() + pos, fmt.size() - pos);
+            break;
+        }
+        out.append(fmt.data() + pos, ph - pos);
+        if (const InfraArg* a = nextArg()) {
+            appendArg(r, *a, out);
+        } else {
+            out += "{}";
+        }
+        pos = ph + 2;
+    }
+    // Şablonda yeri olmayan argümanlar sona
+    while (const InfraArg* a = nextArg()) {
+        out += ' ';
+        appendArg(r, *a, out);
+    }
+}
+
+} // namespace recum12::utils
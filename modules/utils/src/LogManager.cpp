@@ -1,12 +1,28 @@
 #include "utils/LogManager.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
 #include <cstdlib>   // std::getenv
+#include <cstring>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
+#include <optional>
 #include <sstream>
 #include <system_error>
+#include <thread>
+#include <unordered_map>
+
+#include "utils/CsvScanner.h"
+#include "utils/UsageSegmentLog.h"
+
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace {
 
@@ -61,47 +77,6 @@ std::string csvEscape(const std::string& value)
     return escaped;
 }
 
-// Basit CSV satırı parse edici.
-// - Çift tırnaklı alanları destekler
-// - "" içindeki çift tırnakları tek tırnak olarak yorumlar
-std::vector<std::string> parseCsvLine(const std::string& line)
-{
-    std::vector<std::string> cols;
-    std::string current;
-    current.reserve(line.size());
-
-    bool inQuotes = false;
-
-    for (std::size_t i = 0; i < line.size(); ++i) {
-        char c = line[i];
-        if (inQuotes) {
-            if (c == '"') {
-                // "" ise gerçek bir " karakteri
-                if (i + 1 < line.size() && line[i + 1] == '"') {
-                    current.push_back('"');
-                    ++i;
-                } else {
-                    inQuotes = false;
-                }
-            } else {
-                current.push_back(c);
-            }
-        } else {
-            if (c == '"') {
-                inQuotes = true;
-            } else if (c == ',') {
-                cols.push_back(current);
-                current.clear();
-            } else {
-                current.push_back(c);
-            }
-        }
-    }
-
-    cols.push_back(current);
-    return cols;
-}
-
 // Klasör mevcut değilse oluşturur
 bool ensureDir(const fs::path& p)
 {
@@ -133,6 +108,256 @@ bool ensureFileWithHeader(const fs::path& filePath, const std::string& headerLin
 
 namespace recum12::utils {
 
+namespace {
+
+const char* const kUsageHeader =
+    "processId,rfid,firstName,lastName,plate,limit,fuel,logCode,timeStamp,sendOk";
+
+// Eski düz usage log'u: yalnızca ilk açılıştaki göçün kaynağı
+fs::path usageCsvPath(const std::string& appRoot)
+{
+    return fs::path(appRoot) / "logs" / "log_user" / "logs.csv";
+}
+
+// exportUsageCsv varsayılan çıktısı (göç kaynağıyla karışmasın)
+fs::path usageExportPath(const std::string& appRoot)
+{
+    return fs::path(appRoot) / "logs" / "log_user" / "usage_export.csv";
+}
+
+fs::path usageLogDir(const std::string& appRoot)
+{
+    return fs::path(appRoot) / "logs" / "log_user" / "usage";
+}
+
+fs::path usageAckPath(const std::string& appRoot)
+{
+    return fs::path(appRoot) / "logs" / "log_user" / "logs.ack";
+}
+
+fs::path usageSeqPath(const std::string& appRoot)
+{
+    return fs::path(appRoot) / "logs" / "log_user" / "usage.seq";
+}
+
+// Satırın processId kolonu (ilk alan, tırnaksız sayı); yoksa 0.
+std::uint64_t leadingId(const std::string& line)
+{
+    std::uint64_t v = 0;
+    for (char c : line) {
+        if (c < '0' || c > '9') {
+            return (c == ',') ? v : 0;
+        }
+        v = v * 10 + static_cast<std::uint64_t>(c - '0');
+    }
+    return v;
+}
+
+// UsageEntry → tek CSV satırı ('\n' yok; segment çerçevesinin payload'ı)
+std::string formatUsagePayload(const LogManager::UsageEntry& e)
+{
+    std::ostringstream oss;
+    oss << e.processId << ','
+        << e.rfid << ','
+        << csvEscape(e.firstName) << ','
+        << csvEscape(e.lastName) << ','
+        << csvEscape(e.plate) << ','
+        << e.limit << ','
+        << e.fuel.toString() << ','
+        << csvEscape(e.logCode) << ','
+        << csvEscape(e.timeStamp) << ','
+        << csvEscape(e.sendOk);
+    return oss.str();
+}
+
+// Cache'teki satırın tahmini bellek maliyeti (SSO dışı string'ler heap'te)
+std::size_t usageEntryBytes(const LogManager::UsageEntry& e)
+{
+    const auto heap = [](const std::string& s) {
+        return s.capacity() > std::string().capacity() ? s.capacity() + 1 : 0;
+    };
+    return sizeof(e) + heap(e.firstName) + heap(e.lastName) + heap(e.plate) +
+           heap(e.logCode) + heap(e.timeStamp) + heap(e.sendOk);
+}
+
+// daysAgo gün önceki UTC gün: "YYYY-MM-DD"
+std::string isoDayUtc(int daysAgo)
+{
+    using clock = std::chrono::system_clock;
+    const auto t = clock::to_time_t(clock::now() - std::chrono::hours(24) * daysAgo);
+    std::tm tm{};
+    gmtime_r(&t, &tm);
+    char buf[16];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d", &tm);
+    return buf;
+}
+
+// Satır görüntüsü → UsageEntry (alanlar burada kopyalanır).
+LogManager::UsageEntry entryFromView(const UsageRowView& v)
+{
+    LogManager::UsageEntry e;
+    e.processId = v.processId;
+    e.rfid      = v.rfid();
+    e.firstName = v.text(UsageRowView::FirstName);
+    e.lastName  = v.text(UsageRowView::LastName);
+    e.plate     = v.text(UsageRowView::Plate);
+    e.limit     = v.limit();
+    e.fuel      = v.fuel();
+    e.logCode   = v.text(UsageRowView::LogCode);
+    e.timeStamp = v.text(UsageRowView::TimeStamp);
+    e.sendOk    = v.text(UsageRowView::SendOk);
+    return e;
+}
+
+// Satırın sendOk kolonunu değiştirir; değişmediyse false.
+bool setSendOk(std::string& line, const std::string& sendOk)
+{
+    std::vector<CsvField> cols;
+    const std::size_t n = CsvScanner::splitRow(line, cols);
+    if (n < 9 || (n >= 10 && cols[9].text() == sendOk)) {
+        return false;
+    }
+
+    std::string row;
+    row.reserve(line.size() + 4);
+    for (std::size_t c = 0; c < 9; ++c) {
+        row += csvEscape(cols[c].text());
+        row += ',';
+    }
+    row += csvEscape(sendOk);
+    line = std::move(row);
+    return true;
+}
+
+bool writeAllFd(int fd, const char* data, std::size_t len)
+{
+    while (len > 0) {
+        const ssize_t n = ::write(fd, data, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        len  -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// [0, n) işlerini en fazla workers thread'de üretir; consume(i, sonuç)
+// çağıran thread'de i sırasıyla çalışır. Tüketilmeyi bekleyen sonuç sayısı
+// window ile sınırlıdır. consume false dönerse kalan işler bırakılır.
+template <class Result, class Produce, class Consume>
+bool runOrdered(std::size_t n, unsigned workers, std::size_t window,
+                Produce produce, Consume consume)
+{
+    if (workers <= 1 || n <= 1) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!consume(i, produce(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    window = std::max<std::size_t>(window, workers);
+    std::mutex                          mtx;
+    std::condition_variable             cv;
+    std::vector<std::optional<Result>>  slots(n);
+    std::size_t                         claimed  = 0;
+    std::size_t                         consumed = 0;
+    bool                                stop     = false;
+
+    const auto work = [&] {
+        for (;;) {
+            std::size_t i = 0;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&] { return stop || claimed >= n || claimed < consumed + window; });
+                if (stop || claimed >= n) {
+                    return;
+                }
+                i = claimed++;
+            }
+            Result r = produce(i);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                slots[i] = std::move(r);
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    const std::size_t threads = std::min<std::size_t>(workers, n);
+    for (std::size_t t = 0; t < threads; ++t) {
+        pool.emplace_back(work);
+    }
+
+    bool ok = true;
+    for (std::size_t i = 0; i < n && ok; ++i) {
+        Result r;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return slots[i].has_value(); });
+            r = std::move(*slots[i]);
+            slots[i].reset();
+        }
+        ok = consume(i, std::move(r));
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            consumed = i + 1;
+            stop     = !ok;
+        }
+        cv.notify_all();
+    }
+
+    for (auto& t : pool) {
+        t.join();
+    }
+    return ok;
+}
+
+// Paralel okumada tek parçanın (segment) çıktısı
+template <class T>
+struct PartResult {
+    T                  value{};
+    UsageCursor::Stats stats;
+};
+
+void addStats(UsageCursor::Stats& total, const UsageCursor::Stats& s)
+{
+    total.segments += s.segments;
+    total.scanned  += s.scanned;
+    total.matched  += s.matched;
+    total.bytes    += s.bytes;
+}
+
+// "[LogManager] <what>: N satır, X MB, W worker, T ms (Y MB/s)"
+void reportThroughput(const char* what, const UsageCursor::Stats& st, unsigned workers,
+                      std::chrono::steady_clock::duration took)
+{
+    // Ondalık tek hane (InfraLog double'ı %g yazar)
+    const auto   r1 = [](double v) { return std::round(v * 10.0) / 10.0; };
+    const double ms = std::chrono::duration<double, std::milli>(took).count();
+    const double mb = static_cast<double>(st.bytes) / (1024.0 * 1024.0);
+    RECUM_LOG_INFO("LogManager", "{}: {} satır, {} MB, {} segment, {} worker, {} ms ({} MB/s)",
+                   what, st.matched, r1(mb), st.segments, workers, r1(ms),
+                   r1(ms > 0 ? mb * 1000.0 / ms : 0.0));
+}
+
+} // namespace
+
+LogManager::LogManager() = default;
+
+LogManager::~LogManager()
+{
+    closeUsageWriter();
+    stopUsageMaintenance();
+    stopInfraLog();
+}
+
 // ---------------------------------------------------------------------
 // 1) Common appRoot & scaffold
 // ---------------------------------------------------------------------
@@ -174,6 +399,11 @@ std::string LogManager::detectAppRoot()
     return current.string();
 }
 
+std::string LogManager::nowTimeStamp()
+{
+    return isoNowUtc();
+}
+
 bool LogManager::ensureScaffold(const std::string& appRoot)
 {
     try {
@@ -181,6 +411,7 @@ bool LogManager::ensureScaffold(const std::string& appRoot)
 
         fs::path logsDir     = root / "logs";
         fs::path logsUserDir = logsDir / "log_user";
+        fs::path flowDir     = logsDir / "flow";
         fs::path configsDir  = root / "configs";
 
         if (!ensureDir(logsDir)) {
@@ -189,6 +420,9 @@ bool LogManager::ensureScaffold(const std::string& appRoot)
         if (!ensureDir(logsUserDir)) {
             return false;
         }
+        if (!ensureDir(flowDir)) {
+            return false;
+        }
         if (!ensureDir(configsDir)) {
             return false;
         }
@@ -200,14 +434,6 @@ bool LogManager::ensureScaffold(const std::string& appRoot)
             return false;
         }
 
-        // usage log dosyası (pompa user transaction log'u)
-        const fs::path usageCsv = logsUserDir / "logs.csv";
-        const std::string usageHeader =
-            "processId,rfid,firstName,lastName,plate,limit,fuel,logCode,timeStamp,sendOk";
-        if (!ensureFileWithHeader(usageCsv, usageHeader)) {
-            return false;
-        }
-
         return true;
     } catch (...) {
         return false;
@@ -215,253 +441,718 @@ bool LogManager::ensureScaffold(const std::string& appRoot)
 }
 
 // ---------------------------------------------------------------------
-// 2) Usage logs: <appRoot>/configs/logs.csv
+// 2) Usage logs: <appRoot>/logs/log_user/usage/ (çerçeveli segmentler)
 // ---------------------------------------------------------------------
 
-void LogManager::setOnUsageAppended(UsageAppendCb cb)
-{
-    std::lock_guard<std::mutex> lock(usageMtx_);
-    onUsageAppended_ = std::move(cb);
-}
-
-bool LogManager::appendUsage(const std::string& appRoot, const UsageEntry& e)
+bool LogManager::openUsageLog(const std::string& appRoot) const
 {
+    // appendMtx_ çağıran tarafından tutuluyor.
+    const std::string dir = usageLogDir(appRoot).string();
+    if (usageLog_.isOpen()) {
+        if (usageLog_.dir() == dir) {
+            return true;
+        }
+        if (usageWriter_) {
+            // Yazıcının wal.log'u başka bir kökte; karışmasın
+            RECUM_LOG_ERROR("LogManager", "usage log başka bir appRoot için açık: {}", usageLog_.dir());
+            return false;
+        }
+        usageLog_.close();
+    }
+    // Manifest için kaydın processId'si ve zaman damgası (9. kolon)
+    const auto info = [](const std::string& payload, std::uint64_t& id, std::string& ts) {
+        id = leadingId(payload);
+        std::vector<CsvField> cols;
+        if (CsvScanner::splitRow(payload, cols) >= 9) {
+            ts = cols[8].text();
+        }
+    };
     if (!ensureScaffold(appRoot)) {
         return false;
     }
-
-    UsageEntry entry = e; // lokal kopya: timestamp ve sendOk normalize edeceğiz
-    if (entry.timeStamp.empty()) {
-        entry.timeStamp = isoNowUtc();
-    }
-    if (entry.sendOk.empty()) {
-        entry.sendOk = "NA";
+    if (!usageLog_.open(dir, info)) {
+        if (usageLog_.busy()) {
+            RECUM_LOG_ERROR("LogManager", "usage store başka bir süreçte açık (uygulama çalışıyor mu?): {}", dir);
+        }
+        return false;
     }
 
-    fs::path filePath = fs::path(appRoot) / "logs" / "log_user" / "logs.csv";
+    const auto rec = usageLog_.recovery();
+    RECUM_LOG_INFO("LogManager", "usage wal recovery: records={} truncated_bytes={}{} segments={} rescanned={}",
+                   rec.wal_records, rec.truncated_bytes, rec.wal_recreated ? " (yeni wal)" : "",
+                   rec.segments, rec.rescanned);
 
-    std::ofstream ofs(filePath, std::ios::app);
-    if (!ofs.is_open()) {
-        return false;
+    if (!usageLog_.empty()) {
+        return true;
     }
 
-    ofs
-        << entry.processId << ','
-        << csvEscape(entry.rfid) << ','
-        << csvEscape(entry.firstName) << ','
-        << csvEscape(entry.lastName) << ','
-        << csvEscape(entry.plate) << ','
-        << entry.limit << ','
-        << entry.fuel << ','
-        << csvEscape(entry.logCode) << ','
-        << csvEscape(entry.timeStamp) << ','
-        << csvEscape(entry.sendOk)
-        << '\n';
+    // İlk açılış: eski düz logs.csv satırlarını bir kez segmentlere taşı
+    std::ifstream ifs(usageCsvPath(appRoot));
+    std::string line;
+    if (!ifs.is_open() || !std::getline(ifs, line)) {
+        return true;
+    }
+    std::vector<std::string> rows;
+    while (std::getline(ifs, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            rows.push_back(line);
+        }
+    }
+    if (!rows.empty()) {
+        if (!usageLog_.importInitial(rows)) {
+            RECUM_LOG_ERROR("LogManager", "logs.csv göçü başarısız");
+            return false;
+        }
+        RECUM_LOG_INFO("LogManager", "logs.csv → usage segmentleri: {} satır taşındı", rows.size());
+    }
+
+    // Göç bitti: kaynak emekli edilir, store boşalsa da yeniden alınmaz
+    ifs.close();
+    const fs::path migrated = usageCsvPath(appRoot).string() + ".migrated";
+    std::error_code ec;
+    fs::rename(usageCsvPath(appRoot), migrated, ec);
+    if (ec) {
+        RECUM_LOG_WARN("LogManager", "logs.csv → {} taşınamadı: {}", migrated.string(), ec.message());
+    }
+    return true;
+}
 
-    if (!ofs) {
+bool LogManager::sealUsageLocked()
+{
+    // appendMtx_ çağıran tarafından tutuluyor.
+    std::unique_lock<std::mutex> fileLock;
+    if (usageWriter_) {
+        usageWriter_->flush();
+        fileLock = usageWriter_->lockFile();
+    }
+    if (!usageLog_.seal()) {
         return false;
     }
+    return !usageWriter_ || usageWriter_->reopenLocked();
+}
 
-    UsageAppendCb cbCopy;
+bool LogManager::openUsageWriter(const std::string& appRoot, const UsageWriterConfig& cfg)
+{
+    closeUsageWriter();
     {
-        std::lock_guard<std::mutex> lock(usageMtx_);
-        usageRows_.push_back(entry);
-        cbCopy = onUsageAppended_;
+        std::lock_guard<std::mutex> lock(appendMtx_);
+        if (!openUsageLog(appRoot)) {
+            return false;
+        }
     }
 
-    if (cbCopy) {
-        cbCopy(entry);
+    // Önceki çalışmadan kalan onayları yazıcı açılmadan işle
+    if (!compactUsageAcks(appRoot)) {
+        RECUM_LOG_WARN("LogManager", "logs.ack compaction failed");
     }
 
+    std::lock_guard<std::mutex> lock(appendMtx_);
+    auto w = std::make_shared<UsageLogWriter>();
+    if (!w->open(usageLog_.walPath(), std::string{}, cfg)) {
+        return false;
+    }
+    usageWriter_     = std::move(w);
+    usageWriterRoot_ = appRoot;
     return true;
 }
 
-bool LogManager::loadUsage(const std::string& appRoot,
-                           std::vector<UsageEntry>& out) const
+void LogManager::closeUsageWriter()
 {
-    fs::path filePath = fs::path(appRoot) / "logs" / "log_user" / "logs.csv";
-    std::ifstream ifs(filePath);
-    if (!ifs.is_open()) {
-        return false;
+    std::lock_guard<std::mutex> lock(appendMtx_);
+    if (usageWriter_) {
+        usageWriter_->close();
+        usageWriter_.reset();
+        usageWriterRoot_.clear();
     }
+}
 
-    std::string line;
-
-    // İlk satır header, atla
-    if (!std::getline(ifs, line)) {
+bool LogManager::startUsageMaintenance(const std::string& appRoot,
+                                       const UsageSegmentLog::MaintenancePolicy& policy)
+{
+    std::lock_guard<std::mutex> lock(appendMtx_);
+    if (!openUsageLog(appRoot)) {
         return false;
     }
+    return usageLog_.startMaintenance(policy);
+}
 
-    std::vector<UsageEntry> loaded;
+void LogManager::stopUsageMaintenance()
+{
+    usageLog_.stopMaintenance();
+}
 
-    while (std::getline(ifs, line)) {
-        if (line.empty()) {
-            continue;
+std::shared_ptr<UsageLogWriter> LogManager::usageWriter() const
+{
+    std::lock_guard<std::mutex> lock(appendMtx_);
+    return usageWriter_;
+}
+
+bool LogManager::flushUsage()
+{
+    const auto w = usageWriter();
+    return w ? w->flush() : true;
+}
+
+UsageWriterStats LogManager::usageWriterStats() const
+{
+    const auto w = usageWriter();
+    return w ? w->stats() : UsageWriterStats{};
+}
+
+void LogManager::setOnUsageAppended(UsageAppendCb cb)
+{
+    std::lock_guard<std::mutex> lock(usageMtx_);
+    onUsageAppended_ = std::move(cb);
+}
+
+void LogManager::setUsageCacheWindow(const UsageCacheWindow& window)
+{
+    std::lock_guard<std::mutex> lock(usageMtx_);
+    usageWindow_ = window;
+    trimUsageCacheLocked();
+}
+
+LogManager::UsageCacheStats LogManager::usageCacheStats() const
+{
+    std::lock_guard<std::mutex> lock(usageMtx_);
+    UsageCacheStats st;
+    st.rows  = usageRows_.size();
+    st.bytes = usageCacheBytes_;
+    st.older = usageOlder_;
+    return st;
+}
+
+std::vector<LogManager::UsageEntry> LogManager::recentUsage() const
+{
+    std::lock_guard<std::mutex> lock(usageMtx_);
+    return std::vector<UsageEntry>(usageRows_.begin(), usageRows_.end());
+}
+
+void LogManager::foldUsageLocked(const UsageEntry& e) const
+{
+    UsageSummary& o = usageOlder_;
+    ++o.rows;
+    if (e.logCode == "PumpOff_PC") {
+        ++o.sales;
+    }
+    o.fuel += e.fuel;
+    if (UsageSegmentLog::isIsoTimeStamp(e.timeStamp)) {
+        if (o.firstTs.empty() || e.timeStamp < o.firstTs) {
+            o.firstTs = e.timeStamp;
+        }
+        if (e.timeStamp > o.lastTs) {
+            o.lastTs = e.timeStamp;
         }
+    }
+}
 
-        auto cols = parseCsvLine(line);
-        if (cols.size() < 9) {
-            // Beklenmeyen satır; şimdilik atla
-            continue;
+void LogManager::trimUsageCacheLocked() const
+{
+    // Satırlar kabaca zaman sıralı: baştan (en eski) kırpmak yeterli
+    const std::string cutoff =
+        usageWindow_.max_days > 0 ? isoDayUtc(usageWindow_.max_days - 1) : std::string();
+    while (!usageRows_.empty()) {
+        const UsageEntry& front = usageRows_.front();
+        const bool tooOld = !cutoff.empty() &&
+                            (!UsageSegmentLog::isIsoTimeStamp(front.timeStamp) ||
+                             front.timeStamp < cutoff);
+        if (usageRows_.size() <= usageWindow_.max_rows && !tooOld) {
+            break;
         }
+        foldUsageLocked(front);
+        usageCacheBytes_ -= usageEntryBytes(front);
+        usageRows_.pop_front();
+    }
+}
 
-        // 9 kolonlu eski format: sendOk yok → "NA"
-        // 10 kolonlu yeni format: sendOk 9. indeks
-        const bool hasSendOk = (cols.size() >= 10);
+bool LogManager::appendUsage(const std::string& appRoot, const UsageEntry& e, bool sale_end)
+{
+    UsageEntry entry = e; // lokal kopya: timestamp ve sendOk normalize edeceğiz
+    if (entry.timeStamp.empty()) {
+        entry.timeStamp = isoNowUtc();
+    }
+    if (entry.sendOk.empty()) {
+        entry.sendOk = "NA";
+    }
 
-        UsageEntry e;
-        try {
-            e.processId = std::stoi(cols[0]);
-        } catch (...) {
-            e.processId = 0;
+    UsageAppendCb cbCopy;
+    bool          durable = true;
+    {
+        std::lock_guard<std::mutex> lock(appendMtx_);
+        if (!openUsageLog(appRoot)) {
+            return false;
+        }
+        if (entry.processId == 0) {
+            entry.processId = allocateUsageIdLocked(appRoot);
+            if (entry.processId == 0) {
+                return false;
+            }
         }
 
-        e.rfid       = (cols.size() > 1) ? cols[1] : std::string{};
-        e.firstName  = (cols.size() > 2) ? cols[2] : std::string{};
-        e.lastName   = (cols.size() > 3) ? cols[3] : std::string{};
-        e.plate      = (cols.size() > 4) ? cols[4] : std::string{};
+        // Gün değiştiyse ya da wal.log büyüdüyse önce mühürle: segmentler
+        // günlük kalır, açılış recovery'si yalnızca kuyruğu tarar
+        if (usageLog_.needsRotation(entry.timeStamp) && !sealUsageLocked()) {
+            RECUM_LOG_WARN("LogManager", "usage wal mühürlenemedi");
+        }
 
-        try {
-            e.limit = (cols.size() > 5) ? std::stoi(cols[5]) : 0;
-        } catch (...) {
-            e.limit = 0;
+        std::string frame;
+        UsageSegmentLog::appendFrame(frame, formatUsagePayload(entry));
+        if (usageWriter_ && appRoot == usageWriterRoot_) {
+            // Asenkron yol: çerçeve kuyruğa, write + fdatasync yazıcı thread'inde
+            if (!usageWriter_->enqueue(frame, sale_end)) {
+                return false;
+            }
+            usageLog_.noteAppend(frame.size(), entry.processId, entry.timeStamp);
+            // OnSaleEnd: kapanış satırı zaten sync noktası; sonucunu bekle ki
+            // write/fdatasync hatası çağırana dönsün
+            if (sale_end && usageWriter_->config().durability == UsageDurability::OnSaleEnd) {
+                durable = usageWriter_->flush();
+            }
+        } else if (!usageLog_.append(frame, entry.processId, entry.timeStamp)) {
+            return false;
         }
 
-        try {
-            e.fuel = (cols.size() > 6) ? std::stod(cols[6]) : 0.0;
-        } catch (...) {
-            e.fuel = 0.0;
+        std::lock_guard<std::mutex> ulock(usageMtx_);
+        usageRows_.push_back(entry);
+        usageCacheBytes_ += usageEntryBytes(usageRows_.back());
+        trimUsageCacheLocked();
+        cbCopy = onUsageAppended_;
+    }
+
+    if (cbCopy) {
+        cbCopy(entry);
+    }
+
+    return durable;
+}
+
+bool LogManager::openUsageSeq(const std::string& appRoot)
+{
+    const std::string path = usageSeqPath(appRoot).string();
+    if (usageSeq_.isOpen()) {
+        if (usageSeq_.path() == path) {
+            return true;
         }
+        usageSeq_.close();
+    }
+    // Sayaç dosyası kaybolmuş/bozulmuşsa id'ler store'daki en büyük id'nin
+    // üstünden verilir (manifest + wal; usage log açık)
+    return ensureScaffold(appRoot) && usageSeq_.open(path, 64, usageLog_.maxId());
+}
+
+std::uint64_t LogManager::allocateUsageId(const std::string& appRoot)
+{
+    std::lock_guard<std::mutex> lock(appendMtx_);
+    if (!openUsageLog(appRoot)) {
+        return 0;
+    }
+    return allocateUsageIdLocked(appRoot);
+}
+
+std::uint64_t LogManager::allocateUsageIdLocked(const std::string& appRoot)
+{
+    // appendMtx_ çağıran tarafından tutuluyor.
+    std::lock_guard<std::mutex> lock(seqMtx_);
+    return openUsageSeq(appRoot) ? usageSeq_.next() : 0;
+}
 
-        e.logCode   = (cols.size() > 7) ? cols[7] : std::string{};
-        e.timeStamp = (cols.size() > 8) ? cols[8] : std::string{};
-        e.sendOk    = hasSendOk ? cols[9] : std::string{"NA"};
+void LogManager::setUsageLoadWorkers(unsigned workers)
+{
+    usageLoadWorkers_.store(std::max(1u, workers), std::memory_order_relaxed);
+}
 
-        loaded.push_back(std::move(e));
+bool LogManager::loadUsage(const std::string& appRoot,
+                           std::vector<UsageEntry>& out) const
+{
+    const auto              t0 = std::chrono::steady_clock::now();
+    std::vector<UsageEntry> loaded;
+    UsageCursor::Stats      st;
+    if (!readUsage(appRoot, UsageFilter{}, loaded, &st)) {
+        return false;
     }
+    reportThroughput("usage yükleme", st, usageLoadWorkers_.load(std::memory_order_relaxed),
+                     std::chrono::steady_clock::now() - t0);
 
     {
+        // Pencereye sığmayacak baş kısım kopyalanmadan doğrudan özete katlanır
         std::lock_guard<std::mutex> lock(usageMtx_);
-        usageRows_ = loaded;
+        usageRows_.clear();
+        usageOlder_      = UsageSummary{};
+        usageCacheBytes_ = 0;
+        const std::size_t first =
+            loaded.size() - std::min(loaded.size(), usageWindow_.max_rows);
+        for (std::size_t i = 0; i < loaded.size(); ++i) {
+            if (i < first) {
+                foldUsageLocked(loaded[i]);
+                continue;
+            }
+            usageRows_.push_back(loaded[i]);
+            usageCacheBytes_ += usageEntryBytes(usageRows_.back());
+        }
+        trimUsageCacheLocked();
     }
 
-    out = loaded;
+    out = std::move(loaded);
     return true;
 }
 
-bool LogManager::updateUsageSendOk(const std::string& appRoot,
-                                   int processId,
-                                   const std::string& timeStamp,
-                                   const std::string& sendOk)
+bool LogManager::loadUsageRange(const std::string& appRoot,
+                                const std::string& fromTs,
+                                const std::string& toTs,
+                                std::vector<UsageEntry>& out) const
+{
+    UsageFilter filter;
+    filter.fromTs = fromTs;
+    filter.toTs   = toTs;
+    out.clear();
+    return readUsage(appRoot, filter, out);
+}
+
+bool LogManager::snapshotUsage(const std::string& appRoot, const UsageFilter& filter,
+                               UsageSegmentLog::Snapshot& snap,
+                               std::shared_ptr<const UsageCursor::AckMap>& acks) const
 {
-    fs::path filePath = fs::path(appRoot) / "logs" / "log_user" / "logs.csv";
+    // Kuyrukta bekleyen satırlar da okunacak dosyada olsun
+    if (const auto w = usageWriter()) {
+        w->flush();
+    }
+
+    // Journal segmentlerden önce okunur: arada compaction olursa onaylar
+    // zaten yeniden yazılmış segmentte olur (tersi sırada kaybolabilirdi).
+    UsageCursor::AckMap journal;
+    UsageAckJournal::readAll(usageAckPath(appRoot).string(), journal);
+    acks = std::make_shared<const UsageCursor::AckMap>(std::move(journal));
 
-    std::ifstream ifs(filePath);
-    if (!ifs.is_open()) {
+    std::lock_guard<std::mutex> alock(appendMtx_);
+    if (!openUsageLog(appRoot)) {
         return false;
     }
+    snap = usageLog_.snapshot(filter.fromTs, filter.toTs);
+    return true;
+}
 
-    std::vector<std::string> lines;
-    std::string line;
-    while (std::getline(ifs, line)) {
-        lines.push_back(line);
+UsageCursor LogManager::openUsageCursor(const std::string& appRoot,
+                                        const UsageFilter& filter) const
+{
+    UsageSegmentLog::Snapshot                  snap;
+    std::shared_ptr<const UsageCursor::AckMap> acks;
+    if (!snapshotUsage(appRoot, filter, snap, acks)) {
+        return UsageCursor{};
     }
+    return UsageCursor(std::move(snap), filter, std::move(acks));
+}
 
-    if (lines.empty()) {
+bool LogManager::readUsage(const std::string& appRoot,
+                           const UsageFilter& filter,
+                           std::vector<UsageEntry>& out,
+                           UsageCursor::Stats* stats) const
+{
+    UsageSegmentLog::Snapshot                  snap;
+    std::shared_ptr<const UsageCursor::AckMap> acks;
+    if (!snapshotUsage(appRoot, filter, snap, acks)) {
         return false;
     }
 
+    // Her segment (çerçeve sınırlı, ≤ kSegmentBytes) ayrı bir iş: worker'lar
+    // kendi cursor'ıyla çözer, sonuçlar segment sırasıyla birleştirilir
+    using Rows = PartResult<std::vector<UsageEntry>>;
+    UsageCursor::Stats total;
+    total.skipped = snap.skipped;
+    runOrdered<Rows>(
+        snap.parts.size(), usageLoadWorkers_.load(std::memory_order_relaxed), snap.parts.size(),
+        [&](std::size_t i) {
+            UsageSegmentLog::Snapshot one;
+            one.parts.push_back(snap.parts[i]);
+            UsageCursor  cur(std::move(one), filter, acks);
+            UsageRowView row;
+            Rows         r;
+            while (cur.next(row)) {
+                r.value.push_back(entryFromView(row));
+            }
+            r.stats = cur.stats();
+            return r;
+        },
+        [&](std::size_t, Rows&& r) {
+            if (out.empty()) {
+                out = std::move(r.value);
+            } else {
+                out.insert(out.end(), std::make_move_iterator(r.value.begin()),
+                           std::make_move_iterator(r.value.end()));
+            }
+            addStats(total, r.stats);
+            return true;
+        });
+
+    if (stats) {
+        *stats = total;
+    }
+    return true;
+}
+
+bool LogManager::exportUsageCsv(const std::string& appRoot, const std::string& outPath) const
+{
+    const fs::path    path = outPath.empty() ? usageExportPath(appRoot) : fs::path(outPath);
+    const std::string tmp  = path.string() + ".tmp";
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    const auto                                 t0 = std::chrono::steady_clock::now();
+    UsageSegmentLog::Snapshot                  snap;
+    std::shared_ptr<const UsageCursor::AckMap> acks;
+    if (!snapshotUsage(appRoot, UsageFilter{}, snap, acks)) {
+        ::close(fd);
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    // Segmentler worker'larda CSV'ye çevrilir, bu thread sırayla yazar.
+    // Bekleyen çıktı 2 × worker segmentle sınırlı: bellek kullanımı kayıt
+    // sayısından bağımsız.
+    const std::string header  = std::string(kUsageHeader) + '\n';
+    const unsigned    workers = usageLoadWorkers_.load(std::memory_order_relaxed);
+    using Chunk = PartResult<std::string>;
+    UsageCursor::Stats total;
+    bool ok = writeAllFd(fd, header.data(), header.size()) &&
+              runOrdered<Chunk>(
+                  snap.parts.size(), workers, 2 * static_cast<std::size_t>(workers),
+                  [&](std::size_t i) {
+                      UsageSegmentLog::Snapshot one;
+                      one.parts.push_back(snap.parts[i]);
+                      UsageCursor  cur(std::move(one), UsageFilter{}, acks);
+                      UsageRowView row;
+                      Chunk        c;
+                      while (cur.next(row)) {
+                          if (!row.acked) {
+                              c.value.append(row.payload.data(), row.payload.size());
+                          } else {
+                              // Onaylı satır: sendOk kolonu journal'daki değerle
+                              for (std::size_t col = 0; col < UsageRowView::SendOk; ++col) {
+                                  c.value += csvEscape(row.text(static_cast<UsageRowView::Col>(col)));
+                                  c.value += ',';
+                              }
+                              c.value += csvEscape(row.text(UsageRowView::SendOk));
+                          }
+                          c.value += '\n';
+                      }
+                      c.stats = cur.stats();
+                      return c;
+                  },
+                  [&](std::size_t, Chunk&& c) {
+                      addStats(total, c.stats);
+                      return writeAllFd(fd, c.value.data(), c.value.size());
+                  });
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+    const std::size_t rows = total.matched;
+
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    RECUM_LOG_INFO("LogManager", "usage CSV export: {} ({} satır)", path.string(), rows);
+    reportThroughput("usage export", total, workers, std::chrono::steady_clock::now() - t0);
+    return true;
+}
+
+bool LogManager::openAckJournal(const std::string& appRoot)
+{
+    // ackMtx_ çağıran tarafından tutuluyor.
+    const std::string path = usageAckPath(appRoot).string();
+    if (ackJournal_.isOpen()) {
+        if (ackJournal_.path() == path) {
+            return true;
+        }
+        ackJournal_.close();
+    }
+    return ensureScaffold(appRoot) && ackJournal_.open(path);
+}
+
+bool LogManager::ackUsage(const std::string& appRoot,
+                          std::uint64_t processId,
+                          const std::string& sendOk)
+{
+    if (processId == 0) {
+        return false;
+    }
     const std::string normalizedSendOk = sendOk.empty() ? "NA" : sendOk;
 
-    bool headerUpdated = false;
-    bool anyRowUpdated = false;
+    std::lock_guard<std::mutex> lock(ackMtx_);
+    if (!openAckJournal(appRoot) || !ackJournal_.append(processId, normalizedSendOk)) {
+        return false;
+    }
 
-    // Header
+    // Bellek cache'ini de güncelle (onaylar genelde son satırlar için → sondan)
     {
-        auto headerCols = parseCsvLine(lines[0]);
-        if (headerCols.size() == 9) {
-            headerCols.push_back("sendOk");
-
-            std::ostringstream oss;
-            for (std::size_t i = 0; i < headerCols.size(); ++i) {
-                if (i > 0) {
-                    oss << ',';
-                }
-                oss << csvEscape(headerCols[i]);
-            }
-            lines[0] = oss.str();
-            headerUpdated = true;
+        std::lock_guard<std::mutex> ulock(usageMtx_);
+        const auto it = std::find_if(
+            usageRows_.rbegin(), usageRows_.rend(),
+            [processId](const UsageEntry& e) { return e.processId == processId; });
+        if (it != usageRows_.rend()) {
+            usageCacheBytes_ -= usageEntryBytes(*it);
+            it->sendOk = normalizedSendOk;
+            usageCacheBytes_ += usageEntryBytes(*it);
         }
     }
 
-    // Data satırları
-    for (std::size_t i = 1; i < lines.size(); ++i) {
-        if (lines[i].empty()) {
-            continue;
-        }
+    // Journal'ı arada bir segmentlere işle (onay başına amortize O(1))
+    if (ackJournal_.records() >= kAckCompactThreshold && !compactAcksLocked(appRoot)) {
+        RECUM_LOG_WARN("LogManager", "logs.ack compaction failed");
+    }
+    return true;
+}
 
-        auto cols = parseCsvLine(lines[i]);
-        if (cols.size() < 9) {
-            continue;
-        }
+bool LogManager::updateUsageSendOk(const std::string& appRoot,
+                                   std::uint64_t processId,
+                                   const std::string& /*timeStamp*/,
+                                   const std::string& sendOk)
+{
+    return ackUsage(appRoot, processId, sendOk);
+}
 
-        int rowProcId = 0;
-        try {
-            rowProcId = std::stoi(cols[0]);
-        } catch (...) {
-            rowProcId = 0;
-        }
+bool LogManager::compactUsageAcks(const std::string& appRoot)
+{
+    std::lock_guard<std::mutex> lock(ackMtx_);
+    return compactAcksLocked(appRoot);
+}
 
-        const std::string rowTs = (cols.size() > 8) ? cols[8] : std::string{};
+std::size_t LogManager::usageAckBacklog() const
+{
+    return ackJournal_.records();
+}
 
-        if (rowProcId == processId && rowTs == timeStamp) {
-            if (cols.size() == 9) {
-                cols.push_back(normalizedSendOk);
-            } else if (cols.size() >= 10) {
-                cols[9] = normalizedSendOk;
-            }
+bool LogManager::compactAcksLocked(const std::string& appRoot)
+{
+    // ackMtx_ çağıran tarafından tutuluyor.
+    if (!openAckJournal(appRoot)) {
+        return false;
+    }
+    std::unordered_map<std::uint64_t, std::string> acks;
+    if (!UsageAckJournal::readAll(ackJournal_.path(), acks)) {
+        return false;
+    }
+    if (acks.empty()) {
+        return true;
+    }
 
-            std::ostringstream oss;
-            for (std::size_t c = 0; c < cols.size(); ++c) {
-                if (c > 0) {
-                    oss << ',';
-                }
-                oss << csvEscape(cols[c]);
-            }
-            lines[i] = oss.str();
-            anyRowUpdated = true;
-        }
+    // Yeniden yazım boyunca segmentlere kayıt eklenmesin
+    std::lock_guard<std::mutex> alock(appendMtx_);
+    if (!openUsageLog(appRoot)) {
+        return false;
+    }
+    std::unique_lock<std::mutex> fileLock;
+    if (usageWriter_) {
+        usageWriter_->flush();
+        fileLock = usageWriter_->lockFile();
     }
 
-    if (!anyRowUpdated && !headerUpdated) {
+    // Yalnızca onaylı kaydı olan segmentler tmp + rename ile yeniden yazılır;
+    // id aralığı hiçbir onayı kapsamayan segment (manifest) açılmaz bile
+    std::vector<std::uint64_t> ids;
+    ids.reserve(acks.size());
+    for (const auto& kv : acks) {
+        ids.push_back(kv.first);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    std::size_t changed      = 0;
+    bool        walRewritten = false;
+    const bool ok = usageLog_.rewrite(
+        [&acks](std::string& payload) {
+            const auto it = acks.find(leadingId(payload));
+            return it != acks.end() && setSendOk(payload, it->second);
+        },
+        [&ids](std::uint64_t lo, std::uint64_t hi) {
+            const auto it = std::lower_bound(ids.begin(), ids.end(), lo);
+            return it != ids.end() && *it <= hi;
+        },
+        changed, walRewritten);
+    if (walRewritten && usageWriter_ && !usageWriter_->reopenLocked()) {
+        return false;
+    }
+    if (!ok) {
         return false;
     }
 
-    // Tüm dosyayı tekrar yaz
-    std::ofstream ofs(filePath, std::ios::trunc);
-    if (!ofs.is_open()) {
+    // Onaylar artık segmentlerde; çökme burada olursa journal tekrar uygulanır
+    if (!ackJournal_.reset()) {
         return false;
     }
+    RECUM_LOG_INFO("LogManager", "logs.ack compacted: {} acks, {} rows", acks.size(), changed);
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// 3) Infra logs: <appRoot>/logs/recumLogs.csv
+// ---------------------------------------------------------------------
 
-    for (const auto& l : lines) {
-        ofs << l << '\n';
+bool LogManager::startInfraLog(const std::string& appRoot, const InfraSinkConfig& cfg)
+{
+    if (!ensureScaffold(appRoot)) {
+        return false;
+    }
+    const fs::path filePath = fs::path(appRoot) / "logs" / "recumLogs.csv";
+    std::lock_guard<std::mutex> lock(infraMtx_);
+    if (!InfraLog::start(filePath.string(), cfg)) {
+        return false;
     }
+    infraStarted_ = true;
+    return true;
+}
 
-    if (!ofs) {
+void LogManager::stopInfraLog()
+{
+    std::lock_guard<std::mutex> lock(infraMtx_);
+    if (infraStarted_) {
+        InfraLog::stop();
+        infraStarted_ = false;
+    }
+}
+
+InfraLogStats LogManager::infraLogStats() const
+{
+    return InfraLog::stats();
+}
+
+bool LogManager::appendInfra(const std::string& appRoot,
+                             const std::string& level,
+                             const std::string& code,
+                             const std::string& message,
+                             const std::string& details)
+{
+    if (InfraLog::running()) {
+        const InfraLevel lv = (level == "ERROR") ? InfraLevel::Error
+                            : (level == "WARN")  ? InfraLevel::Warn
+                            : (level == "DEBUG") ? InfraLevel::Debug
+                                                 : InfraLevel::Info;
+        return InfraLog::writeText(lv, code, message, details);
+    }
+
+    if (!ensureScaffold(appRoot)) {
         return false;
     }
 
-    // Bellek cache'ini de güncelle
-    {
-        std::lock_guard<std::mutex> lock(usageMtx_);
-        for (auto& e : usageRows_) {
-            if (e.processId == processId && e.timeStamp == timeStamp) {
-                e.sendOk = normalizedSendOk;
-            }
-        }
+    const fs::path filePath = fs::path(appRoot) / "logs" / "recumLogs.csv";
+
+    std::lock_guard<std::mutex> lock(infraMtx_);
+    std::ofstream ofs(filePath, std::ios::app);
+    if (!ofs.is_open()) {
+        return false;
     }
 
-    return true;
+    ofs
+        << csvEscape(isoNowUtc()) << ','
+        << csvEscape(level) << ','
+        << csvEscape(code) << ','
+        << csvEscape(message) << ','
+        << csvEscape(details)
+        << '\n';
+
+    return static_cast<bool>(ofs);
 }
 
 } // namespace recum12::utils
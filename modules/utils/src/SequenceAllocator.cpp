@@ -0,0 +1,191 @@
+#include "utils/SequenceAllocator.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/InfraLog.h"
+
+namespace recum12::utils {
+
+namespace {
+
+constexpr char          kMagic[8] = {'R', 'C', 'U', 'M', 'S', 'E', 'Q', '\0'};
+constexpr std::uint32_t kVersion  = 1;
+
+struct Slot
+{
+    std::uint64_t limit;      // bu id'ye kadar (dahil) ayrıldı
+    std::uint64_t gen;        // yazım nesli; büyük olan güncel
+    std::uint64_t checksum;   // bu alan hariç slot
+};
+
+struct DiskLayout
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    Slot          slot[2];
+};
+
+static_assert(sizeof(Slot) == 24, "Slot layout degisti");
+static_assert(sizeof(DiskLayout) == 64, "DiskLayout layout degisti");
+
+std::uint64_t slotChecksum(const Slot& s)
+{
+    const auto*   p = reinterpret_cast<const std::uint8_t*>(&s);
+    std::uint64_t h = 1469598103934665603ULL;   // FNV-1a 64
+    for (std::size_t i = 0; i < offsetof(Slot, checksum); ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+} // namespace
+
+SequenceAllocator::~SequenceAllocator()
+{
+    close();
+}
+
+bool SequenceAllocator::open(const std::string& path, std::uint32_t block, std::uint64_t floor)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ >= 0) {
+        return true;
+    }
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        RECUM_LOG_ERROR("Seq", "open failed: {}: {}", path, std::strerror(errno));
+        return false;
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 ||
+        (st.st_size != static_cast<off_t>(sizeof(DiskLayout)) &&
+         ::ftruncate(fd, static_cast<off_t>(sizeof(DiskLayout))) != 0)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* map = ::mmap(nullptr, sizeof(DiskLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        RECUM_LOG_ERROR("Seq", "mmap failed: {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    auto* d = static_cast<DiskLayout*>(map);
+    std::uint64_t limit = 0;
+    std::uint64_t gen   = 0;
+    bool          valid = false;
+    if (std::memcmp(d->magic, kMagic, sizeof(kMagic)) == 0 && d->version == kVersion) {
+        for (const Slot& s : d->slot) {
+            if (s.checksum == slotChecksum(s) && s.gen >= gen) {
+                gen   = s.gen;
+                limit = s.limit;
+                valid = true;
+            }
+        }
+        if (!valid) {
+            RECUM_LOG_WARN("Seq", "{}: iki slot da bozuk, sayaç sıfırlandı", path);
+        }
+    } else {
+        // Boş veya tanınmayan dosya → sıfırdan başla.
+        if (st.st_size != 0) {
+            RECUM_LOG_WARN("Seq", "{}: tanınmayan dosya, sayaç sıfırlandı", path);
+        }
+        std::memset(d, 0, sizeof(DiskLayout));
+        std::memcpy(d->magic, kMagic, sizeof(kMagic));
+        d->version = kVersion;
+        if (::msync(map, sizeof(DiskLayout), MS_SYNC) != 0) {
+            ::munmap(map, sizeof(DiskLayout));
+            ::close(fd);
+            return false;
+        }
+    }
+
+    // Sıfırlanan ya da geride kalan sayaç store'daki en büyük id'den devam
+    // eder; yeni sınır ilk next()'te diske yazılır
+    if (limit < floor) {
+        RECUM_LOG_WARN("Seq", "{}: sayaç {} < store max id {}, {}'den devam", path, limit,
+                       floor, floor + 1);
+        limit = floor;
+    }
+
+    path_  = path;
+    fd_    = fd;
+    map_   = map;
+    block_ = block > 0 ? block : 1;
+    limit_ = limit;
+    gen_   = gen;
+    next_  = limit + 1;   // önceki çalışmada ayrılıp kullanılmayanlar atlanır
+    return true;
+}
+
+void SequenceAllocator::close()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ < 0) {
+        return;
+    }
+    // Temiz kapanış: kullanılmayan aralığı geri ver (sonraki açılışta boşluk yok)
+    if (next_ - 1 < limit_) {
+        reserveLocked(next_ - 1);
+    }
+    ::munmap(map_, sizeof(DiskLayout));
+    ::close(fd_);
+    map_ = nullptr;
+    fd_  = -1;
+}
+
+bool SequenceAllocator::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return fd_ >= 0;
+}
+
+bool SequenceAllocator::reserveLocked(std::uint64_t limit)
+{
+    auto* d = static_cast<DiskLayout*>(map_);
+
+    // Güncel slota dokunma: yeni sınır diğer slota yazılır
+    Slot& s    = d->slot[(gen_ + 1) % 2];
+    s.limit    = limit;
+    s.gen      = gen_ + 1;
+    s.checksum = slotChecksum(s);
+    if (::msync(map_, sizeof(DiskLayout), MS_SYNC) != 0) {
+        RECUM_LOG_ERROR("Seq", "msync failed: {}", std::strerror(errno));
+        return false;
+    }
+    ++gen_;
+    limit_ = limit;
+    return true;
+}
+
+std::uint64_t SequenceAllocator::next()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ < 0) {
+        return 0;
+    }
+    if (next_ > limit_ && !reserveLocked(next_ + block_ - 1)) {
+        return 0;
+    }
+    return next_++;
+}
+
+std::uint64_t SequenceAllocator::last() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return next_ - 1;
+}
+
+} // namespace recum12::utils
@@ -1,4 +1,5 @@
 #include "utils/Settings.h"
+#include <algorithm>
 #include <fstream>
 
 #include <nlohmann/json.hpp>
@@ -11,6 +12,26 @@ constexpr const char* kDefaultSettingsPath = "configs/default_settings.json";
 
 using Json = nlohmann::json;
 
+// "addr": 80 veya "addr": "0x50" → DART adresi; alan yoksa true (def korunur)
+bool readPumpAddr(const Json& j, int& addr)
+{
+    if (!j.contains("addr")) {
+        return true;
+    }
+    if (j["addr"].is_number_integer()) {
+        addr = j["addr"].get<int>();
+        return true;
+    }
+    if (j["addr"].is_string()) {
+        try {
+            addr = std::stoi(j["addr"].get<std::string>(), nullptr, 0);
+            return true;
+        } catch (...) {
+        }
+    }
+    return false;
+}
+
 } // namespace
 
 Settings::Settings()
@@ -32,6 +53,8 @@ Settings::Settings()
     pumpCfg.stop_bits = 1;
 
     rs485_.push_back(pumpCfg);
+
+    rfid_.push_back(RfidConfig{});
 }
 
 Settings Settings::loadDefault()
@@ -104,9 +127,117 @@ Settings Settings::loadFromFile(const std::string& path)
                     }
                 }
 
+                // "slots": [{"addr": "0x50", "nozzle": 1}, ...] (addr sayı veya "0x.." metni)
+                if (item.contains("slots") && item["slots"].is_array()) {
+                    for (const auto& js : item["slots"]) {
+                        if (!js.is_object()) {
+                            continue;
+                        }
+                        PumpSlotConfig sc;
+                        int addr = sc.addr;
+                        if (!readPumpAddr(js, addr)) {
+                            continue;
+                        }
+                        const int nozzle = js.value("nozzle", static_cast<int>(sc.nozzle));
+                        if (addr < 0x50 || addr > 0x6F || nozzle < 1 || nozzle > 15) {
+                            continue; // DART dışı adres / tabanca
+                        }
+                        sc.addr   = static_cast<std::uint8_t>(addr);
+                        sc.nozzle = static_cast<std::uint8_t>(nozzle);
+                        cfg.slots.push_back(sc);
+                    }
+                }
+
                 settings.rs485_.push_back(std::move(cfg));
             }
         }
+
+        if (root.contains("quota") && root["quota"].is_object()) {
+            const auto& jq = root["quota"];
+            // JSON sayıları double gelir; konfig kenarında bir kez x100'e yuvarla.
+            auto readVolume = [&jq](const char* key, Volume def) {
+                if (jq.contains(key) && jq[key].is_number()) {
+                    return Volume::fromDouble(jq[key].get<double>());
+                }
+                if (jq.contains(key) && jq[key].is_string()) {
+                    Volume v{};
+                    if (Volume::parse(jq[key].get<std::string>(), v)) {
+                        return v;
+                    }
+                }
+                return def;
+            };
+            settings.quota_.daily     = readVolume("daily_liters",   settings.quota_.daily);
+            settings.quota_.weekly    = readVolume("weekly_liters",  settings.quota_.weekly);
+            settings.quota_.monthly   = readVolume("monthly_liters", settings.quota_.monthly);
+            settings.quota_.per_plate = jq.value("per_plate",        settings.quota_.per_plate);
+            settings.quota_.user_limit_daily =
+                jq.value("user_limit_daily", settings.quota_.user_limit_daily);
+        }
+
+        // "rfid": {...} (tek okuyucu) veya [{...}, ...]
+        if (root.contains("rfid") &&
+            (root["rfid"].is_object() || root["rfid"].is_array())) {
+            const Json list = root["rfid"].is_array() ? root["rfid"]
+                                                      : Json::array({root["rfid"]});
+            std::vector<RfidConfig> readers;
+            for (const auto& jr : list) {
+                if (!jr.is_object()) {
+                    continue;
+                }
+                RfidConfig rc;
+                rc.backend = jr.value("backend", rc.backend);
+                rc.script  = jr.value("script",  rc.script);
+                rc.device  = jr.value("device",  rc.device);
+                if (jr.contains("mode") && jr["mode"].is_string()) {
+                    rc.hardware_poll = (jr["mode"].get<std::string>() != "select");
+                }
+                rc.poll_period_ms = jr.value("poll_period_ms", rc.poll_period_ms);
+                rc.poll_count     = jr.value("poll_count",     rc.poll_count);
+
+                int addr = rc.addr;
+                const int nozzle = jr.value("nozzle", static_cast<int>(rc.nozzle));
+                if (!readPumpAddr(jr, addr) ||
+                    (addr != 0 && (addr < 0x50 || addr > 0x6F)) || nozzle < 1 || nozzle > 15) {
+                    continue; // DART dışı adres / tabanca
+                }
+                rc.addr   = static_cast<std::uint8_t>(addr);
+                rc.nozzle = static_cast<std::uint8_t>(nozzle);
+                readers.push_back(std::move(rc));
+            }
+            if (!readers.empty()) {
+                settings.rfid_ = std::move(readers);
+            }
+        }
+
+        if (root.contains("usage_log") && root["usage_log"].is_object()) {
+            const auto& ju = root["usage_log"];
+            auto& ul = settings.usage_log_;
+            const std::string d = ju.value("durability", ul.durability);
+            if (d == "record" || d == "interval" || d == "sale_end") {
+                ul.durability = d;
+            }
+            ul.interval_ms = std::max(1,  ju.value("interval_ms", ul.interval_ms));
+            ul.queue       = std::max(16, ju.value("queue",       ul.queue));
+            ul.retention_days = std::max(0, ju.value("retention_days", ul.retention_days));
+            ul.compress       = ju.value("compress", ul.compress);
+            ul.load_workers   = std::clamp(ju.value("load_workers", ul.load_workers), 1, 16);
+            ul.cache_rows     = std::max(0, ju.value("cache_rows", ul.cache_rows));
+            ul.cache_days     = std::max(0, ju.value("cache_days", ul.cache_days));
+        }
+
+        if (root.contains("infra_log") && root["infra_log"].is_object()) {
+            const auto& ji = root["infra_log"];
+            auto& il = settings.infra_log_;
+            const std::string lv = ji.value("min_level", il.min_level);
+            if (lv == "DEBUG" || lv == "INFO" || lv == "WARN" || lv == "ERROR") {
+                il.min_level = lv;
+            }
+            il.ring_records = std::max(16, ji.value("ring_records", il.ring_records));
+            il.max_kb       = std::max(16, ji.value("max_kb",       il.max_kb));
+            il.keep_files   = std::max(0,  ji.value("keep_files",   il.keep_files));
+            il.console      = ji.value("console", il.console);
+        }
     } catch (...) {
         // Herhangi bir beklenmeyen durumda mevcut (kısmen dolu) ayarları koru
     }
@@ -0,0 +1,271 @@
+#include "utils/UsageAckJournal.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/InfraLog.h"
+
+namespace recum12::utils {
+
+namespace {
+
+constexpr char          kMagic[8] = {'R', 'C', 'U', 'M', 'A', 'C', 'K', '\0'};
+constexpr std::uint32_t kVersion  = 2;   // v2: anahtar satır sırası değil processId
+
+struct DiskHeader
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t record_size;
+};
+
+struct DiskRecord
+{
+    std::uint64_t process_id;
+    char          send_ok[UsageAckJournal::kSendOkMax + 1];  // '\0' ile dolu
+    std::uint64_t checksum;                                  // bu alan hariç kayıt
+};
+
+static_assert(sizeof(DiskHeader) == 16, "DiskHeader layout degisti");
+static_assert(sizeof(DiskRecord) == 24, "DiskRecord layout degisti");
+
+// 64-bit FNV-1a (core::UserDbImage ile aynı; utils core'a bağımlı değil)
+std::uint64_t fnv1a(const void* data, std::size_t len)
+{
+    const auto*   p = static_cast<const std::uint8_t*>(data);
+    std::uint64_t h = 1469598103934665603ULL;
+    for (std::size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::uint64_t recordChecksum(const DiskRecord& r)
+{
+    return fnv1a(&r, offsetof(DiskRecord, checksum));
+}
+
+DiskHeader freshHeader()
+{
+    DiskHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version     = kVersion;
+    h.record_size = sizeof(DiskRecord);
+    return h;
+}
+
+bool writeAll(int fd, const void* data, std::size_t len)
+{
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    while (len > 0) {
+        const ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p   += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool readFile(int fd, std::vector<std::uint8_t>& data)
+{
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        return false;
+    }
+    data.resize(static_cast<std::size_t>(st.st_size));
+    std::size_t got = 0;
+    while (got < data.size()) {
+        const ssize_t n = ::pread(fd, data.data() + got, data.size() - got,
+                                  static_cast<off_t>(got));
+        if (n <= 0) {
+            break;
+        }
+        got += static_cast<std::size_t>(n);
+    }
+    data.resize(got);
+    return true;
+}
+
+bool headerValid(const std::vector<std::uint8_t>& data)
+{
+    DiskHeader h{};
+    if (data.size() < sizeof(h)) {
+        return false;
+    }
+    std::memcpy(&h, data.data(), sizeof(h));
+    return std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 &&
+           h.version == kVersion && h.record_size == sizeof(DiskRecord);
+}
+
+// Geçerli kayıtları sırayla gezer; ilk bozuk kaydın ofsetini döner.
+template <typename Fn>
+std::size_t forEachRecord(const std::vector<std::uint8_t>& data, Fn&& fn)
+{
+    std::size_t off = sizeof(DiskHeader);
+    while (off + sizeof(DiskRecord) <= data.size()) {
+        DiskRecord r{};
+        std::memcpy(&r, data.data() + off, sizeof(r));
+        if (r.checksum != recordChecksum(r)) {
+            break; // yarım/bozuk kayıt → buradan sonrasını at
+        }
+        fn(r);
+        off += sizeof(DiskRecord);
+    }
+    return off;
+}
+
+} // namespace
+
+UsageAckJournal::~UsageAckJournal()
+{
+    close();
+}
+
+bool UsageAckJournal::open(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ >= 0) {
+        return true;
+    }
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        RECUM_LOG_ERROR("UsageAck", "open failed: {}: {}", path, std::strerror(errno));
+        return false;
+    }
+
+    std::vector<std::uint8_t> data;
+    if (!readFile(fd, data)) {
+        ::close(fd);
+        return false;
+    }
+
+    std::size_t records = 0;
+    bool        torn    = false;
+    if (!headerValid(data)) {
+        // Boş veya tanınmayan dosya → sıfırdan başla.
+        const DiskHeader h = freshHeader();
+        if (::ftruncate(fd, 0) != 0 || !writeAll(fd, &h, sizeof(h))) {
+            ::close(fd);
+            return false;
+        }
+        ::fdatasync(fd);
+    } else {
+        const std::size_t end = forEachRecord(data, [&records](const DiskRecord&) { ++records; });
+        if (end != data.size()) {
+            torn = ::ftruncate(fd, static_cast<off_t>(end)) != 0;
+            if (!torn) {
+                ::fdatasync(fd); // torn write: son bozuk kaydı kes
+            }
+        }
+    }
+
+    path_    = path;
+    fd_      = fd;
+    records_ = records;
+    torn_    = torn;
+    return true;
+}
+
+void UsageAckJournal::close()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool UsageAckJournal::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return fd_ >= 0;
+}
+
+bool UsageAckJournal::append(std::uint64_t processId, const std::string& sendOk)
+{
+    if (sendOk.size() > kSendOkMax) {
+        return false;
+    }
+
+    DiskRecord r{};
+    r.process_id = processId;
+    std::memcpy(r.send_ok, sendOk.data(), sendOk.size());
+    r.checksum = recordChecksum(r);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ < 0 || torn_) {
+        return false;
+    }
+    if (!writeAll(fd_, &r, sizeof(r))) {
+        // Yarım kayıt hizayı bozar: okuma orada durur, sonraki onaylar
+        // kaybolurdu → son tam kayda geri kes
+        const off_t good = static_cast<off_t>(sizeof(DiskHeader) + records_ * sizeof(DiskRecord));
+        if (::ftruncate(fd_, good) != 0) {
+            RECUM_LOG_ERROR("UsageAck", "{}: yarım kayıt geri alınamadı, ekleme durdu", path_);
+            torn_ = true;
+        }
+        return false;
+    }
+    ++records_;
+    return ::fdatasync(fd_) == 0;
+}
+
+bool UsageAckJournal::reset()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ < 0) {
+        return false;
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(sizeof(DiskHeader))) != 0) {
+        return false;
+    }
+    records_ = 0;
+    torn_    = false;
+    return ::fdatasync(fd_) == 0;
+}
+
+std::size_t UsageAckJournal::records() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return records_;
+}
+
+bool UsageAckJournal::readAll(const std::string& path,
+                              std::unordered_map<std::uint64_t, std::string>& out)
+{
+    out.clear();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno == ENOENT;
+    }
+
+    std::vector<std::uint8_t> data;
+    const bool ok = readFile(fd, data);
+    ::close(fd);
+    if (!ok) {
+        return false;
+    }
+    if (!headerValid(data)) {
+        return true; // boş / tanınmayan → onay yok
+    }
+
+    forEachRecord(data, [&out](const DiskRecord& r) {
+        out[r.process_id] = std::string(r.send_ok, ::strnlen(r.send_ok, sizeof(r.send_ok)));
+    });
+    return true;
+}
+
+} // namespace recum12::utils
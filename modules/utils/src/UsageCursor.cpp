@@ -0,0 +1,270 @@
+#include "utils/UsageCursor.h"
+
+#include <charconv>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/InfraLog.h"
+
+namespace recum12::utils {
+
+// ---------------------------------------------------------------------
+// UsageRowView
+// ---------------------------------------------------------------------
+
+std::string UsageRowView::text(Col c) const
+{
+    return CsvField{cols[c], true, (escaped & (1u << c)) != 0}.text();
+}
+
+bool UsageRowView::equals(Col c, std::string_view v) const
+{
+    return (escaped & (1u << c)) ? text(c) == v : cols[c] == v;
+}
+
+CardUid UsageRowView::rfid() const noexcept
+{
+    CardUid u;
+    CardUid::parseHex(cols[Rfid], u); // bozuk UID → boş
+    return u;
+}
+
+Volume UsageRowView::fuel() const noexcept
+{
+    Volume v{};
+    Volume::parse(cols[Fuel], v); // "12,34" tırnaklı yazılmışsa da tırnaksız görünür
+    return v;
+}
+
+int UsageRowView::limit() const noexcept
+{
+    int v = 0;
+    const std::string_view s = cols[Limit];
+    std::from_chars(s.data(), s.data() + s.size(), v);
+    return v;
+}
+
+// ---------------------------------------------------------------------
+// UsageCursor
+// ---------------------------------------------------------------------
+
+struct UsageCursor::State {
+    UsageSegmentLog::Snapshot                      snap;
+    UsageFilter                                    filter;
+    std::shared_ptr<const AckMap> acks;
+    Stats                         stats;
+
+    std::size_t      part{0};       // sıradaki açılacak parça
+    bool             active{false}; // file geçerli mi
+    bool             activeWal{false};
+    std::string      activePath;
+    std::size_t      off{0};
+    std::string_view file;          // map ya da inflated
+    void*            map{nullptr};
+    std::size_t      mapLen{0};
+    std::string      inflated;
+    std::vector<CsvField> fields;   // splitRow ara tamponu
+
+    ~State() { release(); }
+
+    void release()
+    {
+        if (map) {
+            ::munmap(map, mapLen);
+            map    = nullptr;
+            mapLen = 0;
+        }
+        inflated.clear();
+        file   = {};
+        active = false;
+    }
+
+    // Açık dosyayı salt-okunur eşler; boş dosya → false
+    bool mapFile(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        const std::size_t len = static_cast<std::size_t>(st.st_size);
+        void* m = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // eşleme fd'den bağımsız
+        if (m == MAP_FAILED) {
+            return false;
+        }
+        ::madvise(m, len, MADV_SEQUENTIAL);
+        map    = m;
+        mapLen = len;
+        file   = std::string_view(static_cast<const char*>(m), len);
+        return true;
+    }
+
+    bool openPart(const UsageSegmentLog::ReadPart& p)
+    {
+        for (const auto& [path, compressed] : p.paths) {
+            release();
+            if (compressed) {
+                if (!UsageSegmentLog::readCompressed(path, static_cast<std::size_t>(p.raw_bytes),
+                                                     inflated)) {
+                    continue;
+                }
+                file = inflated;
+            } else if (!mapFile(path)) {
+                continue;
+            }
+
+            // Yeni açılmış wal.log (mühürleme sonrası) başka seq taşır → sıradaki yol
+            std::uint64_t seq = 0;
+            if (!UsageSegmentLog::fileSeq(file, seq) || seq != p.seq) {
+                continue;
+            }
+            active     = true;
+            activeWal  = p.wal;
+            activePath = path;
+            off        = UsageSegmentLog::kHeaderSize;
+            return true;
+        }
+        release();
+        return false;
+    }
+
+    bool matches(const UsageRowView& row) const
+    {
+        if (filter.ranged()) {
+            const std::string_view ts = row.cols[UsageRowView::TimeStamp];
+            if (!UsageSegmentLog::isIsoTimeStamp(ts) ||
+                (!filter.fromTs.empty() && ts < std::string_view(filter.fromTs)) ||
+                (!filter.toTs.empty() && ts > std::string_view(filter.toTs))) {
+                return false;
+            }
+        }
+        if (!filter.logCode.empty() && !row.equals(UsageRowView::LogCode, filter.logCode)) {
+            return false;
+        }
+        if (!filter.plate.empty() && !row.equals(UsageRowView::Plate, filter.plate)) {
+            return false;
+        }
+        if (!filter.rfid.empty()) {
+            CardUid u;
+            if (!CardUid::parseHex(row.cols[UsageRowView::Rfid], u) || !(u == filter.rfid)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+UsageCursor::UsageCursor() = default;
+
+UsageCursor::UsageCursor(UsageSegmentLog::Snapshot snap, UsageFilter filter, AckMap acks)
+    : UsageCursor(std::move(snap), std::move(filter),
+                  std::make_shared<const AckMap>(std::move(acks)))
+{
+}
+
+UsageCursor::UsageCursor(UsageSegmentLog::Snapshot snap, UsageFilter filter,
+                         std::shared_ptr<const AckMap> acks)
+    : st_(std::make_unique<State>())
+{
+    st_->snap          = std::move(snap);
+    st_->filter        = std::move(filter);
+    st_->acks          = std::move(acks);
+    st_->stats.skipped = st_->snap.skipped;
+}
+
+UsageCursor::~UsageCursor() = default;
+
+UsageCursor::UsageCursor(UsageCursor&&) noexcept            = default;
+UsageCursor& UsageCursor::operator=(UsageCursor&&) noexcept = default;
+
+UsageCursor::Stats UsageCursor::stats() const
+{
+    return st_ ? st_->stats : Stats{};
+}
+
+bool UsageCursor::splitRow(std::string_view line, UsageRowView& row,
+                           std::vector<CsvField>& fields)
+{
+    const std::size_t n = CsvScanner::splitRow(line, fields);
+    if (n < UsageRowView::kCols - 1) {
+        return false; // beklenmeyen satır
+    }
+
+    row.escaped = 0;
+    row.payload = line;
+    row.acked   = false;
+    for (std::size_t c = 0; c < UsageRowView::kCols && c < n; ++c) {
+        row.cols[c] = fields[c].raw;
+        if (fields[c].escaped) {
+            row.escaped |= static_cast<std::uint16_t>(1u << c);
+        }
+    }
+    if (n == UsageRowView::kCols - 1) {
+        row.cols[UsageRowView::SendOk] = "NA"; // eski 9 kolonlu satır
+    }
+
+    const std::string_view id = row.cols[UsageRowView::ProcessId];
+    row.processId = 0;
+    std::from_chars(id.data(), id.data() + id.size(), row.processId);
+    return true;
+}
+
+bool UsageCursor::next(UsageRowView& row)
+{
+    if (!st_) {
+        return false;
+    }
+    State& s = *st_;
+    for (;;) {
+        if (!s.active) {
+            if (s.part >= s.snap.parts.size()) {
+                return false;
+            }
+            if (!s.openPart(s.snap.parts[s.part++])) {
+                continue; // saklama süresiyle silinmiş olabilir
+            }
+            ++s.stats.segments;
+            s.stats.bytes += s.file.size();
+        }
+
+        std::string_view payload;
+        const std::size_t next = UsageSegmentLog::nextFrame(s.file, s.off, payload);
+        if (next == 0) {
+            // wal.log'da yarım kuyruk normal: yazıcı o an ekliyor olabilir
+            if (s.off != s.file.size() && !s.activeWal) {
+                RECUM_LOG_WARN("UsageLog", "{}: {} bayt bozuk kuyruk atlandı", s.activePath,
+                               s.file.size() - s.off);
+            }
+            s.release();
+            continue;
+        }
+        s.off = next;
+        ++s.stats.scanned;
+
+        if (!splitRow(payload, row, s.fields) || !s.matches(row)) {
+            continue;
+        }
+        if (s.acks && !s.acks->empty() && row.processId != 0) {
+            const auto it = s.acks->find(row.processId);
+            if (it != s.acks->end()) {
+                row.cols[UsageRowView::SendOk] = it->second;
+                row.escaped &= static_cast<std::uint16_t>(~(1u << UsageRowView::SendOk));
+                row.acked   = true;
+            }
+        }
+        ++s.stats.matched;
+        return true;
+    }
+}
+
+} // namespace recum12::utils
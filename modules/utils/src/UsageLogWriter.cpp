@@ -0,0 +1,299 @@
+#include "utils/UsageLogWriter.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/InfraLog.h"
+
+namespace recum12::utils {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::int64_t usSince(Clock::time_point t0)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count();
+}
+
+void addSample(std::int64_t v, std::uint64_t n, std::int64_t& last, std::int64_t& max, double& avg)
+{
+    last = v;
+    if (n == 1 || v > max) max = v;
+    avg += (static_cast<double>(v) - avg) / static_cast<double>(n);
+}
+
+} // namespace
+
+UsageLogWriter::~UsageLogWriter()
+{
+    close();
+}
+
+bool UsageLogWriter::open(const std::string& path, const std::string& header,
+                          const UsageWriterConfig& cfg)
+{
+    if (fd_ >= 0) {
+        return true;
+    }
+
+    const int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        RECUM_LOG_ERROR("UsageLog", "open failed: {}: {}", path, std::strerror(errno));
+        return false;
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && st.st_size == 0 && !header.empty()) {
+        const std::string h = header + '\n';
+        if (::write(fd, h.data(), h.size()) != static_cast<ssize_t>(h.size())) {
+            ::close(fd);
+            return false;
+        }
+    }
+
+    cfg_  = cfg;
+    path_ = path;
+    if (cfg_.queue_capacity == 0) {
+        cfg_.queue_capacity = 1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        ring_.assign(cfg_.queue_capacity, Item{});
+        head_       = 0;
+        count_      = 0;
+        stop_       = false;
+        enqSeq_     = 0;
+        durableSeq_ = 0;
+        forceSync_  = false;
+        stats_      = UsageWriterStats{};
+        fd_         = fd;
+        torn_       = false;
+    }
+    thread_ = std::thread(&UsageLogWriter::run, this);
+    return true;
+}
+
+void UsageLogWriter::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (fd_ < 0) {
+            return;
+        }
+        stop_ = true;
+    }
+    notEmpty_.notify_all();
+    notFull_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    ::close(fd_);
+    fd_ = -1;
+    ring_.clear();
+}
+
+bool UsageLogWriter::enqueue(std::string line, bool sync_point)
+{
+    const auto t0 = Clock::now();
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (fd_ < 0 || stop_ || torn_) {
+            return false;
+        }
+        if (count_ == ring_.size()) {
+            // Kayıt düşürmek yerine geri basınç: disk takıldıysa üretici bekler
+            ++stats_.full_waits;
+            notFull_.wait(lock, [this] { return count_ < ring_.size() || stop_; });
+            if (stop_) {
+                return false;
+            }
+        }
+        Item& it      = ring_[(head_ + count_) % ring_.size()];
+        it.line       = std::move(line);
+        it.sync_point = sync_point;
+        ++count_;
+        ++enqSeq_;
+        ++stats_.enqueued;
+        addSample(usSince(t0), stats_.enqueued, stats_.enqueue_last_us,
+                  stats_.enqueue_max_us, stats_.enqueue_avg_us);
+    }
+    notEmpty_.notify_one();
+    return true;
+}
+
+bool UsageLogWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (fd_ < 0) {
+        return false;
+    }
+    const std::uint64_t target = enqSeq_;
+    const std::uint64_t errors = stats_.write_errors;
+    forceSync_ = true;
+    notEmpty_.notify_one();
+    durable_.wait(lock, [this, target] { return durableSeq_ >= target || fd_ < 0; });
+    return stats_.write_errors == errors;
+}
+
+std::unique_lock<std::mutex> UsageLogWriter::lockFile()
+{
+    return std::unique_lock<std::mutex>(fileMtx_);
+}
+
+bool UsageLogWriter::reopenLocked()
+{
+    const int nfd = ::open(path_.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (nfd < 0) {
+        RECUM_LOG_ERROR("UsageLog", "reopen failed: {}: {}", path_, std::strerror(errno));
+        return false;
+    }
+    // Aynı fd numarası üzerine: yazıcı thread'i fd_'yi değişmeden kullanır
+    const bool ok = ::dup3(nfd, fd_, O_CLOEXEC) >= 0;
+    ::close(nfd);
+    if (ok) {
+        torn_ = false;   // yeni dosya
+    }
+    return ok;
+}
+
+UsageWriterStats UsageLogWriter::stats() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return stats_;
+}
+
+bool UsageLogWriter::writeAll(const std::string& buf)
+{
+    // fileMtx_ tutuluyor. Yarım kalan write (ör. ENOSPC) wal'da yırtık çerçeve
+    // bırakır; sonraki çerçeveler arkasına eklenirse açılış recovery'si
+    // yırtık yerden keser ve hepsi kaybolur → son iyi boya geri dön.
+    struct stat st{};
+    const off_t good = ::fstat(fd_, &st) == 0 ? st.st_size : -1;
+
+    const char* p    = buf.data();
+    std::size_t left = buf.size();
+    while (left > 0) {
+        const ssize_t n = ::write(fd_, p, left);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            RECUM_LOG_ERROR("UsageLog", "write failed: {}", std::strerror(errno));
+            if (left != buf.size() && (good < 0 || ::ftruncate(fd_, good) != 0)) {
+                RECUM_LOG_ERROR("UsageLog", "{}: yarım çerçeve geri alınamadı, yazıcı durdu", path_);
+                torn_ = true;
+            }
+            return false;
+        }
+        p    += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool UsageLogWriter::syncNow()
+{
+    const auto t0 = Clock::now();
+    const bool ok = ::fdatasync(fd_) == 0;
+    const int  err = errno;
+    const std::int64_t us = usSince(t0);
+    if (!ok) {
+        RECUM_LOG_ERROR("UsageLog", "fdatasync failed: {}", std::strerror(err));
+    }
+
+    // Hata, durableSeq_ ilerlemeden sayılır: bekleyen flush() false döner
+    std::lock_guard<std::mutex> lock(mtx_);
+    ++stats_.syncs;
+    addSample(us, stats_.syncs, stats_.sync_last_us, stats_.sync_max_us, stats_.sync_avg_us);
+    if (!ok) ++stats_.write_errors;
+    return ok;
+}
+
+void UsageLogWriter::run()
+{
+    std::vector<std::string> batch;
+    batch.reserve(ring_.size());
+    std::string buf;
+
+    auto          lastSync   = Clock::now();
+    bool          dirty      = false;   // yazıldı, sync edilmedi
+    std::uint64_t writtenSeq = 0;
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    for (;;) {
+        if (count_ == 0 && !stop_ && !forceSync_) {
+            if (dirty && cfg_.durability == UsageDurability::Interval) {
+                notEmpty_.wait_until(lock, lastSync + cfg_.interval);
+            } else {
+                notEmpty_.wait(lock);
+            }
+        }
+
+        // Kuyruğu tek seferde boşalt (kopya yok, string'ler taşınır)
+        bool syncPoint = false;
+        batch.clear();
+        for (std::size_t i = 0; i < count_; ++i) {
+            Item& it = ring_[(head_ + i) % ring_.size()];
+            batch.push_back(std::move(it.line));
+            syncPoint |= it.sync_point;
+        }
+        head_  = (head_ + count_) % ring_.size();
+        count_ = 0;
+        const std::uint64_t batchEnd = enqSeq_;
+        const bool force    = forceSync_;
+        const bool stopping = stop_;
+        forceSync_ = false;
+        lock.unlock();
+        notFull_.notify_all();
+
+        bool ok = true;
+        if (!batch.empty()) {
+            buf.clear();
+            for (const auto& l : batch) {
+                buf += l;
+            }
+            std::lock_guard<std::mutex> flock(fileMtx_);
+            ok         = !torn_ && writeAll(buf);
+            dirty      = true;
+            writtenSeq = batchEnd;
+        }
+
+        const auto now = Clock::now();
+        const bool doSync =
+            dirty && (force || stopping ||
+                      cfg_.durability == UsageDurability::PerRecord ||
+                      (cfg_.durability == UsageDurability::OnSaleEnd && syncPoint) ||
+                      (cfg_.durability == UsageDurability::Interval &&
+                       now - lastSync >= cfg_.interval));
+        if (doSync) {
+            std::lock_guard<std::mutex> flock(fileMtx_);
+            syncNow();
+            lastSync = now;
+            dirty    = false;
+        }
+
+        lock.lock();
+        if (!batch.empty()) {
+            ++stats_.batches;
+            stats_.written  += batch.size();
+            if (batch.size() > stats_.max_batch) stats_.max_batch = batch.size();
+            if (!ok) ++stats_.write_errors;
+        }
+        if (!dirty) {
+            durableSeq_ = writtenSeq;
+            durable_.notify_all();
+        }
+        if (stopping && count_ == 0) {
+            break;
+        }
+    }
+}
+
+} // namespace recum12::utils
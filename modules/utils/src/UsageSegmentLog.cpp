@@ -0,0 +1,1168 @@
+#include "utils/UsageSegmentLog.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include <zlib.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/file.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "utils/InfraLog.h"
+
+namespace recum12::utils {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr char          kMagic[8] = {'R', 'C', 'U', 'M', 'U', 'S', 'G', '\0'};
+constexpr std::uint32_t kVersion  = 1;
+
+const char* const kManifestHeader =
+    "seq,compressed,records,raw_bytes,min_id,max_id,min_ts,max_ts,untimed";
+
+struct DiskHeader
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t seq;
+};
+
+struct FrameHeader
+{
+    std::uint32_t len;
+    std::uint32_t crc;
+};
+
+static_assert(sizeof(DiskHeader) == UsageSegmentLog::kHeaderSize, "DiskHeader layout degisti");
+static_assert(sizeof(FrameHeader) == UsageSegmentLog::kFrameOverhead, "FrameHeader layout degisti");
+
+const std::array<std::uint32_t, 256>& crcTable()
+{
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+DiskHeader makeHeader(std::uint64_t seq)
+{
+    DiskHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.seq     = seq;
+    return h;
+}
+
+std::string headerBytes(std::uint64_t seq)
+{
+    const DiskHeader h = makeHeader(seq);
+    return std::string(reinterpret_cast<const char*>(&h), sizeof(h));
+}
+
+bool readFile(const std::string& path, std::string& data)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    data.resize(static_cast<std::size_t>(st.st_size));
+    std::size_t got = 0;
+    while (got < data.size()) {
+        const ssize_t n = ::pread(fd, &data[got], data.size() - got, static_cast<off_t>(got));
+        if (n <= 0) {
+            break;
+        }
+        got += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+    data.resize(got);
+    return true;
+}
+
+bool writeAll(int fd, const void* data, std::size_t len)
+{
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    while (len > 0) {
+        const ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p   += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// Rename'in kendisi de kalıcı olsun
+void syncDir(const std::string& dir)
+{
+    const int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd >= 0) {
+        ::fsync(dfd);
+        ::close(dfd);
+    }
+}
+
+// Yeni dosya yazar + fsync (rename öncesi adım)
+bool writeFileSynced(const std::string& path, const std::string& bytes)
+{
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = writeAll(fd, bytes.data(), bytes.size());
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok) {
+        std::remove(path.c_str());
+    }
+    return ok;
+}
+
+// tmp + fsync + rename (yarım dosya asla görünmesin)
+bool replaceFile(const std::string& path, const std::string& bytes)
+{
+    const std::string tmp = path + ".tmp";
+    if (!writeFileSynced(tmp, bytes)) {
+        return false;
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    syncDir(fs::path(path).parent_path().string());
+    return true;
+}
+
+bool headerValid(std::string_view data, std::uint64_t* seq = nullptr)
+{
+    DiskHeader h{};
+    if (data.size() < sizeof(h)) {
+        return false;
+    }
+    std::memcpy(&h, data.data(), sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) {
+        return false;
+    }
+    if (seq) {
+        *seq = h.seq;
+    }
+    return true;
+}
+
+// Geçerli çerçeveleri gezer; ilk bozuk/yarım çerçevenin ofsetini döner.
+template <typename Fn>
+std::size_t scanFrames(const std::string& data, Fn&& fn)
+{
+    std::size_t      off = sizeof(DiskHeader);
+    std::string_view payload;
+    while (const std::size_t next = UsageSegmentLog::nextFrame(data, off, payload)) {
+        fn(off, off + sizeof(FrameHeader), payload.size());
+        off = next;
+    }
+    return off;
+}
+
+// Bugünden days gün önceki UTC gün ("YYYY-MM-DD")
+std::string utcDayBefore(int days)
+{
+    const std::time_t t = std::time(nullptr) - static_cast<std::time_t>(days) * 86400;
+    std::tm tm{};
+    gmtime_r(&t, &tm);
+    char buf[16];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d", &tm);
+    return buf;
+}
+
+bool deflateAll(const std::string& in, std::string& out)
+{
+    uLongf len = compressBound(static_cast<uLong>(in.size()));
+    out.resize(len);
+    if (compress2(reinterpret_cast<Bytef*>(&out[0]), &len,
+                  reinterpret_cast<const Bytef*>(in.data()), static_cast<uLong>(in.size()),
+                  Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return false;
+    }
+    out.resize(len);
+    return true;
+}
+
+// hint: beklenen açık boy (manifest raw_bytes); yanlışsa akış büyütülerek açılır
+bool inflateAll(const std::string& in, std::string& out, std::size_t hint)
+{
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK) {
+        return false;
+    }
+    out.resize(std::max<std::size_t>(hint, in.size() * 4) + 64);
+    zs.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+
+    int rc = Z_OK;
+    while (rc == Z_OK) {
+        if (zs.total_out == out.size()) {
+            out.resize(out.size() * 2);
+        }
+        zs.next_out  = reinterpret_cast<Bytef*>(&out[zs.total_out]);
+        zs.avail_out = static_cast<uInt>(out.size() - zs.total_out);
+        rc = inflate(&zs, Z_NO_FLUSH);
+    }
+    out.resize(zs.total_out);
+    inflateEnd(&zs);
+    return rc == Z_STREAM_END;
+}
+
+// Bakım thread'i satış/yazma thread'leriyle CPU yarışmasın
+void lowerThreadPriority()
+{
+    sched_param sp{};
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &sp) != 0) {
+        ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), 19);
+    }
+}
+
+} // namespace
+
+UsageSegmentLog::~UsageSegmentLog()
+{
+    close();
+}
+
+std::uint32_t UsageSegmentLog::crc32(const void* data, std::size_t len)
+{
+    const auto& t = crcTable();
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    std::uint32_t c = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < len; ++i) {
+        c = t[(c ^ p[i]) & 0xFFu] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+bool UsageSegmentLog::isIsoTimeStamp(std::string_view ts)
+{
+    if (ts.size() < 10 || ts[4] != '-' || ts[7] != '-') {
+        return false;
+    }
+    for (std::size_t i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (ts[i] < '0' || ts[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+void UsageSegmentLog::appendFrame(std::string& out, const std::string& payload)
+{
+    FrameHeader f{};
+    f.len = static_cast<std::uint32_t>(payload.size());
+    f.crc = crc32(payload.data(), payload.size());
+    out.append(reinterpret_cast<const char*>(&f), sizeof(f));
+    out += payload;
+}
+
+std::size_t UsageSegmentLog::nextFrame(std::string_view file, std::size_t off,
+                                       std::string_view& payload)
+{
+    FrameHeader f{};
+    if (off + sizeof(f) > file.size()) {
+        return 0;
+    }
+    std::memcpy(&f, file.data() + off, sizeof(f));
+    const std::size_t body = off + sizeof(f);
+    if (f.len > kMaxPayload || body + f.len > file.size() ||
+        crc32(file.data() + body, f.len) != f.crc) {
+        return 0;
+    }
+    payload = file.substr(body, f.len);
+    return body + f.len;
+}
+
+bool UsageSegmentLog::fileSeq(std::string_view file, std::uint64_t& seq)
+{
+    return headerValid(file, &seq);
+}
+
+bool UsageSegmentLog::readCompressed(const std::string& path, std::size_t hint, std::string& out)
+{
+    std::string z;
+    return readFile(path, z) && inflateAll(z, out, hint);
+}
+
+std::string UsageSegmentLog::segPath(std::uint64_t seq, bool compressed) const
+{
+    std::ostringstream oss;
+    oss << "seg-" << std::setw(8) << std::setfill('0') << seq << (compressed ? ".log.z" : ".log");
+    return (fs::path(dir_) / oss.str()).string();
+}
+
+std::string UsageSegmentLog::walPath() const
+{
+    return (fs::path(dir_) / "wal.log").string();
+}
+
+std::string UsageSegmentLog::manifestPath() const
+{
+    return (fs::path(dir_) / "manifest.csv").string();
+}
+
+void UsageSegmentLog::noteRecord(SegmentInfo& s, std::uint64_t id, const std::string& ts) const
+{
+    ++s.records;
+    if (id != 0) {
+        s.min_id = (s.min_id == 0) ? id : std::min(s.min_id, id);
+        s.max_id = std::max(s.max_id, id);
+    }
+    if (!isIsoTimeStamp(ts)) {
+        ++s.untimed;
+        return;
+    }
+    if (s.min_ts.empty() || ts < s.min_ts) {
+        s.min_ts = ts;
+    }
+    if (s.max_ts.empty() || ts > s.max_ts) {
+        s.max_ts = ts;
+    }
+}
+
+bool UsageSegmentLog::scanInfo(const std::string& data, SegmentInfo& s) const
+{
+    if (!headerValid(data)) {
+        return false;
+    }
+    const std::uint64_t seq        = s.seq;
+    const bool          compressed = s.compressed;
+    s            = SegmentInfo{};
+    s.seq        = seq;
+    s.compressed = compressed;
+    s.raw_bytes  = data.size();
+
+    std::string payload;
+    std::string ts;
+    scanFrames(data, [&](std::size_t, std::size_t body, std::size_t len) {
+        payload.assign(data, body, len);
+        std::uint64_t id = 0;
+        ts.clear();
+        if (info_) {
+            info_(payload, id, ts);
+        }
+        noteRecord(s, id, ts);
+    });
+    return true;
+}
+
+bool UsageSegmentLog::readSegment(const SegmentInfo& s, std::string& data) const
+{
+    if (!s.compressed) {
+        return readFile(segPath(s.seq, false), data);
+    }
+    std::string z;
+    return readFile(segPath(s.seq, true), z) &&
+           inflateAll(z, data, static_cast<std::size_t>(s.raw_bytes));
+}
+
+bool UsageSegmentLog::writeManifestLocked() const
+{
+    std::ostringstream oss;
+    oss << kManifestHeader << '\n';
+    for (const auto& seg : sealed_) {
+        const SegmentInfo& s = seg.info;
+        oss << s.seq << ',' << (s.compressed ? 1 : 0) << ',' << s.records << ','
+            << s.raw_bytes << ',' << s.min_id << ',' << s.max_id << ','
+            << s.min_ts << ',' << s.max_ts << ',' << s.untimed << '\n';
+    }
+    if (!replaceFile(manifestPath(), oss.str())) {
+        RECUM_LOG_ERROR("UsageLog", "manifest yazılamadı: {}", manifestPath());
+        return false;
+    }
+    return true;
+}
+
+bool UsageSegmentLog::loadSegments()
+{
+    std::error_code ec;
+    const fs::path pending = fs::path(dir_) / "import.pending";
+    if (fs::exists(pending, ec)) {
+        // Yarım kalmış logs.csv göçü: kaynak hâlâ logs.csv, baştan yapılacak
+        for (const auto& de : fs::directory_iterator(dir_, ec)) {
+            if (de.path().filename().string().compare(0, 4, "seg-") == 0) {
+                fs::remove(de.path(), ec);
+            }
+        }
+        fs::remove(manifestPath(), ec);
+        fs::remove(walPath(), ec);
+        fs::remove(pending, ec);
+        syncDir(dir_);
+        RECUM_LOG_WARN("UsageLog", "yarım kalan göç temizlendi, yeniden yapılacak");
+    }
+
+    // Dizindeki segmentler: seq → (.log var, .log.z var)
+    std::map<std::uint64_t, std::pair<bool, bool>> files;
+    for (const auto& de : fs::directory_iterator(dir_, ec)) {
+        const std::string name = de.path().filename().string();
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+            fs::remove(de.path(), ec); // yarım kalmış tmp
+            continue;
+        }
+        const bool plain = name.size() == 16 && name.compare(12, 4, ".log") == 0;
+        const bool z     = name.size() == 18 && name.compare(12, 6, ".log.z") == 0;
+        if ((!plain && !z) || name.compare(0, 4, "seg-") != 0) {
+            continue;
+        }
+        try {
+            auto& f = files[std::stoull(name.substr(4, 8))];
+            (plain ? f.first : f.second) = true;
+        } catch (...) {
+        }
+    }
+
+    std::map<std::uint64_t, SegmentInfo> listed;
+    {
+        std::string text;
+        if (readFile(manifestPath(), text)) {
+            std::istringstream iss(text);
+            std::string line;
+            std::getline(iss, line); // header
+            while (std::getline(iss, line)) {
+                std::vector<std::string> cols;
+                std::istringstream ls(line);
+                std::string col;
+                while (std::getline(ls, col, ',')) {
+                    cols.push_back(col);
+                }
+                if (cols.size() != 9) {
+                    continue;
+                }
+                try {
+                    SegmentInfo s;
+                    s.seq        = std::stoull(cols[0]);
+                    s.compressed = cols[1] == "1";
+                    s.records    = std::stoull(cols[2]);
+                    s.raw_bytes  = std::stoull(cols[3]);
+                    s.min_id     = std::stoull(cols[4]);
+                    s.max_id     = std::stoull(cols[5]);
+                    s.min_ts     = cols[6];
+                    s.max_ts     = cols[7];
+                    s.untimed    = std::stoull(cols[8]);
+                    listed[s.seq] = s;
+                } catch (...) {
+                }
+            }
+        }
+    }
+
+    sealed_.clear();
+    bool dirty = listed.size() != files.size();
+    std::string data;
+    for (auto& [seq, f] : files) {
+        if (f.first && f.second) {
+            // rewrite .log'u geri yazdı ya da sıkıştırma yarım kaldı: .log güncel
+            fs::remove(segPath(seq, true), ec);
+            f.second = false;
+        }
+
+        const auto it = listed.find(seq);
+        Segment seg;
+        if (it != listed.end() && it->second.compressed == f.second) {
+            seg.info = it->second;
+            if (!f.second) {
+                seg.info.raw_bytes = fs::file_size(segPath(seq, false), ec);
+            }
+        } else {
+            seg.info.seq        = seq;
+            seg.info.compressed = f.second;
+            if (!readSegment(seg.info, data) || !scanInfo(data, seg.info)) {
+                RECUM_LOG_ERROR("UsageLog", "segment okunamadı: {}", segPath(seq, f.second));
+            }
+            ++recovery_.rescanned;
+            dirty = true;
+        }
+        sealed_.push_back(std::move(seg));
+    }
+
+    recovery_.segments = sealed_.size();
+    if (dirty) {
+        writeManifestLocked();
+    }
+    return true;
+}
+
+bool UsageSegmentLog::createWal(std::uint64_t seq)
+{
+    if (!replaceFile(walPath(), headerBytes(seq))) {
+        return false;
+    }
+    walSeq_   = seq;
+    walBytes_ = 0;
+    wal_      = SegmentInfo{};
+    wal_.seq  = seq;
+    walTorn_  = false;
+    return true;
+}
+
+bool UsageSegmentLog::recoverWal()
+{
+    const std::uint64_t nextSeq = sealed_.empty() ? 1 : sealed_.back().info.seq + 1;
+
+    std::string data;
+    if (!readFile(walPath(), data)) {
+        // Yok (ilk açılış ya da mühürleme sonrası çökme) → yeni wal
+        recovery_.wal_recreated = true;
+        return createWal(nextSeq);
+    }
+
+    std::uint64_t seq = 0;
+    if (!headerValid(data, &seq)) {
+        if (data.size() > sizeof(DiskHeader)) {
+            // Header bozuk ama içerik var: silme, kenara al
+            const std::string bad = walPath() + ".bad";
+            std::rename(walPath().c_str(), bad.c_str());
+            RECUM_LOG_ERROR("UsageLog", "wal.log header bozuk, {} olarak saklandı", bad);
+        }
+        recovery_.wal_recreated = true;
+        return createWal(nextSeq);
+    }
+
+    SegmentInfo info;
+    std::string payload;
+    std::string ts;
+    const std::size_t end = scanFrames(data, [&](std::size_t, std::size_t body, std::size_t len) {
+        payload.assign(data, body, len);
+        std::uint64_t id = 0;
+        ts.clear();
+        if (info_) {
+            info_(payload, id, ts);
+        }
+        noteRecord(info, id, ts);
+    });
+    if (end != data.size()) {
+        // Torn write: son yarım/bozuk çerçeveyi kes
+        const int fd = ::open(walPath().c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(end)) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return false;
+        }
+        ::fdatasync(fd);
+        ::close(fd);
+        recovery_.truncated_bytes = data.size() - end;
+    }
+
+    walSeq_               = std::max(seq, nextSeq);
+    walBytes_             = end - sizeof(DiskHeader);
+    wal_                  = info;
+    wal_.seq              = walSeq_;
+    recovery_.wal_records = info.records;
+    return true;
+}
+
+bool UsageSegmentLog::open(const std::string& dir, RecordInfoFn info)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    if (open_) {
+        return true;
+    }
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (!fs::is_directory(dir, ec)) {
+        return false;
+    }
+
+    // Recovery ve loadSegments dosya siler/keser: önce süreç kilidi
+    busy_ = false;
+    const std::string lockPath = (fs::path(dir) / ".lock").string();
+    lockFd_ = ::open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lockFd_ < 0) {
+        return false;
+    }
+    if (::flock(lockFd_, LOCK_EX | LOCK_NB) != 0) {
+        busy_ = (errno == EWOULDBLOCK);
+        ::close(lockFd_);
+        lockFd_ = -1;
+        return false;
+    }
+
+    dir_  = dir;
+    info_ = std::move(info);
+
+    recovery_ = RecoveryStats{};
+    walTorn_  = false;   // recoverWal yırtık kuyruğu keser
+    if (!loadSegments() || !recoverWal()) {
+        ::close(lockFd_);
+        lockFd_ = -1;
+        return false;
+    }
+    open_ = true;
+    return true;
+}
+
+void UsageSegmentLog::close()
+{
+    stopMaintenance();
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    open_ = false;
+    sealed_.clear();
+    walBytes_ = 0;
+    wal_      = SegmentInfo{};
+    if (lockFd_ >= 0) {
+        ::close(lockFd_);   // flock'u bırakır
+        lockFd_ = -1;
+    }
+}
+
+bool UsageSegmentLog::isOpen() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return open_;
+}
+
+bool UsageSegmentLog::busy() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return busy_;
+}
+
+UsageSegmentLog::RecoveryStats UsageSegmentLog::recovery() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return recovery_;
+}
+
+std::vector<UsageSegmentLog::SegmentInfo> UsageSegmentLog::segments() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    std::vector<SegmentInfo> out;
+    out.reserve(sealed_.size());
+    for (const auto& s : sealed_) {
+        out.push_back(s.info);
+    }
+    return out;
+}
+
+bool UsageSegmentLog::empty() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return sealed_.empty() && walBytes_ == 0;
+}
+
+std::uint64_t UsageSegmentLog::maxId() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    std::uint64_t id = wal_.max_id;
+    for (const auto& s : sealed_) {
+        id = std::max(id, s.info.max_id);
+    }
+    return id;
+}
+
+std::uint64_t UsageSegmentLog::walBytes() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return walBytes_;
+}
+
+bool UsageSegmentLog::needsRotation(const std::string& ts) const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    if (walBytes_ >= kSegmentBytes) {
+        return true;
+    }
+    // Günlük segment: yeni kaydın günü wal'daki en geç günden ileride.
+    // Geriye düşen (saat düzeltmesi) kayıt mevcut segmentte kalır; aralık
+    // min/max olduğundan manifest yine doğru.
+    return wal_.records > 0 && !wal_.max_ts.empty() && isIsoTimeStamp(ts) &&
+           ts.compare(0, 10, wal_.max_ts, 0, 10) > 0;
+}
+
+void UsageSegmentLog::noteAppend(std::uint64_t bytes, std::uint64_t id, const std::string& ts)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    walBytes_ += bytes;
+    noteRecord(wal_, id, ts);
+}
+
+bool UsageSegmentLog::append(const std::string& frame, std::uint64_t id, const std::string& ts)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    if (!open_) {
+        return false;
+    }
+    if (walTorn_) {
+        return false;
+    }
+    const int fd = ::open(walPath().c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    // Yarım write'ın baytları geri alınır: arkasına eklenen çerçeveler
+    // açılış recovery'sinde yırtık yerden kesilip kaybolurdu
+    struct stat st{};
+    const off_t good = ::fstat(fd, &st) == 0 ? st.st_size : -1;
+    const bool  ok   = writeAll(fd, frame.data(), frame.size());
+    if (!ok && (good < 0 || ::ftruncate(fd, good) != 0)) {
+        RECUM_LOG_ERROR("UsageLog", "{}: yarım çerçeve geri alınamadı, ekleme durdu", walPath());
+        walTorn_ = true;
+    }
+    ::close(fd);
+    if (ok) {
+        walBytes_ += frame.size();
+        noteRecord(wal_, id, ts);
+    }
+    return ok;
+}
+
+bool UsageSegmentLog::seal()
+{
+    {
+        std::unique_lock<std::shared_mutex> lock(mtx_);
+        if (!open_ || walBytes_ == 0) {
+            return open_;
+        }
+
+        const int fd = ::open(walPath().c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        const bool synced = ::fsync(fd) == 0;
+        ::close(fd);
+
+        const std::string sealedPath = segPath(walSeq_, false);
+        if (!synced || std::rename(walPath().c_str(), sealedPath.c_str()) != 0) {
+            return false;
+        }
+        Segment seg;
+        seg.info            = wal_;
+        seg.info.seq        = walSeq_;
+        seg.info.compressed = false;
+        seg.info.raw_bytes  = walBytes_ + sizeof(DiskHeader);
+        sealed_.push_back(std::move(seg));
+        // Manifest yazılamazsa açılışta segment taranıp eklenir
+        writeManifestLocked();
+        // Çökme burada olursa açılışta wal.log yok → recoverWal yenisini açar
+        if (!createWal(walSeq_ + 1)) {
+            return false;
+        }
+    }
+
+    // Yeni mühürlü segment: bakım thread'i sıkıştırsın
+    {
+        std::lock_guard<std::mutex> mlock(maintMtx_);
+        maintKick_ = true;
+    }
+    maintCv_.notify_one();
+    return true;
+}
+
+UsageSegmentLog::Snapshot UsageSegmentLog::snapshot(const std::string& fromTs,
+                                                    const std::string& toTs) const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    Snapshot snap;
+    if (!open_) {
+        return snap;
+    }
+
+    const bool ranged  = !fromTs.empty() || !toTs.empty();
+    const auto overlap = [&](const SegmentInfo& s) {
+        if (!ranged || s.untimed > 0 || s.min_ts.empty()) {
+            return true; // zamanı bilinmeyen kayıt var → atlanamaz
+        }
+        return (fromTs.empty() || s.max_ts >= fromTs) && (toTs.empty() || s.min_ts <= toTs);
+    };
+
+    for (const auto& seg : sealed_) {
+        const SegmentInfo& s = seg.info;
+        if (s.records == 0 || !overlap(s)) {
+            ++snap.skipped;
+            continue;
+        }
+        ReadPart p;
+        p.seq       = s.seq;
+        p.raw_bytes = s.raw_bytes;
+        p.paths     = {{segPath(s.seq, s.compressed), s.compressed},
+                       {segPath(s.seq, !s.compressed), !s.compressed}};
+        snap.parts.push_back(std::move(p));
+    }
+
+    // wal.log: okunana kadar mühürlenmiş olabilir → aynı seq'li segment
+    if (!ranged || (wal_.records > 0 && overlap(wal_))) {
+        ReadPart p;
+        p.seq   = walSeq_;
+        p.wal   = true;
+        p.paths = {{walPath(), false}, {segPath(walSeq_, false), false}, {segPath(walSeq_, true), true}};
+        snap.parts.push_back(std::move(p));
+    } else {
+        ++snap.skipped;
+    }
+    return snap;
+}
+
+bool UsageSegmentLog::rewrite(const std::function<bool(std::string& payload)>& mutate,
+                              const std::function<bool(std::uint64_t, std::uint64_t)>& mayContain,
+                              std::size_t& changed, bool& walRewritten)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    changed      = 0;
+    walRewritten = false;
+    if (!open_) {
+        return false;
+    }
+
+    std::string data;
+    std::string out;
+    std::string payload;
+
+    // data'daki çerçeveleri mutate eder; değişen kayıt sayısı (out: yeni içerik)
+    const auto apply = [&]() -> std::size_t {
+        std::size_t segChanged = 0;
+        out.assign(data, 0, sizeof(DiskHeader));
+        const std::size_t end = scanFrames(data, [&](std::size_t, std::size_t body, std::size_t len) {
+            payload.assign(data, body, len);
+            if (mutate(payload)) {
+                ++segChanged;
+            }
+            appendFrame(out, payload);
+        });
+        // Bozuk kuyruk (mühürlü segmentte olmamalı) olduğu gibi korunur
+        out.append(data, end, std::string::npos);
+        return segChanged;
+    };
+
+    bool ok            = true;
+    bool manifestDirty = false;
+    for (auto& seg : sealed_) {
+        SegmentInfo& s = seg.info;
+        if (s.records == 0 || (mayContain && !mayContain(s.min_id, s.max_id))) {
+            continue;
+        }
+        if (!readSegment(s, data) || !headerValid(data)) {
+            continue;
+        }
+        const std::size_t segChanged = apply();
+        if (segChanged == 0) {
+            continue;
+        }
+        // Sıkıştırılmış segment açık .log olarak geri yazılır (.log önceliklidir)
+        if (!replaceFile(segPath(s.seq, false), out)) {
+            ok = false;
+            continue;
+        }
+        if (s.compressed) {
+            std::remove(segPath(s.seq, true).c_str());
+            s.compressed = false;
+        }
+        s.raw_bytes   = out.size();
+        ++seg.gen;
+        changed      += segChanged;
+        manifestDirty = true;
+    }
+    if (manifestDirty) {
+        writeManifestLocked();
+    }
+
+    if (wal_.records == 0 || (mayContain && !mayContain(wal_.min_id, wal_.max_id)) ||
+        !readFile(walPath(), data) || !headerValid(data)) {
+        return ok;
+    }
+    const std::size_t walChanged = apply();
+    if (walChanged > 0) {
+        if (!replaceFile(walPath(), out)) {
+            return false;
+        }
+        changed     += walChanged;
+        walRewritten = true;
+        walBytes_    = out.size() - sizeof(DiskHeader);
+    }
+    return ok;
+}
+
+bool UsageSegmentLog::importInitial(const std::vector<std::string>& payloads)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    if (!open_ || !sealed_.empty() || walBytes_ != 0) {
+        return false;
+    }
+
+    const std::string pending = (fs::path(dir_) / "import.pending").string();
+    if (!writeFileSynced(pending, std::string{})) {
+        return false;
+    }
+    syncDir(dir_);
+
+    std::uint64_t seq = walSeq_;
+    Segment       cur;
+    cur.info.seq = seq;
+    std::string   out = headerBytes(seq);
+    std::string   ts;
+
+    const auto flush = [&]() {
+        if (cur.info.records == 0) {
+            return true;
+        }
+        cur.info.raw_bytes = out.size();
+        if (!writeFileSynced(segPath(seq, false), out)) {
+            return false;
+        }
+        sealed_.push_back(cur);
+        ++seq;
+        cur          = Segment{};
+        cur.info.seq = seq;
+        out          = headerBytes(seq);
+        return true;
+    };
+
+    bool ok = true;
+    for (const auto& p : payloads) {
+        std::uint64_t id = 0;
+        ts.clear();
+        if (info_) {
+            info_(p, id, ts);
+        }
+        // Canlı yazımla aynı sınırlar: gün değişimi ya da boyut eşiği
+        const bool dayChanged = cur.info.records > 0 && !cur.info.max_ts.empty() &&
+                                isIsoTimeStamp(ts) && ts.compare(0, 10, cur.info.max_ts, 0, 10) > 0;
+        if ((dayChanged || out.size() - sizeof(DiskHeader) >= kSegmentBytes) && !(ok = flush())) {
+            break;
+        }
+        appendFrame(out, p);
+        noteRecord(cur.info, id, ts);
+    }
+    ok = ok && flush();
+    syncDir(dir_);
+
+    // Manifest yazıldıktan sonra işaret kalkar: göç artık tamam
+    if (!ok || !writeManifestLocked() || !createWal(seq) || std::remove(pending.c_str()) != 0) {
+        RECUM_LOG_ERROR("UsageLog", "logs.csv göçü yarım kaldı (açılışta yeniden denenir)");
+        return false;
+    }
+    syncDir(dir_);
+    recovery_.segments = sealed_.size();
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// Bakım: sıkıştırma + saklama süresi
+// ---------------------------------------------------------------------
+
+bool UsageSegmentLog::compressOne(std::uint64_t seq)
+{
+    std::uint64_t gen = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(mtx_);
+        const auto it = std::find_if(sealed_.begin(), sealed_.end(),
+                                     [seq](const Segment& s) { return s.info.seq == seq; });
+        if (it == sealed_.end() || it->info.compressed) {
+            return true;
+        }
+        gen = it->gen;
+    }
+
+    // Asıl iş kilitsiz: rename atomik olduğundan eski ya da yeni içerik okunur,
+    // arada rewrite olduysa gen değişir ve sonuç atılır
+    std::string raw;
+    std::string z;
+    std::string check;
+    if (!readFile(segPath(seq, false), raw) || !headerValid(raw) || !deflateAll(raw, z) ||
+        !inflateAll(z, check, raw.size()) || check != raw) {
+        return false;
+    }
+    const std::string zPath = segPath(seq, true);
+    const std::string tmp   = zPath + ".tmp";
+    if (!writeFileSynced(tmp, z)) {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    const auto it = std::find_if(sealed_.begin(), sealed_.end(),
+                                 [seq](const Segment& s) { return s.info.seq == seq; });
+    if (it == sealed_.end() || it->info.compressed || it->gen != gen ||
+        std::rename(tmp.c_str(), zPath.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return true;
+    }
+    syncDir(dir_);
+    it->info.compressed = true;
+    it->info.raw_bytes  = raw.size();
+    writeManifestLocked();
+    // Çökme burada olursa ikisi birden kalır; açılışta .log kazanır
+    std::remove(segPath(seq, false).c_str());
+    syncDir(dir_);
+
+    std::lock_guard<std::mutex> slock(statsMtx_);
+    ++maintStats_.compressed;
+    maintStats_.bytes_in  += raw.size();
+    maintStats_.bytes_out += z.size();
+    return true;
+}
+
+std::size_t UsageSegmentLog::expireBefore(const std::string& cutoffDay)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    std::vector<SegmentInfo> expired;
+    for (auto it = sealed_.begin(); it != sealed_.end();) {
+        const SegmentInfo& s = it->info;
+        // Yalnızca tüm kayıtlarının günü bilinen ve cutoff'tan eski segmentler
+        if (s.records > 0 && s.untimed == 0 && !s.max_ts.empty() &&
+            s.max_ts.compare(0, 10, cutoffDay) < 0) {
+            expired.push_back(s);
+            it = sealed_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (expired.empty()) {
+        return 0;
+    }
+
+    // Önce manifest: çökmede kalan dosya açılışta taranıp geri eklenir,
+    // sonraki turda yine silinir
+    writeManifestLocked();
+    std::uint64_t records = 0;
+    for (const auto& s : expired) {
+        std::remove(segPath(s.seq, s.compressed).c_str());
+        records += s.records;
+    }
+    syncDir(dir_);
+
+    std::lock_guard<std::mutex> slock(statsMtx_);
+    maintStats_.expired         += expired.size();
+    maintStats_.expired_records += records;
+    return expired.size();
+}
+
+bool UsageSegmentLog::maintenanceStopping()
+{
+    std::lock_guard<std::mutex> lock(maintMtx_);
+    return maintStop_;
+}
+
+bool UsageSegmentLog::runMaintenance(const MaintenancePolicy& policy)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    std::size_t expired = 0;
+    if (policy.retention_days > 0) {
+        expired = expireBefore(utcDayBefore(policy.retention_days));
+    }
+
+    bool        ok         = true;
+    std::size_t compressed = 0;
+    if (policy.compress) {
+        std::vector<std::uint64_t> todo;
+        {
+            std::shared_lock<std::shared_mutex> lock(mtx_);
+            for (const auto& s : sealed_) {
+                if (!s.info.compressed) {
+                    todo.push_back(s.info.seq);
+                }
+            }
+        }
+        for (std::uint64_t seq : todo) {
+            if (maintenanceStopping()) {
+                break;
+            }
+            if (!compressOne(seq)) {
+                RECUM_LOG_WARN("UsageLog", "segment sıkıştırılamadı: {}", segPath(seq, false));
+                ok = false;
+                continue;
+            }
+            ++compressed;
+        }
+    }
+
+    if (expired > 0 || compressed > 0) {
+        RECUM_LOG_INFO("UsageLog", "bakım: {} segment sıkıştırıldı, {} segment saklama süresi dolup silindi",
+                       compressed, expired);
+    }
+    return ok;
+}
+
+UsageSegmentLog::MaintenanceStats UsageSegmentLog::maintenanceStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMtx_);
+    return maintStats_;
+}
+
+void UsageSegmentLog::maintenanceLoop(MaintenancePolicy policy)
+{
+    lowerThreadPriority();
+
+    std::unique_lock<std::mutex> lock(maintMtx_);
+    while (!maintStop_) {
+        maintCv_.wait_for(lock, policy.period, [this] { return maintStop_ || maintKick_; });
+        if (maintStop_) {
+            break;
+        }
+        maintKick_ = false;
+        lock.unlock();
+        runMaintenance(policy);
+        lock.lock();
+    }
+}
+
+bool UsageSegmentLog::startMaintenance(const MaintenancePolicy& policy)
+{
+    if (!isOpen()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(maintMtx_);
+    if (maintThread_.joinable()) {
+        return true;
+    }
+    maintStop_   = false;
+    maintKick_   = true; // ilk tur hemen: önceki çalışmadan kalan segmentler
+    maintThread_ = std::thread(&UsageSegmentLog::maintenanceLoop, this, policy);
+    return true;
+}
+
+void UsageSegmentLog::stopMaintenance()
+{
+    {
+        std::lock_guard<std::mutex> lock(maintMtx_);
+        if (!maintThread_.joinable()) {
+            return;
+        }
+        maintStop_ = true;
+    }
+    maintCv_.notify_one();
+    maintThread_.join();
+}
+
+} // namespace recum12::utils